@@ -27,58 +27,6 @@
 
 GST_DEBUG_CATEGORY_STATIC (gst_assess_debug);
 #define GST_CAT_DEFAULT gst_assess_debug
-#define ASSESS_NAME_LENGTH (8 * 5)
-
-#define GST_ASSESS_LOCK(obj) (g_mutex_lock (&(obj)->lock))
-#define GST_ASSESS_UNLOCK(obj) (g_mutex_unlock (&(obj)->lock))
-#define ASSESS_DB_LOCK() (g_mutex_lock (&assess_db_lock))
-#define ASSESS_DB_UNLOCK() (g_mutex_unlock (&assess_db_lock))
-#define ASSESS_POINT_LOCK(ap) (g_mutex_lock (&(ap)->lock))
-#define ASSESS_POINT_UNLOCK(ap) (g_mutex_unlock (&(ap)->lock))
-
-/**
- * @class GstAssessPoint 
- * @struct _GstAssessPoint 
- * @brief Helper class for assessment.
- */
-typedef struct _GstAssessPoint
-{
-  GMutex lock;
-  guint number;
-  guint sequence;
-  gchar *name;
-  GstClockTime ats;
-  GstClockTime pts;
-  GstClockTime dts;
-  GstClockTime duration;
-  guint64 running_time;         /* measured in milliseconds */
-  guint64 offset, offset_end;
-  guint64 buffer_count;
-} GstAssessPoint;
-
-/**
- * @deprecated Not Used!
- */
-typedef struct _GstAssessDB
-{
-  GstClock *clock;
-  guint timer;
-  GHashTable *hash;
-} GstAssessDB;
-
-/**
- * @deprecated Not Used!
- */
-typedef struct _GstAssessMeta
-{
-  GstMeta base;
-  guint sequence;
-} GstAssessMeta;
-
-static GMutex assess_db_lock = { 0 };
-static GstAssessDB assess_db = { 0 };
-
-//static GType assess_meta_api;
 
 static GstStaticPadTemplate gst_assess_sink_factory =
 GST_STATIC_PAD_TEMPLATE ("sink",
@@ -96,175 +44,186 @@ enum
 {
   PROP_0,
   PROP_N,
+  PROP_FROM,
+  PROP_STATS,
 };
 
 #define gst_assess_parent_class parent_class
 G_DEFINE_TYPE (GstAssess, gst_assess, GST_TYPE_BASE_TRANSFORM);
 
-#define GST_ASSESS_META_IMPL "GstSwitchAssessMetaImpl"
-
 /**
- * @deprecated
+ * @brief The index of the highest bit set in @value, which is not 0.
  */
-gboolean
-gst_assess_meta_init (GstMeta * meta, gpointer params, GstBuffer * buffer)
+static guint
+gst_assess_msb (guint64 value)
 {
-  GstAssessMeta *assess_meta = (GstAssessMeta *) meta;
-  assess_meta->sequence = 0;
-  INFO ("%s", __FUNCTION__);
-  return TRUE;
+  if (value >> 32)
+    return 31 + g_bit_storage ((gulong) (value >> 32));
+  return g_bit_storage ((gulong) value) - 1;
 }
 
 /**
- * @deprecated
+ * @brief The bucket a value of @value usec is counted in.
  */
-void
-gst_assess_meta_free (GstMeta * meta, GstBuffer * buffer)
+static guint
+gst_assess_bucket (gint64 value)
 {
-  //g_free (meta);
-  INFO ("%s", __FUNCTION__);
+  guint64 v = CLAMP (value, 0, (G_GINT64_CONSTANT (1) << 40) - 1);
+  guint shift;
+
+  if (v < (2 << GST_ASSESS_SUB_BITS))
+    return v;
+  shift = gst_assess_msb (v) - GST_ASSESS_SUB_BITS;
+  return (shift << GST_ASSESS_SUB_BITS) + (v >> shift);
 }
 
 /**
- * @deprecated
+ * @brief The value in the middle of the @bucket.
  */
-gboolean
-gst_assess_meta_transform (GstBuffer * transbuf,
-    GstMeta * meta, GstBuffer * buffer, GQuark type, gpointer data)
+static gint64
+gst_assess_bucket_value (guint bucket)
 {
-  //GstAssessMeta *assess_meta = (GstAssessMeta *) meta;
-  INFO ("%s", __FUNCTION__);
-  return TRUE;
+  guint shift;
+
+  if (bucket < (2 << GST_ASSESS_SUB_BITS))
+    return bucket;
+  shift = (bucket >> GST_ASSESS_SUB_BITS) - 1;
+  return ((gint64) (bucket - (shift << GST_ASSESS_SUB_BITS)) << shift) +
+      ((G_GINT64_CONSTANT (1) << shift) >> 1);
 }
 
 /**
- * @deprecated
+ * @brief Count a value of @value usec, from the streaming thread.
  */
-static gint
-assess_compare_name (gconstpointer a, gconstpointer b, gpointer user_data)
+void
+gst_assess_histogram_add (GstAssessHistogram * histogram, gint64 value)
 {
-  GHashTable *assess_point_hash = user_data;
-  GstAssessPoint *ap1 = g_hash_table_lookup (assess_point_hash, a);
-  GstAssessPoint *ap2 = g_hash_table_lookup (assess_point_hash, b);
-  if (ap1->number < ap2->number)
-    return -1;
-  if (ap1->number > ap2->number)
-    return 1;
-  if (ap1->pts < ap2->pts)
-    return -1;
-  if (ap1->pts > ap2->pts)
-    return 1;
-  return 0;
+  g_atomic_int_inc (&histogram->counts[gst_assess_bucket (value)]);
 }
 
 /**
- * @deprecated
+ * @brief The number of values counted in @histogram.
  */
-static gboolean
-assess_db_timeout (gpointer data)
+guint64
+gst_assess_histogram_count (GstAssessHistogram * histogram)
 {
-  gboolean ret = TRUE;
-  GHashTable *assess_point_hash = NULL;
-  GList *keys, *key, *names, *name;
-  ASSESS_DB_LOCK ();
-  keys = g_hash_table_get_keys (assess_db.hash);
-  g_print ("========== %d pipelines ==========\n", g_list_length (keys));
-  for (key = keys; key; key = g_list_next (key)) {
-    const gchar *s = (gchar *) key->data, *ss = NULL;
-    assess_point_hash = g_hash_table_lookup (assess_db.hash, s);
-    names = g_hash_table_get_keys (assess_point_hash);
-    names =
-        g_list_sort_with_data (names, assess_compare_name, assess_point_hash);
-    /*
-       g_print ("%s\n", s);
-     */
-    for (name = names; name; name = g_list_next (name)) {
-      GstAssessPoint *assess_point =
-          g_hash_table_lookup (assess_point_hash, name->data);
-      const int padlen = ASSESS_NAME_LENGTH - strlen (assess_point->name);
-      if (0 < padlen)
-        ss = g_strnfill (padlen, ' ');
-      else
-        ss = g_strdup ("");
-      g_print ("\t%d\t%s%s\tats=%lld, " //"\t%d\t%s%s\tsequence=%d,ats=%lld, "
-          "pts=%lld, dts=%lld, duration=%lld, "
-          "buffers=%lld, time=%lldms, offset=%lld"
-          "\n", assess_point->number, assess_point->name, ss,
-          //assess_point->sequence,
-          (long long int) (assess_point->ats /*/ GST_MSECOND */ ),
-          (assess_point->pts == GST_CLOCK_TIME_NONE ? -1 :
-              (long long int) (assess_point->pts /*/ GST_MSECOND */ )),
-          (assess_point->dts == GST_CLOCK_TIME_NONE ? -1 :
-              (long long int) (assess_point->dts /*/ GST_MSECOND */ )),
-          (assess_point->duration == GST_CLOCK_TIME_NONE ? -1 :
-              (long long int) (assess_point->duration /*/ GST_MSECOND */ )),
-          (long long int) assess_point->buffer_count,
-          (long long int) assess_point->running_time,
-          (long long int) assess_point->offset);
-      g_free ((gpointer) ss);
-    }
-    g_list_free (names);
-  }
-  g_list_free (keys);
-  ASSESS_DB_UNLOCK ();
-  return ret;
+  guint64 count = 0;
+  guint i;
+
+  for (i = 0; i < GST_ASSESS_BUCKETS; ++i)
+    count += (guint) g_atomic_int_get (&histogram->counts[i]);
+  return count;
 }
 
 /**
- * @deprecated
+ * @brief The value in usec below which @percentile percent of the values
+ *        in @histogram are, -1 if it is empty.
+ *
+ * The streaming thread may be counting meanwhile, the buckets are read
+ * once each so the result is always one of the counted values.
  */
-static void
-gst_assess_init (GstAssess * assess)
+gint64
+gst_assess_histogram_percentile (GstAssessHistogram * histogram,
+    gdouble percentile)
 {
-  g_mutex_init (&assess->lock);
+  guint counts[GST_ASSESS_BUCKETS];
+  guint64 count = 0, rank, seen = 0;
+  guint i;
+
+  for (i = 0; i < GST_ASSESS_BUCKETS; ++i)
+    count += counts[i] = g_atomic_int_get (&histogram->counts[i]);
+  if (count == 0)
+    return -1;
+
+  rank = MAX (1, (guint64) ((percentile / 100.0) * count + 0.5));
+  for (i = 0; i < GST_ASSESS_BUCKETS; ++i) {
+    seen += counts[i];
+    if (seen >= rank)
+      return gst_assess_bucket_value (i);
+  }
+  return gst_assess_bucket_value (GST_ASSESS_BUCKETS - 1);
 }
 
 /**
- * @deprecated
+ * @brief Remember when the buffer of @pts passed @assess.
+ *
+ * Each slot is a sequence lock: the streaming thread is the only writer,
+ * the readers retry nothing but skip a slot being written.
  */
 static void
-gst_assess_dispose (GstAssess * assess)
+gst_assess_stamp (GstAssess * assess, GstClockTime pts, gint64 time)
 {
-  GstElement *pipeline = NULL;
-  GHashTable *assess_point_hash = NULL;
+  GstAssessStamp *stamp = &assess->ring[assess->stamp++ % GST_ASSESS_RING];
 
-  pipeline = GST_ELEMENT (gst_element_get_parent (GST_ELEMENT (assess)));
+  g_atomic_int_inc (&stamp->seq);
+  stamp->pts = pts;
+  stamp->time = time;
+  g_atomic_int_inc (&stamp->seq);
+}
 
-  if (!pipeline) {
-    //ERROR ("fix me");
-    goto end;
+/**
+ * @brief When the buffer of @pts passed @assess, -1 if it is not known.
+ */
+static gint64
+gst_assess_find_stamp (GstAssess * assess, GstClockTime pts)
+{
+  guint i;
+
+  for (i = 0; i < GST_ASSESS_RING; ++i) {
+    GstAssessStamp *stamp = &assess->ring[i];
+    gint seq = g_atomic_int_get (&stamp->seq);
+    GstClockTime stamp_pts;
+    gint64 time;
+
+    if (seq & 1)
+      continue;
+    stamp_pts = stamp->pts;
+    time = stamp->time;
+    if (stamp_pts == pts && time && g_atomic_int_get (&stamp->seq) == seq)
+      return time;
   }
+  return -1;
+}
 
-  ASSESS_DB_LOCK ();
-
-  if (assess_db.hash) {
-    assess_point_hash = g_hash_table_lookup (assess_db.hash,
-        GST_ELEMENT_NAME (pipeline));
-    if (assess_point_hash) {
-      g_hash_table_remove (assess_point_hash, GST_ELEMENT_NAME (assess));
-    }
-  }
+/**
+ * @brief Percentiles of both histograms, in a "assess" structure.
+ */
+static GstStructure *
+gst_assess_get_stats (GstAssess * assess)
+{
+  return gst_structure_new ("assess",
+      "buffers", G_TYPE_UINT, (guint) g_atomic_int_get (&assess->buffers),
+      "jitter-p50", G_TYPE_INT64,
+      gst_assess_histogram_percentile (&assess->jitter, 50.0),
+      "jitter-p99", G_TYPE_INT64,
+      gst_assess_histogram_percentile (&assess->jitter, 99.0),
+      "jitter-p999", G_TYPE_INT64,
+      gst_assess_histogram_percentile (&assess->jitter, 99.9),
+      "latency-p50", G_TYPE_INT64,
+      gst_assess_histogram_percentile (&assess->latency, 50.0),
+      "latency-p99", G_TYPE_INT64,
+      gst_assess_histogram_percentile (&assess->latency, 99.0),
+      "latency-p999", G_TYPE_INT64,
+      gst_assess_histogram_percentile (&assess->latency, 99.9), NULL);
+}
 
-  ASSESS_DB_UNLOCK ();
+static void
+gst_assess_init (GstAssess * assess)
+{
+  assess->last_pts = GST_CLOCK_TIME_NONE;
 
-end:
-  G_OBJECT_CLASS (parent_class)->dispose (G_OBJECT (assess));
+  /* never writes the buffers, so they are not copied to be made writable */
+  gst_base_transform_set_passthrough (GST_BASE_TRANSFORM (assess), TRUE);
 }
 
-/**
- * @deprecated
- */
 static void
 gst_assess_finalize (GstAssess * assess)
 {
-  g_mutex_clear (&assess->lock);
+  g_free (assess->from);
 
   G_OBJECT_CLASS (parent_class)->finalize (G_OBJECT (assess));
 }
 
-/**
- * @deprecated
- */
 static void
 gst_assess_set_property (GstAssess * assess, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -273,15 +232,16 @@ gst_assess_set_property (GstAssess * assess, guint prop_id,
     case PROP_N:
       assess->number = g_value_get_uint (value);
       break;
+    case PROP_FROM:
+      g_free (assess->from);
+      assess->from = g_value_dup_string (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (assess), prop_id, pspec);
       break;
   }
 }
 
-/**
- * @deprecated
- */
 static void
 gst_assess_get_property (GstAssess * assess, guint prop_id,
     GValue * value, GParamSpec * pspec)
@@ -290,6 +250,12 @@ gst_assess_get_property (GstAssess * assess, guint prop_id,
     case PROP_N:
       g_value_set_uint (value, assess->number);
       break;
+    case PROP_FROM:
+      g_value_set_string (value, assess->from);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_assess_get_stats (assess));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (assess), prop_id, pspec);
       break;
@@ -297,145 +263,102 @@ gst_assess_get_property (GstAssess * assess, guint prop_id,
 }
 
 /**
- * @deprecated
+ * @brief Clear the counters and find the upstream point in the pipeline.
  */
 static gboolean
 gst_assess_start (GstBaseTransform * trans)
 {
   GstAssess *this = GST_ASSESS (trans);
-  (void) this;
+  GstObject *top = gst_object_ref (this), *parent;
+  GstElement *upstream = NULL;
+
+  g_atomic_int_set (&this->buffers, 0);
+  this->last_time = 0;
+  this->last_pts = GST_CLOCK_TIME_NONE;
+  memset (&this->jitter, 0, sizeof (this->jitter));
+  memset (&this->latency, 0, sizeof (this->latency));
+  memset (this->ring, 0, sizeof (this->ring));
+
+  if (this->from == NULL) {
+    gst_object_unref (top);
+    return TRUE;
+  }
+
+  while ((parent = gst_object_get_parent (top))) {
+    gst_object_unref (top);
+    top = parent;
+  }
+  if (GST_IS_BIN (top))
+    upstream = gst_bin_get_by_name (GST_BIN (top), this->from);
+  gst_object_unref (top);
+
+  if (upstream && GST_IS_ASSESS (upstream) && upstream != GST_ELEMENT (this)) {
+    this->upstream = GST_ASSESS (upstream);
+  } else {
+    WARN ("%s: no assess point %s", GST_ELEMENT_NAME (this), this->from);
+    if (upstream)
+      gst_object_unref (upstream);
+  }
   return TRUE;
 }
 
 /**
- * @deprecated
+ * @brief Print what was measured.
  */
 static gboolean
 gst_assess_stop (GstBaseTransform * trans)
 {
   GstAssess *this = GST_ASSESS (trans);
-  (void) this;
-  return TRUE;
-}
-
-/**
- * @deprecated
- */
-static GstFlowReturn
-gst_assess_transform (GstBaseTransform * trans, GstBuffer * buffer)
-{
-  GstAssess *this = NULL;
-  GstElement *pipeline = NULL;
-  GstClock *pipeline_clock = NULL;
-  GstClockTime ats;
-  GstFlowReturn ret;
-  GHashTable *assess_point_hash = NULL;
-  GstAssessPoint *assess_point = NULL;
-  //GstMeta *assess_meta = NULL;
-
-  this = GST_ASSESS (trans);
-  pipeline = GST_ELEMENT (gst_element_get_parent (GST_ELEMENT (trans)));
-  pipeline_clock = gst_pipeline_get_clock (GST_PIPELINE (pipeline));
-
-  ASSESS_DB_LOCK ();
-
-  assess_point_hash = g_hash_table_lookup (assess_db.hash,
-      GST_ELEMENT_NAME (pipeline));
-  if (assess_point_hash == NULL) {
-    assess_point_hash = g_hash_table_new_full (g_str_hash, g_str_equal,
-        g_free, g_free);
-    g_hash_table_insert (assess_db.hash,
-        g_strdup (GST_ELEMENT_NAME (pipeline)), assess_point_hash);
-  }
-
-  assess_point = g_hash_table_lookup (assess_point_hash,
-      GST_ELEMENT_NAME (this));
-  if (assess_point == NULL) {
-    assess_point = g_new0 (GstAssessPoint, 1);
-    assess_point->number = this->number;
-    assess_point->name = g_strdup (GST_ELEMENT_NAME (this));
-    g_hash_table_insert (assess_point_hash, assess_point->name, assess_point);
-    g_mutex_init (&assess_point->lock);
-  }
-
-  ats = gst_clock_get_time (assess_db.clock);
-
-  ASSESS_DB_UNLOCK ();
-
-  if (!assess_point) {
-    goto end;
-  }
-
-  ASSESS_POINT_LOCK (assess_point);
-
-  //assess_meta = gst_buffer_get_meta (buffer, GST_TYPE_ASSESS);
+  GstStructure *stats = gst_assess_get_stats (this);
+  gchar *s = gst_structure_to_string (stats);
 
-  assess_point->ats = ats;
-  assess_point->pts = GST_BUFFER_PTS (buffer);
-  assess_point->buffer_count += 1;
-  assess_point->offset = GST_BUFFER_OFFSET (buffer);
-  assess_point->offset_end += GST_BUFFER_OFFSET_END (buffer);
-  assess_point->duration = GST_BUFFER_DURATION (buffer);
+  INFO ("%d %s: %s", this->number, GST_ELEMENT_NAME (this), s);
+  g_free (s);
+  gst_structure_free (stats);
 
-  if (GST_CLOCK_TIME_NONE != GST_BUFFER_DURATION (buffer)) {
-    assess_point->running_time += GST_BUFFER_DURATION (buffer) / GST_MSECOND;
+  if (this->upstream) {
+    gst_object_unref (this->upstream);
+    this->upstream = NULL;
   }
-
-  ASSESS_POINT_UNLOCK (assess_point);
-
-end:
-  gst_object_unref (pipeline_clock);
-  ret = GST_FLOW_OK;
-  return ret;
+  return TRUE;
 }
 
 /**
- * @deprecated
+ * @brief Count the buffer, on the streaming thread only.
+ *
+ * The jitter is how far the arrival distance strays from the PTS distance,
+ * the latency is since the buffer of the same PTS passed the upstream
+ * point, so it is only measured where the timestamps are kept.
  */
-static gboolean
-gst_assess_sink_event (GstBaseTransform * trans, GstEvent * event)
+static GstFlowReturn
+gst_assess_transform (GstBaseTransform * trans, GstBuffer * buffer)
 {
   GstAssess *this = GST_ASSESS (trans);
-  gboolean ret = TRUE;
-  (void) this;
-  ret = GST_BASE_TRANSFORM_CLASS (parent_class)->sink_event (trans, event);
-  return ret;
-}
-
-/**
- * @deprecated
- */
-static GstStateChangeReturn
-gst_assess_change_state (GstElement * element, GstStateChange transition)
-{
-  GstStateChangeReturn ret;
-  GstAssess *this = GST_ASSESS (element);
+  GstClockTime pts = GST_BUFFER_PTS (buffer);
+  gint64 now = g_get_monotonic_time (), then;
 
-  (void) this;
+  g_atomic_int_inc (&this->buffers);
+  if (!GST_CLOCK_TIME_IS_VALID (pts))
+    return GST_FLOW_OK;
 
-  switch (transition) {
-    case GST_STATE_CHANGE_READY_TO_PAUSED:
-      break;
-    default:
-      break;
+  if (GST_CLOCK_TIME_IS_VALID (this->last_pts)) {
+    gint64 expected = GST_CLOCK_DIFF (this->last_pts, pts) / GST_USECOND;
+    gst_assess_histogram_add (&this->jitter,
+        ABS (now - this->last_time - expected));
   }
+  this->last_time = now;
+  this->last_pts = pts;
 
-  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
-
-  switch (transition) {
-    case GST_STATE_CHANGE_PAUSED_TO_READY:
-      //gst_assess_reset (this);
-      break;
-    default:
-      break;
+  if (this->upstream) {
+    then = gst_assess_find_stamp (this->upstream, pts);
+    if (0 <= then)
+      gst_assess_histogram_add (&this->latency, now - then);
   }
 
-  return ret;
+  gst_assess_stamp (this, pts, now);
+  return GST_FLOW_OK;
 }
 
-/**
- * @deprecated
- */
 static void
 gst_assess_class_init (GstAssessClass * klass)
 {
@@ -446,12 +369,21 @@ gst_assess_class_init (GstAssessClass * klass)
   object_class->set_property = (GObjectSetPropertyFunc) gst_assess_set_property;
   object_class->get_property = (GObjectGetPropertyFunc) gst_assess_get_property;
   object_class->finalize = (GObjectFinalizeFunc) gst_assess_finalize;
-  object_class->dispose = (GObjectFinalizeFunc) gst_assess_dispose;
 
   g_object_class_install_property (object_class, PROP_N,
       g_param_spec_uint ("n", "N", "Number",
           0, (guint) - 1, -1, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (object_class, PROP_FROM,
+      g_param_spec_string ("from", "From",
+          "The upstream assess point to measure the latency from",
+          NULL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Stats",
+          "Buffers, p50/p99/p999 jitter and latency in usec",
+          GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (element_class,
       "Stream Assessment", "Element",
       "Assess streams for frame drop and latency",
@@ -463,35 +395,9 @@ gst_assess_class_init (GstAssessClass * klass)
   gst_element_class_add_pad_template (element_class,
       gst_static_pad_template_get (&gst_assess_src_factory));
 
-  //element_class->request_new_pad = gst_assess_request_new_pad;
-  //element_class->release_pad = gst_assess_release_pad;
-  element_class->change_state = GST_DEBUG_FUNCPTR (gst_assess_change_state);
-
-  basetrans_class->sink_event = GST_DEBUG_FUNCPTR (gst_assess_sink_event);
   basetrans_class->transform_ip = GST_DEBUG_FUNCPTR (gst_assess_transform);
   basetrans_class->start = GST_DEBUG_FUNCPTR (gst_assess_start);
   basetrans_class->stop = GST_DEBUG_FUNCPTR (gst_assess_stop);
 
-  if (assess_db.hash == NULL) {
-    ASSESS_DB_LOCK ();
-    /*
-       const gchar *tags[] = { "assess", NULL };
-       assess_meta_api = gst_meta_api_type_register ("GstSwitchAssessMeta",
-       &tags[0]);
-       gst_meta_register (assess_meta_api, GST_ASSESS_META_IMPL,
-       sizeof (GstAssessMeta), gst_assess_meta_init,
-       gst_assess_meta_free, gst_assess_meta_transform);
-     */
-
-    if (assess_db.hash == NULL) {
-      assess_db.clock = gst_system_clock_obtain ();
-      assess_db.hash = g_hash_table_new_full (g_str_hash, g_str_equal,
-          g_free, (GDestroyNotify) g_hash_table_destroy);
-      assess_db.timer = g_timeout_add (5000,
-          (GSourceFunc) assess_db_timeout, NULL);
-    }
-    ASSESS_DB_UNLOCK ();
-  }
-
   GST_DEBUG_CATEGORY_INIT (gst_assess_debug, "assess", 0, "Assess");
 }
@@ -36,16 +36,59 @@ G_BEGIN_DECLS
   (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_ASSESS))
 typedef struct _GstAssess GstAssess;
 typedef struct _GstAssessClass GstAssessClass;
+typedef struct _GstAssessHistogram GstAssessHistogram;
+typedef struct _GstAssessStamp GstAssessStamp;
+
+/* Values below 2^5 usec have a bucket each, then every power of two is
+   split into 2^4 buckets, up to 2^40 usec. */
+#define GST_ASSESS_SUB_BITS 4
+#define GST_ASSESS_BUCKETS \
+  ((40 - GST_ASSESS_SUB_BITS + 1) << GST_ASSESS_SUB_BITS)
+#define GST_ASSESS_RING 64
+
+/**
+ * @brief A log-linear histogram of usec values, in the manner of HDR
+ *        histograms: a bucket is never wider than 1/16 of its values.
+ *
+ * Only the streaming thread of the point adds to it, anyone may read it.
+ */
+struct _GstAssessHistogram
+{
+  gint counts[GST_ASSESS_BUCKETS];
+};
+
+/**
+ * @brief When a buffer passed a point, kept for the points downstream.
+ */
+struct _GstAssessStamp
+{
+  gint seq;                     /* odd while being written */
+  GstClockTime pts;
+  gint64 time;
+};
 
 /**
  * @brief Helper class for assessment.
+ *
+ * A point never takes a lock on the streaming thread, its counters are
+ * written by that thread only and read with atomic loads.
  */
 struct _GstAssess
 {
   GstBaseTransform base;
-  GMutex lock;
 
   guint number;
+  gchar *from;                  /* the upstream point to time from */
+  GstAssess *upstream;          /* found by the name in @from on start */
+
+  gint buffers;
+  gint64 last_time;             /* streaming thread only */
+  GstClockTime last_pts;        /* streaming thread only */
+  guint stamp;                  /* the next slot in @ring */
+  GstAssessStamp ring[GST_ASSESS_RING];
+
+  GstAssessHistogram jitter;    /* arrivals against the PTS distance */
+  GstAssessHistogram latency;   /* since the buffer passed @upstream */
 
   GstPad *sinkpad;
   GstPad *srcpad;
@@ -61,5 +104,10 @@ struct _GstAssessClass
 
 GType gst_assess_get_type (void);
 
+void gst_assess_histogram_add (GstAssessHistogram * histogram, gint64 value);
+guint64 gst_assess_histogram_count (GstAssessHistogram * histogram);
+gint64 gst_assess_histogram_percentile (GstAssessHistogram * histogram,
+    gdouble percentile);
+
 G_END_DECLS
 #endif //__GST_ASSESS_H__
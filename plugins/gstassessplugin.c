@@ -23,6 +23,8 @@
 
 #include <gst/gst.h>
 #include "gstassess.h"
+#include "gstlatencystamp.h"
+#include "gstlatencydetect.h"
 #include "gstconvbin.h"
 #include "../logutils.h"
 
@@ -33,6 +35,16 @@ plugin_init (GstPlugin * plugin)
     return FALSE;
   }
 
+  if (!gst_element_register (plugin, "latencystamp", GST_RANK_NONE,
+          GST_TYPE_LATENCY_STAMP)) {
+    return FALSE;
+  }
+
+  if (!gst_element_register (plugin, "latencydetect", GST_RANK_NONE,
+          GST_TYPE_LATENCY_DETECT)) {
+    return FALSE;
+  }
+
   return TRUE;
 }
 
@@ -0,0 +1,223 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include "gstlatencydetect.h"
+#include "gstlatencystamp.h"
+#include "../logutils.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_latency_detect_debug);
+#define GST_CAT_DEFAULT gst_latency_detect_debug
+
+/* codes older than this are taken for stale frames */
+#define GST_LATENCY_DETECT_MAX (10 * G_USEC_PER_SEC)
+
+static GstStaticPadTemplate gst_latency_detect_sink_factory =
+GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_LATENCY_STAMP_FORMATS)));
+
+static GstStaticPadTemplate gst_latency_detect_src_factory =
+GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_LATENCY_STAMP_FORMATS)));
+
+enum
+{
+  PROP_0,
+  PROP_PATH,
+  PROP_STATS,
+};
+
+#define gst_latency_detect_parent_class parent_class
+G_DEFINE_TYPE (GstLatencyDetect, gst_latency_detect, GST_TYPE_VIDEO_FILTER);
+
+/**
+ * @brief The path, the frames seen and detected, p50/p99/p999 in usec.
+ */
+static GstStructure *
+gst_latency_detect_get_stats (GstLatencyDetect * detect)
+{
+  return gst_structure_new ("latency",
+      "path", G_TYPE_STRING, detect->path ? detect->path : "",
+      "frames", G_TYPE_UINT, (guint) g_atomic_int_get (&detect->frames),
+      "detected", G_TYPE_UINT, (guint) g_atomic_int_get (&detect->detected),
+      "latency-p50", G_TYPE_INT64,
+      gst_assess_histogram_percentile (&detect->latency, 50.0),
+      "latency-p99", G_TYPE_INT64,
+      gst_assess_histogram_percentile (&detect->latency, 99.0),
+      "latency-p999", G_TYPE_INT64,
+      gst_assess_histogram_percentile (&detect->latency, 99.9), NULL);
+}
+
+static void
+gst_latency_detect_init (GstLatencyDetect * detect)
+{
+  /* only reads the frames */
+  gst_base_transform_set_passthrough (GST_BASE_TRANSFORM (detect), TRUE);
+}
+
+static void
+gst_latency_detect_finalize (GstLatencyDetect * detect)
+{
+  g_free (detect->path);
+
+  G_OBJECT_CLASS (parent_class)->finalize (G_OBJECT (detect));
+}
+
+static void
+gst_latency_detect_set_property (GstLatencyDetect * detect, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  switch (prop_id) {
+    case PROP_PATH:
+      g_free (detect->path);
+      detect->path = g_value_dup_string (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (detect), prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_latency_detect_get_property (GstLatencyDetect * detect, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  switch (prop_id) {
+    case PROP_PATH:
+      g_value_set_string (value, detect->path);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_latency_detect_get_stats (detect));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (detect), prop_id, pspec);
+      break;
+  }
+}
+
+static gboolean
+gst_latency_detect_start (GstBaseTransform * trans)
+{
+  GstLatencyDetect *this = GST_LATENCY_DETECT (trans);
+
+  g_atomic_int_set (&this->frames, 0);
+  g_atomic_int_set (&this->detected, 0);
+  this->line = 0;
+  memset (&this->latency, 0, sizeof (this->latency));
+  return TRUE;
+}
+
+/**
+ * @brief Print what was measured.
+ */
+static gboolean
+gst_latency_detect_stop (GstBaseTransform * trans)
+{
+  GstLatencyDetect *this = GST_LATENCY_DETECT (trans);
+  GstStructure *stats;
+  gchar *s;
+
+  if (g_atomic_int_get (&this->detected) == 0)
+    return TRUE;
+
+  stats = gst_latency_detect_get_stats (this);
+  s = gst_structure_to_string (stats);
+  INFO ("%s", s);
+  g_free (s);
+  gst_structure_free (stats);
+  return TRUE;
+}
+
+/**
+ * @brief Count the latency of the code in @frame, if there is one.
+ *
+ * The code holds the low 32 bits of the clock, the difference is right as
+ * long as it is below 71 minutes.
+ */
+static GstFlowReturn
+gst_latency_detect_transform_frame_ip (GstVideoFilter * filter,
+    GstVideoFrame * frame)
+{
+  GstLatencyDetect *this = GST_LATENCY_DETECT (filter);
+  guint32 time;
+  gint32 latency;
+
+  g_atomic_int_inc (&this->frames);
+  if (!gst_latency_stamp_read (frame, &this->line, &time))
+    return GST_FLOW_OK;
+
+  latency = (gint32) ((guint32) g_get_monotonic_time () - time);
+  if (0 <= latency && latency < GST_LATENCY_DETECT_MAX) {
+    g_atomic_int_inc (&this->detected);
+    gst_assess_histogram_add (&this->latency, latency);
+  }
+  return GST_FLOW_OK;
+}
+
+static void
+gst_latency_detect_class_init (GstLatencyDetectClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstBaseTransformClass *basetrans_class = GST_BASE_TRANSFORM_CLASS (klass);
+  GstVideoFilterClass *filter_class = GST_VIDEO_FILTER_CLASS (klass);
+
+  object_class->set_property =
+      (GObjectSetPropertyFunc) gst_latency_detect_set_property;
+  object_class->get_property =
+      (GObjectGetPropertyFunc) gst_latency_detect_get_property;
+  object_class->finalize = (GObjectFinalizeFunc) gst_latency_detect_finalize;
+
+  g_object_class_install_property (object_class, PROP_PATH,
+      g_param_spec_string ("path", "Path",
+          "The name of the measured path", NULL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Stats",
+          "Frames seen and detected, p50/p99/p999 latency in usec",
+          GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_set_static_metadata (element_class,
+      "Latency detector", "Filter/Video",
+      "Measure the glass to glass latency of latencystamp barcodes",
+      "Duzy Chan <code@duzy.info>");
+
+  gst_element_class_add_pad_template (element_class,
+      gst_static_pad_template_get (&gst_latency_detect_sink_factory));
+
+  gst_element_class_add_pad_template (element_class,
+      gst_static_pad_template_get (&gst_latency_detect_src_factory));
+
+  basetrans_class->start = GST_DEBUG_FUNCPTR (gst_latency_detect_start);
+  basetrans_class->stop = GST_DEBUG_FUNCPTR (gst_latency_detect_stop);
+  filter_class->transform_frame_ip =
+      GST_DEBUG_FUNCPTR (gst_latency_detect_transform_frame_ip);
+
+  GST_DEBUG_CATEGORY_INIT (gst_latency_detect_debug, "latencydetect", 0,
+      "Latency detector");
+}
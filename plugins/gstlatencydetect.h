@@ -0,0 +1,73 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GST_LATENCY_DETECT_H__
+#define __GST_LATENCY_DETECT_H__
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+#include <gst/video/gstvideofilter.h>
+#include "gstassess.h"
+
+G_BEGIN_DECLS
+#define GST_TYPE_LATENCY_DETECT \
+  (gst_latency_detect_get_type ())
+#define GST_LATENCY_DETECT(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj),GST_TYPE_LATENCY_DETECT,\
+      GstLatencyDetect))
+#define GST_LATENCY_DETECT_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST ((klass),GST_TYPE_LATENCY_DETECT,\
+      GstLatencyDetectClass))
+#define GST_IS_LATENCY_DETECT(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_LATENCY_DETECT))
+#define GST_IS_LATENCY_DETECT_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_LATENCY_DETECT))
+typedef struct _GstLatencyDetect GstLatencyDetect;
+typedef struct _GstLatencyDetectClass GstLatencyDetectClass;
+
+/**
+ * @brief Reads the barcodes of latencystamp and counts how long ago they
+ *        were painted, per path.
+ *
+ * Like the assess points, the counters are only written by the streaming
+ * thread and read with atomic loads.
+ */
+struct _GstLatencyDetect
+{
+  GstVideoFilter base;
+
+  gchar *path;                  /* what the measured path is called */
+  gint frames;
+  gint detected;
+  gint line;                    /* where the latest code was found */
+  GstAssessHistogram latency;
+};
+
+/**
+ * @brief GstLatencyDetectClass
+ */
+struct _GstLatencyDetectClass
+{
+  GstVideoFilterClass base_class;
+};
+
+GType gst_latency_detect_get_type (void);
+
+G_END_DECLS
+#endif //__GST_LATENCY_DETECT_H__
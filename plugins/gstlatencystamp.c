@@ -0,0 +1,306 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include "gstlatencystamp.h"
+#include "../logutils.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_latency_stamp_debug);
+#define GST_CAT_DEFAULT gst_latency_stamp_debug
+
+#define GST_LATENCY_STAMP_BITS (32 + 8)
+#define GST_LATENCY_STAMP_CELLS (4 + 2 * GST_LATENCY_STAMP_BITS)
+#define GST_LATENCY_STAMP_COLUMNS 128   /* cells across the frame */
+#define GST_LATENCY_STAMP_ROWS 54       /* codes down the frame */
+#define GST_LATENCY_STAMP_WHITE 235
+#define GST_LATENCY_STAMP_BLACK 16
+#define GST_LATENCY_STAMP_THRESHOLD \
+  ((GST_LATENCY_STAMP_WHITE + GST_LATENCY_STAMP_BLACK) / 2)
+
+static GstStaticPadTemplate gst_latency_stamp_sink_factory =
+GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_LATENCY_STAMP_FORMATS)));
+
+static GstStaticPadTemplate gst_latency_stamp_src_factory =
+GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_LATENCY_STAMP_FORMATS)));
+
+#define gst_latency_stamp_parent_class parent_class
+G_DEFINE_TYPE (GstLatencyStamp, gst_latency_stamp, GST_TYPE_VIDEO_FILTER);
+
+/**
+ * @brief The check byte of @time, never 0 so a black corner is no code.
+ */
+static guint8
+gst_latency_stamp_check (guint32 time)
+{
+  return (time ^ (time >> 8) ^ (time >> 16) ^ (time >> 24) ^ 0xa5) & 0xff;
+}
+
+/**
+ * @brief The cells of the code of @time, from the left.
+ */
+static void
+gst_latency_stamp_cells (guint32 time, gboolean * cells)
+{
+  guint8 check = gst_latency_stamp_check (time);
+  gboolean bit;
+  guint i;
+
+  cells[0] = cells[2] = TRUE;
+  cells[1] = cells[3] = FALSE;
+  for (i = 0; i < GST_LATENCY_STAMP_BITS; ++i) {
+    bit = i < 32 ? (time >> (31 - i)) & 1 : (check >> (39 - i)) & 1;
+    cells[4 + 2 * i] = bit;
+    cells[5 + 2 * i] = !bit;
+  }
+}
+
+/**
+ * @brief Paint the code of @time into the luma of @frame.
+ *
+ * A cell is 1/128 of the frame wide, to a fraction of a pixel, and never
+ * less than 2 pixels.
+ */
+void
+gst_latency_stamp_write (GstVideoFrame * frame, guint32 time)
+{
+  guint8 *data = GST_VIDEO_FRAME_COMP_DATA (frame, 0);
+  gint stride = GST_VIDEO_FRAME_COMP_STRIDE (frame, 0);
+  gint pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, 0);
+  gint width = GST_VIDEO_FRAME_COMP_WIDTH (frame, 0);
+  gint height = GST_VIDEO_FRAME_COMP_HEIGHT (frame, 0);
+  gboolean cells[GST_LATENCY_STAMP_CELLS];
+  gdouble w = MAX (2.0, (gdouble) width / GST_LATENCY_STAMP_COLUMNS);
+  gint h = MAX (2, height / GST_LATENCY_STAMP_ROWS);
+  gint i, x, y;
+
+  if (w * GST_LATENCY_STAMP_CELLS > width || h > height)
+    return;
+
+  gst_latency_stamp_cells (time, cells);
+  for (y = 0; y < h; ++y) {
+    guint8 *line = data + y * stride;
+    for (i = 0; i < GST_LATENCY_STAMP_CELLS; ++i) {
+      guint8 luma = cells[i] ? GST_LATENCY_STAMP_WHITE :
+          GST_LATENCY_STAMP_BLACK;
+      for (x = (gint) (i * w); x < (gint) ((i + 1) * w); ++x)
+        line[x * pstride] = luma;
+    }
+  }
+}
+
+/**
+ * @brief Where the luma of @line crosses the threshold between the pixels
+ *        @x - 1 and @x, to a fraction of a pixel.
+ */
+static gdouble
+gst_latency_stamp_edge (const guint8 * line, gint pstride, gint x)
+{
+  gint a = line[(x - 1) * pstride], b = line[x * pstride];
+
+  return x - 0.5 + (gdouble) (a - GST_LATENCY_STAMP_THRESHOLD) / (a - b);
+}
+
+/**
+ * @brief The first pixel of @line from @x on which is white if @white,
+ *        black if not, -1 if there is none before @end.
+ */
+static gint
+gst_latency_stamp_next (const guint8 * line, gint pstride, gint x, gint end,
+    gboolean white)
+{
+  for (; x < end; ++x)
+    if ((line[x * pstride] > GST_LATENCY_STAMP_THRESHOLD) == white)
+      return x;
+  return -1;
+}
+
+/**
+ * @brief Decode a code in @line which has its first black cell at @x.
+ *
+ * The cells are counted off the edges in between, the cell width being
+ * measured again at every edge. A bit is a white and a black cell or the
+ * other way round, so no run is longer than two cells and the count
+ * never slips, whatever the scale.
+ */
+static gboolean
+gst_latency_stamp_decode (const guint8 * line, gint pstride, gint width,
+    gint x, guint32 * time)
+{
+  gboolean cells[GST_LATENCY_STAMP_CELLS], expected[GST_LATENCY_STAMP_CELLS];
+  gint limit = width / GST_LATENCY_STAMP_CELLS + 2, n = 1, next, end, k;
+  gdouble first, last, edge = 0, w = limit, runs[2] = { 0, 0 };
+  gboolean white = FALSE;
+  guint32 value = 0;
+  guint i;
+
+  cells[0] = TRUE;
+  first = last = gst_latency_stamp_edge (line, pstride, x);
+  while (n < GST_LATENCY_STAMP_CELLS) {
+    end = MIN (width, x + (gint) (2.5 * w) + 2);
+    next = gst_latency_stamp_next (line, pstride, x + 1, end, !white);
+    if (next < 0) {
+      /* the last cells may run into the picture */
+      if (n < 3 || n + 2 < GST_LATENCY_STAMP_CELLS)
+        return FALSE;
+      k = GST_LATENCY_STAMP_CELLS - n;
+    } else {
+      edge = gst_latency_stamp_edge (line, pstride, next);
+      if (n < 3) {
+        /* the black and white calibration cells tell the width */
+        runs[n - 1] = edge - last;
+        k = 1;
+      } else {
+        k = (gint) ((edge - last) / w + 0.5);
+        if (k < 1)
+          return FALSE;
+        k = MIN (k, GST_LATENCY_STAMP_CELLS - n);
+      }
+    }
+
+    for (i = 0; i < k; ++i)
+      cells[n++] = white;
+    if (next < 0)
+      break;
+
+    w = (edge - first) / (n - 1);
+    if (n == 3 && (w < 1.5 || ABS (runs[0] - runs[1]) > MAX (1.5, w / 2)))
+      return FALSE;
+    last = edge;
+    x = next;
+    white = !white;
+  }
+
+  if (line[(gint) (first + 1.5 * w) * pstride] -
+      line[(gint) (first + 0.5 * w) * pstride] < 64)
+    return FALSE;
+
+  for (i = 0; i < 32; ++i)
+    value = (value << 1) | cells[4 + 2 * i];
+  gst_latency_stamp_cells (value, expected);
+  if (memcmp (cells, expected, sizeof (cells)) != 0)
+    return FALSE;
+
+  *time = value;
+  return TRUE;
+}
+
+/**
+ * @brief Look for a code in @line, from its first white to black edge on.
+ *
+ * The first white and black cells are at least 2 pixels wide, which keeps
+ * most edges of a picture from being decoded.
+ */
+static gboolean
+gst_latency_stamp_read_line (const guint8 * line, gint pstride, gint width,
+    guint32 * time)
+{
+  gint x;
+
+  for (x = 1; x + GST_LATENCY_STAMP_CELLS < width; ++x)
+    if (line[(x - 1) * pstride] > GST_LATENCY_STAMP_THRESHOLD &&
+        line[x * pstride] <= GST_LATENCY_STAMP_THRESHOLD &&
+        line[(x + 1) * pstride] <= GST_LATENCY_STAMP_THRESHOLD &&
+        (x < 2 || line[(x - 2) * pstride] > GST_LATENCY_STAMP_THRESHOLD) &&
+        gst_latency_stamp_decode (line, pstride, width, x, time))
+      return TRUE;
+  return FALSE;
+}
+
+/**
+ * @brief Read the code in @frame into @time, FALSE if there is none.
+ * @param line The line to look in first, set to the one the code was
+ *        found in, or NULL.
+ *
+ * The code is searched for in every other line, so it is found wherever a
+ * composite put the stamped picture, and at whatever scale. The cells are
+ * told apart at the middle of white and black.
+ */
+gboolean
+gst_latency_stamp_read (GstVideoFrame * frame, gint * line, guint32 * time)
+{
+  guint8 *data = GST_VIDEO_FRAME_COMP_DATA (frame, 0);
+  gint stride = GST_VIDEO_FRAME_COMP_STRIDE (frame, 0);
+  gint pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, 0);
+  gint width = GST_VIDEO_FRAME_COMP_WIDTH (frame, 0);
+  gint height = GST_VIDEO_FRAME_COMP_HEIGHT (frame, 0);
+  gint y;
+
+  /* the code stays where it was until the composite changes */
+  if (line && 0 <= *line && *line < height &&
+      gst_latency_stamp_read_line (data + *line * stride, pstride, width,
+          time))
+    return TRUE;
+
+  for (y = 0; y < height; y += 2) {
+    if (gst_latency_stamp_read_line (data + y * stride, pstride, width,
+            time)) {
+      if (line)
+        *line = y;
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+static void
+gst_latency_stamp_init (GstLatencyStamp * stamp)
+{
+}
+
+static GstFlowReturn
+gst_latency_stamp_transform_frame_ip (GstVideoFilter * filter,
+    GstVideoFrame * frame)
+{
+  gst_latency_stamp_write (frame, (guint32) g_get_monotonic_time ());
+  return GST_FLOW_OK;
+}
+
+static void
+gst_latency_stamp_class_init (GstLatencyStampClass * klass)
+{
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstVideoFilterClass *filter_class = GST_VIDEO_FILTER_CLASS (klass);
+
+  gst_element_class_set_static_metadata (element_class,
+      "Latency stamp", "Filter/Video",
+      "Paint the capture time as a barcode, for latencydetect",
+      "Duzy Chan <code@duzy.info>");
+
+  gst_element_class_add_pad_template (element_class,
+      gst_static_pad_template_get (&gst_latency_stamp_sink_factory));
+
+  gst_element_class_add_pad_template (element_class,
+      gst_static_pad_template_get (&gst_latency_stamp_src_factory));
+
+  filter_class->transform_frame_ip =
+      GST_DEBUG_FUNCPTR (gst_latency_stamp_transform_frame_ip);
+
+  GST_DEBUG_CATEGORY_INIT (gst_latency_stamp_debug, "latencystamp", 0,
+      "Latency stamp");
+}
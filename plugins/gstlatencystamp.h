@@ -0,0 +1,75 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GST_LATENCY_STAMP_H__
+#define __GST_LATENCY_STAMP_H__
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+#include <gst/video/gstvideofilter.h>
+
+G_BEGIN_DECLS
+#define GST_TYPE_LATENCY_STAMP \
+  (gst_latency_stamp_get_type ())
+#define GST_LATENCY_STAMP(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj),GST_TYPE_LATENCY_STAMP,GstLatencyStamp))
+#define GST_LATENCY_STAMP_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST ((klass),GST_TYPE_LATENCY_STAMP,\
+      GstLatencyStampClass))
+#define GST_IS_LATENCY_STAMP(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_LATENCY_STAMP))
+#define GST_IS_LATENCY_STAMP_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_LATENCY_STAMP))
+/* The barcode formats, which all have the luma in the first component */
+#define GST_LATENCY_STAMP_FORMATS \
+  "{ I420, YV12, Y42B, Y444, NV12, NV21, YUY2, UYVY }"
+typedef struct _GstLatencyStamp GstLatencyStamp;
+typedef struct _GstLatencyStampClass GstLatencyStampClass;
+
+/**
+ * @brief Paints the capture time as a barcode in the top left corner.
+ *
+ * The barcode is a row of cells of black or white luma: two white and
+ * black cells to calibrate, then the low 32 bits of the monotonic clock in
+ * usec and a check byte, most significant bits first. A bit is a white and
+ * a black cell for 1, a black and a white one for 0. A cell is 1/128 of
+ * the frame wide and the code 1/54 of it high, so it survives scaling, and
+ * it is found anywhere in the frame, like in a composite.
+ */
+struct _GstLatencyStamp
+{
+  GstVideoFilter base;
+};
+
+/**
+ * @brief GstLatencyStampClass
+ */
+struct _GstLatencyStampClass
+{
+  GstVideoFilterClass base_class;
+};
+
+GType gst_latency_stamp_get_type (void);
+
+void gst_latency_stamp_write (GstVideoFrame * frame, guint32 time);
+gboolean gst_latency_stamp_read (GstVideoFrame * frame, gint * line,
+    guint32 * time);
+
+G_END_DECLS
+#endif //__GST_LATENCY_STAMP_H__
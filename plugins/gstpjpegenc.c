@@ -0,0 +1,601 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <setjmp.h>
+#include <jpeglib.h>
+#include "gstpjpegenc.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_pjpegenc_debug);
+#define GST_CAT_DEFAULT gst_pjpegenc_debug
+
+#define PJPEG_MCU_SIZE 16       /* 4:2:0, 2x2 luma blocks per MCU */
+#define PJPEG_MAX_RESTART_INTERVAL 65535
+#define PJPEG_INITIAL_SLICE_SIZE (64 * 1024)
+
+#define PJPEG_MARKER_SOF0 0xC0
+#define PJPEG_MARKER_RST0 0xD0
+#define PJPEG_MARKER_EOI 0xD9
+#define PJPEG_MARKER_SOS 0xDA
+#define PJPEG_MARKER_DRI 0xDD
+
+/**
+ * @brief One slice of a frame, encoded as a complete JPEG image of its own.
+ */
+struct _GstPJpegEncSlice
+{
+  GstPJpegEnc *enc;             /*!< the encoder */
+  guint first_row;              /*!< the first MCU row of the slice */
+  guint rows;                   /*!< number of MCU rows */
+
+  struct jpeg_compress_struct cinfo;
+  struct jpeg_error_mgr jerr;
+  struct jpeg_destination_mgr jdest;
+  jmp_buf jmp;
+  gboolean failed;              /*!< encoding the slice failed */
+
+  guint8 *data;                 /*!< the encoded slice */
+  gsize size;                   /*!< bytes used of %data */
+  gsize alloc;                  /*!< bytes allocated for %data */
+  gsize scan;                   /*!< where the entropy coded data starts */
+
+  guint8 *pad;                  /*!< padded rows for odd frame widths */
+};
+
+enum
+{
+  PROP_0,
+  PROP_QUALITY,
+  PROP_THREADS,
+  PROP_SLICES,
+};
+
+static GstStaticPadTemplate gst_pjpegenc_sink_factory =
+GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE ("I420")));
+
+static GstStaticPadTemplate gst_pjpegenc_src_factory =
+GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("image/jpeg, "
+        "width = (int) [ 16, 65535 ], "
+        "height = (int) [ 16, 65535 ], "
+        "framerate = (fraction) [ 0/1, MAX ]"));
+
+#define gst_pjpegenc_parent_class parent_class
+G_DEFINE_TYPE (GstPJpegEnc, gst_pjpegenc, GST_TYPE_VIDEO_ENCODER);
+
+static void
+gst_pjpegenc_init (GstPJpegEnc * enc)
+{
+  enc->quality = GST_PJPEGENC_DEFAULT_QUALITY;
+  enc->threads = 0;
+  enc->slices = 0;
+  g_mutex_init (&enc->lock);
+  g_cond_init (&enc->cond);
+}
+
+static void
+gst_pjpegenc_free_slices (GstPJpegEnc * enc)
+{
+  guint n;
+  for (n = 0; n < enc->n_slices; ++n) {
+    GstPJpegEncSlice *slice = &enc->slice[n];
+    jpeg_destroy_compress (&slice->cinfo);
+    g_free (slice->data);
+    g_free (slice->pad);
+  }
+  g_free (enc->slice);
+  enc->slice = NULL;
+  enc->n_slices = 0;
+}
+
+static void
+gst_pjpegenc_finalize (GstPJpegEnc * enc)
+{
+  gst_pjpegenc_free_slices (enc);
+  g_mutex_clear (&enc->lock);
+  g_cond_clear (&enc->cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (G_OBJECT (enc));
+}
+
+static void
+gst_pjpegenc_set_property (GstPJpegEnc * enc, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_QUALITY:
+      enc->quality = g_value_get_int (value);
+      break;
+    case PROP_THREADS:
+      enc->threads = g_value_get_uint (value);
+      break;
+    case PROP_SLICES:
+      enc->slices = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (enc), property_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_pjpegenc_get_property (GstPJpegEnc * enc, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_QUALITY:
+      g_value_set_int (value, enc->quality);
+      break;
+    case PROP_THREADS:
+      g_value_set_uint (value, enc->threads);
+      break;
+    case PROP_SLICES:
+      g_value_set_uint (value, enc->slices);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (enc), property_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_pjpegenc_error_exit (j_common_ptr cinfo)
+{
+  GstPJpegEncSlice *slice = (GstPJpegEncSlice *) cinfo->client_data;
+  char message[JMSG_LENGTH_MAX];
+  (*cinfo->err->format_message) (cinfo, message);
+  GST_WARNING ("MCU row %d: %s", slice->first_row, message);
+  longjmp (slice->jmp, 1);
+}
+
+static void
+gst_pjpegenc_init_destination (j_compress_ptr cinfo)
+{
+  GstPJpegEncSlice *slice = (GstPJpegEncSlice *) cinfo->client_data;
+  if (slice->alloc == 0) {
+    slice->alloc = PJPEG_INITIAL_SLICE_SIZE;
+    slice->data = g_malloc (slice->alloc);
+  }
+  cinfo->dest->next_output_byte = slice->data;
+  cinfo->dest->free_in_buffer = slice->alloc;
+}
+
+static boolean
+gst_pjpegenc_empty_output_buffer (j_compress_ptr cinfo)
+{
+  GstPJpegEncSlice *slice = (GstPJpegEncSlice *) cinfo->client_data;
+  gsize used = slice->alloc;
+
+  /* libjpeg only calls us when the whole buffer is used */
+  slice->alloc *= 2;
+  slice->data = g_realloc (slice->data, slice->alloc);
+  cinfo->dest->next_output_byte = slice->data + used;
+  cinfo->dest->free_in_buffer = slice->alloc - used;
+  return TRUE;
+}
+
+static void
+gst_pjpegenc_term_destination (j_compress_ptr cinfo)
+{
+  GstPJpegEncSlice *slice = (GstPJpegEncSlice *) cinfo->client_data;
+  slice->size = slice->alloc - cinfo->dest->free_in_buffer;
+}
+
+/**
+ * @brief Find where the entropy coded data of a libjpeg image starts.
+ * @return the offset of the SOS marker, or 0 if not found
+ */
+static gsize
+gst_pjpegenc_find_sos (const guint8 * data, gsize size, gsize * scan)
+{
+  gsize pos = 2;                /* skip SOI */
+  while (pos + 4 <= size && data[pos] == 0xFF) {
+    gsize len = (data[pos + 2] << 8) | data[pos + 3];
+    if (data[pos + 1] == PJPEG_MARKER_SOS) {
+      *scan = pos + 2 + len;
+      return *scan <= size ? pos : 0;
+    }
+    pos += 2 + len;
+  }
+  return 0;
+}
+
+/**
+ * @brief Point a row array at the luma or chroma rows of one MCU row.
+ *
+ * Rows below the frame repeat its last row, and when the plane is narrower
+ * than a whole number of MCUs the rows are copied into %pad, with the last
+ * column repeated.
+ */
+static void
+gst_pjpegenc_get_rows (JSAMPROW * rows, guint n, const guint8 * plane,
+    gint stride, guint width, guint height, guint padded_width, guint y,
+    guint8 * pad)
+{
+  guint i, row;
+  for (i = 0; i < n; ++i) {
+    row = MIN (y + i, height - 1);
+    if (width == padded_width) {
+      rows[i] = (JSAMPROW) (plane + row * stride);
+    } else {
+      rows[i] = pad + i * padded_width;
+      memcpy (rows[i], plane + row * stride, width);
+      memset (rows[i] + width, rows[i][width - 1], padded_width - width);
+    }
+  }
+}
+
+/**
+ * @brief Encode one slice of the current frame, on a pool thread.
+ */
+static void
+gst_pjpegenc_encode_slice (GstPJpegEncSlice * slice, GstPJpegEnc * enc)
+{
+  struct jpeg_compress_struct *cinfo = &slice->cinfo;
+  GstVideoFrame *frame = enc->frame;
+  const guint width = GST_VIDEO_FRAME_WIDTH (frame);
+  const guint height = GST_VIDEO_FRAME_HEIGHT (frame);
+  const guint cwidth = GST_VIDEO_FRAME_COMP_WIDTH (frame, 1);
+  const guint cheight = GST_VIDEO_FRAME_COMP_HEIGHT (frame, 1);
+  const guint y0 = slice->first_row * PJPEG_MCU_SIZE;
+  const guint y1 = MIN (y0 + slice->rows * PJPEG_MCU_SIZE, height);
+  const guint padded = enc->mcus_per_row * PJPEG_MCU_SIZE;
+  JSAMPROW y_rows[PJPEG_MCU_SIZE];
+  JSAMPROW u_rows[PJPEG_MCU_SIZE / 2];
+  JSAMPROW v_rows[PJPEG_MCU_SIZE / 2];
+  JSAMPARRAY planes[3] = { y_rows, u_rows, v_rows };
+  guint y;
+
+  slice->failed = TRUE;
+  slice->size = 0;
+  if (setjmp (slice->jmp)) {
+    jpeg_abort_compress (cinfo);
+    goto done;
+  }
+
+  cinfo->image_width = width;
+  cinfo->image_height = y1 - y0;
+  cinfo->input_components = 3;
+  cinfo->in_color_space = JCS_YCbCr;
+  jpeg_set_defaults (cinfo);
+  jpeg_set_colorspace (cinfo, JCS_YCbCr);
+  jpeg_set_quality (cinfo, enc->frame_quality, TRUE);
+  cinfo->raw_data_in = TRUE;
+  cinfo->dct_method = JDCT_IFAST;
+  cinfo->comp_info[0].h_samp_factor = 2;
+  cinfo->comp_info[0].v_samp_factor = 2;
+  cinfo->comp_info[1].h_samp_factor = 1;
+  cinfo->comp_info[1].v_samp_factor = 1;
+  cinfo->comp_info[2].h_samp_factor = 1;
+  cinfo->comp_info[2].v_samp_factor = 1;
+
+  jpeg_start_compress (cinfo, TRUE);
+  for (y = y0; y < y1; y += PJPEG_MCU_SIZE) {
+    gst_pjpegenc_get_rows (y_rows, PJPEG_MCU_SIZE,
+        GST_VIDEO_FRAME_COMP_DATA (frame, 0),
+        GST_VIDEO_FRAME_COMP_STRIDE (frame, 0), width, height, padded, y,
+        slice->pad);
+    gst_pjpegenc_get_rows (u_rows, PJPEG_MCU_SIZE / 2,
+        GST_VIDEO_FRAME_COMP_DATA (frame, 1),
+        GST_VIDEO_FRAME_COMP_STRIDE (frame, 1), cwidth, cheight, padded / 2,
+        y / 2, slice->pad + PJPEG_MCU_SIZE * padded);
+    gst_pjpegenc_get_rows (v_rows, PJPEG_MCU_SIZE / 2,
+        GST_VIDEO_FRAME_COMP_DATA (frame, 2),
+        GST_VIDEO_FRAME_COMP_STRIDE (frame, 2), cwidth, cheight, padded / 2,
+        y / 2, slice->pad + PJPEG_MCU_SIZE * padded * 3 / 2);
+    jpeg_write_raw_data (cinfo, planes, PJPEG_MCU_SIZE);
+  }
+  jpeg_finish_compress (cinfo);
+
+  slice->failed = (gst_pjpegenc_find_sos (slice->data, slice->size,
+          &slice->scan) == 0) || slice->size < slice->scan + 2;
+
+done:
+  g_mutex_lock (&enc->lock);
+  if (--enc->pending == 0)
+    g_cond_signal (&enc->cond);
+  g_mutex_unlock (&enc->lock);
+}
+
+/**
+ * @brief Split the frame into slices for the negotiated size.
+ */
+static void
+gst_pjpegenc_setup_slices (GstPJpegEnc * enc, guint width, guint height)
+{
+  guint mcu_rows = (height + PJPEG_MCU_SIZE - 1) / PJPEG_MCU_SIZE;
+  guint threads = enc->threads ? enc->threads : g_get_num_processors ();
+  guint n_slices = enc->slices ? enc->slices : threads;
+  guint n;
+
+  gst_pjpegenc_free_slices (enc);
+
+  enc->mcus_per_row = (width + PJPEG_MCU_SIZE - 1) / PJPEG_MCU_SIZE;
+  n_slices = CLAMP (n_slices, 1, mcu_rows);
+  enc->slice_rows = (mcu_rows + n_slices - 1) / n_slices;
+
+  /* a restart interval covers exactly one slice */
+  enc->slice_rows = MIN (enc->slice_rows,
+      PJPEG_MAX_RESTART_INTERVAL / enc->mcus_per_row);
+  enc->n_slices = (mcu_rows + enc->slice_rows - 1) / enc->slice_rows;
+  enc->slice = g_new0 (GstPJpegEncSlice, enc->n_slices);
+
+  for (n = 0; n < enc->n_slices; ++n) {
+    GstPJpegEncSlice *slice = &enc->slice[n];
+    slice->enc = enc;
+    slice->first_row = n * enc->slice_rows;
+    slice->rows = MIN (enc->slice_rows, mcu_rows - slice->first_row);
+    if (width % PJPEG_MCU_SIZE)
+      slice->pad = g_malloc (enc->mcus_per_row * PJPEG_MCU_SIZE *
+          PJPEG_MCU_SIZE * 2);
+
+    slice->cinfo.err = jpeg_std_error (&slice->jerr);
+    slice->jerr.error_exit = gst_pjpegenc_error_exit;
+    slice->cinfo.client_data = slice;
+    jpeg_create_compress (&slice->cinfo);
+    slice->jdest.init_destination = gst_pjpegenc_init_destination;
+    slice->jdest.empty_output_buffer = gst_pjpegenc_empty_output_buffer;
+    slice->jdest.term_destination = gst_pjpegenc_term_destination;
+    slice->cinfo.dest = &slice->jdest;
+  }
+
+  GST_INFO_OBJECT (enc, "%dx%d in %d slices of %d MCU rows, %d threads",
+      width, height, enc->n_slices, enc->slice_rows, threads);
+}
+
+/**
+ * @brief The size of the joined image.
+ */
+static gsize
+gst_pjpegenc_joined_size (GstPJpegEnc * enc)
+{
+  GstPJpegEncSlice *first = &enc->slice[0];
+  gsize scan_header = first->scan;
+  gsize size = scan_header + 6 + 2;     /* DRI and EOI */
+  guint n;
+  for (n = 0; n < enc->n_slices; ++n) {
+    GstPJpegEncSlice *slice = &enc->slice[n];
+    size += slice->size - slice->scan - 2 + 2;  /* entropy data, RSTn */
+  }
+  return size - 2;              /* no RSTn after the last slice */
+}
+
+/**
+ * @brief Join the encoded slices into one image.
+ *
+ * The headers come from the first slice, with the frame height patched and
+ * a restart interval of one slice added. The entropy coded data of each
+ * slice follows, separated by RSTn markers. Every slice starts with fresh
+ * DC predictions, which is exactly what a decoder does after RSTn.
+ */
+static void
+gst_pjpegenc_join_slices (GstPJpegEnc * enc, guint height, guint8 * out)
+{
+  GstPJpegEncSlice *first = &enc->slice[0];
+  guint restart_interval = enc->mcus_per_row * enc->slice_rows;
+  gsize sos = gst_pjpegenc_find_sos (first->data, first->size, &first->scan);
+  guint8 *p = out;
+  gsize pos;
+  guint n;
+
+  memcpy (p, first->data, sos);
+  for (pos = 2; pos + 9 <= sos; pos += 2 + ((p[pos + 2] << 8) | p[pos + 3])) {
+    if (p[pos + 1] == PJPEG_MARKER_SOF0) {
+      p[pos + 5] = height >> 8;
+      p[pos + 6] = height & 0xFF;
+      break;
+    }
+  }
+  p += sos;
+
+  *p++ = 0xFF;
+  *p++ = PJPEG_MARKER_DRI;
+  *p++ = 0;
+  *p++ = 4;
+  *p++ = restart_interval >> 8;
+  *p++ = restart_interval & 0xFF;
+
+  memcpy (p, first->data + sos, first->scan - sos);
+  p += first->scan - sos;
+
+  for (n = 0; n < enc->n_slices; ++n) {
+    GstPJpegEncSlice *slice = &enc->slice[n];
+    gsize len = slice->size - slice->scan - 2;
+    memcpy (p, slice->data + slice->scan, len);
+    p += len;
+    if (n + 1 < enc->n_slices) {
+      *p++ = 0xFF;
+      *p++ = PJPEG_MARKER_RST0 + (n & 7);
+    }
+  }
+
+  *p++ = 0xFF;
+  *p++ = PJPEG_MARKER_EOI;
+}
+
+static gboolean
+gst_pjpegenc_start (GstVideoEncoder * encoder)
+{
+  GstPJpegEnc *enc = GST_PJPEGENC (encoder);
+  guint threads = enc->threads ? enc->threads : g_get_num_processors ();
+  GError *error = NULL;
+
+  enc->pool = g_thread_pool_new ((GFunc) gst_pjpegenc_encode_slice, enc,
+      threads, TRUE, &error);
+  if (!enc->pool) {
+    GST_ELEMENT_ERROR (enc, RESOURCE, FAILED,
+        ("Failed to start encoder threads"), ("%s", error->message));
+    g_error_free (error);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+static gboolean
+gst_pjpegenc_stop (GstVideoEncoder * encoder)
+{
+  GstPJpegEnc *enc = GST_PJPEGENC (encoder);
+
+  if (enc->pool) {
+    g_thread_pool_free (enc->pool, FALSE, TRUE);
+    enc->pool = NULL;
+  }
+  if (enc->input_state) {
+    gst_video_codec_state_unref (enc->input_state);
+    enc->input_state = NULL;
+  }
+  gst_pjpegenc_free_slices (enc);
+  return TRUE;
+}
+
+static gboolean
+gst_pjpegenc_set_format (GstVideoEncoder * encoder, GstVideoCodecState * state)
+{
+  GstPJpegEnc *enc = GST_PJPEGENC (encoder);
+  GstVideoCodecState *output_state;
+
+  if (enc->input_state)
+    gst_video_codec_state_unref (enc->input_state);
+  enc->input_state = gst_video_codec_state_ref (state);
+
+  gst_pjpegenc_setup_slices (enc, GST_VIDEO_INFO_WIDTH (&state->info),
+      GST_VIDEO_INFO_HEIGHT (&state->info));
+
+  output_state = gst_video_encoder_set_output_state (encoder,
+      gst_caps_new_empty_simple ("image/jpeg"), state);
+  gst_video_codec_state_unref (output_state);
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_pjpegenc_handle_frame (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame)
+{
+  GstPJpegEnc *enc = GST_PJPEGENC (encoder);
+  GstVideoFrame vframe;
+  GstFlowReturn ret;
+  GstMapInfo map;
+  guint n;
+
+  if (!gst_video_frame_map (&vframe, &enc->input_state->info,
+          frame->input_buffer, GST_MAP_READ)) {
+    GST_ELEMENT_ERROR (enc, STREAM, FORMAT, (NULL), ("Failed to map frame"));
+    gst_video_codec_frame_unref (frame);
+    return GST_FLOW_ERROR;
+  }
+
+  /* all slices must share the same quantization tables */
+  enc->frame = &vframe;
+  enc->frame_quality = enc->quality;
+  enc->pending = enc->n_slices;
+  for (n = 0; n < enc->n_slices; ++n)
+    g_thread_pool_push (enc->pool, &enc->slice[n], NULL);
+
+  g_mutex_lock (&enc->lock);
+  while (enc->pending)
+    g_cond_wait (&enc->cond, &enc->lock);
+  g_mutex_unlock (&enc->lock);
+
+  gst_video_frame_unmap (&vframe);
+  enc->frame = NULL;
+
+  for (n = 0; n < enc->n_slices; ++n) {
+    if (enc->slice[n].failed) {
+      GST_ELEMENT_ERROR (enc, STREAM, ENCODE, (NULL),
+          ("Failed to encode slice %d", n));
+      gst_video_codec_frame_unref (frame);
+      return GST_FLOW_ERROR;
+    }
+  }
+
+  ret = gst_video_encoder_allocate_output_frame (encoder, frame,
+      gst_pjpegenc_joined_size (enc));
+  if (ret != GST_FLOW_OK) {
+    gst_video_codec_frame_unref (frame);
+    return ret;
+  }
+
+  gst_buffer_map (frame->output_buffer, &map, GST_MAP_WRITE);
+  gst_pjpegenc_join_slices (enc,
+      GST_VIDEO_INFO_HEIGHT (&enc->input_state->info), map.data);
+  gst_buffer_unmap (frame->output_buffer, &map);
+
+  GST_VIDEO_CODEC_FRAME_SET_SYNC_POINT (frame);
+  return gst_video_encoder_finish_frame (encoder, frame);
+}
+
+static void
+gst_pjpegenc_class_init (GstPJpegEncClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstVideoEncoderClass *encoder_class = GST_VIDEO_ENCODER_CLASS (klass);
+
+  object_class->set_property =
+      (GObjectSetPropertyFunc) gst_pjpegenc_set_property;
+  object_class->get_property =
+      (GObjectGetPropertyFunc) gst_pjpegenc_get_property;
+  object_class->finalize = (GObjectFinalizeFunc) gst_pjpegenc_finalize;
+
+  g_object_class_install_property (object_class, PROP_QUALITY,
+      g_param_spec_int ("quality", "Quality", "JPEG quality",
+          0, 100, GST_PJPEGENC_DEFAULT_QUALITY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_THREADS,
+      g_param_spec_uint ("threads", "Threads",
+          "Encoder threads, 0 for one per CPU",
+          0, 256, 0, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_SLICES,
+      g_param_spec_uint ("slices", "Slices",
+          "Slices per frame, 0 for one per thread",
+          0, 4096, 0, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_set_static_metadata (element_class,
+      "Parallel JPEG encoder", "Codec/Encoder/Image",
+      "Encode frames as baseline JPEG, slices in parallel",
+      "Duzy Chan <code@duzy.info>");
+
+  gst_element_class_add_pad_template (element_class,
+      gst_static_pad_template_get (&gst_pjpegenc_sink_factory));
+
+  gst_element_class_add_pad_template (element_class,
+      gst_static_pad_template_get (&gst_pjpegenc_src_factory));
+
+  encoder_class->start = GST_DEBUG_FUNCPTR (gst_pjpegenc_start);
+  encoder_class->stop = GST_DEBUG_FUNCPTR (gst_pjpegenc_stop);
+  encoder_class->set_format = GST_DEBUG_FUNCPTR (gst_pjpegenc_set_format);
+  encoder_class->handle_frame = GST_DEBUG_FUNCPTR (gst_pjpegenc_handle_frame);
+
+  GST_DEBUG_CATEGORY_INIT (gst_pjpegenc_debug, "pjpegenc", 0,
+      "Parallel JPEG encoder");
+}
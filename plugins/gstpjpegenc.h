@@ -0,0 +1,84 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GST_PJPEGENC_H__
+#define __GST_PJPEGENC_H__
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+#include <gst/video/gstvideoencoder.h>
+
+G_BEGIN_DECLS
+#define GST_TYPE_PJPEGENC \
+  (gst_pjpegenc_get_type ())
+#define GST_PJPEGENC(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj),GST_TYPE_PJPEGENC,GstPJpegEnc))
+#define GST_PJPEGENC_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST ((klass),GST_TYPE_PJPEGENC,GstPJpegEncClass))
+#define GST_IS_PJPEGENC(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_PJPEGENC))
+#define GST_IS_PJPEGENC_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_PJPEGENC))
+#define GST_PJPEGENC_DEFAULT_QUALITY 85
+typedef struct _GstPJpegEnc GstPJpegEnc;
+typedef struct _GstPJpegEncClass GstPJpegEncClass;
+typedef struct _GstPJpegEncSlice GstPJpegEncSlice;
+
+/**
+ * @brief Parallel JPEG encoder.
+ *
+ * Each frame is cut into horizontal slices of whole MCU rows, which are
+ * encoded on a thread pool and joined into one baseline JPEG, with a
+ * restart marker between the slices.
+ */
+struct _GstPJpegEnc
+{
+  GstVideoEncoder base;
+
+  gint quality;                 /*!< the JPEG quality */
+  guint threads;                /*!< the encoder threads, 0 for one per CPU */
+  guint slices;                 /*!< slices per frame, 0 for one per thread */
+
+  GstVideoCodecState *input_state;      /*!< the negotiated input */
+  GThreadPool *pool;            /*!< the slice encoding threads */
+
+  GMutex lock;                  /*!< the lock for %pending */
+  GCond cond;                   /*!< signaled when %pending drops to 0 */
+  guint pending;                /*!< slices of %frame still being encoded */
+  GstVideoFrame *frame;         /*!< the frame being encoded */
+  gint frame_quality;           /*!< the quality %frame is encoded at */
+
+  GstPJpegEncSlice *slice;      /*!< the slices */
+  guint n_slices;               /*!< number of %slice */
+  guint slice_rows;             /*!< MCU rows per slice */
+  guint mcus_per_row;           /*!< MCUs per MCU row */
+};
+
+/**
+ * @brief GstPJpegEncClass
+ */
+struct _GstPJpegEncClass
+{
+  GstVideoEncoderClass base_class;
+};
+
+GType gst_pjpegenc_get_type (void);
+
+G_END_DECLS
+#endif //__GST_PJPEGENC_H__
@@ -0,0 +1,728 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE             /* O_DIRECT */
+#endif
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "gstringsink.h"
+#include "../logutils.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_ring_sink_debug);
+#define GST_CAT_DEFAULT gst_ring_sink_debug
+
+#define GST_RING_SINK_LOCK(obj) (g_mutex_lock (&(obj)->lock))
+#define GST_RING_SINK_UNLOCK(obj) (g_mutex_unlock (&(obj)->lock))
+
+/* O_DIRECT wants the memory, the file offsets and the lengths aligned, every
+ * file starts on a block boundary of the ring for that. */
+#define RING_BLOCK_SIZE 4096
+#define RING_CHUNK_SIZE (1024 * 1024)   /* bytes per write */
+#define RING_ROUND_DOWN(n) ((n) & ~(guint64) (RING_BLOCK_SIZE - 1))
+#define RING_ROUND_UP(n) RING_ROUND_DOWN ((n) + RING_BLOCK_SIZE - 1)
+#define RING_FILE_OPEN G_MAXUINT64
+
+/**
+ * @brief Bytes to write over a file once it is complete.
+ */
+typedef struct _GstRingSinkPatch
+{
+  guint64 offset;               /*!< the file offset */
+  GBytes *data;                 /*!< the bytes */
+} GstRingSinkPatch;
+
+/**
+ * @brief A file being written from the ring.
+ */
+typedef struct _GstRingSinkFile
+{
+  gchar *path;                  /*!< the file name */
+  guint64 start;                /*!< the ring position of the first byte */
+  guint64 end;                  /*!< the position after the last byte */
+  gboolean failed;              /*!< the file can't be written */
+  GQueue patches;               /*!< rewrites to apply when closed */
+} GstRingSinkFile;
+
+static GstStaticPadTemplate gst_ring_sink_sink_factory =
+GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+enum
+{
+  PROP_0,
+  PROP_LOCATION,
+  PROP_BUFFER_SIZE,
+  PROP_HIGH_WATER,
+  PROP_DIRECT,
+  PROP_OVERRUN,
+  PROP_FILL,
+  PROP_MAX_FILL,
+  PROP_WRITTEN,
+  PROP_THROUGHPUT,
+  PROP_DROPPED,
+};
+
+#define gst_ring_sink_parent_class parent_class
+G_DEFINE_TYPE (GstRingSink, gst_ring_sink, GST_TYPE_BASE_SINK);
+
+static void
+gst_ring_sink_init (GstRingSink * sink)
+{
+  sink->buffer_size = GST_RING_SINK_DEFAULT_BUFFER_SIZE;
+  sink->high_water = GST_RING_SINK_DEFAULT_HIGH_WATER;
+  sink->direct = TRUE;
+  g_mutex_init (&sink->lock);
+  g_cond_init (&sink->cond);
+  g_queue_init (&sink->files);
+  sink->seek = -1;
+
+  gst_base_sink_set_sync (GST_BASE_SINK (sink), FALSE);
+}
+
+static void
+gst_ring_sink_patch_free (GstRingSinkPatch * patch)
+{
+  g_bytes_unref (patch->data);
+  g_free (patch);
+}
+
+static void
+gst_ring_sink_file_free (GstRingSinkFile * file)
+{
+  g_queue_foreach (&file->patches, (GFunc) gst_ring_sink_patch_free, NULL);
+  g_queue_clear (&file->patches);
+  g_free (file->path);
+  g_free (file);
+}
+
+static void
+gst_ring_sink_finalize (GstRingSink * sink)
+{
+  GST_RING_SINK_LOCK (sink);
+  sink->quit = TRUE;
+  g_cond_signal (&sink->cond);
+  GST_RING_SINK_UNLOCK (sink);
+
+  // The writer drains the files left in the ring before quitting
+  if (sink->writer)
+    g_thread_join (sink->writer);
+
+  g_queue_foreach (&sink->files, (GFunc) gst_ring_sink_file_free, NULL);
+  g_queue_clear (&sink->files);
+  free (sink->ring);
+  g_free (sink->location);
+  g_mutex_clear (&sink->lock);
+  g_cond_clear (&sink->cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (G_OBJECT (sink));
+}
+
+/**
+ * @return the ring fill in percent, locked
+ */
+static guint
+gst_ring_sink_fill (GstRingSink * sink)
+{
+  if (sink->ring_size == 0)
+    return 0;
+  return (sink->head - sink->tail) * 100 / sink->ring_size;
+}
+
+/**
+ * @brief Update %overrun from the ring fill, locked.
+ * @return TRUE if the fill just crossed the high water mark
+ *
+ * %overrun is cleared when the fill drops below half the high water mark,
+ * so that it doesn't flap around the mark.
+ */
+static gboolean
+gst_ring_sink_update_fill (GstRingSink * sink)
+{
+  guint fill = gst_ring_sink_fill (sink);
+
+  if (sink->max_fill < fill)
+    sink->max_fill = fill;
+  if (!sink->overrun && sink->high_water <= fill) {
+    sink->overrun = TRUE;
+    return TRUE;
+  }
+  if (sink->overrun && fill < sink->high_water / 2)
+    sink->overrun = FALSE;
+  return FALSE;
+}
+
+static void
+gst_ring_sink_set_property (GstRingSink * sink, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_LOCATION:
+      GST_OBJECT_LOCK (sink);
+      g_free (sink->location);
+      sink->location = g_value_dup_string (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_BUFFER_SIZE:
+      sink->buffer_size = g_value_get_uint64 (value);
+      break;
+    case PROP_HIGH_WATER:
+      GST_RING_SINK_LOCK (sink);
+      sink->high_water = g_value_get_uint (value);
+      GST_RING_SINK_UNLOCK (sink);
+      break;
+    case PROP_DIRECT:
+      sink->direct = g_value_get_boolean (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (sink), property_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_ring_sink_get_property (GstRingSink * sink, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_LOCATION:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_string (value, sink->location);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_BUFFER_SIZE:
+      g_value_set_uint64 (value, sink->buffer_size);
+      break;
+    case PROP_HIGH_WATER:
+      g_value_set_uint (value, sink->high_water);
+      break;
+    case PROP_DIRECT:
+      g_value_set_boolean (value, sink->direct);
+      break;
+    case PROP_OVERRUN:
+      GST_RING_SINK_LOCK (sink);
+      g_value_set_boolean (value, sink->overrun);
+      GST_RING_SINK_UNLOCK (sink);
+      break;
+    case PROP_FILL:
+      GST_RING_SINK_LOCK (sink);
+      g_value_set_uint (value, gst_ring_sink_fill (sink));
+      GST_RING_SINK_UNLOCK (sink);
+      break;
+    case PROP_MAX_FILL:
+      GST_RING_SINK_LOCK (sink);
+      g_value_set_uint (value, sink->max_fill);
+      GST_RING_SINK_UNLOCK (sink);
+      break;
+    case PROP_WRITTEN:
+      GST_RING_SINK_LOCK (sink);
+      g_value_set_uint64 (value, sink->written);
+      GST_RING_SINK_UNLOCK (sink);
+      break;
+    case PROP_THROUGHPUT:
+      GST_RING_SINK_LOCK (sink);
+      g_value_set_uint64 (value, sink->throughput);
+      GST_RING_SINK_UNLOCK (sink);
+      break;
+    case PROP_DROPPED:
+      GST_RING_SINK_LOCK (sink);
+      g_value_set_uint64 (value, sink->dropped);
+      GST_RING_SINK_UNLOCK (sink);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (sink), property_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Open a file for writing, with O_DIRECT if the file system takes it.
+ */
+static gint
+gst_ring_sink_open_file (const gchar * path, gboolean direct)
+{
+  const gint flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+  gint fd = -1;
+
+#ifdef O_DIRECT
+  if (direct) {
+    fd = open (path, flags | O_DIRECT, 0644);
+    if (fd < 0 && errno != EINVAL)
+      return -1;
+  }
+#endif
+  if (fd < 0)
+    fd = open (path, flags, 0644);
+  return fd;
+}
+
+static gboolean
+gst_ring_sink_write_all (gint fd, const guint8 * data, gsize size,
+    off_t offset)
+{
+  while (0 < size) {
+    gssize n = pwrite (fd, data, size, offset);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return FALSE;
+    data += n;
+    size -= n;
+    offset += n;
+  }
+  return TRUE;
+}
+
+/**
+ * @brief Apply the rewrites of a file, in the order they were made.
+ */
+static void
+gst_ring_sink_apply_patches (GstRingSinkFile * file)
+{
+  GstRingSinkPatch *patch;
+  gboolean ok = TRUE;
+  gint fd;
+
+  if (g_queue_is_empty (&file->patches))
+    return;
+
+  // The patches are small and unaligned, so no O_DIRECT here
+  fd = open (file->path, O_WRONLY | O_CLOEXEC);
+  if (fd < 0) {
+    WARN ("%s: %s", file->path, g_strerror (errno));
+    return;
+  }
+  while (ok && (patch = g_queue_pop_head (&file->patches))) {
+    gsize size;
+    const guint8 *data = g_bytes_get_data (patch->data, &size);
+    ok = gst_ring_sink_write_all (fd, data, size, patch->offset);
+    gst_ring_sink_patch_free (patch);
+  }
+  if (!ok || fdatasync (fd) < 0)
+    WARN ("%s: %s", file->path, g_strerror (errno));
+  close (fd);
+}
+
+/**
+ * @brief The writer thread.
+ *
+ * Writes whole chunks of the oldest file out of the ring, whole blocks
+ * only while the file is open. The partial block at the end is written
+ * padded and the file is truncated to its size when it is closed.
+ */
+static gpointer
+gst_ring_sink_writer (GstRingSink * sink)
+{
+  GstRingSinkFile *file;
+  gint fd = -1;
+
+  GST_RING_SINK_LOCK (sink);
+  while ((file = g_queue_peek_head (&sink->files)) || !sink->quit) {
+    guint64 end, offset, pos, len;
+    gboolean ok = TRUE;
+    gint64 now;
+
+    if (file == NULL) {
+      g_cond_wait (&sink->cond, &sink->lock);
+      continue;
+    }
+
+    if (sink->quit && file->end == RING_FILE_OPEN)
+      file->end = sink->head;
+    if (sink->tail < file->start)
+      sink->tail = file->start;
+
+    if (fd < 0 && !file->failed) {
+      gboolean direct = sink->direct;
+      GST_RING_SINK_UNLOCK (sink);
+      fd = gst_ring_sink_open_file (file->path, direct);
+      if (fd < 0) {
+        GST_ELEMENT_ERROR (sink, RESOURCE, OPEN_WRITE,
+            ("Could not open file \"%s\" for writing.", file->path),
+            GST_ERROR_SYSTEM);
+      }
+      GST_RING_SINK_LOCK (sink);
+      file->failed = fd < 0;
+    }
+
+    end = file->end;
+    if (end == RING_FILE_OPEN)
+      end = RING_ROUND_DOWN (sink->head);
+    len = sink->tail < end ? end - sink->tail : 0;
+
+    if (len == 0 && file->end != RING_FILE_OPEN) {
+      g_queue_pop_head (&sink->files);
+      GST_RING_SINK_UNLOCK (sink);
+      if (0 <= fd) {
+        if (ftruncate (fd, file->end - file->start) < 0 || fdatasync (fd) < 0)
+          WARN ("%s: %s", file->path, g_strerror (errno));
+        close (fd);
+        fd = -1;
+        gst_ring_sink_apply_patches (file);
+      }
+      INFO ("Written %s", file->path);
+      gst_ring_sink_file_free (file);
+      GST_RING_SINK_LOCK (sink);
+      continue;
+    }
+
+    if (len < RING_CHUNK_SIZE && file->end == RING_FILE_OPEN) {
+      g_cond_wait (&sink->cond, &sink->lock);
+      continue;
+    }
+
+    offset = sink->tail - file->start;
+    pos = sink->tail % sink->ring_size;
+    len = MIN (len, RING_CHUNK_SIZE);
+    len = MIN (len, sink->ring_size - pos);
+    GST_RING_SINK_UNLOCK (sink);
+
+    if (0 <= fd) {
+      ok = gst_ring_sink_write_all (fd, sink->ring + pos, RING_ROUND_UP (len),
+          offset);
+      if (!ok) {
+        GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
+            ("Error while writing to file \"%s\".", file->path),
+            GST_ERROR_SYSTEM);
+      }
+    }
+    now = g_get_monotonic_time ();
+
+    GST_RING_SINK_LOCK (sink);
+    if (!ok) {
+      close (fd);
+      fd = -1;
+      file->failed = TRUE;
+    }
+    sink->tail += len;
+    sink->written += len;
+    sink->window_bytes += len;
+    if (sink->window_start == 0)
+      sink->window_start = now;
+    if (G_USEC_PER_SEC <= now - sink->window_start) {
+      sink->throughput = sink->window_bytes * G_USEC_PER_SEC
+          / (now - sink->window_start);
+      sink->window_start = now;
+      sink->window_bytes = 0;
+    }
+    gst_ring_sink_update_fill (sink);
+  }
+  GST_RING_SINK_UNLOCK (sink);
+  return NULL;
+}
+
+/**
+ * @brief Open the location, the ring and the writer are made on first use.
+ */
+static gboolean
+gst_ring_sink_start (GstBaseSink * basesink)
+{
+  GstRingSink *sink = GST_RING_SINK (basesink);
+  GstRingSinkFile *file;
+  gchar *location;
+
+  GST_OBJECT_LOCK (sink);
+  location = g_strdup (sink->location);
+  GST_OBJECT_UNLOCK (sink);
+
+  if (location == NULL) {
+    GST_ELEMENT_ERROR (sink, RESOURCE, NOT_FOUND,
+        ("No file name specified for writing."), (NULL));
+    return FALSE;
+  }
+
+  GST_RING_SINK_LOCK (sink);
+  if (sink->ring == NULL) {
+    void *ring = NULL;
+    sink->ring_size = MAX (RING_ROUND_UP (sink->buffer_size),
+        2 * RING_CHUNK_SIZE);
+    if (posix_memalign (&ring, RING_BLOCK_SIZE, sink->ring_size) != 0) {
+      GST_RING_SINK_UNLOCK (sink);
+      GST_ELEMENT_ERROR (sink, RESOURCE, NO_SPACE_LEFT,
+          ("Can't allocate %" G_GUINT64_FORMAT " bytes of ring buffer",
+              sink->ring_size), (NULL));
+      g_free (location);
+      return FALSE;
+    }
+    // Fault the pages in now rather than while recording
+    memset (ring, 0, sink->ring_size);
+    sink->ring = ring;
+  }
+  if (sink->writer == NULL) {
+    sink->writer = g_thread_new ("ringsink",
+        (GThreadFunc) gst_ring_sink_writer, sink);
+  }
+
+  file = g_new0 (GstRingSinkFile, 1);
+  file->path = location;
+  file->start = RING_ROUND_UP (sink->head);
+  file->end = RING_FILE_OPEN;
+  sink->head = file->start;
+  sink->seek = -1;
+  g_queue_push_tail (&sink->files, file);
+  g_cond_signal (&sink->cond);
+  GST_RING_SINK_UNLOCK (sink);
+  return TRUE;
+}
+
+/**
+ * @brief Close the file, the writer finishes it in the background.
+ */
+static gboolean
+gst_ring_sink_stop (GstBaseSink * basesink)
+{
+  GstRingSink *sink = GST_RING_SINK (basesink);
+  GstRingSinkFile *file;
+
+  GST_RING_SINK_LOCK (sink);
+  file = g_queue_peek_tail (&sink->files);
+  if (file && file->end == RING_FILE_OPEN)
+    file->end = sink->head;
+  g_cond_signal (&sink->cond);
+  GST_RING_SINK_UNLOCK (sink);
+  return TRUE;
+}
+
+/**
+ * @brief Follow byte segments, a segment before the end of the file starts
+ * a rewrite, one at the end goes back to appending.
+ */
+static gboolean
+gst_ring_sink_event (GstBaseSink * basesink, GstEvent * event)
+{
+  GstRingSink *sink = GST_RING_SINK (basesink);
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_SEGMENT) {
+    const GstSegment *segment;
+    GstRingSinkFile *file;
+
+    gst_event_parse_segment (event, &segment);
+    GST_RING_SINK_LOCK (sink);
+    file = g_queue_peek_tail (&sink->files);
+    if (segment->format == GST_FORMAT_BYTES && file
+        && file->end == RING_FILE_OPEN) {
+      if (segment->start == sink->head - file->start)
+        sink->seek = -1;
+      else
+        sink->seek = segment->start;
+    }
+    GST_RING_SINK_UNLOCK (sink);
+  }
+
+  return GST_BASE_SINK_CLASS (parent_class)->event (basesink, event);
+}
+
+/**
+ * @brief The files are seekable in bytes, for muxers to rewrite headers.
+ */
+static gboolean
+gst_ring_sink_query (GstBaseSink * basesink, GstQuery * query)
+{
+  if (GST_QUERY_TYPE (query) == GST_QUERY_SEEKING) {
+    GstFormat format;
+
+    gst_query_parse_seeking (query, &format, NULL, NULL, NULL);
+    if (format == GST_FORMAT_BYTES) {
+      gst_query_set_seeking (query, GST_FORMAT_BYTES, TRUE, 0, -1);
+      return TRUE;
+    }
+  }
+
+  return GST_BASE_SINK_CLASS (parent_class)->query (basesink, query);
+}
+
+/**
+ * @brief Keep a rewrite aside for the writer to apply on close.
+ */
+static void
+gst_ring_sink_add_patch (GstRingSink * sink, GstMapInfo * map)
+{
+  GstRingSinkPatch *patch = g_new0 (GstRingSinkPatch, 1);
+  GstRingSinkFile *file;
+
+  patch->offset = sink->seek;
+  patch->data = g_bytes_new (map->data, map->size);
+
+  GST_RING_SINK_LOCK (sink);
+  file = g_queue_peek_tail (&sink->files);
+  if (file == NULL || file->end != RING_FILE_OPEN) {
+    gst_ring_sink_patch_free (patch);
+    sink->seek = -1;
+  } else {
+    g_queue_push_tail (&file->patches, patch);
+    sink->seek += map->size;
+    if (sink->seek == sink->head - file->start)
+      sink->seek = -1;
+  }
+  GST_RING_SINK_UNLOCK (sink);
+}
+
+/**
+ * @brief Copy the buffer into the ring, never waiting for the disk.
+ */
+static GstFlowReturn
+gst_ring_sink_render (GstBaseSink * basesink, GstBuffer * buffer)
+{
+  GstRingSink *sink = GST_RING_SINK (basesink);
+  guint64 head, used, pos, n;
+  gboolean alert = FALSE;
+  guint fill = 0;
+  GstMapInfo map;
+
+  if (!gst_buffer_map (buffer, &map, GST_MAP_READ)) {
+    GST_ELEMENT_ERROR (sink, STREAM, FAILED, (NULL), ("Can't map buffer"));
+    return GST_FLOW_ERROR;
+  }
+
+  // Only the streaming thread moves %seek away from -1
+  if (sink->seek >= 0) {
+    gst_ring_sink_add_patch (sink, &map);
+    gst_buffer_unmap (buffer, &map);
+    return GST_FLOW_OK;
+  }
+
+  GST_RING_SINK_LOCK (sink);
+  head = sink->head;
+  used = head - sink->tail;
+  GST_RING_SINK_UNLOCK (sink);
+
+  // Only the writer moves the tail, the space up to it is ours to copy into
+  if (sink->ring_size < used + map.size) {
+    GST_RING_SINK_LOCK (sink);
+    sink->dropped += 1;
+    GST_RING_SINK_UNLOCK (sink);
+    GST_WARNING_OBJECT (sink, "ring full, dropped %" G_GSIZE_FORMAT " bytes",
+        map.size);
+  } else {
+    pos = head % sink->ring_size;
+    n = MIN (map.size, sink->ring_size - pos);
+    memcpy (sink->ring + pos, map.data, n);
+    memcpy (sink->ring, map.data + n, map.size - n);
+
+    GST_RING_SINK_LOCK (sink);
+    sink->head += map.size;
+    alert = gst_ring_sink_update_fill (sink);
+    fill = gst_ring_sink_fill (sink);
+    g_cond_signal (&sink->cond);
+    GST_RING_SINK_UNLOCK (sink);
+  }
+  gst_buffer_unmap (buffer, &map);
+
+  if (alert) {
+    GST_ELEMENT_WARNING (sink, RESOURCE, WRITE,
+        ("The disk can't keep up with the recording"),
+        ("ring buffer %u%% full, %" G_GUINT64_FORMAT " bytes/s written",
+            fill, sink->throughput));
+  }
+  return GST_FLOW_OK;
+}
+
+static void
+gst_ring_sink_class_init (GstRingSinkClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstBaseSinkClass *basesink_class = GST_BASE_SINK_CLASS (klass);
+
+  object_class->set_property =
+      (GObjectSetPropertyFunc) gst_ring_sink_set_property;
+  object_class->get_property =
+      (GObjectGetPropertyFunc) gst_ring_sink_get_property;
+  object_class->finalize = (GObjectFinalizeFunc) gst_ring_sink_finalize;
+
+  g_object_class_install_property (object_class, PROP_LOCATION,
+      g_param_spec_string ("location", "File Location",
+          "Location of the file to write", NULL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_BUFFER_SIZE,
+      g_param_spec_uint64 ("buffer-size", "Buffer Size",
+          "Size of the ring buffer in bytes, allocated on first start",
+          0, G_MAXUINT64, GST_RING_SINK_DEFAULT_BUFFER_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_HIGH_WATER,
+      g_param_spec_uint ("high-water", "High Water",
+          "Ring buffer fill in percent to report an overrun at",
+          1, 100, GST_RING_SINK_DEFAULT_HIGH_WATER,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_DIRECT,
+      g_param_spec_boolean ("direct", "Direct",
+          "Write with O_DIRECT, bypassing the page cache", TRUE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_OVERRUN,
+      g_param_spec_boolean ("overrun", "Overrun",
+          "The ring buffer is filled above the high water mark", FALSE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_FILL,
+      g_param_spec_uint ("fill", "Fill",
+          "Ring buffer fill in percent",
+          0, 100, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_MAX_FILL,
+      g_param_spec_uint ("max-fill", "Max Fill",
+          "Highest ring buffer fill in percent",
+          0, 100, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_WRITTEN,
+      g_param_spec_uint64 ("written", "Written",
+          "Bytes written to files",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_THROUGHPUT,
+      g_param_spec_uint64 ("throughput", "Throughput",
+          "Bytes per second written in the last second",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_DROPPED,
+      g_param_spec_uint64 ("dropped", "Dropped",
+          "Buffers dropped on a full ring buffer",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_set_static_metadata (element_class,
+      "Ring buffered file sink", "Sink/File",
+      "Write to a file from a ring buffer, never blocking on the disk",
+      "Duzy Chan <code@duzy.info>");
+
+  gst_element_class_add_pad_template (element_class,
+      gst_static_pad_template_get (&gst_ring_sink_sink_factory));
+
+  basesink_class->start = GST_DEBUG_FUNCPTR (gst_ring_sink_start);
+  basesink_class->stop = GST_DEBUG_FUNCPTR (gst_ring_sink_stop);
+  basesink_class->render = GST_DEBUG_FUNCPTR (gst_ring_sink_render);
+  basesink_class->event = GST_DEBUG_FUNCPTR (gst_ring_sink_event);
+  basesink_class->query = GST_DEBUG_FUNCPTR (gst_ring_sink_query);
+
+  GST_DEBUG_CATEGORY_INIT (gst_ring_sink_debug, "ringsink", 0, "RingSink");
+}
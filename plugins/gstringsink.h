@@ -0,0 +1,92 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GST_RING_SINK_H__
+#define __GST_RING_SINK_H__
+
+#include <gst/gst.h>
+#include <gst/base/gstbasesink.h>
+
+G_BEGIN_DECLS
+#define GST_TYPE_RING_SINK \
+  (gst_ring_sink_get_type ())
+#define GST_RING_SINK(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj),GST_TYPE_RING_SINK,GstRingSink))
+#define GST_RING_SINK_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST ((klass),GST_TYPE_RING_SINK,GstRingSinkClass))
+#define GST_IS_RING_SINK(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_RING_SINK))
+#define GST_IS_RING_SINK_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_RING_SINK))
+#define GST_RING_SINK_DEFAULT_BUFFER_SIZE (128 * 1024 * 1024)
+#define GST_RING_SINK_DEFAULT_HIGH_WATER 75     /* percent */
+typedef struct _GstRingSink GstRingSink;
+typedef struct _GstRingSinkClass GstRingSinkClass;
+
+/**
+ * @brief Write-behind file sink.
+ *
+ * Buffers are copied into a preallocated ring, and written to the file by
+ * a writer thread, so a slow disk never blocks the streaming thread. The
+ * ring outlives the files, a new location may be opened while the last
+ * file is still being written. Writes before the end of the file, like a
+ * muxer rewriting its headers, are kept aside and applied when the file
+ * is closed.
+ */
+struct _GstRingSink
+{
+  GstBaseSink base;
+
+  gchar *location;              /*!< the file to open on start */
+  guint64 buffer_size;          /*!< the ring size in bytes */
+  guint high_water;             /*!< the ring fill to raise %overrun at */
+  gboolean direct;              /*!< write with O_DIRECT if possible */
+
+  GMutex lock;                  /*!< the lock for everything below */
+  GCond cond;                   /*!< signaled for the writer thread */
+  GThread *writer;              /*!< the writer thread */
+  gboolean quit;                /*!< the writer thread should quit */
+  guint8 *ring;                 /*!< the ring */
+  guint64 ring_size;            /*!< the size of %ring */
+  guint64 head;                 /*!< bytes queued into the ring so far */
+  guint64 tail;                 /*!< bytes taken out of the ring so far */
+  GQueue files;                 /*!< the files to write, oldest first */
+  gint64 seek;                  /*!< the position of a rewrite, or -1 */
+
+  gboolean overrun;             /*!< the ring is filled above %high_water */
+  guint max_fill;               /*!< the highest ring fill seen, percent */
+  guint64 written;              /*!< bytes written to files */
+  guint64 throughput;           /*!< bytes/s written in the last second */
+  guint64 dropped;              /*!< buffers dropped on a full ring */
+  gint64 window_start;          /*!< start of the throughput window, usec */
+  guint64 window_bytes;         /*!< bytes written in the window */
+};
+
+/**
+ * @brief GstRingSinkClass
+ */
+struct _GstRingSinkClass
+{
+  GstBaseSinkClass base_class;
+};
+
+GType gst_ring_sink_get_type (void);
+
+G_END_DECLS
+#endif //__GST_RING_SINK_H__
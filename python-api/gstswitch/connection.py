@@ -529,3 +529,720 @@ class Connection(object):
             message = error.message
             new_message = "{0}: {1}".format(message, "mark_tracking")
             raise ConnectionError(new_message)
+
+    def add_encoded_output(self, codec, preset, bitrate):
+        """add_encoded_output(in  s codec,
+                           in  s preset,
+                           in  u bitrate,
+                           out i port);
+        Calls add_encoded_output remotely
+
+        :param codec: 'h264' or 'vp8'
+        :param preset: x264 speed preset, ignored for vp8
+        :param bitrate: target bitrate in kbit/s, 0 for the default
+        :returns: tuple with first element the port, 0 on failure
+        """
+        try:
+            args = GLib.Variant('(ssu)', (codec, preset, bitrate))
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'add_encoded_output',
+                args,
+                GLib.VariantType.new("(i)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "add_encoded_output")
+            raise ConnectionError(new_message)
+
+    def remove_encoded_output(self, port):
+        """remove_encoded_output(in  i port,
+                              out b result);
+        Calls remove_encoded_output remotely
+
+        :param port: the port of the encoded output
+        :returns: tuple with first element True if removed
+        """
+        try:
+            args = GLib.Variant('(i)', (port,))
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'remove_encoded_output',
+                args,
+                GLib.VariantType.new("(b)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "remove_encoded_output")
+            raise ConnectionError(new_message)
+
+    def get_encoded_outputs(self):
+        """get_encoded_outputs(out s outputs);
+        Calls get_encoded_outputs remotely
+
+        :param: None
+        :returns: tuple with first element the printed a(issuuxxu)
+        """
+        try:
+            args = None
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_encoded_outputs',
+                args,
+                GLib.VariantType.new("(s)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_encoded_outputs")
+            raise ConnectionError(new_message)
+
+    def get_preview_thumbnail(self, port, width, height, rate, jpeg):
+        """get_preview_thumbnail(in  i port,
+                              in  i width,
+                              in  i height,
+                              in  i rate,
+                              in  b jpeg,
+                              out i thumbnail_port);
+        Calls get_preview_thumbnail remotely
+
+        :param port: the preview port to take the thumbnail of
+        :param width: thumbnail width, 0 to keep the aspect ratio
+        :param height: thumbnail height, 0 to keep the aspect ratio
+        :param rate: frames per second, 0 for the input rate
+        :param jpeg: True to serve JPEG frames instead of raw
+        :returns: tuple with first element the thumbnail port, 0 on failure
+        """
+        try:
+            args = GLib.Variant('(iiiib)', (port, width, height, rate, jpeg))
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_preview_thumbnail',
+                args,
+                GLib.VariantType.new("(i)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_preview_thumbnail")
+            raise ConnectionError(new_message)
+
+    def set_multiview(self, width, height, columns, jpeg):
+        """set_multiview(in  i width,
+                      in  i height,
+                      in  i columns,
+                      in  b jpeg,
+                      out i port);
+        Calls set_multiview remotely
+
+        :param width: multiview width, 0 to remove the multiview
+        :param height: multiview height, 0 to keep the aspect ratio
+        :param columns: tile columns, 0 for a square grid
+        :param jpeg: True to serve JPEG frames instead of raw
+        :returns: tuple with first element the multiview port, 0 if none
+        """
+        try:
+            args = GLib.Variant('(iiib)', (width, height, columns, jpeg))
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'set_multiview',
+                args,
+                GLib.VariantType.new("(i)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "set_multiview")
+            raise ConnectionError(new_message)
+
+    def get_multiview_port(self):
+        """get_multiview_port(out i port);
+        Calls get_multiview_port remotely
+
+        :param: None
+        :returns: tuple with first element the multiview port, 0 if none
+        """
+        try:
+            args = None
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_multiview_port',
+                args,
+                GLib.VariantType.new("(i)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_multiview_port")
+            raise ConnectionError(new_message)
+
+    def get_branch_stats(self):
+        """get_branch_stats(out s stats);
+        Calls get_branch_stats remotely
+
+        :param: None
+        :returns: tuple with first element the statistics string
+        """
+        try:
+            args = None
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_branch_stats',
+                args,
+                GLib.VariantType.new("(s)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_branch_stats")
+            raise ConnectionError(new_message)
+
+    def get_client_stats(self):
+        """get_client_stats() -> (s)
+        Calls get_client_stats remotely
+
+        :param: None
+        :returns: tuple with a string of the client statistics
+        """
+        try:
+            args = None
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_client_stats',
+                args,
+                GLib.VariantType.new("(s)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_client_stats")
+            raise ConnectionError(new_message)
+
+    def get_record_stats(self):
+        """get_record_stats() -> (s)
+        Calls get_record_stats remotely
+
+        :param: None
+        :returns: tuple with a string of the recorder statistics
+        """
+        try:
+            args = None
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_record_stats',
+                args,
+                GLib.VariantType.new("(s)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_record_stats")
+            raise ConnectionError(new_message)
+
+    def get_iso_stats(self):
+        """get_iso_stats() -> (s)
+        Calls get_iso_stats remotely
+
+        :param: None
+        :returns: tuple with a string of the input recording statistics
+        """
+        try:
+            args = None
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_iso_stats',
+                args,
+                GLib.VariantType.new("(s)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_iso_stats")
+            raise ConnectionError(new_message)
+
+    def replay_mark_in(self, port):
+        """replay_mark_in(in  i port,
+                       out b result);
+        Calls replay_mark_in remotely
+
+        :param port: the input port, or the compose port for the program
+        :returns: tuple with first element True if marked
+        """
+        try:
+            args = GLib.Variant('(i)', (port,))
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'replay_mark_in',
+                args,
+                GLib.VariantType.new("(b)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "replay_mark_in")
+            raise ConnectionError(new_message)
+
+    def replay_mark_out(self, port):
+        """replay_mark_out(in  i port,
+                        out b result);
+        Calls replay_mark_out remotely
+
+        :param port: the input port, or the compose port for the program
+        :returns: tuple with first element True if marked
+        """
+        try:
+            args = GLib.Variant('(i)', (port,))
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'replay_mark_out',
+                args,
+                GLib.VariantType.new("(b)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "replay_mark_out")
+            raise ConnectionError(new_message)
+
+    def replay_play(self, port, speed):
+        """replay_play(in  i port,
+                    in  d speed,
+                    out i replay);
+        Calls replay_play remotely
+
+        :param port: the input port, or the compose port for the program
+        :param speed: the playback speed, below 1 for slow motion
+        :returns: tuple with first element the replay port, 0 on failure
+        """
+        try:
+            args = GLib.Variant('(id)', (port, speed))
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'replay_play',
+                args,
+                GLib.VariantType.new("(i)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "replay_play")
+            raise ConnectionError(new_message)
+
+    def replay_stop(self, port):
+        """replay_stop(in  i port,
+                    out b result);
+        Calls replay_stop remotely
+
+        :param port: the port of the replay
+        :returns: tuple with first element True if stopped
+        """
+        try:
+            args = GLib.Variant('(i)', (port,))
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'replay_stop',
+                args,
+                GLib.VariantType.new("(b)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "replay_stop")
+            raise ConnectionError(new_message)
+
+    def get_replay_stats(self):
+        """get_replay_stats() -> (s)
+        Calls get_replay_stats remotely
+
+        :param: None
+        :returns: tuple with a string of the replay ring statistics
+        """
+        try:
+            args = None
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_replay_stats',
+                args,
+                GLib.VariantType.new("(s)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_replay_stats")
+            raise ConnectionError(new_message)
+
+    def set_audio_mix(self, port, gain, mute, pan):
+        """set_audio_mix(in  i port,
+                      in  d gain,
+                      in  b mute,
+                      in  d pan,
+                      out b result);
+        Calls set_audio_mix remotely
+
+        :param port: the audio input port
+        :param gain: the linear gain, 1.0 for unity
+        :param mute: True to leave the input out of the mix
+        :param pan: -1.0 left to 1.0 right
+        :returns: tuple with first element True if the input is mixed
+        """
+        try:
+            args = GLib.Variant('(idbd)', (port, gain, mute, pan))
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'set_audio_mix',
+                args,
+                GLib.VariantType.new("(b)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "set_audio_mix")
+            raise ConnectionError(new_message)
+
+    def get_audio_mix(self):
+        """get_audio_mix() -> (s)
+        Calls get_audio_mix remotely
+
+        :param: None
+        :returns: tuple with a string of the audio input mix settings
+        """
+        try:
+            args = None
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_audio_mix',
+                args,
+                GLib.VariantType.new("(s)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_audio_mix")
+            raise ConnectionError(new_message)
+
+    def get_audio_levels(self):
+        """get_audio_levels() -> (s)
+        Calls get_audio_levels remotely
+
+        :param: None
+        :returns: tuple with a string of the latest audio levels
+        """
+        try:
+            args = None
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_audio_levels',
+                args,
+                GLib.VariantType.new("(s)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_audio_levels")
+            raise ConnectionError(new_message)
+
+    def set_av_offset(self, port, offset):
+        """set_av_offset(in  i port,
+                      in  x offset,
+                      out b result);
+        Calls set_av_offset remotely
+
+        :param port: the video or audio input port
+        :param offset: the delay in usec
+        :returns: tuple with first element True if the delay is applied
+        """
+        try:
+            args = GLib.Variant('(ix)', (port, offset))
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'set_av_offset',
+                args,
+                GLib.VariantType.new("(b)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "set_av_offset")
+            raise ConnectionError(new_message)
+
+    def get_av_offsets(self):
+        """get_av_offsets() -> (s)
+        Calls get_av_offsets remotely
+
+        :param: None
+        :returns: tuple with a string of the input delays
+        """
+        try:
+            args = None
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_av_offsets',
+                args,
+                GLib.VariantType.new("(s)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_av_offsets")
+            raise ConnectionError(new_message)
+
+    def pair_audio(self, video_port, audio_port):
+        """pair_audio(in  i video_port,
+                   in  i audio_port,
+                   out b result);
+        Calls pair_audio remotely
+
+        :param video_port: the video input port
+        :param audio_port: the audio input port, 0 to unpair
+        :returns: tuple with first element True if paired
+        """
+        try:
+            args = GLib.Variant('(ii)', (video_port, audio_port))
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'pair_audio',
+                args,
+                GLib.VariantType.new("(b)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "pair_audio")
+            raise ConnectionError(new_message)
+
+    def get_audio_latency(self):
+        """get_audio_latency() -> (s)
+        Calls get_audio_latency remotely
+
+        :param: None
+        :returns: tuple with a string of the audio latencies
+        """
+        try:
+            args = None
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_audio_latency',
+                args,
+                GLib.VariantType.new("(s)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_audio_latency")
+            raise ConnectionError(new_message)
+
+    def get_loudness(self):
+        """get_loudness() -> (s)
+        Calls get_loudness remotely
+
+        :param: None
+        :returns: tuple with a string of the program loudness
+        """
+        try:
+            args = None
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_loudness',
+                args,
+                GLib.VariantType.new("(s)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_loudness")
+            raise ConnectionError(new_message)
+
+    def get_watchdog_stats(self):
+        """get_watchdog_stats() -> (s)
+        Calls get_watchdog_stats remotely
+
+        :param: None
+        :returns: tuple with a string of the pipeline watchdog statistics
+        """
+        try:
+            args = None
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_watchdog_stats',
+                args,
+                GLib.VariantType.new("(s)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_watchdog_stats")
+            raise ConnectionError(new_message)
+
+    def get_stats(self):
+        """get_stats() -> (s)
+        Calls get_stats remotely
+
+        :param: None
+        :returns: tuple with a string of the pipeline counters
+        """
+        try:
+            args = None
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_stats',
+                args,
+                GLib.VariantType.new("(s)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_stats")
+            raise ConnectionError(new_message)
+
+    def get_latency(self):
+        """get_latency() -> (s)
+        Calls get_latency remotely
+
+        :param: None
+        :returns: tuple with a string of the measured latencies
+        """
+        try:
+            args = None
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_latency',
+                args,
+                GLib.VariantType.new("(s)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_latency")
+            raise ConnectionError(new_message)
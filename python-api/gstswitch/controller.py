@@ -56,6 +56,8 @@ class Controller(object):
         self.callbacks_show_face_marker = []
         self.callbacks_show_track_marker = []
         self.callbacks_select_face = []
+        self.callbacks_audio_levels = []
+        self.callbacks_stats = []
 
     @property
     def address(self):
@@ -415,6 +417,524 @@ class Controller(object):
         self.establish_connection()
         self.connection.mark_tracking(faces)
 
+    def add_encoded_output(self, codec, preset, bitrate):
+        """Add an encoded output of the composite, encoded once and served
+        to any number of clients
+
+        :param codec: 'h264' or 'vp8'
+        :param preset: x264 speed preset, ignored for vp8
+        :param bitrate: target bitrate in kbit/s, 0 for the default
+        :returns: the port the output is served on, 0 on failure
+        """
+        self.establish_connection()
+        conn = self.connection.add_encoded_output(codec, preset, bitrate)
+        try:
+            res = conn.unpack()[0]
+            return res
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+
+    def remove_encoded_output(self, port):
+        """Remove an encoded output, dropping its clients
+
+        :param port: the port of the encoded output
+        :returns: True if the output was removed
+        """
+        self.establish_connection()
+        conn = self.connection.remove_encoded_output(port)
+        try:
+            res = conn.unpack()[0]
+            return res
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+
+    def get_encoded_outputs(self):
+        """Get the encoded outputs with their statistics
+
+        :param: None
+        :returns: list of tuples (port, codec, preset, bitrate,
+                  measured bitrate, latency usec, max latency usec,
+                  clients)
+        """
+        self.establish_connection()
+        conn = self.connection.get_encoded_outputs()
+        try:
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        try:
+            return ast.literal_eval(res)
+        except (ValueError, SyntaxError):
+            raise ConnectionReturnError(("Connection returned "
+                                         "invalid values:{0}")
+                                        .format(res))
+
+    def get_preview_thumbnail(self, port, width, height, rate, jpeg):
+        """Get a downscaled, optionally decimated and JPEG compressed
+        thumbnail of a preview port
+
+        :param port: the preview port
+        :param width: thumbnail width, 0 to keep the aspect ratio
+        :param height: thumbnail height, 0 to keep the aspect ratio
+        :param rate: frames per second, 0 for the input rate
+        :param jpeg: True to serve JPEG frames instead of raw
+        :returns: the port the thumbnail is served on, 0 on failure
+        """
+        self.establish_connection()
+        conn = self.connection.get_preview_thumbnail(port, width, height,
+                                                     rate, jpeg)
+        try:
+            res = conn.unpack()[0]
+            return res
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+
+    def set_multiview(self, width, height, columns, jpeg):
+        """Set up the server rendered multiview, tiling all inputs with
+        labels and tally borders into a single stream
+
+        :param width: multiview width, 0 to remove the multiview
+        :param height: multiview height, 0 to keep the aspect ratio
+        :param columns: tile columns, 0 for a square grid
+        :param jpeg: True to serve JPEG frames instead of raw
+        :returns: the port the multiview is served on, 0 if none
+        """
+        self.establish_connection()
+        conn = self.connection.set_multiview(width, height, columns, jpeg)
+        try:
+            res = conn.unpack()[0]
+            return res
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+
+    def get_multiview_port(self):
+        """Get the port the multiview is served on
+
+        :param: None
+        :returns: the multiview port, 0 if there is no multiview
+        """
+        self.establish_connection()
+        conn = self.connection.get_multiview_port()
+        try:
+            res = conn.unpack()[0]
+            return res
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+
+    def get_branch_stats(self):
+        """Get the demand statistics of the preview branches
+
+        :param: None
+        :returns: list of tuples (port, case type, clients, buffers
+                  dropped while idle, idle usec, usec per buffer,
+                  estimated usec saved)
+        """
+        self.establish_connection()
+        conn = self.connection.get_branch_stats()
+        try:
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        try:
+            return ast.literal_eval(res)
+        except (ValueError, SyntaxError):
+            raise ConnectionReturnError(("Connection returned "
+                                         "invalid values:{0}")
+                                        .format(res))
+
+    def get_client_stats(self):
+        """Get the statistics of every client of every serving point
+
+        :param: None
+        :returns: list of tuples (port, client socket, lag usec, buffers
+                  dropped, bytes sent, throughput bit/s)
+        """
+        self.establish_connection()
+        conn = self.connection.get_client_stats()
+        try:
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        try:
+            return ast.literal_eval(res)
+        except (ValueError, SyntaxError):
+            raise ConnectionReturnError(("Connection returned "
+                                         "invalid values:{0}")
+                                        .format(res))
+
+    def get_record_stats(self):
+        """Get the recorder statistics
+
+        :param: None
+        :returns: tuple (file being written, files written, frames
+                  written, frames lost by the last rollover, frames
+                  lost in total, codec, frames/s achieved by the
+                  encoder, frames/s required, disk buffer fill %,
+                  highest disk buffer fill %, bytes/s written to
+                  disk, frames dropped on a full disk buffer)
+        """
+        self.establish_connection()
+        conn = self.connection.get_record_stats()
+        try:
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        try:
+            return ast.literal_eval(res)
+        except (ValueError, SyntaxError):
+            raise ConnectionReturnError(("Connection returned "
+                                         "invalid values:{0}")
+                                        .format(res))
+
+    def get_iso_stats(self):
+        """Get the input recordings with their costs
+
+        :param: None
+        :returns: list of tuples (input port, 'video' or 'audio', file
+                  being written, frames written, bytes written, encoder
+                  CPU % of one core, bytes/s written, usec waited for
+                  an encode slot)
+        """
+        self.establish_connection()
+        conn = self.connection.get_iso_stats()
+        try:
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        try:
+            return ast.literal_eval(res)
+        except (ValueError, SyntaxError):
+            raise ConnectionReturnError(("Connection returned "
+                                         "invalid values:{0}")
+                                        .format(res))
+
+    def replay_mark_in(self, port):
+        """Mark the start of an instant replay clip, now
+
+        :param port: the input port, or the compose port for the program
+        :returns: True if marked, False if the port keeps no replays
+        """
+        self.establish_connection()
+        conn = self.connection.replay_mark_in(port)
+        try:
+            res = conn.unpack()[0]
+            return res
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+
+    def replay_mark_out(self, port):
+        """Mark the end of an instant replay clip, now
+
+        :param port: the input port, or the compose port for the program
+        :returns: True if marked, False without a ring or an in point
+        """
+        self.establish_connection()
+        conn = self.connection.replay_mark_out(port)
+        try:
+            res = conn.unpack()[0]
+            return res
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+
+    def replay_play(self, port, speed=1.0):
+        """Play the marked clip back over and over as a new video input,
+        which can be switched to like any other
+
+        :param port: the input port, or the compose port for the program
+        :param speed: the playback speed, below 1 for slow motion
+        :returns: the port of the replay input, 0 on failure
+        """
+        self.establish_connection()
+        conn = self.connection.replay_play(port, float(speed))
+        try:
+            res = conn.unpack()[0]
+            return res
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+
+    def replay_stop(self, port):
+        """Stop playing a replay, ending its input
+
+        :param port: the port of the replay input
+        :returns: True if the replay was stopped
+        """
+        self.establish_connection()
+        conn = self.connection.replay_stop(port)
+        try:
+            res = conn.unpack()[0]
+            return res
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+
+    def get_replay_stats(self):
+        """Get the instant replay rings with their memory use
+
+        :param: None
+        :returns: list of tuples (input or compose port, 'input' or
+                  'program', seconds held, frames held, bytes held,
+                  bytes per second of ring, usec since the in point,
+                  usec since the out point, -1 when not marked)
+        """
+        self.establish_connection()
+        conn = self.connection.get_replay_stats()
+        try:
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        try:
+            return ast.literal_eval(res)
+        except (ValueError, SyntaxError):
+            raise ConnectionReturnError(("Connection returned "
+                                         "invalid values:{0}")
+                                        .format(res))
+
+    def set_audio_mix(self, port, gain=1.0, mute=False, pan=0.0):
+        """Change how an audio input is mixed, needs the server to run
+        with --audio-mix. The change is ramped in smoothly.
+
+        :param port: the audio input port
+        :param gain: the linear gain, 1.0 for unity, up to 10.0
+        :param mute: True to leave the input out of the mix
+        :param pan: -1.0 left to 1.0 right
+        :returns: True if the input is mixed
+        """
+        self.establish_connection()
+        conn = self.connection.set_audio_mix(port, float(gain), bool(mute),
+                                             float(pan))
+        try:
+            res = conn.unpack()[0]
+            return res
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+
+    def get_audio_mix(self):
+        """Get how every audio input is mixed
+
+        :param: None
+        :returns: list of tuples (audio input port, gain, mute, pan),
+                  empty when the server is not mixing, mute is a bool
+        """
+        self.establish_connection()
+        conn = self.connection.get_audio_mix()
+        try:
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        try:
+            # the server sends the mute as 1 or 0
+            return [(port, gain, bool(mute), pan)
+                    for port, gain, mute, pan in ast.literal_eval(res)]
+        except (ValueError, SyntaxError, TypeError):
+            raise ConnectionReturnError(("Connection returned "
+                                         "invalid values:{0}")
+                                        .format(res))
+
+    def get_audio_levels(self):
+        """Get the latest audio levels, as also sent by the audio_levels
+        Signal
+
+        :param: None
+        :returns: list of tuples (audio input port, 0 for the program,
+                  RMS, peak and decaying peak of the loudest channel
+                  in dB)
+        """
+        self.establish_connection()
+        conn = self.connection.get_audio_levels()
+        try:
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        try:
+            return ast.literal_eval(res)
+        except (ValueError, SyntaxError):
+            raise ConnectionReturnError(("Connection returned "
+                                         "invalid values:{0}")
+                                        .format(res))
+
+    def set_av_offset(self, port, offset):
+        """Delay an input to bring it in sync with the others, audio is
+        delayed by whole samples
+
+        :param port: the video or audio input port
+        :param offset: the delay in usec, up to one second
+        :returns: True if the delay is applied
+        """
+        self.establish_connection()
+        conn = self.connection.set_av_offset(port, int(offset))
+        try:
+            res = conn.unpack()[0]
+            return res
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+
+    def get_av_offsets(self):
+        """Get the delays of all inputs
+
+        :param: None
+        :returns: list of tuples (input port, delay in usec)
+        """
+        self.establish_connection()
+        conn = self.connection.get_av_offsets()
+        try:
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        try:
+            return ast.literal_eval(res)
+        except (ValueError, SyntaxError):
+            raise ConnectionReturnError(("Connection returned "
+                                         "invalid values:{0}")
+                                        .format(res))
+
+    def pair_audio(self, video_port, audio_port):
+        """Pair an audio input with a video input, needs the server to run
+        with --audio-follow-video. The mix is crossfaded to the audio when
+        its video is switched to channel A.
+
+        :param video_port: the video input port
+        :param audio_port: the audio input port, 0 to unpair
+        :returns: True if paired
+        """
+        self.establish_connection()
+        conn = self.connection.pair_audio(video_port, audio_port)
+        try:
+            res = conn.unpack()[0]
+            return res
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+
+    def get_audio_latency(self):
+        """Get the latency of every audio input, as reported by the
+        pipelines on the way
+
+        :param: None
+        :returns: list of tuples (audio input port, latency to its monitor
+                  output, latency to the program audio), in usec, -1 where
+                  unknown
+        """
+        self.establish_connection()
+        conn = self.connection.get_audio_latency()
+        try:
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        try:
+            return ast.literal_eval(res)
+        except (ValueError, SyntaxError):
+            raise ConnectionReturnError(("Connection returned "
+                                         "invalid values:{0}")
+                                        .format(res))
+
+    def get_loudness(self):
+        """Get the EBU R 128 loudness of the program audio
+
+        :param: None
+        :returns: tuple (momentary, short-term, integrated loudness in LUFS,
+                  true-peak in dBTP), the integrated loudness and true-peak
+                  of the recording being written
+        """
+        self.establish_connection()
+        conn = self.connection.get_loudness()
+        try:
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        try:
+            return ast.literal_eval(res)
+        except (ValueError, SyntaxError):
+            raise ConnectionReturnError(("Connection returned "
+                                         "invalid values:{0}")
+                                        .format(res))
+
+    def get_watchdog_stats(self):
+        """Get what the pipeline watchdog has done
+
+        :param: None
+        :returns: tuple (stalls, restarts, recoveries, mean time to recover
+                  in usec) since the server started
+        """
+        self.establish_connection()
+        conn = self.connection.get_watchdog_stats()
+        try:
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        try:
+            return ast.literal_eval(res)
+        except (ValueError, SyntaxError):
+            raise ConnectionReturnError(("Connection returned "
+                                         "invalid values:{0}")
+                                        .format(res))
+
+    def get_stats(self):
+        """Get the counters of the elements of every pipeline, as also sent
+        by the stats Signal
+
+        :param: None
+        :returns: list of tuples (worker, elements), elements being a list
+                  of tuples (name, buffers, bytes, dropped, repeated,
+                  queued, processing time in usec or -1)
+        """
+        self.establish_connection()
+        conn = self.connection.get_stats()
+        try:
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        try:
+            return ast.literal_eval(res)
+        except (ValueError, SyntaxError):
+            raise ConnectionReturnError(("Connection returned "
+                                         "invalid values:{0}")
+                                        .format(res))
+
+    def get_latency(self):
+        """Get the glass to glass latency of the inputs stamped by
+        latencystamp, measured with --measure-latency
+
+        :param: None
+        :returns: list of tuples (path, frames, detected, p50, p99, p999),
+                  the percentiles in usec or -1 while nothing was detected
+        """
+        self.establish_connection()
+        conn = self.connection.get_latency()
+        try:
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        try:
+            return ast.literal_eval(res)
+        except (ValueError, SyntaxError):
+            raise ConnectionReturnError(("Connection returned "
+                                         "invalid values:{0}")
+                                        .format(res))
+
     @classmethod
     def parse_preview_ports(cls, res):
         """Parses the preview_ports string"""
@@ -533,3 +1053,34 @@ class Controller(object):
             raise ValueError('Provided argument callback is not callable')
 
         self.callbacks_select_face.append(callback)
+
+    def on_audio_levels(self, callback):
+        """Register a Callback for the audio_levels Signal
+        which is fired every --meter-interval while audio is metered.
+
+        The Callback takes the following Argument:
+            array levels  - An Array of Tuples (port, rms, peak, decay),
+                            the audio input port, 0 for the program, and
+                            the levels of its loudest channel in dB
+        """
+
+        if not callable(callback):
+            raise ValueError('Provided argument callback is not callable')
+
+        self.callbacks_audio_levels.append(callback)
+
+    def on_stats(self, callback):
+        """Register a Callback for the stats Signal
+        which is fired every --stats-interval.
+
+        The Callback takes the following Argument:
+            array stats  - An Array of Tuples (worker, elements), elements
+                           being an Array of Tuples (name, buffers, bytes,
+                           dropped, repeated, queued, processing time in
+                           usec or -1) of each element of the pipeline
+        """
+
+        if not callable(callback):
+            raise ValueError('Provided argument callback is not callable')
+
+        self.callbacks_stats.append(callback)
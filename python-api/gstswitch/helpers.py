@@ -110,7 +110,8 @@ class TestSources(object):
                        height=200,
                        pattern=None,
                        timeoverlay=False,
-                       clockoverlay=False):
+                       clockoverlay=False,
+                       timestamp=False):
         """Start a new test video
         :param port: The port of where the TCP stream will be sent
         Should be same as video port of gst-switch-src
@@ -119,6 +120,7 @@ class TestSources(object):
         :param pattern: The videotestsrc pattern of the output video
         :param timeoverlay: True to enable a running time over video
         :param clockoverlay: True to enable current clock time over video
+        :param timestamp: True to paint the capture time as a barcode
         """
         testsrc = testsource.VideoSrc(
             self.video_port,
@@ -126,7 +128,8 @@ class TestSources(object):
             height,
             pattern,
             timeoverlay,
-            clockoverlay)
+            clockoverlay,
+            timestamp)
         testsrc.run()
         self._running_tests_video.append(testsrc)
 
@@ -66,6 +66,8 @@ class VideoPipeline(BasePipeline):
     :param pattern: The videotestsrc pattern of the output video
     :param timeoverlay: True to enable a running time over video
     :param clockoverlay: True to enable current clock time over video
+    :param timestamp: True to paint the capture time as a barcode, which
+    gst-switch-srv --measure-latency decodes
     """
 
     VIDEO_CAPS = """
@@ -83,7 +85,8 @@ video/x-raw,
             height=200,
             pattern=None,
             timeoverlay=False,
-            clockoverlay=False):
+            clockoverlay=False,
+            timestamp=False):
         super(VideoPipeline, self).__init__()
 
         self.host = host
@@ -95,6 +98,12 @@ video/x-raw,
         src.link(vfilter)
         gdppay = self.make_gdppay()
         self.add(gdppay)
+        head = gdppay
+        if timestamp:
+            # last, so the overlays never cover the barcode
+            head = self.make_latencystamp()
+            self.add(head)
+            head.link(gdppay)
         if timeoverlay:
             _timeoverlay = self.make_timeoverlay()
         if clockoverlay:
@@ -104,17 +113,17 @@ video/x-raw,
             self.add(_clockoverlay)
             vfilter.link(_timeoverlay)
             _timeoverlay.link(_clockoverlay)
-            _clockoverlay.link(gdppay)
+            _clockoverlay.link(head)
         elif timeoverlay:
             self.add(_timeoverlay)
             vfilter.link(_timeoverlay)
-            _timeoverlay.link(gdppay)
+            _timeoverlay.link(head)
         elif clockoverlay:
             self.add(_clockoverlay)
             vfilter.link(_clockoverlay)
-            _clockoverlay.link(gdppay)
+            _clockoverlay.link(head)
         else:
-            vfilter.link(gdppay)
+            vfilter.link(head)
 
         sink = self.make_tcpclientsink(port)
         self.add(sink)
@@ -167,6 +176,13 @@ video/x-raw,
         element.set_property('font-desc', "Verdana bold 50")
         return element
 
+    def make_latencystamp(self):
+        """Return a latencystamp element
+        :returns: A latencystamp element
+        """
+        element = self.make('latencystamp', 'latencystamp')
+        return element
+
     def make_tcpclientsink(self, port):
         """Return a TCP client sink element
         :port: Port to sink
@@ -330,6 +346,7 @@ class VideoSrc(object):
     None for random
     :param timeoverlay: True to enable a running time over video
     :param clockoverlay: True to enable current clock time over video
+    :param timestamp: True to paint the capture time as a barcode
     """
     HOST = '127.0.0.1'
 
@@ -340,7 +357,8 @@ class VideoSrc(object):
             height=200,
             pattern=None,
             timeoverlay=False,
-            clockoverlay=False):
+            clockoverlay=False,
+            timestamp=False):
         super(VideoSrc, self).__init__()
         self._port = None
         self._width = None
@@ -348,6 +366,7 @@ class VideoSrc(object):
         self._pattern = None
         self._timeoverlay = None
         self._clockoverlay = None
+        self._timestamp = None
 
         self.port = port
         self.width = width
@@ -355,6 +374,7 @@ class VideoSrc(object):
         self.pattern = self.generate_pattern(pattern)
         self.timeoverlay = timeoverlay
         self.clockoverlay = clockoverlay
+        self.timestamp = timestamp
         self.pipeline = VideoPipeline(
             self.port,
             self.HOST,
@@ -362,7 +382,8 @@ class VideoSrc(object):
             self.height,
             self.pattern,
             self.timeoverlay,
-            self.clockoverlay)
+            self.clockoverlay,
+            self.timestamp)
 
     @property
     def port(self):
@@ -497,6 +518,23 @@ class VideoSrc(object):
             raise ValueError("Clockoverlay: '{0}' must be True of False"
                              .format(clockoverlay))
 
+    @property
+    def timestamp(self):
+        """Get the timestamp"""
+        return self._timestamp
+
+    @timestamp.setter
+    def timestamp(self, timestamp):
+        """Set the timestamp
+        :raises ValueError: Timestamp must be True or False
+        """
+        stamp = str(timestamp)
+        if stamp == 'True' or stamp == 'False':
+            self._timestamp = timestamp
+        else:
+            raise ValueError("Timestamp: '{0}' must be True of False"
+                             .format(timestamp))
+
     def run(self):
         """Run the pipeline"""
         self.pipeline.play()
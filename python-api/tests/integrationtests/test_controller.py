@@ -10,8 +10,18 @@ import pytest
 import time
 import datetime
 import subprocess
-
-from gi.repository import GLib
+import socket
+import threading
+import array
+try:
+    from urllib.request import urlopen
+    from urllib.error import HTTPError
+except ImportError:
+    from urllib2 import urlopen, HTTPError
+
+import gi
+gi.require_version('Gst', '1.0')
+from gi.repository import GLib, Gst
 from mock import Mock
 from integrationtests.compare import CompareVideo
 
@@ -291,6 +301,79 @@ class TestSignals(object):
         finally:
             serv.terminate_and_output_status(cov=True)
 
+    def test_on_audio_levels(self):
+        """Create a Controller object, add an audio source and check that
+        its levels and the program levels are published
+        """
+        serv = Server(path=PATH, video_port=3000, audio_port=4000)
+        try:
+            serv.run('--meter-interval=50')
+
+            controller = Controller()
+            controller.establish_connection()
+
+            test_cb = Mock(side_effect=lambda levels:
+                           self.quit_mainloop_after(5))
+            controller.on_audio_levels(test_cb)
+
+            sources = TestSources(video_port=3000, audio_port=4000)
+            sources.new_test_audio()
+
+            GLib.timeout_add_seconds(5, self.quit_mainloop)
+            self.run_mainloop()
+            polled = controller.get_audio_levels()
+
+            sources.terminate_audio()
+            serv.terminate(1)
+            assert test_cb.call_count >= 5
+            levels = test_cb.call_args[0][0]
+            assert 0 in [l[0] for l in levels]
+            for _, rms, peak, decay in levels:
+                assert -90.0 <= rms <= peak <= 0.0
+                assert decay >= peak
+            assert [l[0] for l in polled] == [l[0] for l in levels]
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
+    def test_on_stats(self):
+        """Create a Controller object, add a video source and check that
+        the counters of the pipelines are published and move
+        """
+        serv = Server(path=PATH, video_port=3000)
+        try:
+            serv.run('--stats-interval=200')
+
+            controller = Controller()
+            controller.establish_connection()
+
+            test_cb = Mock(side_effect=lambda stats:
+                           self.quit_mainloop_after(10))
+            controller.on_stats(test_cb)
+
+            sources = TestSources(video_port=3000)
+            sources.new_test_video()
+
+            GLib.timeout_add_seconds(5, self.quit_mainloop)
+            self.run_mainloop()
+            polled = dict(controller.get_stats())
+
+            sources.terminate_video()
+            serv.terminate(1)
+            assert test_cb.call_count >= 10
+            first = dict(test_cb.call_args_list[0][0][0])
+            last = dict(test_cb.call_args[0][0])
+            assert 'composite' in polled
+
+            def buffers(stats):
+                """The buffers out of the composite pipeline"""
+                return sum(e[1] for e in stats['composite'])
+            assert buffers(first) < buffers(last) <= buffers(polled)
+            for _, elements in polled.items():
+                for _, _, _, _, _, _, time in elements:
+                    assert time >= -1
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
 
 class VideoFileSink(object):
 
@@ -438,6 +521,197 @@ class TestNewRecord(object):
             finally:
                 serv.terminate_and_output_status(cov=True)
 
+    def test_new_record_rollover(self):
+        """Test new_record rolls over without losing frames"""
+        serv = Server(path=PATH, record_file="rollover-%Y.data",
+                      video_format="debug")
+        try:
+            serv.run()
+            sources = TestSources(video_port=3000)
+            sources.new_test_video()
+            time.sleep(2)
+
+            controller = Controller()
+            for _ in range(3):
+                assert controller.new_record() is True
+                time.sleep(1)
+            location, files, frames, last_gap, total_gap = \
+                controller.get_record_stats()[:5]
+            print(location, files, frames, last_gap, total_gap)
+
+            sources.terminate_video()
+            serv.terminate(1)
+            assert files == 4
+            assert frames > 0
+            assert last_gap == 0
+            assert total_gap == 0
+            assert os.path.exists(location) is True
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
+    def test_record_max_time(self):
+        """Test recording files are cut by duration"""
+        serv = Server(path=PATH, record_file="segment-%Y.data",
+                      video_format="debug")
+        try:
+            serv.run('--record-max-time=1')
+            sources = TestSources(video_port=3000)
+            sources.new_test_video()
+            time.sleep(5)
+
+            stats = Controller().get_record_stats()
+            print(stats)
+
+            sources.terminate_video()
+            serv.terminate(1)
+            assert stats[1] >= 3
+            assert stats[4] == 0
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
+    def test_record_codecs(self):
+        """Test the recording codecs keep up with the composite"""
+        for codec in ['mjpeg', 'h264', 'ffv1', 'raw']:
+            serv = Server(path=PATH, record_file="codec-%Y.data",
+                          video_format="debug")
+            try:
+                serv.run('--record-codec={0}'.format(codec))
+                sources = TestSources(video_port=3000)
+                sources.new_test_video()
+                time.sleep(4)
+
+                stats = Controller().get_record_stats()
+                print(stats)
+
+                sources.terminate_video()
+                serv.terminate(1)
+                assert stats[5] == codec
+                assert stats[7] > 0
+                assert stats[6] > 0.9 * stats[7]
+            finally:
+                serv.terminate_and_output_status(cov=True)
+
+    def test_record_disk_buffer(self):
+        """Test the recording is written behind through the disk buffer"""
+        serv = Server(path=PATH, record_file="buffer-%Y.data",
+                      video_format="debug")
+        try:
+            serv.run('--record-buffer=16')
+            sources = TestSources(video_port=3000)
+            sources.new_test_video()
+            time.sleep(4)
+
+            stats = Controller().get_record_stats()
+            print(stats)
+
+            sources.terminate_video()
+            serv.terminate(1)
+            assert stats[10] > 0
+            assert stats[9] < 75
+            assert stats[11] == 0
+            assert os.path.getsize(stats[0]) > 0
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
+    def test_record_index(self):
+        """Test a recording cut short is made seekable from its index"""
+        serv = Server(path=PATH, record_file="index-%Y.data",
+                      video_format="debug")
+        try:
+            serv.run()
+            sources = TestSources(video_port=3000)
+            sources.new_test_video()
+            sources.new_test_video()
+            time.sleep(3)
+
+            controller = Controller()
+            closed = controller.get_record_stats()[0]
+            assert controller.new_record() is True
+            time.sleep(1)
+            controller.set_composite_mode(Controller.COMPOSITE_PIP)
+            time.sleep(3)
+            location = controller.get_record_stats()[0]
+
+            # Lose the open recording as in a crash
+            serv.kill()
+            sources.terminate_video()
+            time.sleep(2)
+
+            reindex = os.path.join(PATH, 'gst-switch-reindex')
+            for name in [closed, location]:
+                assert os.path.exists(name + '.idx') is True
+                out = subprocess.check_output([reindex, name])
+                print(out)
+                assert b'repaired' in out or b'already seekable' in out
+            out = subprocess.check_output([reindex, closed])
+            assert b'already seekable' in out
+            out = subprocess.check_output([reindex, location])
+            assert b'already seekable' in out
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
+    def test_record_iso(self):
+        """Test every input is recorded into its own file"""
+        serv = Server(path=PATH, record_file="iso-%Y.data",
+                      video_format="debug")
+        try:
+            serv.run('--record-iso')
+            sources = TestSources(video_port=3000)
+            sources.new_test_video()
+            sources.new_test_video()
+            time.sleep(4)
+
+            controller = Controller()
+            assert controller.new_record() is True
+            time.sleep(1)
+            isos = controller.get_iso_stats()
+            print(isos)
+
+            sources.terminate_video()
+            serv.terminate(1)
+            assert len(isos) == 2
+            for _, kind, location, frames, size, _, rate, _ in isos:
+                assert kind == 'video'
+                assert '-input' in location
+                assert frames > 0
+                assert size > 0
+                assert rate > 0
+                assert os.path.getsize(location) > 0
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
+    def test_new_record_restart(self):
+        """Test a recorder restarted for a new composite size does not hold
+        up new_record while it closes out its file"""
+        serv = Server(path=PATH, record_file="restart-%Y.data",
+                      video_format="debug")
+        try:
+            serv.run('--state-timeout=2000')
+            sources = TestSources(video_port=3000)
+            sources.new_test_video()
+            sources.new_test_video()
+            time.sleep(3)
+
+            controller = Controller()
+            closed = controller.get_record_stats()[0]
+            controller.set_composite_mode(Controller.COMPOSITE_DUAL_EQUAL)
+            time.sleep(1)
+            start = time.time()
+            assert controller.new_record() is True
+            elapsed = time.time() - start
+            time.sleep(3)
+            location, _, frames = controller.get_record_stats()[:3]
+            print(elapsed, closed, location, frames)
+
+            sources.terminate_video()
+            serv.terminate(1)
+            assert elapsed < 1
+            assert location != closed
+            assert frames > 0
+            assert os.path.getsize(closed) > 0
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
 
 class TestAdjustPIP(object):
 
@@ -548,6 +822,563 @@ class TestSwitch(object):
         for i in range(start, 6):
             self.switch(dic[i - start][0], dic[i - start][1], i)
 
+    def test_switch_pooled(self):
+        """Test switching back and forth runs on pooled pipelines, with
+        and without the pool"""
+        for args in ['', '--pool-size=0']:
+            serv = Server(path=PATH, video_format="debug")
+            try:
+                serv.run(args)
+                sources = TestSources(video_port=3000)
+                sources.new_test_video(pattern=4)
+                sources.new_test_video(pattern=5)
+                time.sleep(3)
+
+                controller = Controller()
+                ports = controller.get_preview_ports()
+                results = []
+                for port in [3004, 3003] * 5:
+                    results.append(
+                        controller.switch(Controller.VIDEO_CHANNEL_A, port))
+                    time.sleep(0.5)
+                switched = controller.get_preview_ports()
+
+                sources.terminate_video()
+                serv.terminate(1)
+                assert results == [True] * 10
+                assert sorted(switched) == sorted(ports)
+            finally:
+                serv.terminate_and_output_status(cov=True)
+
+
+class TestReplay(object):
+
+    """Test the instant replay methods"""
+
+    def test_replay(self):
+        """Test a marked clip plays back as an input which can be switched
+        to, and the rings report their memory use"""
+        serv = Server(path=PATH, video_format="debug")
+        try:
+            serv.run('--replay=10')
+            sources = TestSources(video_port=3000)
+            sources.new_test_video(pattern=4)
+            sources.new_test_video(pattern=5)
+            time.sleep(3)
+
+            controller = Controller()
+            compose_port = controller.get_compose_port()
+            assert controller.replay_mark_out(3004) is False
+            assert controller.replay_mark_in(3004) is True
+            assert controller.replay_mark_in(compose_port) is True
+            time.sleep(2)
+            assert controller.replay_mark_out(3004) is True
+            assert controller.replay_mark_in(1) is False
+
+            port = controller.replay_play(3004, 0.5)
+            program = controller.replay_play(compose_port)
+            time.sleep(2)
+            assert port > 0
+            assert program > 0
+            assert controller.switch(Controller.VIDEO_CHANNEL_A, port)
+            time.sleep(1)
+            rings = controller.get_replay_stats()
+            print(rings)
+            assert controller.replay_stop(port) is True
+            assert controller.replay_stop(program) is True
+            assert controller.replay_stop(3004) is False
+
+            sources.terminate_video()
+            serv.terminate(1)
+            assert len(rings) == 3
+            assert (compose_port, 'program') in [r[:2] for r in rings]
+            for _, _, seconds, frames, size, per_second, mark_in, _ in rings:
+                assert seconds > 0
+                assert frames > 0
+                assert size > 0
+                assert per_second > 0
+                assert mark_in != 0
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
+
+class TestAudioMix(object):
+
+    """Test the audio mixer methods"""
+
+    def test_audio_mix(self):
+        """Test every audio input is mixed, and can be changed without
+        restarting the mix"""
+        serv = Server(path=PATH, video_format="debug")
+        try:
+            serv.run('--audio-mix')
+            sources = TestSources(video_port=3000, audio_port=4000)
+            sources.new_test_audio(freq=110)
+            sources.new_test_audio(freq=440)
+            time.sleep(3)
+
+            controller = Controller()
+            mix = controller.get_audio_mix()
+            ports = [m[0] for m in mix]
+            assert controller.set_audio_mix(ports[0], 0.5, pan=-1.0) is True
+            assert controller.set_audio_mix(ports[1], mute=True) is True
+            assert controller.set_audio_mix(1, 0.5) is False
+            time.sleep(1)
+            changed = controller.get_audio_mix()
+            assert controller.set_audio_mix(ports[1], mute=False) is True
+            time.sleep(1)
+            unmuted = controller.get_audio_mix()
+
+            sources.terminate_audio()
+            serv.terminate(1)
+            assert len(mix) == 2
+            for _, gain, mute, pan in mix:
+                assert gain == 1.0
+                assert mute is False
+                assert pan == 0.0
+            assert changed == [(ports[0], 0.5, False, -1.0),
+                               (ports[1], 1.0, True, 0.0)]
+            assert unmuted[1] == (ports[1], 1.0, False, 0.0)
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
+
+class TestLipSync(object):
+
+    """Measure the lip-sync error with a flash and a beep sent together"""
+    OFFSET = 200000
+    TOLERANCE = 0.06
+
+    @classmethod
+    def flash_and_beep(cls):
+        """Start a source flashing its video and beeping its audio at the
+        same time, every second"""
+        Gst.init(None)
+        pipeline = Gst.parse_launch(
+            "videotestsrc is-live=true pattern=white "
+            "! video/x-raw,format=I420,width=300,height=200,"
+            "framerate=25/1,pixel-aspect-ratio=1/1 "
+            "! videobalance name=flash brightness=-1 "
+            "! gdppay ! tcpclientsink port=3000 "
+            "audiotestsrc is-live=true freq=1000 samplesperbuffer=240 "
+            "! volume name=beep volume=0 "
+            "! audio/x-raw,rate=48000,channels=2,format=S16LE,"
+            "layout=interleaved ! gdppay ! tcpclientsink port=4000")
+        flash = pipeline.get_by_name('flash')
+        beep = pipeline.get_by_name('beep')
+        running = [True]
+
+        def blink():
+            """Flash and beep for 100 ms every second"""
+            while running[0]:
+                flash.set_property('brightness', 0.0)
+                beep.set_property('volume', 1.0)
+                time.sleep(0.1)
+                flash.set_property('brightness', -1.0)
+                beep.set_property('volume', 0.0)
+                time.sleep(0.9)
+
+        thread = threading.Thread(target=blink)
+        pipeline.set_state(Gst.State.PLAYING)
+        thread.start()
+
+        def stop():
+            """Stop the source"""
+            running[0] = False
+            thread.join()
+            pipeline.set_state(Gst.State.NULL)
+        return stop
+
+    @classmethod
+    def onsets(cls, port, loud, duration=5):
+        """Receive an output and return when it turned loud (or bright)"""
+        pipeline = Gst.parse_launch(
+            "tcpclientsrc port={0} ! gdpdepay ! fakesink name=sink "
+            "signal-handoffs=true sync=false".format(port))
+        onsets = []
+        was = [True]
+
+        def handoff(_, buf, *__):
+            """Record the arrival of a change to loud"""
+            _, info = buf.map(Gst.MapFlags.READ)
+            now = loud(info.data)
+            buf.unmap(info)
+            if now and not was[0]:
+                onsets.append(time.time())
+            was[0] = now
+        pipeline.get_by_name('sink').connect('handoff', handoff)
+        pipeline.set_state(Gst.State.PLAYING)
+        time.sleep(duration)
+        pipeline.set_state(Gst.State.NULL)
+        return onsets
+
+    @classmethod
+    def bright(cls, data):
+        """True if the first (luma) byte of a frame is white"""
+        return bytearray(data[:1])[0] > 128
+
+    @classmethod
+    def beeping(cls, data):
+        """True if any S16LE sample of the buffer is loud"""
+        samples = array.array('h', bytes(data))
+        return max(abs(x) for x in samples) > 8000
+
+    def lip_sync_error(self, video_port, audio_port):
+        """Return the median time a beep arrives after its flash"""
+        results = {}
+
+        def receive(port, loud):
+            """Collect the onsets of one output"""
+            results[port] = self.onsets(port, loud)
+        threads = [
+            threading.Thread(target=receive,
+                             args=(video_port, self.bright)),
+            threading.Thread(target=receive,
+                             args=(audio_port, self.beeping))]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        errors = []
+        for flash in results[video_port]:
+            beeps = results[audio_port]
+            if beeps:
+                errors.append(min((b - flash for b in beeps), key=abs))
+        errors.sort()
+        print(video_port, audio_port, errors)
+        assert len(errors) >= 3
+        return errors[len(errors) // 2]
+
+    def test_av_offset(self):
+        """Test delaying the audio moves the beeps after the flashes"""
+        serv = Server(path=PATH, video_format="debug")
+        stop = None
+        try:
+            serv.run()
+            stop = self.flash_and_beep()
+            time.sleep(3)
+
+            controller = Controller()
+            offsets = controller.get_av_offsets()
+            assert len(offsets) == 2
+            video_port, audio_port = [o[0] for o in sorted(offsets)]
+            before = self.lip_sync_error(video_port, audio_port)
+
+            assert controller.set_av_offset(audio_port, self.OFFSET) is True
+            assert controller.set_av_offset(audio_port, -1) is False
+            assert controller.set_av_offset(1, self.OFFSET) is False
+            time.sleep(2)
+            after = self.lip_sync_error(video_port, audio_port)
+            offsets = controller.get_av_offsets()
+
+            stop()
+            stop = None
+            serv.terminate(1)
+            print(before, after)
+            assert (audio_port, self.OFFSET) in offsets
+            assert (video_port, 0) in offsets
+            assert abs(after - before - self.OFFSET / 1e6) < self.TOLERANCE
+        finally:
+            if stop:
+                stop()
+            serv.terminate_and_output_status(cov=True)
+
+    @classmethod
+    def program_level(cls, controller):
+        """The RMS level of the program audio"""
+        levels = dict((l[0], l[1]) for l in controller.get_audio_levels())
+        return levels.get(0, -90.0)
+
+    def test_audio_follow_video(self):
+        """Test switching the video crossfades to its paired audio"""
+        serv = Server(path=PATH, video_format="debug")
+        try:
+            serv.run('--audio-follow-video')
+            sources = TestSources(video_port=3000, audio_port=4000)
+            sources.new_test_video()
+            sources.new_test_video()
+            time.sleep(2)
+            sources.new_test_audio(freq=440)
+            # silence
+            sources.new_test_audio(wave=4)
+            time.sleep(3)
+
+            controller = Controller()
+            ports = sorted(o[0] for o in controller.get_av_offsets())
+            videos, audios = ports[:2], ports[2:]
+            assert controller.pair_audio(videos[0], audios[0]) is True
+            assert controller.pair_audio(videos[1], audios[1]) is True
+            time.sleep(1)
+            mix = controller.get_audio_mix()
+            loud = self.program_level(controller)
+            assert controller.switch(Controller.VIDEO_CHANNEL_A, videos[1])
+            time.sleep(1)
+            quiet = self.program_level(controller)
+            assert controller.switch(Controller.VIDEO_CHANNEL_A, videos[0])
+            time.sleep(1)
+            again = self.program_level(controller)
+            changed = controller.get_audio_mix()
+
+            sources.terminate_video()
+            sources.terminate_audio()
+            serv.terminate(1)
+            print(loud, quiet, again)
+            assert loud > quiet + 30
+            assert again > quiet + 30
+            # crossfading leaves the mix settings alone
+            assert changed == mix
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
+
+class TestAudioEngine(object):
+
+    """Measure the end-to-end audio latency with and without the engine"""
+
+    @classmethod
+    def beeper(cls):
+        """Start an audio source beeping every 500 ms, return the times
+        the beeps started and a function to stop it"""
+        Gst.init(None)
+        pipeline = Gst.parse_launch(
+            "audiotestsrc is-live=true freq=1000 samplesperbuffer=48 "
+            "! volume name=beep volume=0 "
+            "! audio/x-raw,rate=48000,channels=2,format=S16LE,"
+            "layout=interleaved ! gdppay ! tcpclientsink port=4000")
+        beep = pipeline.get_by_name('beep')
+        running = [True]
+        beeps = []
+
+        def blink():
+            """Beep for 100 ms every 500 ms"""
+            while running[0]:
+                beep.set_property('volume', 1.0)
+                beeps.append(time.time())
+                time.sleep(0.1)
+                beep.set_property('volume', 0.0)
+                time.sleep(0.4)
+
+        thread = threading.Thread(target=blink)
+        pipeline.set_state(Gst.State.PLAYING)
+        thread.start()
+
+        def stop():
+            """Stop the source"""
+            running[0] = False
+            thread.join()
+            pipeline.set_state(Gst.State.NULL)
+        return beeps, stop
+
+    def latency(self, args=''):
+        """Return the median time from a beep to it arriving at the audio
+        output, and the latencies the server reports"""
+        serv = Server(path=PATH, video_format="debug")
+        stop = None
+        try:
+            serv.run(args)
+            beeps, stop = self.beeper()
+            time.sleep(3)
+
+            controller = Controller()
+            port = controller.get_audio_port()
+            arrivals = TestLipSync.onsets(port, TestLipSync.beeping)
+            reported = controller.get_audio_latency()
+
+            stop()
+            stop = None
+            serv.terminate(1)
+        finally:
+            if stop:
+                stop()
+            serv.terminate_and_output_status(cov=True)
+
+        delays = []
+        for arrival in arrivals:
+            sent = [b for b in beeps if b < arrival]
+            if sent:
+                delays.append(arrival - sent[-1])
+        delays.sort()
+        print(args, delays, reported)
+        assert len(delays) >= 5
+        return delays[len(delays) // 2], reported
+
+    def test_audio_period(self):
+        """Test small audio periods lower the monitor latency"""
+        default, default_reported = self.latency()
+        engine, engine_reported = self.latency(
+            '--audio-period=5 --audio-realtime')
+        print(default, engine)
+        assert engine < default
+        assert len(engine_reported) == 1
+        _, monitor, _ = engine_reported[0]
+        assert 0 < monitor < default_reported[0][1]
+
+
+class TestLoudness(object):
+
+    """Measure the loudness of the program audio"""
+
+    def test_loudness(self):
+        """Test a sine at -20 dBFS reads -20 LUFS, and its loudness goes
+        into the index of the recording"""
+        serv = Server(path=PATH, record_file="loudness-%Y.data",
+                      video_format="debug")
+        pipeline = None
+        try:
+            serv.run()
+            sources = TestSources(video_port=3000)
+            sources.new_test_video()
+            Gst.init(None)
+            pipeline = Gst.parse_launch(
+                "audiotestsrc is-live=true freq=997 volume=0.1 "
+                "! audio/x-raw,rate=48000,channels=2,format=S16LE,"
+                "layout=interleaved ! gdppay ! tcpclientsink port=4000")
+            pipeline.set_state(Gst.State.PLAYING)
+            time.sleep(5)
+
+            controller = Controller()
+            level = controller.get_loudness()
+            closed = controller.get_record_stats()[0]
+            assert controller.new_record() is True
+            time.sleep(1)
+
+            pipeline.set_state(Gst.State.NULL)
+            pipeline = None
+            sources.terminate_video()
+            serv.terminate(1)
+        finally:
+            if pipeline:
+                pipeline.set_state(Gst.State.NULL)
+            serv.terminate_and_output_status(cov=True)
+
+        print(level)
+        momentary, short_term, integrated, true_peak = level
+        for value in [momentary, short_term, integrated, true_peak]:
+            assert abs(value + 20.0) < 1.0
+        with open(closed + '.idx') as index:
+            marks = [l.split()[2:] for l in index if l.startswith('E ')]
+        print(marks)
+        loudness = [m for m in marks if m[0] == 'loudness']
+        assert len(loudness) == 1
+        assert abs(float(loudness[0][1][len('I='):]) + 20.0) < 1.0
+
+
+class TestWatchdog(object):
+
+    """Supervise the buffer flow of the pipelines"""
+
+    def test_watchdog_idle(self):
+        """Test the watchdog leaves healthy and idle pipelines alone, the
+        preview ports have no clients and the inputs stop halfway"""
+        serv = Server(path=PATH, video_format="debug")
+        try:
+            serv.run('--watchdog=500')
+            sources = TestSources(video_port=3000)
+            sources.new_test_video()
+            sources.new_test_video()
+            time.sleep(3)
+
+            controller = Controller()
+            controller.set_composite_mode(Controller.COMPOSITE_DUAL_EQUAL)
+            time.sleep(2)
+            sources.terminate_video()
+            time.sleep(2)
+            stats = controller.get_watchdog_stats()
+            print(stats)
+
+            serv.terminate(1)
+            assert stats == (0, 0, 0, 0)
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
+
+class TestLatency(object):
+
+    """Measure the glass to glass latency of timestamped inputs"""
+
+    def test_get_latency(self):
+        """Test the output and every preview branch detect the codes"""
+        serv = Server(path=PATH, video_format="debug")
+        try:
+            serv.run('--measure-latency')
+            sources = TestSources(video_port=3000)
+            sources.new_test_video(timestamp=True)
+            sources.new_test_video(timestamp=True)
+            time.sleep(3)
+
+            controller = Controller()
+            latency = dict((path, (detected, p50, p999))
+                           for path, _, detected, p50, _, p999
+                           in controller.get_latency())
+            print(latency)
+            sources.terminate_video()
+            serv.terminate(1)
+
+            assert 'output' in latency
+            assert len([path for path in latency
+                        if path.startswith('preview_')]) == 2
+            for detected, p50, p999 in latency.values():
+                assert detected > 0
+                assert 0 <= p50 <= p999
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
+
+class TestMetrics(object):
+
+    """Scrape the metrics of the server over HTTP"""
+
+    PORT = 9300
+
+    @staticmethod
+    def scrape(path='/metrics'):
+        """Fetch the metrics, a dict of every sample by name and labels"""
+        url = 'http://127.0.0.1:{0}{1}'.format(TestMetrics.PORT, path)
+        text = urlopen(url, timeout=5).read().decode('utf-8')
+        samples = {}
+        for line in text.splitlines():
+            if line and not line.startswith('#'):
+                name, value = line.rsplit(' ', 1)
+                samples[name] = float(value)
+        return samples
+
+    def test_metrics(self):
+        """Test the inputs, switches, mode changes and requests are counted"""
+        serv = Server(path=PATH, video_format="debug")
+        try:
+            serv.run('--metrics-port={0}'.format(self.PORT))
+            sources = TestSources(video_port=3000)
+            sources.new_test_video()
+            sources.new_test_video()
+            time.sleep(3)
+
+            controller = Controller()
+            before = self.scrape()
+            assert controller.switch(Controller.VIDEO_CHANNEL_A, 3004)
+            assert controller.set_composite_mode(Controller.COMPOSITE_NONE)
+            time.sleep(2)
+            after = self.scrape()
+            with pytest.raises(HTTPError):
+                self.scrape('/')
+            sources.terminate_video()
+            serv.terminate(1)
+
+            print(after)
+            frames = 'gstswitch_input_frames_total{port="3003",type="video"}'
+            assert after[frames] > before[frames] > 0
+            assert after['gstswitch_input_bytes_total'
+                         '{port="3003",type="video"}'] > 0
+            assert after['gstswitch_composite_frames_total'] > 0
+            assert after['gstswitch_switch_latency_seconds_count'] == 1
+            assert after['gstswitch_mode_change_latency_seconds_count'] == 1
+            assert after['gstswitch_dbus_request_seconds_count'
+                         '{method="switch"}'] == 1
+            assert after['process_cpu_seconds_total'] > 0
+            assert after['process_resident_memory_bytes'] > 0
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
 
 class TestClickVideo(object):
 
@@ -725,3 +1556,146 @@ class TestMarkTracking(object):
         start = 7
         for i in range(start, 8):
             self.mark_tracking(dic[i - start], i, True)
+
+
+class TestTimeToFirstFrame(object):
+
+    """Test that a newly connected client gets a frame at once"""
+    MAX_DELAY = 0.5
+
+    def time_to_first_frame(self, port, parse='gdpdepay'):
+        """Connect to port and measure the time to the first buffer"""
+        Gst.init(None)
+        pipeline = Gst.parse_launch(
+            "tcpclientsrc port={0} ! {1} ! fakesink name=sink "
+            "signal-handoffs=true sync=false".format(port, parse))
+        sink = pipeline.get_by_name('sink')
+        first = []
+
+        def handoff(*_):
+            """Record the arrival of the first buffer"""
+            if not first:
+                first.append(time.time())
+        sink.connect('handoff', handoff)
+
+        start = time.time()
+        pipeline.set_state(Gst.State.PLAYING)
+        while not first and time.time() - start < 5:
+            time.sleep(0.01)
+        pipeline.set_state(Gst.State.NULL)
+        assert first
+        return first[0] - start
+
+    def test_raw_outputs(self):
+        """Test the composite and preview outputs"""
+        serv = Server(path=PATH, video_format="debug")
+        try:
+            serv.run()
+            sources = TestSources(video_port=3000)
+            sources.new_test_video()
+            sources.new_test_video()
+            time.sleep(2)
+
+            controller = Controller()
+            ports = [controller.get_compose_port()]
+            ports += controller.get_preview_ports()
+            # idle previews are refreshed once a second, wait for a frame
+            time.sleep(1.5)
+            for port in ports:
+                delay = self.time_to_first_frame(port)
+                print(port, delay)
+                assert delay < self.MAX_DELAY
+
+            sources.terminate_video()
+            serv.terminate(1)
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
+    def test_encoded_output(self):
+        """Test an encoded output starts on the cached keyframe"""
+        serv = Server(path=PATH, video_format="debug")
+        try:
+            serv.run()
+            sources = TestSources(video_port=3000)
+            sources.new_test_video()
+            time.sleep(2)
+
+            controller = Controller()
+            port = controller.add_encoded_output('h264', 'veryfast', 0)
+            time.sleep(3)
+            delay = self.time_to_first_frame(port, 'tsdemux ! h264parse')
+            print(port, delay)
+            assert delay < self.MAX_DELAY
+
+            sources.terminate_video()
+            serv.terminate(1)
+        finally:
+            serv.terminate_and_output_status(cov=True)
+
+
+class TestSlowClients(object):
+
+    """Test that slow clients don't hold back the composite output"""
+    NUM_SLOW = 50
+    LAG = 200
+
+    @classmethod
+    def frame_intervals(cls, port, duration=3):
+        """Receive the output for a while and return the frame intervals"""
+        Gst.init(None)
+        pipeline = Gst.parse_launch(
+            "tcpclientsrc port={0} ! gdpdepay ! fakesink name=sink "
+            "signal-handoffs=true sync=false".format(port))
+        arrivals = []
+        pipeline.get_by_name('sink').connect(
+            'handoff', lambda *_: arrivals.append(time.time()))
+        pipeline.set_state(Gst.State.PLAYING)
+        time.sleep(duration)
+        pipeline.set_state(Gst.State.NULL)
+        # skip the burst of the cached frame
+        arrivals = arrivals[1:]
+        return [b - a for a, b in zip(arrivals, arrivals[1:])]
+
+    @classmethod
+    def stalled_client(cls, port):
+        """Connect to the port and never read"""
+        sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4096)
+        sock.connect(('localhost', port))
+        return sock
+
+    def test_slow_clients(self):
+        """Test output timing with and without 50 stalled clients"""
+        serv = Server(path=PATH, video_format="debug")
+        try:
+            serv.run('--client-lag={0}'.format(self.LAG))
+            sources = TestSources(video_port=3000)
+            sources.new_test_video()
+            time.sleep(2)
+
+            controller = Controller()
+            port = controller.get_compose_port()
+            before = self.frame_intervals(port)
+
+            slow = [self.stalled_client(port) for _ in range(self.NUM_SLOW)]
+            time.sleep(5)
+            after = self.frame_intervals(port)
+            stats = [s for s in controller.get_client_stats()
+                     if s[0] == port]
+            for sock in slow:
+                sock.close()
+
+            sources.terminate_video()
+            serv.terminate(1)
+
+            mean_before = sum(before) / len(before)
+            mean_after = sum(after) / len(after)
+            print(mean_before, max(before), mean_after, max(after))
+            assert abs(mean_after - mean_before) < 0.2 * mean_before
+            assert max(after) < max(before) + 0.1
+
+            # the stalled clients fell behind and were resynced
+            assert len(stats) >= self.NUM_SLOW
+            assert sum(s[3] for s in stats) > 0
+        finally:
+            serv.terminate_and_output_status(cov=True)
@@ -230,7 +230,34 @@ class MockConnection(object):
         'switch': (True,),
         'click_video': (True,),
         'mark_face': None,
-        'mark_tracking': None
+        'mark_tracking': None,
+        'add_encoded_output': (3010,),
+        'remove_encoded_output': (True,),
+        'get_encoded_outputs': ('[]',),
+        'get_preview_thumbnail': (3020,),
+        'set_multiview': (3030,),
+        'get_multiview_port': (3030,),
+        'get_branch_stats': ('[]',),
+        'get_client_stats': ('[]',),
+        'get_record_stats':
+        ("('', 0, 0, 0, 0, 'mjpeg', 0.0, 0.0, 0, 0, 0, 0)",),
+        'get_iso_stats': ('[]',),
+        'replay_mark_in': (True,),
+        'replay_mark_out': (True,),
+        'replay_play': (3040,),
+        'replay_stop': (True,),
+        'get_replay_stats': ('[]',),
+        'set_audio_mix': (True,),
+        'get_audio_mix': ('[]',),
+        'get_audio_levels': ('[]',),
+        'set_av_offset': (True,),
+        'get_av_offsets': ('[]',),
+        'pair_audio': (True,),
+        'get_audio_latency': ('[]',),
+        'get_loudness': ('(-70.0, -70.0, -70.0, -70.0)',),
+        'get_watchdog_stats': ('(0, 0, 0, 0)',),
+        'get_stats': ('[]',),
+        'get_latency': ('[]',)
     }
 
     def __init__(self, method):
@@ -440,3 +467,368 @@ def test_mark_tracking():
     conn.connection = MockConnection('mark_tracking')
     face = [(1, 1, 1, 1), (2, 2, 2, 2)]
     assert conn.mark_tracking(face) is None
+
+
+def test_add_encoded_output():
+    """Test the add_encoded_output method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('add_encoded_output')
+    with pytest.raises(ConnectionError):
+        conn.add_encoded_output('h264', 'veryfast', 2000)
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('add_encoded_output')
+    assert conn.add_encoded_output('h264', 'veryfast', 2000) == (3010,)
+
+
+def test_remove_encoded_output():
+    """Test the remove_encoded_output method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('remove_encoded_output')
+    with pytest.raises(ConnectionError):
+        conn.remove_encoded_output(3010)
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('remove_encoded_output')
+    assert conn.remove_encoded_output(3010) == (True,)
+
+
+def test_get_encoded_outputs():
+    """Test the get_encoded_outputs method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_encoded_outputs')
+    with pytest.raises(ConnectionError):
+        conn.get_encoded_outputs()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_encoded_outputs')
+    assert conn.get_encoded_outputs() == ('[]',)
+
+
+def test_get_preview_thumbnail():
+    """Test the get_preview_thumbnail method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_preview_thumbnail')
+    with pytest.raises(ConnectionError):
+        conn.get_preview_thumbnail(3003, 160, 0, 0, False)
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_preview_thumbnail')
+    assert conn.get_preview_thumbnail(3003, 160, 0, 0, False) == (3020,)
+
+
+def test_set_multiview():
+    """Test the set_multiview method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('set_multiview')
+    with pytest.raises(ConnectionError):
+        conn.set_multiview(1280, 0, 0, False)
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('set_multiview')
+    assert conn.set_multiview(1280, 0, 0, False) == (3030,)
+
+
+def test_get_multiview_port():
+    """Test the get_multiview_port method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_multiview_port')
+    with pytest.raises(ConnectionError):
+        conn.get_multiview_port()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_multiview_port')
+    assert conn.get_multiview_port() == (3030,)
+
+
+def test_get_branch_stats():
+    """Test the get_branch_stats method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_branch_stats')
+    with pytest.raises(ConnectionError):
+        conn.get_branch_stats()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_branch_stats')
+    assert conn.get_branch_stats() == ('[]',)
+
+
+def test_get_client_stats():
+    """Test the get_client_stats method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_client_stats')
+    with pytest.raises(ConnectionError):
+        conn.get_client_stats()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_client_stats')
+    assert conn.get_client_stats() == ('[]',)
+
+
+def test_get_record_stats():
+    """Test the get_record_stats method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_record_stats')
+    with pytest.raises(ConnectionError):
+        conn.get_record_stats()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_record_stats')
+    assert conn.get_record_stats() == \
+        ("('', 0, 0, 0, 0, 'mjpeg', 0.0, 0.0, 0, 0, 0, 0)",)
+
+
+def test_get_iso_stats():
+    """Test the get_iso_stats method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_iso_stats')
+    with pytest.raises(ConnectionError):
+        conn.get_iso_stats()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_iso_stats')
+    assert conn.get_iso_stats() == ('[]',)
+
+
+def test_replay_mark_in():
+    """Test the replay_mark_in method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('replay_mark_in')
+    with pytest.raises(ConnectionError):
+        conn.replay_mark_in(3001)
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('replay_mark_in')
+    assert conn.replay_mark_in(3001) == (True,)
+
+
+def test_replay_mark_out():
+    """Test the replay_mark_out method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('replay_mark_out')
+    with pytest.raises(ConnectionError):
+        conn.replay_mark_out(3001)
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('replay_mark_out')
+    assert conn.replay_mark_out(3001) == (True,)
+
+
+def test_replay_play():
+    """Test the replay_play method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('replay_play')
+    with pytest.raises(ConnectionError):
+        conn.replay_play(3001, 0.5)
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('replay_play')
+    assert conn.replay_play(3001, 0.5) == (3040,)
+
+
+def test_replay_stop():
+    """Test the replay_stop method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('replay_stop')
+    with pytest.raises(ConnectionError):
+        conn.replay_stop(3040)
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('replay_stop')
+    assert conn.replay_stop(3040) == (True,)
+
+
+def test_get_replay_stats():
+    """Test the get_replay_stats method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_replay_stats')
+    with pytest.raises(ConnectionError):
+        conn.get_replay_stats()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_replay_stats')
+    assert conn.get_replay_stats() == ('[]',)
+
+
+def test_set_audio_mix():
+    """Test the set_audio_mix method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('set_audio_mix')
+    with pytest.raises(ConnectionError):
+        conn.set_audio_mix(3004, 0.5, False, -1.0)
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('set_audio_mix')
+    assert conn.set_audio_mix(3004, 0.5, False, -1.0) == (True,)
+
+
+def test_get_audio_mix():
+    """Test the get_audio_mix method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_audio_mix')
+    with pytest.raises(ConnectionError):
+        conn.get_audio_mix()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_audio_mix')
+    assert conn.get_audio_mix() == ('[]',)
+
+
+def test_get_audio_levels():
+    """Test the get_audio_levels method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_audio_levels')
+    with pytest.raises(ConnectionError):
+        conn.get_audio_levels()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_audio_levels')
+    assert conn.get_audio_levels() == ('[]',)
+
+
+def test_set_av_offset():
+    """Test the set_av_offset method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('set_av_offset')
+    with pytest.raises(ConnectionError):
+        conn.set_av_offset(3004, 40000)
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('set_av_offset')
+    assert conn.set_av_offset(3004, 40000) == (True,)
+
+
+def test_get_av_offsets():
+    """Test the get_av_offsets method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_av_offsets')
+    with pytest.raises(ConnectionError):
+        conn.get_av_offsets()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_av_offsets')
+    assert conn.get_av_offsets() == ('[]',)
+
+
+def test_pair_audio():
+    """Test the pair_audio method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('pair_audio')
+    with pytest.raises(ConnectionError):
+        conn.pair_audio(3003, 3004)
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('pair_audio')
+    assert conn.pair_audio(3003, 3004) == (True,)
+
+
+def test_get_audio_latency():
+    """Test the get_audio_latency method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_audio_latency')
+    with pytest.raises(ConnectionError):
+        conn.get_audio_latency()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_audio_latency')
+    assert conn.get_audio_latency() == ('[]',)
+
+
+def test_get_loudness():
+    """Test the get_loudness method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_loudness')
+    with pytest.raises(ConnectionError):
+        conn.get_loudness()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_loudness')
+    assert conn.get_loudness() == ('(-70.0, -70.0, -70.0, -70.0)',)
+
+
+def test_get_watchdog_stats():
+    """Test the get_watchdog_stats method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_watchdog_stats')
+    with pytest.raises(ConnectionError):
+        conn.get_watchdog_stats()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_watchdog_stats')
+    assert conn.get_watchdog_stats() == ('(0, 0, 0, 0)',)
+
+
+def test_get_stats():
+    """Test the get_stats method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_stats')
+    with pytest.raises(ConnectionError):
+        conn.get_stats()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_stats')
+    assert conn.get_stats() == ('[]',)
+
+
+def test_get_latency():
+    """Test the get_latency method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_latency')
+    with pytest.raises(ConnectionError):
+        conn.get_latency()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_latency')
+    assert conn.get_latency() == ('[]',)
@@ -262,6 +262,14 @@ class MockConnection(object):
         else:
             return (True,)
 
+    def get_audio_mix(self):
+        """mock of get_audio_mix"""
+        if self.mode is False:
+            return GLib.Variant(
+                '(s)', ('[(4000, 0.5, 0, -1.0), (4001, 1.0, 1, 0.0)]',))
+        else:
+            return (0,)
+
     def mark_face(self, face):
         """mock of mark_face"""
         pass
@@ -484,6 +492,25 @@ class TestClickVideo(object):
         assert controller.click_video(1, 2, 3, 4) is True
 
 
+class TestGetAudioMix(object):
+
+    """Test the get_audio_mix method"""
+
+    def test_unpack(self):
+        """Test if unpack fails"""
+        controller = Controller(address='unix:abstract=abcdefghijk')
+        controller.connection = MockConnection(True)
+        with pytest.raises(ConnectionReturnError):
+            controller.get_audio_mix()
+
+    def test_normal_unpack(self):
+        """Test the mute of a muted and an unmuted input"""
+        controller = Controller(address='unix:abstract=abcdef')
+        controller.connection = MockConnection(False)
+        assert controller.get_audio_mix() == [(4000, 0.5, False, -1.0),
+                                              (4001, 1.0, True, 0.0)]
+
+
 class TestMarkFaces(object):
 
     """Tes the mark_face method"""
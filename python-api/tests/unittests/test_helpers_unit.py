@@ -74,7 +74,8 @@ class TestTestSources(object):
                      height=200,
                      pattern=None,
                      timeoverlay=False,
-                     clockoverlay=False):
+                     clockoverlay=False,
+                     timestamp=False):
             pass
 
         def run(self):
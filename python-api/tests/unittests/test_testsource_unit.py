@@ -189,6 +189,24 @@ class TestVideoSrcClockOverlay(object):
             assert src.clockoverlay == test
 
 
+class TestVideoSrcTimestamp(object):
+
+    """Test timestamp parameter"""
+
+    def test_fail(self):
+        """Test when timestamp is not boolean/valid"""
+        tests = ['', 1234, 'hi', [1, 2], {1: 2}, None, 0, []]
+        port = 1000
+        for test in tests:
+            with pytest.raises(ValueError):
+                VideoSrc(port=port, timestamp=test)
+
+    def test_normal(self):
+        """Test when timestamp is off"""
+        src = VideoSrc(port=1000, timestamp=False)
+        assert src.timestamp is False
+
+
 class MockPipeline(object):
 
     """Mock Pipeline"""
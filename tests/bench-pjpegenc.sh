@@ -0,0 +1,34 @@
+#!/bin/bash
+#
+#  Compare jpegenc with the slice parallel pjpegenc at the recording sizes.
+#
+#    ./tests/bench-pjpegenc.sh [frames] [threads]
+#
+#  Each size is reported with its encode rate and whether it keeps up with
+#  the frame rate in real time. Run it from the top of the build tree.
+#
+frames=${1:-300}
+threads=${2:-0}
+
+export GST_PLUGIN_PATH=./plugins/.libs:$GST_PLUGIN_PATH
+
+bench() {
+    local size=$1 rate=$2 enc=$3
+    local start end fps
+    start=$(date +%s.%N)
+    gst-launch-1.0 -q \
+	videotestsrc pattern=smpte num-buffers=$frames \
+	! video/x-raw,format=I420,width=${size%x*},height=${size#*x},framerate=$rate/1 \
+	! $enc ! fakesink sync=false > /dev/null || return 1
+    end=$(date +%s.%N)
+    fps=$(echo "$frames / ($end - $start)" | bc -l)
+    printf "%-10s %-4s %-38s %7.1f fps  %s\n" $size $rate "$enc" $fps \
+	$( (( $(echo "$fps >= $rate" | bc) )) && echo realtime || echo SLOW)
+}
+
+for mode in 1280x720:60 1920x1080:60 3840x2160:30; do
+    size=${mode%:*}
+    rate=${mode#*:}
+    bench $size $rate "jpegenc quality=100"
+    bench $size $rate "pjpegenc quality=100 threads=$threads"
+done
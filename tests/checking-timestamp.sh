@@ -3,11 +3,13 @@
 coproc SERVER( \
     ./tools/gst-switch-srv -v \
     --gst-debug-no-color \
+    --measure-latency \
     --record=timestamped.data \
     )
 sleep 2 && coproc CLIENT( \
     ./tools/gst-switch-ui \
     --gst-debug-no-color \
+    --measure-latency \
     )
 sleep 1 && coproc FEED( \
     ./tests/feed-timestamped-video.sh \
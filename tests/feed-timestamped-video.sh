@@ -30,7 +30,7 @@ launch \
     --gst-debug-no-color \
     videotestsrc pattern=$pattern \
     ! video/x-raw,width=$width,height=$height \
-    ! timeoverlay font-desc='"Verdana bold 62"' ! tee name=v \
+    ! timeoverlay font-desc='"Verdana bold 62"' ! latencystamp ! tee name=v \
     v. ! queue ! textoverlay font-desc='"Sans 90"' text=111 \
        ! gdppay ! tcpclientsink name=tcp_sink1 port=3000 \
     v. ! queue ! textoverlay font-desc='"Sans 90"' text=222 \
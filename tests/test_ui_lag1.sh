@@ -2,12 +2,13 @@
 
 # test_ui_lag1.sh
 # demos issue #30: lag between thumb and canvas 
+# the inputs are stamped, the server and the UI print the measured latency
 
 cd ../tools
 
-./gst-switch-srv & srvpid=$! 
+./gst-switch-srv --measure-latency & srvpid=$! 
 sleep 5
-./gst-switch-ui & uipid=$!
+./gst-switch-ui --measure-latency & uipid=$!
 
 # srcpid=()
 for i in 1 2 3 4 5 6; do
@@ -18,6 +19,7 @@ for i in 1 2 3 4 5 6; do
     ! timeoverlay font-desc="Sans 40" \
     ! clockoverlay time-format="%S" font-desc="Sans 240" \
     ! video/x-raw, width=300, height=200 \
+    ! latencystamp \
     ! gdppay \
     ! tcpclientsink port=3000 \
   & srcpid[i]=$!
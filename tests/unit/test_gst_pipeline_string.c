@@ -22,6 +22,7 @@
 #include <stdio.h>
 
 gboolean verbose = FALSE;
+GstSwitchServerOpts opts;
 
 // Dummy methods needed by gstcase.c
 GstCaps *gst_switch_server_getcaps (void);
@@ -248,6 +249,101 @@ test_get_pipeline_string_branch_audio (void)
   g_object_unref (cas);
 }
 
+static void
+test_get_pipeline_string_branch_thumbnail (void)
+{
+  GstCase *cas = new_case (GST_CASE_BRANCH_THUMBNAIL, GST_SERVE_VIDEO_STREAM);
+  GString *desc;
+  g_object_set (cas, "width", 160, "height", 90, "thumbport", 4321, NULL);
+  desc = gst_case_get_pipeline_string (cas);
+  g_assert (desc != NULL && strlen (desc->str) > 0);
+  g_assert (strstr (desc->str, "channel=branch_1234") != NULL);
+  g_assert (strstr (desc->str, "width=160,height=90") != NULL);
+  g_assert (strstr (desc->str, "port=4321") != NULL);
+  g_assert (strstr (desc->str, "videorate") == NULL);
+  g_assert (strstr (desc->str, "jpegenc") == NULL);
+  printf ("\nGST_CASE_BRANCH_THUMBNAIL: %s\n", desc->str);
+  g_string_free (desc, TRUE);
+
+  g_object_set (cas, "rate", 5, "jpeg", TRUE, NULL);
+  desc = gst_case_get_pipeline_string (cas);
+  g_assert (strstr (desc->str, "framerate=5/1") != NULL);
+  g_assert (strstr (desc->str, "jpegenc") != NULL);
+  printf ("\nGST_CASE_BRANCH_THUMBNAIL/JPEG: %s\n", desc->str);
+  g_string_free (desc, TRUE);
+  g_object_unref (cas);
+}
+
+static void
+test_get_pipeline_string_branch_gate (void)
+{
+  static const GstCaseType types[] = {
+    GST_CASE_BRANCH_VIDEO_A, GST_CASE_BRANCH_VIDEO_B,
+    GST_CASE_BRANCH_PREVIEW, GST_CASE_BRANCH_AUDIO,
+    GST_CASE_BRANCH_THUMBNAIL
+  };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (types); ++i) {
+    GstCase *cas = new_case (types[i], types[i] == GST_CASE_BRANCH_AUDIO ?
+        GST_SERVE_AUDIO_STREAM : GST_SERVE_VIDEO_STREAM);
+    GString *desc = gst_case_get_pipeline_string (cas);
+    const gchar *gate = strstr (desc->str, "identity name=gate");
+    const gchar *sink = strstr (desc->str, "tcpserversink");
+    /* the gate comes before any per-client work */
+    g_assert (gate != NULL && sink != NULL && gate < sink);
+    g_assert (strstr (desc->str, "gdppay") > gate);
+    /* new clients get the latest buffer at once */
+    g_assert (strstr (sink, GST_SWITCH_SERVE_LATEST_BUFFER) != NULL);
+    g_string_free (desc, TRUE);
+    g_object_unref (cas);
+  }
+}
+
+static void
+test_get_pipeline_string_audio_engine (void)
+{
+  static const GstCaseType types[] = {
+    GST_CASE_PREVIEW, GST_CASE_COMPOSITE_AUDIO, GST_CASE_BRANCH_AUDIO
+  };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (types); ++i) {
+    GstCase *cas = new_case (types[i], GST_SERVE_AUDIO_STREAM);
+    GString *desc;
+
+    opts.audio_period = 0;
+    desc = gst_case_get_pipeline_string (cas);
+    g_assert (strstr (desc->str, "audioparse") != NULL);
+    g_assert (strstr (desc->str, "period-time") == NULL);
+    g_string_free (desc, TRUE);
+
+    /* the engine hands out fixed periods and leaves the parser out */
+    opts.audio_period = 5;
+    desc = gst_case_get_pipeline_string (cas);
+    g_assert (strstr (desc->str, "audioparse") == NULL);
+    g_assert (strstr (desc->str, "period-time=5000000 ") != NULL);
+    g_assert (strstr (desc->str, "latency-time=10000000 ") != NULL);
+    printf ("\nAUDIO ENGINE (%d): %s\n", types[i], desc->str);
+    g_string_free (desc, TRUE);
+    g_object_unref (cas);
+  }
+  opts.audio_period = 0;
+}
+
+static void
+test_get_pipeline_string_delay (void)
+{
+  GstCase *cas = new_case (GST_CASE_COMPOSITE_VIDEO_A, GST_SERVE_VIDEO_STREAM);
+  GString *desc = gst_case_get_pipeline_string (cas);
+  const gchar *delay = strstr (desc->str, "queue name=delay");
+  /* an A/V sync offset is taken up right after the source */
+  g_assert (delay != NULL && delay < strstr (desc->str, "tee name=s"));
+  g_assert (strstr (delay, "max-size-bytes=0") != NULL);
+  g_string_free (desc, TRUE);
+  g_object_unref (cas);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -284,5 +380,14 @@ main (int argc, char **argv)
   g_test_add_func
       ("/gstswitch/server/gstcase/get_pipeline_string/BRANCH/PREVIEW",
       test_get_pipeline_string_branch_preview);
+  g_test_add_func
+      ("/gstswitch/server/gstcase/get_pipeline_string/BRANCH/THUMBNAIL",
+      test_get_pipeline_string_branch_thumbnail);
+  g_test_add_func ("/gstswitch/server/gstcase/get_pipeline_string/BRANCH/GATE",
+      test_get_pipeline_string_branch_gate);
+  g_test_add_func ("/gstswitch/server/gstcase/get_pipeline_string/AUDIO/ENGINE",
+      test_get_pipeline_string_audio_engine);
+  g_test_add_func ("/gstswitch/server/gstcase/get_pipeline_string/DELAY",
+      test_get_pipeline_string_delay);
   return g_test_run ();
 }
@@ -0,0 +1,140 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "plugins/gstassess.h"
+
+#define BUFFERS 50
+#define VALUES 10000
+
+gboolean verbose = FALSE;
+
+static void
+assert_near (gint64 value, gint64 expected)
+{
+  /* no bucket is wider than 1/16 of its values */
+  g_assert_cmpint (ABS (value - expected), <=, expected / 16);
+}
+
+static void
+test_assess_histogram (void)
+{
+  GstAssessHistogram *histogram = g_new0 (GstAssessHistogram, 1);
+  gint64 i;
+
+  g_assert_cmpint (gst_assess_histogram_percentile (histogram, 50.0), ==, -1);
+
+  for (i = 1; i <= VALUES; ++i)
+    gst_assess_histogram_add (histogram, i);
+  g_assert_cmpuint (gst_assess_histogram_count (histogram), ==, VALUES);
+  assert_near (gst_assess_histogram_percentile (histogram, 50.0), 5000);
+  assert_near (gst_assess_histogram_percentile (histogram, 99.0), 9900);
+  assert_near (gst_assess_histogram_percentile (histogram, 99.9), 9990);
+
+  /* small values are exact, huge ones are kept */
+  memset (histogram, 0, sizeof (*histogram));
+  gst_assess_histogram_add (histogram, 7);
+  g_assert_cmpint (gst_assess_histogram_percentile (histogram, 50.0), ==, 7);
+  gst_assess_histogram_add (histogram, G_GINT64_CONSTANT (1) << 38);
+  assert_near (gst_assess_histogram_percentile (histogram, 100.0),
+      G_GINT64_CONSTANT (1) << 38);
+  g_free (histogram);
+}
+
+static void
+test_assess_latency (void)
+{
+  GstElement *pipeline, *point;
+  GstStructure *stats;
+  GstMessage *message;
+  GstBus *bus;
+  guint buffers;
+  gint64 latency, jitter;
+
+  /* the identity holds every buffer for 2 ms between the points */
+  pipeline = gst_parse_launch ("videotestsrc num-buffers="
+      G_STRINGIFY (BUFFERS) " ! video/x-raw,width=64,height=48 "
+      "! assess name=a ! identity sleep-time=2000 "
+      "! assess name=b from=a ! fakesink", NULL);
+  g_assert (pipeline);
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  bus = gst_element_get_bus (pipeline);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  g_assert_cmpint (GST_MESSAGE_TYPE (message), ==, GST_MESSAGE_EOS);
+  gst_message_unref (message);
+  gst_object_unref (bus);
+
+  point = gst_bin_get_by_name (GST_BIN (pipeline), "b");
+  g_object_get (point, "stats", &stats, NULL);
+  g_assert (gst_structure_get_uint (stats, "buffers", &buffers));
+  g_assert_cmpuint (buffers, ==, BUFFERS);
+  g_assert (gst_structure_get_int64 (stats, "latency-p50", &latency));
+  g_assert_cmpint (latency, >=, 2000 - 2000 / 16);
+  g_assert (gst_structure_get_int64 (stats, "latency-p999", &latency));
+  g_assert_cmpint (latency, >=, 2000 - 2000 / 16);
+  g_assert (gst_structure_get_int64 (stats, "jitter-p50", &jitter));
+  g_assert_cmpint (jitter, >=, 0);
+  gst_structure_free (stats);
+  gst_object_unref (point);
+
+  /* no upstream point, no latency */
+  point = gst_bin_get_by_name (GST_BIN (pipeline), "a");
+  g_object_get (point, "stats", &stats, NULL);
+  g_assert (gst_structure_get_int64 (stats, "latency-p50", &latency));
+  g_assert_cmpint (latency, ==, -1);
+  gst_structure_free (stats);
+  gst_object_unref (point);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+static void
+test_assess_cost (void)
+{
+  GstAssessHistogram *histogram = g_new0 (GstAssessHistogram, 1);
+  gint64 start, i;
+  gdouble cost;
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < 1000000; ++i)
+    gst_assess_histogram_add (histogram, i & 0xffff);
+  cost = (g_get_monotonic_time () - start) / 1000.0;
+  printf ("\nASSESS: %.1f nsec a value\n", cost);
+  g_test_minimized_result (cost, "%.1f nsec a value", cost);
+  g_assert_cmpfloat (cost, <, 1000.0);
+  g_free (histogram);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_init (&argc, &argv);
+  g_test_init (&argc, &argv, NULL);
+  gst_element_register (NULL, "assess", GST_RANK_NONE, GST_TYPE_ASSESS);
+  g_test_add_func ("/gstswitch/plugins/assess/histogram",
+      test_assess_histogram);
+  g_test_add_func ("/gstswitch/plugins/assess/latency", test_assess_latency);
+  g_test_add_func ("/gstswitch/plugins/assess/cost", test_assess_cost);
+  return g_test_run ();
+}
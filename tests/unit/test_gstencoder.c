@@ -0,0 +1,135 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <stdio.h>
+
+#include "tools/gstencoder.h"
+#include "tools/gstcomposite.h"
+
+#define WIDTH 64
+#define HEIGHT 48
+
+gboolean verbose = FALSE;
+
+/* the encoder only takes the frame size of the composite by default */
+gint
+gst_composite_default_width ()
+{
+  return WIDTH;
+}
+
+gint
+gst_composite_default_height ()
+{
+  return HEIGHT;
+}
+
+static void
+count (GstWorker * worker, guint * n)
+{
+  *n += 1;
+}
+
+static GstPadProbeReturn
+block (GstPad * pad, GstPadProbeInfo * info, gpointer data)
+{
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+run_for (guint msec)
+{
+  gint64 end = g_get_monotonic_time () + msec * G_TIME_SPAN_MILLISECOND;
+
+  while (g_get_monotonic_time () < end) {
+    while (g_main_context_iteration (NULL, FALSE));
+    g_usleep (10 * G_TIME_SPAN_MILLISECOND);
+  }
+}
+
+static void
+wait_for (guint * n, guint value)
+{
+  while (*n < value)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+test_encoder_bitrate (void)
+{
+  GstWorker *feed;
+  GstEncoder *enc;
+  GstEncoderStats stats;
+  GstElement *source;
+  GstPad *pad;
+  guint feed_starts = 0, feed_ends = 0, starts = 0, ends = 0;
+
+  feed = GST_WORKER (g_object_new (GST_TYPE_WORKER, "name", "feed", NULL));
+  feed->pipeline_string = g_string_new ("videotestsrc is-live=true "
+      "! video/x-raw,width=" G_STRINGIFY (WIDTH) ",height="
+      G_STRINGIFY (HEIGHT) ",framerate=25/1 "
+      "! intervideosink channel=composite_out");
+  g_signal_connect (feed, "start-worker", G_CALLBACK (count), &feed_starts);
+  g_signal_connect (feed, "end-worker", G_CALLBACK (count), &feed_ends);
+  g_assert (gst_worker_start (feed));
+  wait_for (&feed_starts, 1);
+
+  enc = GST_ENCODER (g_object_new (GST_TYPE_ENCODER, "name", "encoder",
+          "codec", GST_ENCODER_CODEC_VP8, "bitrate", 256, NULL));
+  /* any free port */
+  enc->sink_port = 0;
+  g_signal_connect (enc, "start-worker", G_CALLBACK (count), &starts);
+  g_signal_connect (enc, "end-worker", G_CALLBACK (count), &ends);
+  g_assert (gst_worker_start (GST_WORKER (enc)));
+  wait_for (&starts, 1);
+
+  run_for (1500);
+  gst_encoder_get_stats (enc, &stats);
+  g_assert_cmpuint (stats.frames, >, 0);
+  g_assert_cmpuint (stats.bitrate, >, 0);
+
+  /* the input of the encoder stops, no frame closes the window */
+  source = gst_worker_get_element (GST_WORKER (enc), "source");
+  pad = gst_element_get_static_pad (source, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM, block, NULL,
+      NULL);
+  gst_object_unref (pad);
+  gst_object_unref (source);
+
+  run_for (GST_ENCODER_BITRATE_TIMEOUT * 1000 + 500);
+  gst_encoder_get_stats (enc, &stats);
+  g_assert_cmpuint (stats.bitrate, ==, 0);
+
+  g_assert (gst_worker_stop_force (GST_WORKER (enc), TRUE));
+  wait_for (&ends, 1);
+  g_object_unref (enc);
+  g_assert (gst_worker_stop_force (feed, TRUE));
+  wait_for (&feed_ends, 1);
+  g_object_unref (feed);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_init (&argc, &argv);
+  g_test_init (&argc, &argv, NULL);
+  g_test_add_func ("/gstswitch/server/encoder/bitrate", test_encoder_bitrate);
+  return g_test_run ();
+}
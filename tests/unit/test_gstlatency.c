@@ -0,0 +1,189 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <stdio.h>
+
+#include "plugins/gstlatencystamp.h"
+#include "plugins/gstlatencydetect.h"
+
+#define BUFFERS 30
+
+gboolean verbose = FALSE;
+
+static void
+round_trip (GstVideoFormat format, gint width, gint height)
+{
+  GstVideoInfo info;
+  GstVideoFrame frame;
+  GstBuffer *buffer;
+  guint32 time = 0;
+  gdouble w = MAX (2.0, width / 128.0);
+  gint x, y;
+
+  gst_video_info_set_format (&info, format, width, height);
+  buffer = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&info), NULL);
+  gst_buffer_memset (buffer, 0, 0x80, GST_VIDEO_INFO_SIZE (&info));
+  g_assert (gst_video_frame_map (&frame, &info, buffer, GST_MAP_READWRITE));
+
+  /* a grey picture has no code */
+  g_assert (!gst_latency_stamp_read (&frame, NULL, &time));
+  gst_latency_stamp_write (&frame, 0xdeadbeef);
+  g_assert (gst_latency_stamp_read (&frame, NULL, &time));
+  g_assert_cmpuint (time, ==, 0xdeadbeef);
+
+  /* a broken cell fails the check */
+  for (y = 0; y < MAX (2, height / 54); ++y)
+    for (x = (gint) (40 * w); x < (gint) (41 * w); ++x)
+      ((guint8 *) GST_VIDEO_FRAME_COMP_DATA (&frame, 0))
+          [x * GST_VIDEO_FRAME_COMP_PSTRIDE (&frame, 0) +
+          y * GST_VIDEO_FRAME_COMP_STRIDE (&frame, 0)] ^= 0xff;
+  g_assert (!gst_latency_stamp_read (&frame, NULL, &time));
+
+  gst_video_frame_unmap (&frame);
+  gst_buffer_unref (buffer);
+}
+
+static void
+test_latency_code (void)
+{
+  round_trip (GST_VIDEO_FORMAT_I420, 1280, 720);
+  round_trip (GST_VIDEO_FORMAT_I420, 300, 200);
+  round_trip (GST_VIDEO_FORMAT_YUY2, 640, 360);
+  round_trip (GST_VIDEO_FORMAT_NV12, 640, 360);
+}
+
+/**
+ * Run @description to its end, the stats of its latencydetect named detect.
+ */
+static GstStructure *
+run_detect (const gchar * description)
+{
+  GstElement *pipeline, *detect;
+  GstStructure *stats;
+  GstMessage *message;
+  GstBus *bus;
+
+  pipeline = gst_parse_launch (description, NULL);
+  g_assert (pipeline);
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  bus = gst_element_get_bus (pipeline);
+  message = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  g_assert_cmpint (GST_MESSAGE_TYPE (message), ==, GST_MESSAGE_EOS);
+  gst_message_unref (message);
+  gst_object_unref (bus);
+
+  detect = gst_bin_get_by_name (GST_BIN (pipeline), "detect");
+  g_object_get (detect, "stats", &stats, NULL);
+  gst_object_unref (detect);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+  return stats;
+}
+
+static void
+test_latency_detect (void)
+{
+  GstStructure *stats;
+  guint frames, detected;
+  gint64 latency;
+
+  /* 5 ms in between, and a downscale like the previews */
+  stats = run_detect ("videotestsrc num-buffers=" G_STRINGIFY (BUFFERS) " "
+      "pattern=snow ! video/x-raw,format=I420,width=640,height=360 "
+      "! latencystamp ! identity sleep-time=5000 ! videoscale "
+      "! video/x-raw,width=320,height=180 "
+      "! latencydetect name=detect path=test ! fakesink");
+  g_assert_cmpstr (gst_structure_get_string (stats, "path"), ==, "test");
+  g_assert (gst_structure_get_uint (stats, "frames", &frames));
+  g_assert_cmpuint (frames, ==, BUFFERS);
+  g_assert (gst_structure_get_uint (stats, "detected", &detected));
+  g_assert_cmpuint (detected, ==, BUFFERS);
+  g_assert (gst_structure_get_int64 (stats, "latency-p50", &latency));
+  printf ("\nLATENCY: p50 %" G_GINT64_FORMAT " usec\n", latency);
+  g_assert_cmpint (latency, >=, 5000 - 5000 / 16);
+  gst_structure_free (stats);
+}
+
+static void
+test_latency_detect_scaled (void)
+{
+  GstStructure *stats;
+  guint detected;
+
+  /* cells of a fraction of a pixel, scaled up */
+  stats = run_detect ("videotestsrc num-buffers=" G_STRINGIFY (BUFFERS) " "
+      "pattern=snow ! video/x-raw,format=I420,width=300,height=200 "
+      "! latencystamp ! videoscale ! video/x-raw,width=1280,height=720 "
+      "! latencydetect name=detect path=test ! fakesink");
+  g_assert (gst_structure_get_uint (stats, "detected", &detected));
+  g_assert_cmpuint (detected, ==, BUFFERS);
+  gst_structure_free (stats);
+
+  /* and scaled down by a fraction */
+  stats = run_detect ("videotestsrc num-buffers=" G_STRINGIFY (BUFFERS) " "
+      "pattern=snow ! video/x-raw,format=I420,width=1280,height=720 "
+      "! latencystamp ! videoscale ! video/x-raw,width=426,height=240 "
+      "! latencydetect name=detect path=test ! fakesink");
+  g_assert (gst_structure_get_uint (stats, "detected", &detected));
+  g_assert_cmpuint (detected, ==, BUFFERS);
+  gst_structure_free (stats);
+}
+
+static void
+test_latency_detect_composite (void)
+{
+  GstStructure *stats;
+  guint detected;
+
+  /* the output of the DUAL_EQUAL mode, A is half the size and a quarter
+     of the height down */
+  stats = run_detect ("videomixer name=mix background=black "
+      "sink_0::xpos=0 sink_0::ypos=180 sink_1::xpos=641 sink_1::ypos=180 "
+      "! video/x-raw,format=I420,width=1280,height=720 "
+      "! latencydetect name=detect path=output ! fakesink "
+      "videotestsrc num-buffers=" G_STRINGIFY (BUFFERS) " pattern=snow "
+      "! video/x-raw,format=I420,width=1280,height=720 ! latencystamp "
+      "! videoscale ! video/x-raw,width=640,height=360 ! mix.sink_0 "
+      "videotestsrc num-buffers=" G_STRINGIFY (BUFFERS) " pattern=snow "
+      "! video/x-raw,format=I420,width=639,height=360 ! mix.sink_1");
+  g_assert (gst_structure_get_uint (stats, "detected", &detected));
+  g_assert_cmpuint (detected, ==, BUFFERS);
+  gst_structure_free (stats);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_init (&argc, &argv);
+  g_test_init (&argc, &argv, NULL);
+  gst_element_register (NULL, "latencystamp", GST_RANK_NONE,
+      GST_TYPE_LATENCY_STAMP);
+  gst_element_register (NULL, "latencydetect", GST_RANK_NONE,
+      GST_TYPE_LATENCY_DETECT);
+  g_test_add_func ("/gstswitch/plugins/latency/code", test_latency_code);
+  g_test_add_func ("/gstswitch/plugins/latency/detect", test_latency_detect);
+  g_test_add_func ("/gstswitch/plugins/latency/detect/scaled",
+      test_latency_detect_scaled);
+  g_test_add_func ("/gstswitch/plugins/latency/detect/composite",
+      test_latency_detect_composite);
+  return g_test_run ();
+}
@@ -0,0 +1,176 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <math.h>
+#include <stdio.h>
+
+#include "tools/gstloudness.h"
+
+/* the share of a core a meter may take per channel, optimised builds take
+   about 0.2%, this leaves room for coverage builds */
+#define MAX_CPU_PER_CHANNEL 0.05
+
+/**
+ * A stereo sine of the same amplitude and phase on both channels.
+ */
+static gint16 *
+make_sine (gdouble freq, gdouble amplitude, gdouble phase, guint frames)
+{
+  gint16 *data = g_new (gint16, frames * GST_LOUDNESS_CHANNELS);
+  guint i;
+
+  for (i = 0; i < frames; ++i) {
+    gdouble v = amplitude * sin (2 * G_PI * freq * i / GST_LOUDNESS_RATE
+        + phase);
+    data[2 * i] = data[2 * i + 1] = (gint16) lrint (v * 32767.0);
+  }
+  return data;
+}
+
+/**
+ * Feed samples in buffers of 10 ms, like the program audio.
+ */
+static void
+feed (GstLoudness * loudness, const gint16 * data, guint frames)
+{
+  guint i;
+
+  for (i = 0; i < frames; i += 480)
+    gst_loudness_process_s16 (loudness,
+        data + i * GST_LOUDNESS_CHANNELS, MIN (480, frames - i));
+}
+
+static void
+feed_sine (GstLoudness * loudness, gdouble freq, gdouble amplitude,
+    gdouble phase, gdouble seconds)
+{
+  guint frames = (guint) (seconds * GST_LOUDNESS_RATE);
+  gint16 *data = make_sine (freq, amplitude, phase, frames);
+
+  feed (loudness, data, frames);
+  g_free (data);
+}
+
+static void
+test_loudness_sine (void)
+{
+  GstLoudness loudness;
+  GstLoudnessLevel level;
+
+  gst_loudness_init (&loudness);
+  g_assert (!gst_loudness_get (&loudness, &level));
+  g_assert_cmpfloat (level.integrated, ==, GST_LOUDNESS_FLOOR);
+
+  /* a 1 kHz sine at -20 dBFS on both channels reads -20 LUFS */
+  feed_sine (&loudness, 997.0, 0.1, 0.0, 5.0);
+  g_assert (gst_loudness_get (&loudness, &level));
+  g_assert_cmpfloat (fabs (level.momentary + 20.0), <, 0.1);
+  g_assert_cmpfloat (fabs (level.short_term + 20.0), <, 0.1);
+  g_assert_cmpfloat (fabs (level.integrated + 20.0), <, 0.1);
+  g_assert_cmpfloat (fabs (level.true_peak + 20.0), <, 0.1);
+
+  gst_loudness_clear (&loudness);
+}
+
+static void
+test_loudness_gate (void)
+{
+  GstLoudness loudness;
+  GstLoudnessLevel level;
+
+  gst_loudness_init (&loudness);
+  feed_sine (&loudness, 997.0, 0.1, 0.0, 10.0);
+
+  /* silence is gated out of the integrated loudness */
+  feed_sine (&loudness, 997.0, 0.0, 0.0, 10.0);
+  gst_loudness_get (&loudness, &level);
+  g_assert_cmpfloat (level.momentary, ==, GST_LOUDNESS_FLOOR);
+  g_assert_cmpfloat (level.short_term, ==, GST_LOUDNESS_FLOOR);
+  g_assert_cmpfloat (fabs (level.integrated + 20.0), <, 0.1);
+
+  /* so is a quiet part more than 10 LU below the rest */
+  feed_sine (&loudness, 997.0, 0.01, 0.0, 10.0);
+  gst_loudness_get (&loudness, &level);
+  g_assert_cmpfloat (fabs (level.short_term + 40.0), <, 0.1);
+  g_assert_cmpfloat (fabs (level.integrated + 20.0), <, 0.2);
+
+  gst_loudness_reset (&loudness);
+  gst_loudness_get (&loudness, &level);
+  g_assert_cmpfloat (level.integrated, ==, GST_LOUDNESS_FLOOR);
+  g_assert_cmpfloat (level.true_peak, ==, GST_LOUDNESS_FLOOR);
+  g_assert_cmpfloat (fabs (level.short_term + 40.0), <, 0.1);
+
+  gst_loudness_clear (&loudness);
+}
+
+static void
+test_loudness_true_peak (void)
+{
+  GstLoudness loudness;
+  GstLoudnessLevel level;
+
+  /* a quarter rate sine sampled 45 degrees off its peaks, the samples
+     peak 3 dB below the signal */
+  gst_loudness_init (&loudness);
+  feed_sine (&loudness, GST_LOUDNESS_RATE / 4, 0.5, G_PI / 4, 1.0);
+  gst_loudness_get (&loudness, &level);
+  g_assert_cmpfloat (level.true_peak, >, -6.5);
+  g_assert_cmpfloat (level.true_peak, <, -5.5);
+  gst_loudness_clear (&loudness);
+}
+
+static void
+test_loudness_cost (void)
+{
+  const guint seconds = g_test_perf ()? 600 : 60;
+  gint16 *data = make_sine (997.0, 0.5, 0.0, GST_LOUDNESS_RATE);
+  GstLoudness loudness;
+  gint64 start, usec;
+  gdouble cpu;
+  guint i;
+
+  gst_loudness_init (&loudness);
+  start = g_get_monotonic_time ();
+  for (i = 0; i < seconds; ++i)
+    feed (&loudness, data, GST_LOUDNESS_RATE);
+  usec = g_get_monotonic_time () - start;
+  gst_loudness_clear (&loudness);
+  g_free (data);
+
+  /* the share of a core one channel of real time audio takes */
+  cpu = usec / ((gdouble) seconds * G_USEC_PER_SEC * GST_LOUDNESS_CHANNELS);
+  g_test_minimized_result (cpu * 100.0, "%.3f%% of a core per channel",
+      cpu * 100.0);
+  printf ("\nLOUDNESS: %.1f usec per channel second, %.3f%% of a core\n",
+      cpu * G_USEC_PER_SEC, cpu * 100.0);
+  g_assert_cmpfloat (cpu, <, MAX_CPU_PER_CHANNEL);
+}
+
+int
+main (int argc, char **argv)
+{
+  g_test_init (&argc, &argv, NULL);
+  g_test_add_func ("/gstswitch/server/loudness/sine", test_loudness_sine);
+  g_test_add_func ("/gstswitch/server/loudness/gate", test_loudness_gate);
+  g_test_add_func ("/gstswitch/server/loudness/true_peak",
+      test_loudness_true_peak);
+  g_test_add_func ("/gstswitch/server/loudness/cost", test_loudness_cost);
+  return g_test_run ();
+}
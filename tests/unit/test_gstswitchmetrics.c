@@ -0,0 +1,170 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <string.h>
+
+#include "tools/gstswitchmetrics.h"
+
+gboolean verbose = FALSE;
+
+typedef struct _TestScrape TestScrape;
+struct _TestScrape
+{
+  guint16 port;
+  const gchar *request;
+  gint done;
+};
+
+static void
+test_histogram (void)
+{
+  GstSwitchMetricsHistogram h;
+  GString *out = g_string_new ("");
+
+  gst_switch_metrics_histogram_init (&h);
+  gst_switch_metrics_histogram_observe (&h, 500);
+  gst_switch_metrics_histogram_observe (&h, 3000);
+  gst_switch_metrics_histogram_observe (&h, 10 * G_USEC_PER_SEC);
+
+  gst_switch_metrics_append_histogram (out, "test_seconds", NULL, &h);
+  g_assert (strstr (out->str, "test_seconds_bucket{le=\"0.001\"} 1\n"));
+  g_assert (strstr (out->str, "test_seconds_bucket{le=\"0.0025\"} 1\n"));
+  g_assert (strstr (out->str, "test_seconds_bucket{le=\"0.005\"} 2\n"));
+  g_assert (strstr (out->str, "test_seconds_bucket{le=\"5\"} 2\n"));
+  g_assert (strstr (out->str, "test_seconds_bucket{le=\"+Inf\"} 3\n"));
+  g_assert (strstr (out->str, "test_seconds_sum 10.0035\n"));
+  g_assert (strstr (out->str, "test_seconds_count 3\n"));
+
+  g_string_truncate (out, 0);
+  gst_switch_metrics_append_histogram (out, "test_seconds",
+      "method=\"get\"", &h);
+  g_assert (strstr (out->str,
+          "test_seconds_bucket{method=\"get\",le=\"0.001\"} 1\n"));
+  g_assert (strstr (out->str, "test_seconds_count{method=\"get\"} 3\n"));
+
+  g_string_free (out, TRUE);
+  gst_switch_metrics_histogram_clear (&h);
+}
+
+static void
+test_process (void)
+{
+  GString *out = g_string_new ("");
+
+  gst_switch_metrics_append_process (out);
+  g_assert (strstr (out->str, "# TYPE process_cpu_seconds_total counter\n"));
+  g_assert (strstr (out->str, "\nprocess_resident_memory_bytes "));
+  g_string_free (out, TRUE);
+}
+
+static void
+append_test_metrics (GString * out, gpointer data)
+{
+  gst_switch_metrics_append_help (out, "test_total", "counter", "A test.");
+  gst_switch_metrics_append_value (out, "test_total", NULL, 42);
+}
+
+/**
+ * Fetch a request off the service, it only accepts from the main loop.
+ */
+static gpointer
+scrape (TestScrape * scrape)
+{
+  GSocketClient *client = g_socket_client_new ();
+  GSocketConnection *connection;
+  GInputStream *input;
+  GString *response = g_string_new ("");
+  gchar buf[1024];
+  gssize n;
+
+  connection = g_socket_client_connect_to_host (client, "127.0.0.1",
+      scrape->port, NULL, NULL);
+  g_assert (connection);
+  g_assert (g_output_stream_write_all (g_io_stream_get_output_stream
+          (G_IO_STREAM (connection)), scrape->request,
+          strlen (scrape->request), NULL, NULL, NULL));
+  input = g_io_stream_get_input_stream (G_IO_STREAM (connection));
+  while ((n = g_input_stream_read (input, buf, sizeof (buf), NULL, NULL)) > 0)
+    g_string_append_len (response, buf, n);
+
+  g_object_unref (connection);
+  g_object_unref (client);
+  g_atomic_int_set (&scrape->done, TRUE);
+  return g_string_free (response, FALSE);
+}
+
+static gchar *
+fetch (guint16 port, const gchar * request)
+{
+  TestScrape test = { port, request, FALSE };
+  GThread *thread = g_thread_new ("scrape", (GThreadFunc) scrape, &test);
+
+  while (!g_atomic_int_get (&test.done)) {
+    while (g_main_context_iteration (NULL, FALSE));
+    g_usleep (1000);
+  }
+  return g_thread_join (thread);
+}
+
+static void
+test_serve (void)
+{
+  GSocketService *service;
+  GError *error = NULL;
+  guint16 port = 0;
+  gchar *response;
+
+  service = gst_switch_metrics_serve ("127.0.0.1", &port,
+      append_test_metrics, NULL, &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (port, !=, 0);
+
+  response = fetch (port, "GET /metrics HTTP/1.1\r\nHost: test\r\n\r\n");
+  g_assert (g_str_has_prefix (response, "HTTP/1.0 200 OK\r\n"));
+  g_assert (strstr (response, "text/plain; version=0.0.4"));
+  g_assert (g_str_has_suffix (response,
+          "\r\n\r\n# HELP test_total A test.\n# TYPE test_total counter\n"
+          "test_total 42\n"));
+  g_free (response);
+
+  response = fetch (port, "GET / HTTP/1.1\r\n\r\n");
+  g_assert (g_str_has_prefix (response, "HTTP/1.0 404 Not Found\r\n"));
+  g_free (response);
+
+  /* the port is taken */
+  g_assert (!gst_switch_metrics_serve ("127.0.0.1", &port,
+          append_test_metrics, NULL, &error));
+  g_assert (error);
+  g_clear_error (&error);
+
+  g_socket_service_stop (service);
+  g_socket_listener_close (G_SOCKET_LISTENER (service));
+  g_object_unref (service);
+}
+
+int
+main (int argc, char **argv)
+{
+  g_test_init (&argc, &argv, NULL);
+  g_test_add_func ("/gstswitch/server/metrics/histogram", test_histogram);
+  g_test_add_func ("/gstswitch/server/metrics/process", test_process);
+  g_test_add_func ("/gstswitch/server/metrics/serve", test_serve);
+  return g_test_run ();
+}
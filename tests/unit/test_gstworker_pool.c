@@ -0,0 +1,167 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <stdio.h>
+
+#include "tools/gstworker.h"
+
+#define CYCLES 20
+
+gboolean verbose = FALSE;
+
+/* A worker of the shape of a composite case */
+typedef GstWorker TestWorker;
+typedef GstWorkerClass TestWorkerClass;
+
+G_DEFINE_TYPE (TestWorker, test_worker, GST_TYPE_WORKER);
+
+static gboolean pooling = FALSE;
+
+static GString *
+test_worker_get_pipeline_string (GstWorker * worker)
+{
+  return g_string_new ("videotestsrc name=source is-live=true "
+      "! video/x-raw,format=I420,width=1280,height=720,framerate=25/1 "
+      "! queue name=delay ! tee name=s "
+      "s. ! queue ! fakesink name=sink1 sync=false "
+      "s. ! queue ! videoscale ! video/x-raw,width=640,height=360 "
+      "! fakesink name=sink2 sync=false");
+}
+
+static gchar *
+test_worker_get_pool_key (GstWorker * worker)
+{
+  return pooling ? g_strdup ("test") : NULL;
+}
+
+static gboolean
+test_worker_reuse (GstWorker * worker, GstElement * pipeline)
+{
+  GstElement *source = gst_bin_get_by_name (GST_BIN (pipeline), "source");
+
+  if (source == NULL)
+    return FALSE;
+  g_object_set (source, "pattern", 1, NULL);
+  gst_object_unref (source);
+  return TRUE;
+}
+
+static void
+test_worker_init (TestWorker * worker)
+{
+}
+
+static void
+test_worker_class_init (TestWorkerClass * klass)
+{
+  klass->get_pipeline_string = test_worker_get_pipeline_string;
+  klass->get_pool_key = test_worker_get_pool_key;
+  klass->reuse = test_worker_reuse;
+}
+
+static void
+set_flag (GstWorker * worker, gboolean * flag)
+{
+  *flag = TRUE;
+}
+
+/**
+ * Start and stop a worker, return what the start took.
+ */
+static GstWorkerStartStats
+cycle (void)
+{
+  GstWorker *worker = GST_WORKER (g_object_new (test_worker_get_type (),
+          "name", "test", NULL));
+  gboolean started = FALSE, ended = FALSE;
+  GstWorkerStartStats stats;
+
+  g_signal_connect (worker, "start-worker", G_CALLBACK (set_flag), &started);
+  g_signal_connect (worker, "end-worker", G_CALLBACK (set_flag), &ended);
+
+  g_assert (gst_worker_start (worker));
+  while (!started)
+    g_main_context_iteration (NULL, TRUE);
+  stats = worker->start_stats;
+
+  gst_worker_stop_force (worker, TRUE);
+  while (!ended)
+    g_main_context_iteration (NULL, TRUE);
+  g_object_unref (worker);
+  return stats;
+}
+
+/**
+ * The mean start of CYCLES workers, after one to warm up.
+ */
+static GstWorkerStartStats
+measure (const gchar * what)
+{
+  GstWorkerStartStats mean = { 0 }, stats;
+  guint i;
+
+  cycle ();
+  for (i = 0; i < CYCLES; ++i) {
+    stats = cycle ();
+    g_assert (stats.pooled == pooling);
+    mean.build += stats.build / CYCLES;
+    mean.parse += stats.parse / CYCLES;
+    mean.start += stats.start / CYCLES;
+  }
+  printf ("\n%s: start %" G_GINT64_FORMAT " usec, string %" G_GINT64_FORMAT
+      ", parse %" G_GINT64_FORMAT "\n", what, mean.start, mean.build,
+      mean.parse);
+  return mean;
+}
+
+static void
+test_worker_pool (void)
+{
+  GstWorkerStartStats built, pooled;
+
+  pooling = FALSE;
+  built = measure ("BUILT");
+  g_assert_cmpint (built.parse, >, 0);
+
+  pooling = TRUE;
+  pooled = measure ("POOLED");
+  g_assert_cmpint (pooled.build, ==, 0);
+  g_assert_cmpint (pooled.parse, ==, 0);
+  g_test_minimized_result (pooled.start, "pooled start %" G_GINT64_FORMAT
+      " usec, built %" G_GINT64_FORMAT, pooled.start, built.start);
+
+  /* nothing is pooled any more */
+  gst_worker_set_pool_size (0);
+  g_assert (!cycle ().pooled);
+
+  gst_worker_set_pool_size (GST_WORKER_DEFAULT_POOL_SIZE);
+  gst_worker_pool_clear ();
+  g_assert (!cycle ().pooled);
+  gst_worker_pool_clear ();
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_init (&argc, &argv);
+  g_test_init (&argc, &argv, NULL);
+  g_test_add_func ("/gstswitch/server/worker/pool", test_worker_pool);
+  return g_test_run ();
+}
@@ -0,0 +1,227 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <stdio.h>
+
+#include "tools/gstworker.h"
+
+#define TIMEOUT 200             /* ms */
+
+gboolean verbose = FALSE;
+
+typedef struct _TestDone TestDone;
+struct _TestDone
+{
+  gboolean called;
+  gboolean ok;
+  gint64 time;
+};
+
+static void
+set_done (GstWorker * worker, gboolean ok, TestDone * done)
+{
+  done->called = TRUE;
+  done->ok = ok;
+  done->time = g_get_monotonic_time ();
+}
+
+static void
+set_flag (GstWorker * worker, gboolean * flag)
+{
+  *flag = TRUE;
+}
+
+static void
+wait_for (gboolean * flag)
+{
+  while (!*flag)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static GstWorker *
+new_worker (const gchar * pipeline, gboolean * ended)
+{
+  GstWorker *worker = GST_WORKER (g_object_new (GST_TYPE_WORKER,
+          "name", "test", NULL));
+
+  worker->pipeline_string = g_string_new (pipeline);
+  g_signal_connect (worker, "end-worker", G_CALLBACK (set_flag), ended);
+  return worker;
+}
+
+static void
+test_worker_state_start (void)
+{
+  GstWorker *worker;
+  GstWorkerTransitionStats stats;
+  TestDone started = { 0 }, stopped = { 0 };
+  gboolean ended = FALSE;
+
+  gst_worker_set_state_timeout (GST_WORKER_DEFAULT_STATE_TIMEOUT);
+  worker = new_worker ("videotestsrc is-live=true ! fakesink name=sink",
+      &ended);
+
+  g_assert (gst_worker_start_async (worker,
+          (GstWorkerDoneFunc) set_done, &started));
+  g_assert_cmpint (worker->phase, ==, GST_WORKER_PHASE_STARTING);
+  wait_for (&started.called);
+  g_assert (started.ok);
+  g_assert_cmpint (worker->phase, ==, GST_WORKER_PHASE_PLAYING);
+
+  g_assert (gst_worker_get_transition_stats (worker,
+          GST_STATE_CHANGE_NULL_TO_READY, &stats));
+  g_free (stats.slowest);
+  g_assert (gst_worker_get_transition_stats (worker,
+          GST_STATE_CHANGE_READY_TO_PAUSED, &stats));
+  g_assert_cmpstr (stats.slowest, !=, NULL);
+  g_assert_cmpint (stats.slowest_time, <=, stats.time);
+  g_free (stats.slowest);
+  g_assert (gst_worker_get_transition_stats (worker,
+          GST_STATE_CHANGE_PAUSED_TO_PLAYING, &stats));
+  g_free (stats.slowest);
+  g_assert (!gst_worker_get_transition_stats (worker,
+          GST_STATE_CHANGE_READY_TO_NULL, &stats));
+
+  /* done after "end-worker" */
+  g_assert (gst_worker_stop_async (worker, FALSE,
+          (GstWorkerDoneFunc) set_done, &stopped));
+  wait_for (&stopped.called);
+  g_assert (stopped.ok);
+  g_assert (ended);
+  g_assert_cmpint (worker->phase, ==, GST_WORKER_PHASE_STOPPED);
+  g_assert (!gst_worker_stop_async (worker, FALSE, NULL, NULL));
+
+  g_object_unref (worker);
+}
+
+static void
+test_worker_state_eos (void)
+{
+  GstWorker *worker;
+  TestDone stopped = { 0 };
+  gboolean started = FALSE, ended = FALSE;
+  gint64 time;
+
+  gst_worker_set_state_timeout (10 * TIMEOUT);
+  worker = new_worker ("videotestsrc is-live=true ! fakesink", &ended);
+  worker->send_eos_on_stop = TRUE;
+  g_signal_connect (worker, "start-worker", G_CALLBACK (set_flag), &started);
+  g_assert (gst_worker_start (worker));
+  wait_for (&started);
+
+  /* the stop returns at once, the EOS ends it */
+  time = g_get_monotonic_time ();
+  g_assert (gst_worker_stop_async (worker, FALSE,
+          (GstWorkerDoneFunc) set_done, &stopped));
+  g_assert_cmpint (worker->phase, ==, GST_WORKER_PHASE_DRAINING);
+  g_assert (!stopped.called);
+  wait_for (&stopped.called);
+  g_assert (stopped.ok);
+  g_assert (ended);
+  g_assert_cmpint (stopped.time - time, <, 10 * TIMEOUT * 1000);
+
+  g_object_unref (worker);
+}
+
+static GstPadProbeReturn
+drop_eos (GstPad * pad, GstPadProbeInfo * info, gpointer data)
+{
+  return GST_EVENT_TYPE (GST_PAD_PROBE_INFO_EVENT (info)) == GST_EVENT_EOS ?
+      GST_PAD_PROBE_DROP : GST_PAD_PROBE_OK;
+}
+
+static void
+test_worker_state_eos_timeout (void)
+{
+  GstWorker *worker;
+  GstElement *block;
+  GstPad *pad;
+  TestDone stopped = { 0 };
+  gboolean started = FALSE, ended = FALSE;
+  gint64 time;
+
+  gst_worker_set_state_timeout (TIMEOUT);
+  worker = new_worker ("videotestsrc is-live=true ! identity name=block "
+      "! fakesink", &ended);
+  worker->send_eos_on_stop = TRUE;
+  g_signal_connect (worker, "start-worker", G_CALLBACK (set_flag), &started);
+  g_assert (gst_worker_start (worker));
+  wait_for (&started);
+
+  block = gst_worker_get_element (worker, "block");
+  pad = gst_element_get_static_pad (block, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM, drop_eos,
+      NULL, NULL);
+  gst_object_unref (pad);
+  gst_object_unref (block);
+
+  /* the EOS never gets through, the stop is forced */
+  time = g_get_monotonic_time ();
+  g_assert (gst_worker_stop_async (worker, FALSE,
+          (GstWorkerDoneFunc) set_done, &stopped));
+  wait_for (&stopped.called);
+  g_assert (stopped.ok);
+  g_assert (ended);
+  g_assert_cmpint (stopped.time - time, >=, TIMEOUT * 1000);
+
+  g_object_unref (worker);
+}
+
+static void
+test_worker_state_start_timeout (void)
+{
+  GstWorker *worker;
+  TestDone started = { 0 };
+  gboolean ended = FALSE;
+  gint64 time;
+
+  /* nothing is ever pushed, the sink never prerolls */
+  gst_worker_set_state_timeout (TIMEOUT);
+  worker = new_worker ("appsrc name=source ! fakesink name=sink", &ended);
+
+  time = g_get_monotonic_time ();
+  g_assert (gst_worker_start_async (worker,
+          (GstWorkerDoneFunc) set_done, &started));
+  wait_for (&started.called);
+  g_assert (!started.ok);
+  g_assert_cmpint (started.time - time, >=, TIMEOUT * 1000);
+
+  /* and the worker is stopped */
+  wait_for (&ended);
+  g_assert_cmpint (worker->phase, ==, GST_WORKER_PHASE_STOPPED);
+
+  g_object_unref (worker);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_init (&argc, &argv);
+  g_test_init (&argc, &argv, NULL);
+  g_test_add_func ("/gstswitch/server/worker/state/start",
+      test_worker_state_start);
+  g_test_add_func ("/gstswitch/server/worker/state/eos",
+      test_worker_state_eos);
+  g_test_add_func ("/gstswitch/server/worker/state/eos_timeout",
+      test_worker_state_eos_timeout);
+  g_test_add_func ("/gstswitch/server/worker/state/start_timeout",
+      test_worker_state_start_timeout);
+  return g_test_run ();
+}
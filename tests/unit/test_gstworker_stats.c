@@ -0,0 +1,180 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <stdio.h>
+
+#include "tools/gstworker.h"
+
+#define BUFFERS 50
+
+gboolean verbose = FALSE;
+
+static void
+set_flag (GstWorker * worker, gboolean * flag)
+{
+  *flag = TRUE;
+}
+
+static GstWorkerElementStats *
+find (GArray * stats, const gchar * name)
+{
+  guint i;
+
+  for (i = 0; i < stats->len; ++i) {
+    GstWorkerElementStats *s = &g_array_index (stats, GstWorkerElementStats,
+        i);
+    if (g_strcmp0 (s->name, name) == 0)
+      return s;
+  }
+  g_assert_not_reached ();
+  return NULL;
+}
+
+static void
+test_worker_stats (void)
+{
+  GstWorker *worker = GST_WORKER (g_object_new (GST_TYPE_WORKER,
+          "name", "test", NULL));
+  GstWorkerElementStats *s;
+  gboolean ended = FALSE;
+  GArray *stats;
+  GList *workers;
+
+  /* the rate doubles every frame, the slow element takes 1 ms per frame */
+  worker->pipeline_string = g_string_new ("videotestsrc name=source "
+      "num-buffers=" G_STRINGIFY (BUFFERS) " "
+      "! video/x-raw,format=I420,width=64,height=48,framerate=10/1 "
+      "! videorate name=rate ! video/x-raw,framerate=20/1 "
+      "! queue name=queue ! identity name=slow sleep-time=1000 "
+      "! fakesink name=sink sync=false");
+  g_signal_connect (worker, "end-worker", G_CALLBACK (set_flag), &ended);
+
+  workers = gst_worker_list ();
+  g_assert (g_list_find (workers, worker));
+  g_list_free_full (workers, g_object_unref);
+
+  g_assert (gst_worker_start (worker));
+  while (!ended)
+    g_main_context_iteration (NULL, TRUE);
+
+  stats = gst_worker_get_stats (worker);
+  s = find (stats, "source");
+  g_assert_cmpuint (s->buffers, ==, BUFFERS);
+  g_assert_cmpuint (s->bytes, ==, BUFFERS * 64 * 48 * 3 / 2);
+  g_assert_cmpint (s->processing_time, ==, -1);
+
+  s = find (stats, "rate");
+  g_assert_cmpuint (s->dropped, ==, 0);
+  g_assert_cmpuint (s->repeated, >=, BUFFERS - 1);
+  g_assert_cmpuint (s->buffers, ==, BUFFERS + s->repeated);
+  g_assert_cmpint (s->processing_time, >=, 0);
+
+  s = find (stats, "slow");
+  g_assert_cmpint (s->processing_time, >=, 1000);
+
+  s = find (stats, "queue");
+  g_assert_cmpint (s->processing_time, ==, -1);
+  g_assert_cmpuint (s->queued, ==, 0);
+
+  /* counted going in */
+  s = find (stats, "sink");
+  g_assert_cmpuint (s->buffers, ==, find (stats, "rate")->buffers);
+  g_array_unref (stats);
+
+  g_object_unref (worker);
+  workers = gst_worker_list ();
+  g_assert (!g_list_find (workers, worker));
+  g_list_free_full (workers, g_object_unref);
+}
+
+static void
+test_worker_stats_drop (void)
+{
+  GstWorker *worker = GST_WORKER (g_object_new (GST_TYPE_WORKER,
+          "name", "test", NULL));
+  GstWorkerElementStats *s;
+  gboolean ended = FALSE;
+  GArray *stats;
+
+  /* the rate halves, every other frame is dropped */
+  worker->pipeline_string = g_string_new ("videotestsrc "
+      "num-buffers=" G_STRINGIFY (BUFFERS) " "
+      "! video/x-raw,format=I420,width=64,height=48,framerate=20/1 "
+      "! videorate name=rate ! video/x-raw,framerate=10/1 "
+      "! fakesink name=sink sync=false");
+  g_signal_connect (worker, "end-worker", G_CALLBACK (set_flag), &ended);
+
+  g_assert (gst_worker_start (worker));
+  while (!ended)
+    g_main_context_iteration (NULL, TRUE);
+
+  stats = gst_worker_get_stats (worker);
+  s = find (stats, "rate");
+  g_assert_cmpuint (s->repeated, ==, 0);
+  g_assert_cmpuint (s->dropped, >=, BUFFERS / 2 - 2);
+  g_assert_cmpuint (s->dropped + s->buffers, <=, BUFFERS);
+  g_array_unref (stats);
+
+  g_object_unref (worker);
+}
+
+static void
+test_worker_stats_aggregator (void)
+{
+  GstWorker *worker = GST_WORKER (g_object_new (GST_TYPE_WORKER,
+          "name", "test", NULL));
+  GstWorkerElementStats *s;
+  gboolean ended = FALSE;
+  GArray *stats;
+
+  /* timed from the latest of its inputs, like the composite mixer */
+  worker->pipeline_string = g_string_new ("videomixer name=mix "
+      "! fakesink name=sink sync=false "
+      "videotestsrc num-buffers=" G_STRINGIFY (BUFFERS) " "
+      "! video/x-raw,format=AYUV,width=64,height=48 ! mix. "
+      "videotestsrc num-buffers=" G_STRINGIFY (BUFFERS) " "
+      "! video/x-raw,format=AYUV,width=32,height=24 ! mix.");
+  g_signal_connect (worker, "end-worker", G_CALLBACK (set_flag), &ended);
+
+  g_assert (gst_worker_start (worker));
+  while (!ended)
+    g_main_context_iteration (NULL, TRUE);
+
+  stats = gst_worker_get_stats (worker);
+  s = find (stats, "mix");
+  g_assert_cmpuint (s->buffers, ==, BUFFERS);
+  g_assert_cmpint (s->processing_time, >=, 0);
+  g_array_unref (stats);
+
+  g_object_unref (worker);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_init (&argc, &argv);
+  g_test_init (&argc, &argv, NULL);
+  g_test_add_func ("/gstswitch/server/worker/stats", test_worker_stats);
+  g_test_add_func ("/gstswitch/server/worker/stats/drop",
+      test_worker_stats_drop);
+  g_test_add_func ("/gstswitch/server/worker/stats/aggregator",
+      test_worker_stats_aggregator);
+  return g_test_run ();
+}
@@ -0,0 +1,271 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <stdio.h>
+
+#include "tools/gstworker.h"
+
+#define TIMEOUT 200             /* ms */
+
+gboolean verbose = FALSE;
+
+static void
+count (GstWorker * worker, guint * n)
+{
+  *n += 1;
+}
+
+static GstWorker *
+new_worker (const gchar * pipeline, guint * starts, guint * ends)
+{
+  GstWorker *worker = GST_WORKER (g_object_new (GST_TYPE_WORKER,
+          "name", "test", NULL));
+
+  worker->pipeline_string = g_string_new (pipeline);
+  g_signal_connect (worker, "start-worker", G_CALLBACK (count), starts);
+  g_signal_connect (worker, "end-worker", G_CALLBACK (count), ends);
+  return worker;
+}
+
+static GstPadProbeReturn
+block (GstPad * pad, GstPadProbeInfo * info, gpointer data)
+{
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * Run the main loop for @msec, the watchdog wakes it from its own thread.
+ */
+static void
+run_for (guint msec)
+{
+  gint64 end = g_get_monotonic_time () + msec * G_TIME_SPAN_MILLISECOND;
+
+  while (g_get_monotonic_time () < end) {
+    while (g_main_context_iteration (NULL, FALSE));
+    g_usleep (10 * G_TIME_SPAN_MILLISECOND);
+  }
+}
+
+static void
+wait_for (guint * n, guint value)
+{
+  while (*n < value)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+test_watchdog_restart (void)
+{
+  GstWorkerWatchdogStats before, after;
+  GstWorker *worker;
+  GstElement *identity;
+  GstPad *pad;
+  guint starts = 0, ends = 0;
+
+  gst_worker_set_watchdog (TIMEOUT);
+  gst_worker_get_watchdog_stats (&before);
+  worker = new_worker ("videotestsrc is-live=true ! identity name=block "
+      "! fakesink", &starts, &ends);
+  g_assert (gst_worker_start (worker));
+  wait_for (&starts, 1);
+
+  /* the source gets stuck pushing into the blocked pad */
+  identity = gst_worker_get_element (worker, "block");
+  pad = gst_element_get_static_pad (identity, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM, block, NULL,
+      NULL);
+  gst_object_unref (pad);
+  gst_object_unref (identity);
+
+  /* restarted on a new pipeline, which flows */
+  wait_for (&starts, 2);
+  run_for (3 * TIMEOUT);
+  gst_worker_get_watchdog_stats (&after);
+  g_assert_cmpuint (after.stalls - before.stalls, ==, 1);
+  g_assert_cmpuint (after.restarts - before.restarts, ==, 1);
+  g_assert_cmpuint (after.recoveries - before.recoveries, ==, 1);
+  g_assert_cmpint (after.recovery_time, >=, TIMEOUT * 1000);
+  g_assert_cmpuint (ends, ==, 0);
+  g_assert_cmpint (worker->phase, ==, GST_WORKER_PHASE_PLAYING);
+
+  g_assert (gst_worker_stop_force (worker, TRUE));
+  wait_for (&ends, 1);
+  g_object_unref (worker);
+  gst_worker_set_watchdog (0);
+}
+
+static void
+test_watchdog_idle (void)
+{
+  GstWorkerWatchdogStats before, after;
+  GstWorker *worker;
+  guint starts = 0, ends = 0;
+
+  /* not live, it only flows with what is pushed into it */
+  gst_worker_set_watchdog (TIMEOUT);
+  gst_worker_get_watchdog_stats (&before);
+  worker = new_worker ("appsrc ! fakesink async=false", &starts, &ends);
+  g_assert (gst_worker_start (worker));
+  wait_for (&starts, 1);
+
+  run_for (5 * TIMEOUT);
+  gst_worker_get_watchdog_stats (&after);
+  g_assert_cmpuint (after.stalls, ==, before.stalls);
+  g_assert_cmpuint (after.restarts, ==, before.restarts);
+  g_assert_cmpuint (starts, ==, 1);
+
+  g_assert (gst_worker_stop_force (worker, TRUE));
+  wait_for (&ends, 1);
+  g_object_unref (worker);
+  gst_worker_set_watchdog (0);
+}
+
+static void
+test_watchdog_channel (void)
+{
+  GstWorkerWatchdogStats before, after;
+  GstWorker *feed, *worker;
+  GstElement *identity;
+  GstPad *pad;
+  guint feed_starts = 0, feed_ends = 0, starts = 0, ends = 0;
+
+  /* not live, the feed is left alone, and so is the reader of its
+     channel once the feed gets stuck */
+  gst_worker_set_watchdog (TIMEOUT);
+  gst_worker_get_watchdog_stats (&before);
+  feed = new_worker ("videotestsrc "
+      "! video/x-raw,width=64,height=48,framerate=25/1 ! identity name=block "
+      "! intervideosink channel=watchdog", &feed_starts, &feed_ends);
+  g_assert (gst_worker_start (feed));
+  wait_for (&feed_starts, 1);
+  worker = new_worker ("intervideosrc channel=watchdog ! fakesink", &starts,
+      &ends);
+  g_assert (gst_worker_start (worker));
+  wait_for (&starts, 1);
+  run_for (2 * TIMEOUT);
+
+  identity = gst_worker_get_element (feed, "block");
+  pad = gst_element_get_static_pad (identity, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM, block, NULL,
+      NULL);
+  gst_object_unref (pad);
+  gst_object_unref (identity);
+
+  /* the reader sends the latest frame again, then black, and is idle */
+  run_for (5 * TIMEOUT);
+  gst_worker_get_watchdog_stats (&after);
+  g_assert_cmpuint (after.stalls, ==, before.stalls);
+  g_assert_cmpuint (after.restarts, ==, before.restarts);
+  g_assert_cmpuint (starts, ==, 1);
+  g_assert_cmpuint (feed_starts, ==, 1);
+
+  g_assert (gst_worker_stop_force (worker, TRUE));
+  wait_for (&ends, 1);
+  g_object_unref (worker);
+  g_assert (gst_worker_stop_force (feed, TRUE));
+  wait_for (&feed_ends, 1);
+  g_object_unref (feed);
+  gst_worker_set_watchdog (0);
+}
+
+static void
+test_watchdog_unwritten (void)
+{
+  GstWorkerWatchdogStats before, after;
+  GstWorker *worker;
+  guint starts = 0, ends = 0;
+
+  /* nobody ever writes the channel, like a composite with no input yet */
+  gst_worker_set_watchdog (TIMEOUT);
+  gst_worker_get_watchdog_stats (&before);
+  worker = new_worker ("intervideosrc channel=unwritten ! fakesink", &starts,
+      &ends);
+  g_assert (gst_worker_start (worker));
+  wait_for (&starts, 1);
+
+  run_for (5 * TIMEOUT);
+  gst_worker_get_watchdog_stats (&after);
+  g_assert_cmpuint (after.stalls, ==, before.stalls);
+  g_assert_cmpuint (after.restarts, ==, before.restarts);
+  g_assert_cmpuint (starts, ==, 1);
+
+  g_assert (gst_worker_stop_force (worker, TRUE));
+  wait_for (&ends, 1);
+  g_object_unref (worker);
+  gst_worker_set_watchdog (0);
+}
+
+static void
+test_watchdog_backoff (void)
+{
+  GstWorkerWatchdogStats before, after;
+  GstWorker *worker;
+  guint starts = 0, ends = 0, i;
+  gint64 restarts[4];
+
+  /* the sink never renders, every new pipeline is stuck again */
+  gst_worker_set_watchdog (TIMEOUT);
+  gst_worker_get_watchdog_stats (&before);
+  worker = new_worker ("videotestsrc is-live=true ! queue max-size-buffers=1 "
+      "! fakesink async=false sync=true ts-offset=3600000000000",
+      &starts, &ends);
+  g_assert (gst_worker_start (worker));
+
+  for (i = 0; i < G_N_ELEMENTS (restarts); ++i) {
+    wait_for (&starts, i + 2);
+    restarts[i] = g_get_monotonic_time ();
+  }
+  printf ("\nWATCHDOG: restarts %" G_GINT64_FORMAT ", %" G_GINT64_FORMAT
+      ", %" G_GINT64_FORMAT " ms apart\n", (restarts[1] - restarts[0]) / 1000,
+      (restarts[2] - restarts[1]) / 1000, (restarts[3] - restarts[2]) / 1000);
+
+  /* once the backoff is longer than the timeout, each restart waits twice
+     as long as the one before */
+  g_assert_cmpint (restarts[3] - restarts[2], >,
+      (restarts[2] - restarts[1]) * 3 / 2);
+  gst_worker_get_watchdog_stats (&after);
+  g_assert_cmpuint (after.stalls - before.stalls, ==, 1);
+  g_assert_cmpuint (after.recoveries, ==, before.recoveries);
+  g_assert_cmpuint (ends, ==, 0);
+
+  g_assert (gst_worker_stop_force (worker, TRUE));
+  wait_for (&ends, 1);
+  g_object_unref (worker);
+  gst_worker_set_watchdog (0);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_init (&argc, &argv);
+  g_test_init (&argc, &argv, NULL);
+  g_test_add_func ("/gstswitch/server/worker/watchdog/restart",
+      test_watchdog_restart);
+  g_test_add_func ("/gstswitch/server/worker/watchdog/idle",
+      test_watchdog_idle);
+  g_test_add_func ("/gstswitch/server/worker/watchdog/channel",
+      test_watchdog_channel);
+  g_test_add_func ("/gstswitch/server/worker/watchdog/unwritten",
+      test_watchdog_unwritten);
+  g_test_add_func ("/gstswitch/server/worker/watchdog/backoff",
+      test_watchdog_backoff);
+  return g_test_run ();
+}
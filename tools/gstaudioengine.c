@@ -0,0 +1,65 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstaudioengine.h"
+
+/**
+ * @brief Append the timing of an "interaudiosrc" to a pipeline string.
+ * @param desc the pipeline string, ending in the interaudiosrc
+ * @param period msec of audio per buffer, nothing is appended if 0
+ *
+ * The source hands out one period per buffer and reports two periods of
+ * latency. What it may hold is capped at GST_AUDIO_ENGINE_PERIODS, so a
+ * writer running ahead loses samples instead of adding latency for good.
+ */
+void
+gst_audio_engine_append_source (GString * desc, guint period)
+{
+  guint64 time = (guint64) period * GST_MSECOND;
+
+  if (period == 0)
+    return;
+
+  g_string_append_printf (desc, "period-time=%" G_GUINT64_FORMAT " "
+      "latency-time=%" G_GUINT64_FORMAT " buffer-time=%" G_GUINT64_FORMAT " ",
+      time, 2 * time, GST_AUDIO_ENGINE_PERIODS * time);
+}
+
+/**
+ * @brief Append the "audioparse" of an audio hop to a pipeline string.
+ * @param desc the pipeline string
+ * @param period msec of audio per buffer, 0 without the audio engine
+ *
+ * The caps of every audio hop are fixed already, the engine leaves the
+ * parser out.
+ */
+void
+gst_audio_engine_append_parse (GString * desc, guint period)
+{
+  if (period != 0)
+    return;
+
+  g_string_append (desc, "! audioparse raw-format=s16le rate=48000 ");
+}
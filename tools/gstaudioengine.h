@@ -0,0 +1,36 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*! @file */
+
+#ifndef __GST_AUDIO_ENGINE_H__
+#define __GST_AUDIO_ENGINE_H__
+
+#include <gst/gst.h>
+
+#define GST_AUDIO_ENGINE_MIN_PERIOD 2   /* msec */
+#define GST_AUDIO_ENGINE_MAX_PERIOD 20  /* msec */
+#define GST_AUDIO_ENGINE_PERIODS 8      /* periods an audio hop may hold */
+#define GST_AUDIO_ENGINE_PRIORITY 50    /* SCHED_FIFO priority of audio threads */
+
+void gst_audio_engine_append_source (GString * desc, guint period);
+void gst_audio_engine_append_parse (GString * desc, guint period);
+
+#endif //__GST_AUDIO_ENGINE_H__
@@ -37,6 +37,7 @@ enum
   PROP_PORT,
   PROP_HANDLE,
   PROP_ACTIVE,
+  PROP_METER,
 };
 
 /**
@@ -62,6 +63,7 @@ gst_audio_visual_init (GstAudioVisual * visual)
   visual->port = 0;
   visual->handle = 0;
   visual->active = FALSE;
+  visual->meter = TRUE;
   visual->endtime = 0;
 
   g_mutex_init (&visual->endtime_lock);
@@ -127,6 +129,9 @@ gst_audio_visual_set_property (GstAudioVisual * visual, guint property_id,
     case PROP_ACTIVE:
       visual->active = g_value_get_boolean (value);
       break;
+    case PROP_METER:
+      visual->meter = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (visual), property_id, pspec);
       break;
@@ -157,6 +162,9 @@ gst_audio_visual_get_property (GstAudioVisual * visual, guint property_id,
     case PROP_ACTIVE:
       g_value_set_boolean (value, visual->active);
       break;
+    case PROP_METER:
+      g_value_set_boolean (value, visual->meter);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (visual), property_id, pspec);
       break;
@@ -237,9 +245,10 @@ gst_audio_visual_get_pipeline_string (GstAudioVisual * visual)
   g_string_append_printf (desc, "! gdpdepay ! tee name=a\n");
 
   if (visual->active) {
-    g_string_append_printf (desc,
-        "a. ! queue ! audioconvert ! level name=level message=true !"
-        " autoaudiosink name=play sync=false\n");
+    g_string_append_printf (desc, "a. ! queue ! audioconvert ! ");
+    if (visual->meter)
+      g_string_append_printf (desc, "level name=level message=true ! ");
+    g_string_append_printf (desc, "autoaudiosink name=play sync=false\n");
   }
 
   g_string_append_printf (desc, "a. ! queue ! audioconvert ! monoscope ");
@@ -409,6 +418,11 @@ gst_audio_visual_class_init (GstAudioVisualClass * klass)
           "Activated audio",
           FALSE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (object_class, PROP_METER,
+      g_param_spec_boolean ("meter", "Meter",
+          "Meter the active audio locally",
+          TRUE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   worker_class->missing = gst_audio_visual_missing;
   worker_class->prepare = (GstWorkerPrepareFunc) gst_audio_visual_prepare;
   worker_class->message = (GstWorkerMessageFunc) gst_audio_visual_message;
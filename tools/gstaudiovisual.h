@@ -48,6 +48,8 @@ struct _GstAudioVisual
                                  *   the real hardware speaker, e.g. ALSA
                                  **/
 
+  gboolean meter;               /*!< FALSE if the server meters the audio */
+
   gboolean renewing;            /*!< Used by GstSwitchUI. */
 
   GMutex endtime_lock;          /*!< the lock for %endtime */
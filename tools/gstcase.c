@@ -27,6 +27,7 @@
 #include <string.h>
 #include "gstswitchserver.h"
 #include "gstcase.h"
+#include "gstaudioengine.h"
 
 enum
 {
@@ -43,6 +44,9 @@ enum
   PROP_A_HEIGHT,
   PROP_B_WIDTH,
   PROP_B_HEIGHT,
+  PROP_THUMB_PORT,
+  PROP_RATE,
+  PROP_JPEG,
 };
 
 enum
@@ -54,6 +58,12 @@ enum
 extern gboolean verbose;
 
 #define gst_case_parent_class parent_class
+
+/* holds what an A/V sync offset delays, limited in time only so that
+   large frames never block the source */
+#define GST_CASE_DELAY_TIME 2000000000  /* 2 * GST_CASE_MAX_OFFSET */
+#define GST_CASE_DELAY_QUEUE "queue name=delay max-size-buffers=0 " \
+  "max-size-bytes=0 max-size-time=" G_STRINGIFY (GST_CASE_DELAY_TIME)
 G_DEFINE_TYPE (GstCase, gst_case, GST_TYPE_WORKER);
 
 /**
@@ -79,6 +89,21 @@ gst_case_init (GstCase * cas)
   cas->a_height = 0;
   cas->b_width = 0;
   cas->b_height = 0;
+  cas->thumb_port = 0;
+  cas->rate = 0;
+  cas->jpeg = FALSE;
+  cas->clients = 0;
+  cas->idle_buffers = 0;
+  cas->idle_since = g_get_monotonic_time ();
+  cas->idle_time = 0;
+  cas->idle_refresh = 0;
+  cas->buffer_start = 0;
+  cas->buffer_cost = 0;
+  cas->linger = 0;
+  cas->offset = 0;
+
+  g_mutex_init (&cas->gate_lock);
+  gst_meter_init (&cas->meter);
 
   //INFO ("init %p", cas);
 }
@@ -140,6 +165,9 @@ gst_case_dispose (GstCase * cas)
 static void
 gst_case_finalize (GstCase * cas)
 {
+  g_mutex_clear (&cas->gate_lock);
+  gst_meter_clear (&cas->meter);
+
   if (G_OBJECT_CLASS (parent_class)->finalize)
     (*G_OBJECT_CLASS (parent_class)->finalize) (G_OBJECT (cas));
 }
@@ -196,6 +224,15 @@ gst_case_get_property (GstCase * cas, guint property_id,
     case PROP_B_HEIGHT:
       g_value_set_uint (value, cas->b_height);
       break;
+    case PROP_THUMB_PORT:
+      g_value_set_uint (value, cas->thumb_port);
+      break;
+    case PROP_RATE:
+      g_value_set_uint (value, cas->rate);
+      break;
+    case PROP_JPEG:
+      g_value_set_boolean (value, cas->jpeg);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (cas, property_id, pspec);
       break;
@@ -269,6 +306,15 @@ gst_case_set_property (GstCase * cas, guint property_id,
     case PROP_B_HEIGHT:
       cas->b_height = g_value_get_uint (value);
       break;
+    case PROP_THUMB_PORT:
+      cas->thumb_port = g_value_get_uint (value);
+      break;
+    case PROP_RATE:
+      cas->rate = g_value_get_uint (value);
+      break;
+    case PROP_JPEG:
+      cas->jpeg = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (cas), property_id, pspec);
       break;
@@ -294,9 +340,19 @@ gst_case_get_pipeline_string (GstCase * cas)
 
   switch (cas->type) {
     case GST_CASE_INPUT_AUDIO:
-      g_string_append_printf (desc,
-          "giostreamsrc name=source ! gdpdepay ! %s ! interaudiosink name=sink channel=input_%d",
-          caps, cas->sink_port);
+      if (opts.record_iso) {
+        /* an interaudio channel splits its samples between its readers,
+           the input recording reads a channel of its own */
+        g_string_append_printf (desc,
+            "giostreamsrc name=source ! gdpdepay ! %s ! tee name=s "
+            "s. ! queue ! interaudiosink name=sink channel=input_%d "
+            "s. ! queue ! interaudiosink name=iso channel=iso_%d",
+            caps, cas->sink_port, cas->sink_port);
+      } else {
+        g_string_append_printf (desc,
+            "giostreamsrc name=source ! gdpdepay ! %s ! interaudiosink name=sink channel=input_%d",
+            caps, cas->sink_port);
+      }
       break;
 
     case GST_CASE_INPUT_VIDEO:
@@ -308,21 +364,49 @@ gst_case_get_pipeline_string (GstCase * cas)
     case GST_CASE_PREVIEW:
       if (is_audiostream) {
         g_string_append_printf (desc,
-            "interaudiosrc name=source channel=input_%d ! %s ! audioparse raw-format=s16le rate=48000 ! interaudiosink name=sink channel=branch_%d",
-            cas->sink_port, caps, cas->sink_port);
+            "interaudiosrc name=source channel=input_%d ", cas->sink_port);
+        gst_audio_engine_append_source (desc, opts.audio_period);
+        g_string_append_printf (desc, "! %s ! " GST_CASE_DELAY_QUEUE " ",
+            caps);
+        gst_audio_engine_append_parse (desc, opts.audio_period);
+        gst_meter_append_element (desc, opts.meter_interval);
+        if (opts.audio_mix) {
+          g_string_append_printf (desc, "! tee name=s "
+              "s. ! queue ! interaudiosink name=sink1 channel=branch_%d "
+              "s. ! queue ! interaudiosink name=sink2 channel=mix_%d",
+              cas->sink_port, cas->sink_port);
+        } else {
+          g_string_append_printf (desc,
+              "! interaudiosink name=sink channel=branch_%d", cas->sink_port);
+        }
       } else {
         g_string_append_printf (desc,
-            "intervideosrc name=source channel=input_%d ! %s ! intervideosink name=sink channel=branch_%d",
+            "intervideosrc name=source channel=input_%d ! %s ! "
+            GST_CASE_DELAY_QUEUE " ! intervideosink name=sink channel=branch_%d",
             cas->sink_port, caps, cas->sink_port);
       }
       break;
 
     case GST_CASE_COMPOSITE_AUDIO:
+      /* with --audio-mix the mixer owns composite_audio and every audio
+         input is fed to it instead */
       g_string_append_printf (desc,
-          "interaudiosrc name=source channel=input_%d ! %s ! audioparse raw-format=s16le rate=48000 ! tee name=s "
-          "s. ! queue ! interaudiosink name=sink1 channel=branch_%d "
-          "s. ! queue ! interaudiosink name=sink2 channel=composite_audio",
-          cas->sink_port, caps, cas->sink_port);
+          "interaudiosrc name=source channel=input_%d ", cas->sink_port);
+      gst_audio_engine_append_source (desc, opts.audio_period);
+      g_string_append_printf (desc, "! %s ! " GST_CASE_DELAY_QUEUE " ", caps);
+      gst_audio_engine_append_parse (desc, opts.audio_period);
+      gst_meter_append_element (desc, opts.meter_interval);
+      g_string_append_printf (desc, "! tee name=s "
+          "s. ! queue ! interaudiosink name=sink1 channel=branch_%d ",
+          cas->sink_port);
+      if (opts.audio_mix) {
+        g_string_append_printf (desc,
+            "s. ! queue ! interaudiosink name=sink2 channel=mix_%d",
+            cas->sink_port);
+      } else {
+        g_string_append_printf (desc,
+            "s. ! queue ! interaudiosink name=sink2 channel=composite_audio");
+      }
       break;
 
     case GST_CASE_COMPOSITE_VIDEO_A:
@@ -330,7 +414,8 @@ gst_case_get_pipeline_string (GstCase * cas)
     {
       gchar *channel = cas->type == GST_CASE_COMPOSITE_VIDEO_A ? "a" : "b";
       g_string_append_printf (desc,
-          "intervideosrc name=source channel=input_%d ! %s ! tee name=s "
+          "intervideosrc name=source channel=input_%d ! %s ! "
+          GST_CASE_DELAY_QUEUE " ! tee name=s "
           "s. ! queue ! intervideosink name=sink1 channel=branch_%d "
           "s. ! queue ! intervideosink name=sink2 channel=composite_%s",
           cas->sink_port, caps, cas->sink_port, channel);
@@ -339,21 +424,47 @@ gst_case_get_pipeline_string (GstCase * cas)
 
     case GST_CASE_BRANCH_AUDIO:
       g_string_append_printf (desc,
-          "interaudiosrc name=source channel=branch_%d ! %s ! audioparse raw-format=s16le rate=48000 ! gdppay ! tcpserversink name=sink port=%d",
-          cas->sink_port, caps, cas->sink_port);
+          "interaudiosrc name=source channel=branch_%d ", cas->sink_port);
+      gst_audio_engine_append_source (desc, opts.audio_period);
+      g_string_append_printf (desc, "! %s ! identity name=gate ", caps);
+      gst_audio_engine_append_parse (desc, opts.audio_period);
+      g_string_append_printf (desc, "! gdppay ! tcpserversink name=sink "
+          GST_SWITCH_SERVE_LATEST_BUFFER " port=%d", cas->sink_port);
       break;
 
     case GST_CASE_BRANCH_VIDEO_A:
     case GST_CASE_BRANCH_VIDEO_B:
+    case GST_CASE_BRANCH_PREVIEW:
+    {
+      gchar *path = g_strdup_printf ("preview_%d", cas->sink_port);
       g_string_append_printf (desc,
-          "intervideosrc name=source channel=branch_%d ! %s ! gdppay ! tcpserversink name=sink port=%d",
-          cas->sink_port, caps, cas->sink_port);
+          "intervideosrc name=source channel=branch_%d ! %s ",
+          cas->sink_port, caps);
+      /* before the gate, so it is measured without clients too */
+      gst_switch_server_append_latency_detect (desc, path);
+      g_string_append_printf (desc, "! identity name=gate "
+          "! gdppay ! tcpserversink name=sink "
+          GST_SWITCH_SERVE_LATEST_BUFFER " port=%d", cas->sink_port);
+      g_free (path);
       break;
+    }
 
-    case GST_CASE_BRANCH_PREVIEW:
+    case GST_CASE_BRANCH_THUMBNAIL:
+      /* Drop frames before scaling, so decimated thumbnails are cheap. */
       g_string_append_printf (desc,
-          "intervideosrc name=source channel=branch_%d ! %s ! gdppay ! tcpserversink name=sink port=%d",
-          cas->sink_port, caps, cas->sink_port);
+          "intervideosrc name=source channel=branch_%d ! %s "
+          "! identity name=gate ", cas->sink_port, caps);
+      if (cas->rate) {
+        g_string_append_printf (desc, "! videorate drop-only=true "
+            "! video/x-raw,framerate=%d/1 ", cas->rate);
+      }
+      g_string_append_printf (desc, "! videoscale "
+          "! video/x-raw,width=%d,height=%d ", cas->width, cas->height);
+      if (cas->jpeg) {
+        g_string_append_printf (desc, "! jpegenc quality=75 ");
+      }
+      g_string_append_printf (desc, "! gdppay ! tcpserversink name=sink "
+          GST_SWITCH_SERVE_LATEST_BUFFER " port=%d", cas->thumb_port);
       break;
 
     default:
@@ -365,6 +476,173 @@ gst_case_get_pipeline_string (GstCase * cas)
   return desc;
 }
 
+/**
+ * @memberof GstCase
+ *
+ * The gate of a branch. While no client is attached, buffers are dropped
+ * right after the source so nothing is payloaded, encoded or written to
+ * sockets. One buffer per GST_CASE_IDLE_REFRESH_INTERVAL is still let
+ * through, so the sink always holds a recent frame to burst to the next
+ * client. Events are not affected, so caps stay negotiated.
+ */
+static GstPadProbeReturn
+gst_case_gate_sink_probe (GstPad * pad, GstPadProbeInfo * info, GstCase * cas)
+{
+  GstPadProbeReturn ret = GST_PAD_PROBE_OK;
+  gint64 now;
+
+  g_mutex_lock (&cas->gate_lock);
+  if (cas->clients == 0) {
+    now = g_get_monotonic_time ();
+    if (now - cas->idle_refresh < GST_CASE_IDLE_REFRESH_INTERVAL) {
+      cas->idle_buffers += 1;
+      ret = GST_PAD_PROBE_DROP;
+    } else {
+      cas->idle_refresh = now;
+    }
+  }
+  g_mutex_unlock (&cas->gate_lock);
+  return ret;
+}
+
+/**
+ * @memberof GstCase
+ *
+ * Marks a buffer passing the open gate.
+ */
+static GstPadProbeReturn
+gst_case_gate_src_probe (GstPad * pad, GstPadProbeInfo * info, GstCase * cas)
+{
+  g_mutex_lock (&cas->gate_lock);
+  cas->buffer_start = g_get_monotonic_time ();
+  g_mutex_unlock (&cas->gate_lock);
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @memberof GstCase
+ *
+ * Measures the cost of serving a buffer, from the gate to the sink.
+ */
+static GstPadProbeReturn
+gst_case_sink_probe (GstPad * pad, GstPadProbeInfo * info, GstCase * cas)
+{
+  g_mutex_lock (&cas->gate_lock);
+  if (cas->buffer_start) {
+    gint64 cost = g_get_monotonic_time () - cas->buffer_start;
+    if (cas->buffer_cost == 0)
+      cas->buffer_cost = cost;
+    else
+      cas->buffer_cost += (cost - cas->buffer_cost) / 8;
+    cas->buffer_start = 0;
+  }
+  g_mutex_unlock (&cas->gate_lock);
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @param cas The GstCase instance.
+ * @param stats (output) the statistics
+ * @memberof GstCase
+ *
+ * Take a snapshot of the demand statistics of a branch. The saved time is
+ * estimated from the buffers dropped at the gate and the measured cost of
+ * serving one. Until a client has attached once the cost is unknown and
+ * the saved time is reported as 0.
+ */
+void
+gst_case_get_branch_stats (GstCase * cas, GstCaseBranchStats * stats)
+{
+  g_return_if_fail (GST_IS_CASE (cas));
+
+  g_mutex_lock (&cas->gate_lock);
+  stats->clients = cas->clients;
+  stats->idle_buffers = cas->idle_buffers;
+  stats->idle_time = cas->idle_time;
+  if (cas->clients == 0)
+    stats->idle_time += g_get_monotonic_time () - cas->idle_since;
+  stats->buffer_cost = cas->buffer_cost;
+  stats->saved_time = cas->buffer_cost * (gint64) cas->idle_buffers;
+  g_mutex_unlock (&cas->gate_lock);
+}
+
+/**
+ * @param cas The GstCase instance.
+ * @param level (output) the level
+ * @memberof GstCase
+ * @return TRUE if the case is metering its audio and the level is fresh
+ *
+ * Get the latest level of an audio input, only the preview and composite
+ * audio cases are metered.
+ */
+gboolean
+gst_case_get_level (GstCase * cas, GstMeterLevel * level)
+{
+  g_return_val_if_fail (GST_IS_CASE (cas), FALSE);
+
+  return gst_meter_get_level (&cas->meter, level);
+}
+
+/**
+ * @param cas The GstCase instance.
+ * @param source The source element of the case.
+ * @memberof GstCase
+ *
+ * Delay what the case reads from its input by the sync offset of the
+ * input, the offset is rounded to whole samples for audio.
+ */
+static void
+gst_case_set_source_offset (GstCase * cas, GstElement * source)
+{
+  GstClockTime offset = cas->input ? cas->input->offset : 0;
+  GstPad *pad;
+
+  if (cas->serve_type == GST_SERVE_AUDIO_STREAM) {
+    guint64 samples = gst_util_uint64_scale_round (offset, 48000, GST_SECOND);
+    offset = gst_util_uint64_scale (samples, GST_SECOND, 48000);
+  }
+
+  pad = gst_element_get_static_pad (source, "src");
+  gst_pad_set_offset (pad, offset);
+  gst_object_unref (pad);
+}
+
+/**
+ * @param cas The GstCase instance, reading an input.
+ * @memberof GstCase
+ *
+ * Apply a changed sync offset of the input to the running pipeline. The
+ * delay queue takes up the difference, nothing is restarted.
+ */
+void
+gst_case_apply_offset (GstCase * cas)
+{
+  GstElement *source;
+
+  g_return_if_fail (GST_IS_CASE (cas));
+
+  source = gst_worker_get_element (GST_WORKER (cas), "source");
+  if (source) {
+    gst_case_set_source_offset (cas, source);
+    gst_object_unref (source);
+  }
+}
+
+/**
+ * @param cas The GstCase instance.
+ * @param message The message.
+ * @memberof GstCase
+ * @return TRUE to receive further messages
+ *
+ * Handling pipeline messages, the levels of the metered audio cases.
+ */
+static gboolean
+gst_case_message (GstCase * cas, GstMessage * message)
+{
+  gst_meter_message (&cas->meter, message);
+  return TRUE;
+}
+
 /**
  * @param element
  * @param socket
@@ -380,6 +658,13 @@ gst_case_client_socket_added (GstElement * element,
   g_return_if_fail (G_IS_SOCKET (socket));
 
   //INFO ("client-socket-added: %d", g_socket_get_fd (socket));
+
+  g_mutex_lock (&cas->gate_lock);
+  if (cas->clients++ == 0) {
+    cas->idle_time += g_get_monotonic_time () - cas->idle_since;
+    INFO ("%s: active", GST_WORKER (cas)->name);
+  }
+  g_mutex_unlock (&cas->gate_lock);
 }
 
 /**
@@ -394,13 +679,134 @@ static void
 gst_case_client_socket_removed (GstElement * element,
     GSocket * socket, GstCase * cas)
 {
+  gboolean idle = FALSE;
+
   g_return_if_fail (G_IS_SOCKET (socket));
 
   //INFO ("client-socket-removed: %d", g_socket_get_fd (socket));
 
+  g_mutex_lock (&cas->gate_lock);
+  if (cas->clients > 0 && --cas->clients == 0) {
+    cas->idle_since = g_get_monotonic_time ();
+    idle = TRUE;
+    INFO ("%s: idle", GST_WORKER (cas)->name);
+  }
+  g_mutex_unlock (&cas->gate_lock);
+
+  /* a thumbnail is only kept for its clients */
+  if (idle && cas->type == GST_CASE_BRANCH_THUMBNAIL)
+    gst_case_linger (cas);
+
   g_socket_close (socket, NULL);
 }
 
+/**
+ * @param cas The GstCase instance.
+ * @memberof GstCase
+ *
+ * End a thumbnail nobody came back to, in the main loop.
+ */
+static gboolean
+gst_case_linger_end (GstCase * cas)
+{
+  gboolean idle;
+
+  g_mutex_lock (&cas->gate_lock);
+  if (cas->linger == g_source_get_id (g_main_current_source ()))
+    cas->linger = 0;
+  idle = cas->linger == 0 && cas->clients == 0;
+  g_mutex_unlock (&cas->gate_lock);
+
+  if (idle) {
+    INFO ("%s: no clients, ending", GST_WORKER (cas)->name);
+    gst_worker_stop (GST_WORKER (cas));
+  }
+  return FALSE;
+}
+
+/**
+ * @param cas The GstCase instance.
+ * @memberof GstCase
+ *
+ * Stop a thumbnail if it has no client in GST_CASE_THUMBNAIL_LINGER
+ * seconds. Invoked when it is handed to a client, and when its last
+ * client left, from any thread. Every call starts the time over.
+ */
+void
+gst_case_linger (GstCase * cas)
+{
+  g_return_if_fail (GST_IS_CASE (cas));
+
+  g_mutex_lock (&cas->gate_lock);
+  if (cas->linger)
+    g_source_remove (cas->linger);
+  cas->linger = g_timeout_add_seconds_full (G_PRIORITY_DEFAULT,
+      GST_CASE_THUMBNAIL_LINGER, (GSourceFunc) gst_case_linger_end,
+      g_object_ref (cas), g_object_unref);
+  g_mutex_unlock (&cas->gate_lock);
+}
+
+/**
+ * @param cas The GstCase instance.
+ * @memberof GstCase
+ * @return The pool key, NULL if the case is not pooled
+ *
+ * The cases a switch recreates are pooled. Their pipelines only differ in
+ * the port of the input, the rest of the shape is fixed by the type.
+ */
+static gchar *
+gst_case_get_pool_key (GstCase * cas)
+{
+  switch (cas->type) {
+    case GST_CASE_COMPOSITE_VIDEO_A:
+    case GST_CASE_COMPOSITE_VIDEO_B:
+    case GST_CASE_COMPOSITE_AUDIO:
+    case GST_CASE_PREVIEW:
+      return g_strdup_printf ("case-%d-%d", cas->type, cas->serve_type);
+    default:
+      return NULL;
+  }
+}
+
+/**
+ * @param cas The GstCase instance.
+ * @param pipeline A pooled pipeline of the same shape.
+ * @memberof GstCase
+ * @return TRUE if the pipeline is usable
+ *
+ * Point the inter elements of a pooled pipeline to the port of the case.
+ * Only channels ending in a port number are changed, "composite_a" and the
+ * like stay as they are.
+ */
+static gboolean
+gst_case_reuse (GstCase * cas, GstElement * pipeline)
+{
+  static const gchar *names[] = { "source", "sink", "sink1", "sink2" };
+  gboolean ok = FALSE;
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (names); ++i) {
+    GstElement *element = gst_bin_get_by_name (GST_BIN (pipeline), names[i]);
+    gchar *channel = NULL, *port, *renamed;
+
+    if (element == NULL)
+      continue;
+
+    g_object_get (element, "channel", &channel, NULL);
+    port = channel ? strrchr (channel, '_') : NULL;
+    if (port && g_ascii_isdigit (port[1])) {
+      port[1] = '\0';
+      renamed = g_strdup_printf ("%s%d", channel, cas->sink_port);
+      g_object_set (element, "channel", renamed, NULL);
+      g_free (renamed);
+    }
+    g_free (channel);
+    gst_object_unref (element);
+    ok = TRUE;
+  }
+  return ok;
+}
+
 /**
  * @param cas The GstCase instance.
  * @memberof GstCase
@@ -412,6 +818,10 @@ gst_case_prepare (GstCase * cas)
 {
   GstWorker *worker = GST_WORKER (cas);
   GstElement *source = NULL;
+
+  if (cas->serve_type == GST_SERVE_AUDIO_STREAM && opts.audio_realtime)
+    worker->priority = GST_AUDIO_ENGINE_PRIORITY;
+
   switch (cas->type) {
     case GST_CASE_INPUT_AUDIO:
     case GST_CASE_INPUT_VIDEO:
@@ -428,20 +838,69 @@ gst_case_prepare (GstCase * cas)
       gst_object_unref (source);
       break;
 
+    case GST_CASE_COMPOSITE_VIDEO_A:
+    case GST_CASE_COMPOSITE_VIDEO_B:
+    case GST_CASE_COMPOSITE_AUDIO:
+    case GST_CASE_PREVIEW:
+      source = gst_worker_get_element_unlocked (worker, "source");
+      if (source) {
+        gst_case_set_source_offset (cas, source);
+        gst_object_unref (source);
+      }
+      break;
+
     case GST_CASE_BRANCH_VIDEO_A:
     case GST_CASE_BRANCH_VIDEO_B:
     case GST_CASE_BRANCH_AUDIO:
     case GST_CASE_BRANCH_PREVIEW:
+    case GST_CASE_BRANCH_THUMBNAIL:
     {
       GstElement *sink = gst_worker_get_element_unlocked (worker, "sink");
+      GstElement *gate = gst_worker_get_element_unlocked (worker, "gate");
+      GstPad *pad;
 
-      g_return_val_if_fail (GST_IS_ELEMENT (sink), FALSE);
+      if (!GST_IS_ELEMENT (sink) || !GST_IS_ELEMENT (gate)) {
+        ERROR ("no gate or sink");
+        if (sink)
+          gst_object_unref (sink);
+        if (gate)
+          gst_object_unref (gate);
+        return FALSE;
+      }
 
       g_signal_connect (sink, "client-added",
           G_CALLBACK (gst_case_client_socket_added), cas);
 
       g_signal_connect (sink, "client-socket-removed",
           G_CALLBACK (gst_case_client_socket_removed), cas);
+
+      gst_worker_watch_clients (worker, sink, FALSE);
+
+      /* A reset pipeline starts idle again. */
+      g_mutex_lock (&cas->gate_lock);
+      if (cas->clients) {
+        cas->clients = 0;
+        cas->idle_since = g_get_monotonic_time ();
+      }
+      g_mutex_unlock (&cas->gate_lock);
+
+      pad = gst_element_get_static_pad (gate, "sink");
+      gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+          (GstPadProbeCallback) gst_case_gate_sink_probe, cas, NULL);
+      gst_object_unref (pad);
+
+      pad = gst_element_get_static_pad (gate, "src");
+      gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+          (GstPadProbeCallback) gst_case_gate_src_probe, cas, NULL);
+      gst_object_unref (pad);
+
+      pad = gst_element_get_static_pad (sink, "sink");
+      gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+          (GstPadProbeCallback) gst_case_sink_probe, cas, NULL);
+      gst_object_unref (pad);
+
+      gst_object_unref (gate);
+      gst_object_unref (sink);
     }
       break;
 
@@ -547,8 +1006,27 @@ gst_case_class_init (GstCaseClass * klass)
           gst_composite_default_height (),
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (object_class, PROP_THUMB_PORT,
+      g_param_spec_uint ("thumbport", "Thumbnail Port",
+          "The port serving the thumbnail", 0,
+          GST_SWITCH_MAX_SINK_PORT, 0,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_RATE,
+      g_param_spec_uint ("rate", "Rate",
+          "Thumbnail frame rate, 0 for the input rate", 0,
+          G_MAXINT, 0, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_JPEG,
+      g_param_spec_boolean ("jpeg", "JPEG",
+          "Encode the thumbnail as JPEG", FALSE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   worker_class->prepare = (GstWorkerPrepareFunc) gst_case_prepare;
   worker_class->get_pipeline_string = (GstWorkerGetPipelineStringFunc)
       gst_case_get_pipeline_string;
   worker_class->close = (GstWorkerCloseFunc) gst_case_close;
+  worker_class->message = (GstWorkerMessageFunc) gst_case_message;
+  worker_class->get_pool_key = (GstWorkerGetPoolKeyFunc) gst_case_get_pool_key;
+  worker_class->reuse = (GstWorkerReuseFunc) gst_case_reuse;
 }
@@ -23,6 +23,7 @@
 #define __GST_CASE_H__
 
 #include "gstworker.h"
+#include "gstmeter.h"
 #include <gio/gio.h>
 
 #define GST_TYPE_CASE (gst_case_get_type ())
@@ -31,8 +32,13 @@
 #define GST_IS_CASE(object) (G_TYPE_CHECK_INSTANCE_TYPE ((object), GST_TYPE_CASE))
 #define GST_IS_CASE_CLASS(class) (G_TYPE_CHECK_CLASS_TYPE ((class), GST_TYPE_CASE))
 
+#define GST_CASE_IDLE_REFRESH_INTERVAL G_USEC_PER_SEC   /* usec */
+#define GST_CASE_MAX_OFFSET GST_SECOND  /* the longest A/V sync delay */
+#define GST_CASE_THUMBNAIL_LINGER 10    /* seconds a thumbnail has no clients */
+
 typedef struct _GstCase GstCase;
 typedef struct _GstCaseClass GstCaseClass;
+typedef struct _GstCaseBranchStats GstCaseBranchStats;
 
 /**
  *  @brief The type of GstCase.
@@ -50,7 +56,8 @@ typedef enum
   GST_CASE_BRANCH_VIDEO_B,      /*!< special case for branching channel B to output */
   GST_CASE_BRANCH_AUDIO,        /*!< special case for branching active audio to output */
   GST_CASE_BRANCH_PREVIEW,      /*!< special case for branching preview to output */
-  GST_CASE__LAST_TYPE = GST_CASE_BRANCH_PREVIEW
+  GST_CASE_BRANCH_THUMBNAIL,    /*!< downscaled variant of a branch for previews */
+  GST_CASE__LAST_TYPE = GST_CASE_BRANCH_THUMBNAIL
 } GstCaseType;
 
 /**
@@ -74,6 +81,18 @@ typedef enum
   GST_SERVE_AUDIO_STREAM,
 } GstSwitchServeStreamType;
 
+/**
+ *  @brief Demand statistics of a branch case.
+ */
+struct _GstCaseBranchStats
+{
+  guint clients;                /*!< clients attached to the branch */
+  guint64 idle_buffers;         /*!< buffers dropped while nobody watched */
+  gint64 idle_time;             /*!< time spent without clients, usec */
+  gint64 buffer_cost;           /*!< smoothed cost of serving a buffer, usec */
+  gint64 saved_time;            /*!< estimated processing time saved, usec */
+};
+
 /**
  *  @class GstCase
  *  @struct _GstCase
@@ -95,6 +114,22 @@ typedef struct _GstCase
   guint a_height;
   guint b_width;
   guint b_height;
+  gint thumb_port;              /*!< The port serving the thumbnail. */
+  guint rate;                   /*!< The thumbnail frame rate, 0 for the input rate. */
+  gboolean jpeg;                /*!< TRUE if the thumbnail is JPEG encoded. */
+
+  GMutex gate_lock;             /*!< The lock for the branch gate state below. */
+  guint clients;                /*!< Clients attached to the branch sink. */
+  guint64 idle_buffers;         /*!< Buffers dropped at the gate. */
+  gint64 idle_since;            /*!< When the branch went idle, usec. */
+  gint64 idle_time;             /*!< Accumulated idle time, usec. */
+  gint64 idle_refresh;          /*!< When a buffer last passed while idle. */
+  gint64 buffer_start;          /*!< When the last buffer passed the gate. */
+  gint64 buffer_cost;           /*!< Smoothed gate to sink time, usec. */
+  guint linger;                 /*!< The source ending an idle thumbnail. */
+
+  GstMeter meter;               /*!< The level of an audio input case. */
+  GstClockTime offset;          /*!< The sync delay of an input case, ns. */
 } GstCase;
 
 /**
@@ -110,5 +145,9 @@ typedef struct _GstCaseClass
 } GstCaseClass;
 
 GType gst_case_get_type (void);
+void gst_case_get_branch_stats (GstCase * cas, GstCaseBranchStats * stats);
+gboolean gst_case_get_level (GstCase * cas, GstMeterLevel * level);
+void gst_case_apply_offset (GstCase * cas);
+void gst_case_linger (GstCase * cas);
 
 #endif //__GST_CASE_H__
@@ -70,6 +70,8 @@ G_DEFINE_TYPE (GstComposite, gst_composite, GST_TYPE_WORKER);
 
 static void gst_composite_set_mode (GstComposite *, GstCompositeMode);
 static void gst_composite_start_transition (GstComposite *);
+static void gst_composite_apply_parameters (GstComposite *);
+static gboolean gst_composite_end_transition (GstComposite *);
 
 /**
  * Initialize the GstComposite instance.
@@ -231,7 +233,7 @@ gst_composite_ready_for_transition (GstComposite * composite)
  * gst_composite_start_transition:
  *
  * Start the new transition request, this will set the %transition flag into
- * TRUE.
+ * TRUE until the new mode is playing, or applied if the pipeline is not.
  */
 static void
 gst_composite_start_transition (GstComposite * composite)
@@ -241,7 +243,17 @@ gst_composite_start_transition (GstComposite * composite)
   GST_COMPOSITE_LOCK_TRANSITION (composite);
 
   if (gst_composite_ready_for_transition (composite)) {
-    composite->transition = gst_worker_stop (GST_WORKER (composite));
+    GstWorker *worker = GST_WORKER (composite);
+    /* TRUE if a stop is under way, the null handler commits the new mode */
+    composite->transition = gst_worker_stop (worker);
+    if (!composite->transition && worker->pipeline) {
+      /* Not playing, the new mode is applied now and the next start plays
+         it. The transition still ends, in the main loop as the lock is
+         held here, so that the clients learn of the new mode. */
+      gst_composite_apply_parameters (composite);
+      composite->transition = TRUE;
+      g_idle_add ((GSourceFunc) gst_composite_end_transition, composite);
+    }
     /*
        INFO ("transtion ok=%d, %d, %dx%d", composite->transition,
        composite->mode, composite->width, composite->height);
@@ -963,15 +975,19 @@ end:
 
 /**
  * gst_composite_retry_transition:
- * @return Always FALSE to allow glib to cleanup the timeout source
  *
- * This is invoked when the pipeline's getting errors to retry the transition
- * request.
+ * This is invoked when the pipeline stopped on errors to retry the
+ * transition request, unless the pipeline is replaying already.
  */
-static gboolean
-gst_composite_retry_transition (GstComposite * composite)
+static void
+gst_composite_retry_transition (GstComposite * composite, gboolean stopped,
+    gpointer data)
 {
-  g_return_val_if_fail (GST_IS_COMPOSITE (composite), FALSE);
+  g_return_if_fail (GST_IS_COMPOSITE (composite));
+
+  if (!stopped || composite->deprecated ||
+      GST_WORKER (composite)->phase != GST_WORKER_PHASE_STOPPED)
+    return;
 
   if (composite->transition) {
     GST_COMPOSITE_LOCK_TRANSITION (composite);
@@ -983,8 +999,6 @@ gst_composite_retry_transition (GstComposite * composite)
     }
     GST_COMPOSITE_UNLOCK_TRANSITION (composite);
   }
-
-  return FALSE;
 }
 
 /**
@@ -1027,7 +1041,9 @@ gst_composite_error (GstComposite * composite)
   g_return_if_fail (GST_IS_COMPOSITE (composite));
 
   if (composite->transition) {
-    g_timeout_add (10, (GSourceFunc) gst_composite_retry_transition, composite);
+    /* joins the stop of the failed pipeline */
+    gst_worker_stop_async (GST_WORKER (composite), TRUE,
+        (GstWorkerDoneFunc) gst_composite_retry_transition, NULL);
   } else if (composite->adjusting) {
     g_timeout_add (10, (GSourceFunc) gst_composite_retry_adjustment, composite);
   }
@@ -0,0 +1,532 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include "gstswitchserver.h"
+#include "gstcomposite.h"
+#include "gstencoder.h"
+
+enum
+{
+  PROP_0,
+  PROP_CODEC,
+  PROP_PRESET,
+  PROP_BITRATE,
+  PROP_PORT,
+  PROP_WIDTH,
+  PROP_HEIGHT,
+};
+
+extern gboolean verbose;
+
+#define parent_class gst_encoder_parent_class
+
+G_DEFINE_TYPE (GstEncoder, gst_encoder, GST_TYPE_WORKER);
+
+/**
+ * x264enc speed presets accepted for H.264 outputs.
+ */
+static const gchar *gst_encoder_presets[] = {
+  "ultrafast", "superfast", "veryfast", "faster", "fast",
+  "medium", "slow", "slower", "veryslow", NULL
+};
+
+/**
+ * @brief Initialize the GstEncoder instance.
+ * @param enc The GstEncoder instance.
+ * @memberof GstEncoder
+ */
+static void
+gst_encoder_init (GstEncoder * enc)
+{
+  enc->codec = GST_ENCODER_CODEC_H264;
+  enc->preset = g_strdup (GST_ENCODER_DEFAULT_PRESET);
+  enc->bitrate = GST_ENCODER_DEFAULT_BITRATE;
+  enc->sink_port = 0;
+  enc->width = 0;
+  enc->height = 0;
+
+  memset (&enc->pending, 0, sizeof (enc->pending));
+  memset (&enc->stats, 0, sizeof (enc->stats));
+  enc->pending_head = 0;
+  enc->window_start = 0;
+  enc->window_bytes = 0;
+
+  g_mutex_init (&enc->stats_lock);
+}
+
+/**
+ * @brief Invoked to unref objects.
+ * @param enc The GstEncoder instance.
+ * @memberof GstEncoder
+ */
+static void
+gst_encoder_dispose (GstEncoder * enc)
+{
+  INFO ("dispose %p", enc);
+  G_OBJECT_CLASS (parent_class)->dispose (G_OBJECT (enc));
+}
+
+/**
+ * @brief Destroying the GstEncoder instance.
+ * @param enc The GstEncoder instance.
+ * @memberof GstEncoder
+ */
+static void
+gst_encoder_finalize (GstEncoder * enc)
+{
+  g_free (enc->preset);
+  enc->preset = NULL;
+
+  g_mutex_clear (&enc->stats_lock);
+
+  if (G_OBJECT_CLASS (parent_class)->finalize)
+    (*G_OBJECT_CLASS (parent_class)->finalize) (G_OBJECT (enc));
+}
+
+/**
+ * @brief Fetching the GstEncoder property.
+ * @param enc The GstEncoder instance.
+ * @param property_id
+ * @param value
+ * @param pspec
+ * @memberof GstEncoder
+ */
+static void
+gst_encoder_get_property (GstEncoder * enc, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_CODEC:
+      g_value_set_uint (value, enc->codec);
+      break;
+    case PROP_PRESET:
+      g_value_set_string (value, enc->preset);
+      break;
+    case PROP_BITRATE:
+      g_value_set_uint (value, enc->bitrate);
+      break;
+    case PROP_PORT:
+      g_value_set_uint (value, enc->sink_port);
+      break;
+    case PROP_WIDTH:
+      g_value_set_uint (value, enc->width);
+      break;
+    case PROP_HEIGHT:
+      g_value_set_uint (value, enc->height);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (enc, property_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Changing the GstEncoder properties.
+ * @param enc The GstEncoder instance.
+ * @param property_id
+ * @param value
+ * @param pspec
+ * @memberof GstEncoder
+ */
+static void
+gst_encoder_set_property (GstEncoder * enc, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_CODEC:
+      enc->codec = (GstEncoderCodec) g_value_get_uint (value);
+      break;
+    case PROP_PRESET:
+      g_free (enc->preset);
+      enc->preset = g_value_dup_string (value);
+      break;
+    case PROP_BITRATE:
+      enc->bitrate = g_value_get_uint (value);
+      break;
+    case PROP_PORT:
+      enc->sink_port = g_value_get_uint (value);
+      break;
+    case PROP_WIDTH:
+      enc->width = g_value_get_uint (value);
+      break;
+    case PROP_HEIGHT:
+      enc->height = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (enc), property_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Parse a codec name as used on the DBus interface.
+ * @param name "h264" or "vp8"
+ * @param codec (output) the codec
+ * @return TRUE if the name is a known codec.
+ */
+gboolean
+gst_encoder_parse_codec (const gchar * name, GstEncoderCodec * codec)
+{
+  if (g_strcmp0 (name, "h264") == 0) {
+    *codec = GST_ENCODER_CODEC_H264;
+    return TRUE;
+  }
+  if (g_strcmp0 (name, "vp8") == 0) {
+    *codec = GST_ENCODER_CODEC_VP8;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+/**
+ * @brief Get the DBus name of a codec.
+ * @param codec the codec
+ */
+const gchar *
+gst_encoder_codec_to_string (GstEncoderCodec codec)
+{
+  switch (codec) {
+    case GST_ENCODER_CODEC_H264:
+      return "h264";
+    case GST_ENCODER_CODEC_VP8:
+      return "vp8";
+  }
+  return "unknown";
+}
+
+/**
+ * @brief Check an x264 speed preset name.
+ * @param preset the preset name
+ * @return TRUE if x264enc accepts the preset.
+ */
+gboolean
+gst_encoder_is_valid_preset (const gchar * preset)
+{
+  const gchar **p;
+  for (p = gst_encoder_presets; *p; ++p) {
+    if (g_strcmp0 (*p, preset) == 0)
+      return TRUE;
+  }
+  return FALSE;
+}
+
+/**
+ * @param enc The GstEncoder instance.
+ * @memberof GstEncoder
+ * @return The encoder pipeline string, needs freeing when used
+ *
+ * Fetching the encoder pipeline invoked by the GstWorker. The composite
+ * output is encoded once here and fanned out to all clients by the single
+ * tcpserversink. New clients are started on the latest keyframe.
+ */
+static GString *
+gst_encoder_get_pipeline_string (GstEncoder * enc)
+{
+  GString *desc;
+
+  desc = g_string_new ("");
+
+  g_string_append_printf (desc, "intervideosrc name=source "
+      "channel=composite_out ");
+  g_string_append_printf (desc, "! video/x-raw,width=%d,height=%d ",
+      enc->width, enc->height);
+  g_string_append_printf (desc, "! queue max-size-buffers=2 leaky=downstream ");
+
+  switch (enc->codec) {
+    case GST_ENCODER_CODEC_H264:
+      g_string_append_printf (desc, "! x264enc name=enc tune=zerolatency "
+          "speed-preset=%s bitrate=%d key-int-max=%d ",
+          enc->preset, enc->bitrate, GST_ENCODER_KEYFRAME_INTERVAL);
+      g_string_append_printf (desc, "! h264parse config-interval=-1 ");
+      g_string_append_printf (desc, "! mpegtsmux ");
+      break;
+    case GST_ENCODER_CODEC_VP8:
+      g_string_append_printf (desc, "! vp8enc name=enc deadline=1 "
+          "target-bitrate=%d keyframe-max-dist=%d ",
+          enc->bitrate * 1000, GST_ENCODER_KEYFRAME_INTERVAL);
+      g_string_append_printf (desc, "! webmmux streamable=true ");
+      break;
+  }
+
+  g_string_append_printf (desc, "! tcpserversink name=sink sync=false "
+      GST_SWITCH_SERVE_LATEST_KEYFRAME " port=%d ",
+      enc->sink_port);
+
+  return desc;
+}
+
+/**
+ * @brief Remember when a raw frame entered the encoder.
+ * @memberof GstEncoder
+ */
+static GstPadProbeReturn
+gst_encoder_sink_probe (GstPad * pad, GstPadProbeInfo * info, GstEncoder * enc)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  guint n;
+
+  g_mutex_lock (&enc->stats_lock);
+  n = enc->pending_head++ % GST_ENCODER_PENDING_SIZE;
+  enc->pending[n].pts = GST_BUFFER_PTS (buffer);
+  enc->pending[n].time = g_get_monotonic_time ();
+  g_mutex_unlock (&enc->stats_lock);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Account an encoded frame, matching it to its raw frame by PTS.
+ * @memberof GstEncoder
+ */
+static GstPadProbeReturn
+gst_encoder_src_probe (GstPad * pad, GstPadProbeInfo * info, GstEncoder * enc)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  GstClockTime pts = GST_BUFFER_PTS (buffer);
+  gint64 now = g_get_monotonic_time ();
+  gsize size = gst_buffer_get_size (buffer);
+  guint n;
+
+  g_mutex_lock (&enc->stats_lock);
+
+  for (n = 0; GST_CLOCK_TIME_IS_VALID (pts) && n < GST_ENCODER_PENDING_SIZE;
+      ++n) {
+    if (enc->pending[n].time && enc->pending[n].pts == pts) {
+      gint64 latency = now - enc->pending[n].time;
+      if (enc->stats.latency == 0)
+        enc->stats.latency = latency;
+      else
+        enc->stats.latency += (latency - enc->stats.latency) / 8;
+      if (enc->stats.max_latency < latency)
+        enc->stats.max_latency = latency;
+      enc->pending[n].time = 0;
+      break;
+    }
+  }
+
+  enc->stats.frames += 1;
+  enc->stats.bytes += size;
+  enc->window_bytes += size;
+  if (enc->window_start == 0 ||
+      now - enc->window_start >= GST_ENCODER_BITRATE_TIMEOUT * G_USEC_PER_SEC) {
+    /* the first frame, or the first one after a stall, opens a window */
+    enc->stats.bitrate = 0;
+    enc->window_start = now;
+    enc->window_bytes = size;
+  } else if (now - enc->window_start >= G_USEC_PER_SEC) {
+    enc->stats.bitrate = (guint) (enc->window_bytes * 8 * G_USEC_PER_SEC /
+        (now - enc->window_start));
+    enc->window_start = now;
+    enc->window_bytes = 0;
+  }
+
+  g_mutex_unlock (&enc->stats_lock);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Take a snapshot of the encoder statistics, the bitrate is 0 once
+ *        no frame came out for GST_ENCODER_BITRATE_TIMEOUT seconds.
+ * @param enc The GstEncoder instance.
+ * @param stats (output) the statistics
+ * @memberof GstEncoder
+ */
+void
+gst_encoder_get_stats (GstEncoder * enc, GstEncoderStats * stats)
+{
+  GstElement *sink;
+  guint clients = 0;
+
+  g_return_if_fail (GST_IS_ENCODER (enc));
+
+  if (GST_WORKER (enc)->pipeline)
+    sink = gst_worker_get_element (GST_WORKER (enc), "sink");
+  else
+    sink = NULL;
+  if (sink) {
+    g_object_get (sink, "num-handles", &clients, NULL);
+    gst_object_unref (sink);
+  }
+
+  g_mutex_lock (&enc->stats_lock);
+  *stats = enc->stats;
+  /* no frame closed the window long after it was due, the encoder stalled
+     or lost its input */
+  if (enc->window_start && g_get_monotonic_time () - enc->window_start >=
+      GST_ENCODER_BITRATE_TIMEOUT * G_USEC_PER_SEC)
+    stats->bitrate = 0;
+  g_mutex_unlock (&enc->stats_lock);
+
+  stats->clients = clients;
+}
+
+/**
+ * @brief Invoked when a client is attached to the encoded output.
+ * @memberof GstEncoder
+ */
+static void
+gst_encoder_client_socket_added (GstElement * element,
+    GSocket * socket, GstEncoder * enc)
+{
+  g_return_if_fail (G_IS_SOCKET (socket));
+
+  INFO ("%s: client-socket-added: %d", GST_WORKER (enc)->name,
+      g_socket_get_fd (socket));
+}
+
+/**
+ * @brief Invoked when a client leaves the encoded output. We need to close
+ * the socket manually to avoid FD leaks.
+ * @memberof GstEncoder
+ */
+static void
+gst_encoder_client_socket_removed (GstElement * element,
+    GSocket * socket, GstEncoder * enc)
+{
+  g_return_if_fail (G_IS_SOCKET (socket));
+
+  INFO ("%s: client-socket-removed: %d", GST_WORKER (enc)->name,
+      g_socket_get_fd (socket));
+
+  g_socket_close (socket, NULL);
+}
+
+/**
+ * @param enc The GstEncoder instance.
+ * @memberof GstEncoder
+ * @return TRUE indicating the encoder is prepared, FALSE otherwise.
+ *
+ * Invoked when the GstWorker is preparing the pipeline.
+ */
+static gboolean
+gst_encoder_prepare (GstEncoder * enc)
+{
+  GstElement *sink = NULL, *encoder = NULL;
+  GstPad *pad;
+
+  g_return_val_if_fail (GST_IS_ENCODER (enc), FALSE);
+
+  sink = gst_worker_get_element_unlocked (GST_WORKER (enc), "sink");
+  encoder = gst_worker_get_element_unlocked (GST_WORKER (enc), "enc");
+
+  if (!GST_IS_ELEMENT (sink) || !GST_IS_ELEMENT (encoder))
+    goto error_no_element;
+
+  g_signal_connect (sink, "client-added",
+      G_CALLBACK (gst_encoder_client_socket_added), enc);
+  g_signal_connect (sink, "client-socket-removed",
+      G_CALLBACK (gst_encoder_client_socket_removed), enc);
+  gst_worker_watch_clients (GST_WORKER (enc), sink, TRUE);
+
+  pad = gst_element_get_static_pad (encoder, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) gst_encoder_sink_probe, enc, NULL);
+  gst_object_unref (pad);
+
+  pad = gst_element_get_static_pad (encoder, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) gst_encoder_src_probe, enc, NULL);
+  gst_object_unref (pad);
+
+  gst_object_unref (encoder);
+  gst_object_unref (sink);
+  return TRUE;
+
+error_no_element:
+  {
+    ERROR ("%s: no encoder or sink", GST_WORKER (enc)->name);
+    if (sink)
+      gst_object_unref (sink);
+    if (encoder)
+      gst_object_unref (encoder);
+    return FALSE;
+  }
+}
+
+/**
+ * @brief Initialize the GstEncoderClass.
+ * @param klass The GstEncoderClass instance.
+ * @memberof GstEncoderClass
+ */
+static void
+gst_encoder_class_init (GstEncoderClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstWorkerClass *worker_class = GST_WORKER_CLASS (klass);
+
+  object_class->dispose = (GObjectFinalizeFunc) gst_encoder_dispose;
+  object_class->finalize = (GObjectFinalizeFunc) gst_encoder_finalize;
+  object_class->set_property =
+      (GObjectSetPropertyFunc) gst_encoder_set_property;
+  object_class->get_property =
+      (GObjectGetPropertyFunc) gst_encoder_get_property;
+
+  g_object_class_install_property (object_class, PROP_CODEC,
+      g_param_spec_uint ("codec", "Codec",
+          "The output codec",
+          GST_ENCODER_CODEC_H264,
+          GST_ENCODER_CODEC__LAST,
+          GST_ENCODER_CODEC_H264, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_PRESET,
+      g_param_spec_string ("preset", "Preset",
+          "The x264 speed preset", GST_ENCODER_DEFAULT_PRESET,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_BITRATE,
+      g_param_spec_uint ("bitrate", "Bitrate",
+          "The target bitrate in kbit/s",
+          1, 2048000,
+          GST_ENCODER_DEFAULT_BITRATE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_PORT,
+      g_param_spec_uint ("port", "Port",
+          "Sink port",
+          GST_SWITCH_MIN_SINK_PORT,
+          GST_SWITCH_MAX_SINK_PORT,
+          GST_SWITCH_MIN_SINK_PORT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_WIDTH,
+      g_param_spec_uint ("width", "Input Width",
+          "Input video frame width",
+          1, G_MAXINT,
+          gst_composite_default_width (),
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_HEIGHT,
+      g_param_spec_uint ("height", "Input Height",
+          "Input video frame height",
+          1, G_MAXINT,
+          gst_composite_default_height (),
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  worker_class->prepare = (GstWorkerPrepareFunc) gst_encoder_prepare;
+  worker_class->get_pipeline_string = (GstWorkerGetPipelineStringFunc)
+      gst_encoder_get_pipeline_string;
+}
@@ -0,0 +1,117 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_ENCODER_H__
+#define __GST_ENCODER_H__
+
+#include "gstworker.h"
+
+#define GST_TYPE_ENCODER (gst_encoder_get_type ())
+#define GST_ENCODER(object) (G_TYPE_CHECK_INSTANCE_CAST ((object), GST_TYPE_ENCODER, GstEncoder))
+#define GST_ENCODER_CLASS(class) (G_TYPE_CHECK_CLASS_CAST ((class), GST_TYPE_ENCODER, GstEncoderClass))
+#define GST_IS_ENCODER(object) (G_TYPE_CHECK_INSTANCE_TYPE ((object), GST_TYPE_ENCODER))
+#define GST_IS_ENCODER_CLASS(class) (G_TYPE_CHECK_CLASS_TYPE ((class), GST_TYPE_ENCODER))
+
+#define GST_ENCODER_DEFAULT_PRESET "veryfast"
+#define GST_ENCODER_DEFAULT_BITRATE 4000        /* kbit/s */
+#define GST_ENCODER_KEYFRAME_INTERVAL 30        /* frames */
+#define GST_ENCODER_PENDING_SIZE 32     /* frames in flight inside the encoder */
+#define GST_ENCODER_BITRATE_TIMEOUT 2   /* s a bitrate window may stay open */
+
+typedef struct _GstEncoder GstEncoder;
+typedef struct _GstEncoderClass GstEncoderClass;
+typedef struct _GstEncoderStats GstEncoderStats;
+
+/**
+ *  @enum GstEncoderCodec
+ *
+ *  Codecs supported by the encoded outputs.
+ */
+typedef enum
+{
+  GST_ENCODER_CODEC_H264,       /*!< H.264 by x264enc, in MPEG-TS */
+  GST_ENCODER_CODEC_VP8,        /*!< VP8 by vp8enc, in WebM */
+  GST_ENCODER_CODEC__LAST = GST_ENCODER_CODEC_VP8
+} GstEncoderCodec;
+
+/**
+ *  @brief Snapshot of the encoder statistics.
+ */
+struct _GstEncoderStats
+{
+  guint64 frames;               /*!< frames produced by the encoder */
+  guint64 bytes;                /*!< bytes produced by the encoder */
+  guint bitrate;                /*!< measured bitrate over the last second, bit/s */
+  gint64 latency;               /*!< smoothed encode latency, usec */
+  gint64 max_latency;           /*!< worst encode latency seen, usec */
+  guint clients;                /*!< clients attached to the output */
+};
+
+/**
+ *  @class GstEncoder
+ *  @struct _GstEncoder
+ *  @brief Encode the composite output once and serve it to many clients.
+ */
+struct _GstEncoder
+{
+  GstWorker base;               /*!< the parent object */
+
+  GstEncoderCodec codec;        /*!< the codec of the output */
+  gchar *preset;                /*!< the x264 speed preset */
+  guint bitrate;                /*!< the target bitrate, kbit/s */
+  gint sink_port;               /*!< the tcp port the output is served on */
+  guint width;                  /*!< the video width */
+  guint height;                 /*!< the video height */
+
+  GMutex stats_lock;            /*!< the lock for the stats below */
+  struct
+  {
+    GstClockTime pts;
+    gint64 time;
+  } pending[GST_ENCODER_PENDING_SIZE];  /*!< input time of frames in flight */
+  guint pending_head;           /*!< next slot of %pending */
+  GstEncoderStats stats;        /*!< the statistics */
+  gint64 window_start;          /*!< start of the bitrate window, usec */
+  guint64 window_bytes;         /*!< bytes seen in the bitrate window */
+};
+
+/**
+ *  @class GstEncoderClass
+ *  @struct _GstEncoderClass
+ *  @brief The class of GstEncoder.
+ */
+struct _GstEncoderClass
+{
+  GstWorkerClass base_class;    /*!< the parent class */
+};
+
+/**
+ *  @internal Use GST_TYPE_ENCODER instead.
+ *  @see GST_TYPE_ENCODER
+ */
+GType gst_encoder_get_type (void);
+
+gboolean gst_encoder_parse_codec (const gchar * name, GstEncoderCodec * codec);
+const gchar *gst_encoder_codec_to_string (GstEncoderCodec codec);
+gboolean gst_encoder_is_valid_preset (const gchar * preset);
+void gst_encoder_get_stats (GstEncoder * enc, GstEncoderStats * stats);
+
+#endif //__GST_ENCODER_H__
@@ -0,0 +1,661 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <time.h>
+#include "gstswitchserver.h"
+#include "gstiso.h"
+
+enum
+{
+  PROP_0,
+  PROP_PORT,
+  PROP_SERVE,
+  PROP_CODEC,
+  PROP_BASE_TIME,
+};
+
+extern gboolean verbose;
+
+#define parent_class gst_iso_parent_class
+
+G_DEFINE_TYPE (GstIso, gst_iso, GST_TYPE_WORKER);
+
+/*
+ * The encode slots shared by all input recordings. Every input is encoded
+ * by the streaming thread of its own pipeline, a frame may only be encoded
+ * while it holds a slot, so no more than %gst_iso_slots_total frames are
+ * encoded at once however many inputs there are.
+ */
+static GMutex gst_iso_slots_lock;
+static GCond gst_iso_slots_cond;
+static gint gst_iso_slots = 1;
+static gint gst_iso_slots_total = 1;
+
+/**
+ * @brief Initialize the GstIso instance.
+ * @param iso The GstIso instance.
+ * @memberof GstIso
+ */
+static void
+gst_iso_init (GstIso * iso)
+{
+  iso->sink_port = 0;
+  iso->serve_type = GST_SERVE_VIDEO_STREAM;
+  iso->codec = GST_RECORDER_CODEC_MJPEG;
+  iso->base_time = GST_CLOCK_TIME_NONE;
+
+  g_mutex_init (&iso->stats_lock);
+  iso->location = NULL;
+  memset (&iso->stats, 0, sizeof (iso->stats));
+  iso->holding = FALSE;
+  iso->encode_start = 0;
+  iso->window_start = 0;
+  iso->window_cpu = 0;
+  iso->window_bytes = 0;
+  iso->disk = NULL;
+  iso->disk_dropping = FALSE;
+
+  // The files are closed out by an EOS
+  GST_WORKER (iso)->send_eos_on_stop = TRUE;
+}
+
+/**
+ * @brief Give the encode slot of the input back, if it holds one.
+ * @param iso The GstIso instance.
+ * @memberof GstIso
+ */
+static void
+gst_iso_release_slot (GstIso * iso)
+{
+  gboolean holding;
+
+  g_mutex_lock (&iso->stats_lock);
+  holding = iso->holding;
+  iso->holding = FALSE;
+  g_mutex_unlock (&iso->stats_lock);
+
+  if (holding) {
+    g_mutex_lock (&gst_iso_slots_lock);
+    gst_iso_slots += 1;
+    g_cond_signal (&gst_iso_slots_cond);
+    g_mutex_unlock (&gst_iso_slots_lock);
+  }
+}
+
+/**
+ * @brief Invoked to unref objects.
+ * @param iso The GstIso instance.
+ * @memberof GstIso
+ */
+static void
+gst_iso_dispose (GstIso * iso)
+{
+  INFO ("dispose %p", iso);
+  gst_iso_release_slot (iso);
+  if (iso->disk) {
+    gst_object_unref (iso->disk);
+    iso->disk = NULL;
+  }
+  G_OBJECT_CLASS (parent_class)->dispose (G_OBJECT (iso));
+}
+
+/**
+ * @brief Destroying the GstIso instance.
+ * @param iso The GstIso instance.
+ * @memberof GstIso
+ */
+static void
+gst_iso_finalize (GstIso * iso)
+{
+  g_free (iso->location);
+  iso->location = NULL;
+  g_mutex_clear (&iso->stats_lock);
+
+  if (G_OBJECT_CLASS (parent_class)->finalize)
+    (*G_OBJECT_CLASS (parent_class)->finalize) (G_OBJECT (iso));
+}
+
+/**
+ * @brief Fetching the GstIso property.
+ * @param iso The GstIso instance.
+ * @param property_id
+ * @param value
+ * @param pspec
+ * @memberof GstIso
+ */
+static void
+gst_iso_get_property (GstIso * iso, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_PORT:
+      g_value_set_uint (value, iso->sink_port);
+      break;
+    case PROP_SERVE:
+      g_value_set_uint (value, iso->serve_type);
+      break;
+    case PROP_CODEC:
+      g_value_set_uint (value, iso->codec);
+      break;
+    case PROP_BASE_TIME:
+      g_value_set_uint64 (value, iso->base_time);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (iso, property_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Changing the GstIso properties.
+ * @param iso The GstIso instance.
+ * @param property_id
+ * @param value
+ * @param pspec
+ * @memberof GstIso
+ */
+static void
+gst_iso_set_property (GstIso * iso, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_PORT:
+      iso->sink_port = g_value_get_uint (value);
+      break;
+    case PROP_SERVE:
+      iso->serve_type = (GstSwitchServeStreamType) g_value_get_uint (value);
+      break;
+    case PROP_CODEC:
+      iso->codec = (GstRecorderCodec) g_value_get_uint (value);
+      break;
+    case PROP_BASE_TIME:
+      iso->base_time = g_value_get_uint64 (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (iso), property_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Set the number of frames all input recordings may encode at once.
+ * @param threads the number of encode slots, at least 1
+ */
+void
+gst_iso_set_threads (guint threads)
+{
+  if (threads < 1)
+    threads = 1;
+
+  g_mutex_lock (&gst_iso_slots_lock);
+  gst_iso_slots += (gint) threads - gst_iso_slots_total;
+  gst_iso_slots_total = threads;
+  g_cond_broadcast (&gst_iso_slots_cond);
+  g_mutex_unlock (&gst_iso_slots_lock);
+}
+
+/**
+ * @return the CPU time of the calling thread, usec
+ */
+static gint64
+gst_iso_thread_time (void)
+{
+  struct timespec ts;
+
+  if (clock_gettime (CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+    return 0;
+  return (gint64) ts.tv_sec * G_USEC_PER_SEC + ts.tv_nsec / 1000;
+}
+
+/**
+ * @param iso The GstIso instance.
+ * @memberof GstIso
+ * @return The input recording pipeline string, needs freeing when used
+ *
+ * Fetching the input recording pipeline invoked by the GstWorker. The
+ * encoders are single threaded, the inputs are encoded in parallel with
+ * each other rather than each frame in slices. The queue before the
+ * encoder drops the oldest frames if the encode slots can't keep up.
+ */
+static GString *
+gst_iso_get_pipeline_string (GstIso * iso)
+{
+  GString *desc;
+
+  desc = g_string_new ("");
+
+  if (iso->serve_type == GST_SERVE_AUDIO_STREAM) {
+    // Don't encode the audio
+    g_string_append_printf (desc, "interaudiosrc name=source channel=iso_%d "
+        "! %s ! audioparse raw-format=s16le rate=48000 ! queue "
+        "! identity name=enc ", iso->sink_port,
+        gst_switch_server_get_audio_caps_str ());
+  } else {
+    g_string_append_printf (desc, "intervideosrc name=source channel=input_%d "
+        "! %s ! queue max-size-buffers=2 leaky=downstream ", iso->sink_port,
+        gst_switch_server_get_video_caps_str ());
+
+    // The encoder is always named "enc" for the slot and cost probes
+    switch (iso->codec) {
+      case GST_RECORDER_CODEC_MJPEG:
+        g_string_append_printf (desc, "! jpegenc name=enc quality=%d ",
+            GST_ISO_QUALITY);
+        break;
+      case GST_RECORDER_CODEC_H264:
+        // No lookahead, so each frame is out before the next one comes in
+        g_string_append_printf (desc, "! x264enc name=enc "
+            "speed-preset=ultrafast tune=zerolatency threads=1 pass=quant "
+            "quantizer=%d key-int-max=%d ! h264parse ",
+            GST_RECORDER_H264_QUANTIZER, GST_RECORDER_KEYFRAME_INTERVAL);
+        break;
+      case GST_RECORDER_CODEC_FFV1:
+        g_string_append_printf (desc, "! avenc_ffv1 name=enc ");
+        break;
+      case GST_RECORDER_CODEC_RAW:
+        g_string_append_printf (desc, "! identity name=enc ");
+        break;
+    }
+  }
+
+  // The muxer and the file names are set when preparing
+  g_string_append_printf (desc, "! queue name=disk_queue ! disk_sink.%s ",
+      iso->serve_type == GST_SERVE_AUDIO_STREAM ? "audio_0" : "video");
+  g_string_append_printf (desc, "splitmuxsink name=disk_sink "
+      "max-size-bytes=%" G_GUINT64_FORMAT " "
+      "max-size-time=%" G_GUINT64_FORMAT " ",
+      (guint64) opts.record_max_size * 1024 * 1024,
+      (guint64) opts.record_max_time * GST_SECOND);
+
+  INFO ("Input recording pipeline\n----\n%s\n---", desc->str);
+
+  return desc;
+}
+
+/**
+ * @param sink The disk sink.
+ * @param fragment_id The number of the file to open.
+ * @param iso The GstIso instance.
+ * @memberof GstIso
+ * @return The name of the next file.
+ *
+ * The input recordings are named after the composite recording, with the
+ * input port before the extension, e.g. recording-input3001.mkv.
+ */
+static gchar *
+gst_iso_format_location (GstElement * sink, guint fragment_id, GstIso * iso)
+{
+  const gchar *record = gst_switch_server_get_record_filename ();
+  const gchar *ext = strrchr (record, '.');
+  const gchar *dir = strrchr (record, '/');
+  gchar *template, *filename;
+
+  if (!ext || (dir && dir > ext))
+    ext = record + strlen (record);
+  template = g_strdup_printf ("%.*s-input%d%s", (int) (ext - record), record,
+      iso->sink_port, ext);
+  filename = (gchar *) gst_recorder_new_filename (template);
+  g_free (template);
+
+  g_mutex_lock (&iso->stats_lock);
+  if (!filename) {
+    filename = g_strdup_printf ("%s.%05u",
+        iso->location ? iso->location : "recording", fragment_id);
+    WARN ("no new input record filename, using %s", filename);
+  }
+  g_free (iso->location);
+  iso->location = g_strdup (filename);
+  g_mutex_unlock (&iso->stats_lock);
+
+  INFO ("Recording input %d to %s", iso->sink_port, filename);
+  return filename;
+}
+
+/**
+ * @memberof GstIso
+ *
+ * Take an encode slot before a frame goes into the encoder. The wait is
+ * given up if the pipeline is shutting down.
+ */
+static GstPadProbeReturn
+gst_iso_acquire_probe (GstPad * pad, GstPadProbeInfo * info, GstIso * iso)
+{
+  gint64 start = g_get_monotonic_time ();
+  gboolean holding;
+
+  g_mutex_lock (&iso->stats_lock);
+  holding = iso->holding;
+  g_mutex_unlock (&iso->stats_lock);
+
+  // If the last frame gave no output yet, its slot is reused
+  if (!holding) {
+    g_mutex_lock (&gst_iso_slots_lock);
+    while (gst_iso_slots <= 0) {
+      if (GST_PAD_IS_FLUSHING (pad)) {
+        g_mutex_unlock (&gst_iso_slots_lock);
+        return GST_PAD_PROBE_DROP;
+      }
+      g_cond_wait_until (&gst_iso_slots_cond, &gst_iso_slots_lock,
+          g_get_monotonic_time () + GST_ISO_SLOT_WAIT);
+    }
+    gst_iso_slots -= 1;
+    g_mutex_unlock (&gst_iso_slots_lock);
+  }
+
+  g_mutex_lock (&iso->stats_lock);
+  iso->holding = TRUE;
+  iso->stats.wait += g_get_monotonic_time () - start;
+  iso->encode_start = gst_iso_thread_time ();
+  g_mutex_unlock (&iso->stats_lock);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @memberof GstIso
+ *
+ * Give the encode slot back when the encoder is drained or flushed.
+ */
+static GstPadProbeReturn
+gst_iso_release_probe (GstPad * pad, GstPadProbeInfo * info, GstIso * iso)
+{
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_EOS:
+    case GST_EVENT_FLUSH_START:
+      gst_iso_release_slot (iso);
+      break;
+    default:
+      break;
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @memberof GstIso
+ *
+ * Account an encoded frame and give its encode slot back. The encoder
+ * runs in the streaming thread, so the CPU time of the thread between the
+ * encoder input and output is the CPU cost of the frame.
+ */
+static GstPadProbeReturn
+gst_iso_encode_probe (GstPad * pad, GstPadProbeInfo * info, GstIso * iso)
+{
+  gsize size = gst_buffer_get_size (GST_PAD_PROBE_INFO_BUFFER (info));
+  gint64 now = g_get_monotonic_time ();
+  gint64 cpu = gst_iso_thread_time ();
+  gint64 elapsed;
+
+  g_mutex_lock (&iso->stats_lock);
+  if (iso->holding && cpu > iso->encode_start)
+    iso->window_cpu += cpu - iso->encode_start;
+  iso->stats.frames += 1;
+  iso->stats.bytes += size;
+  iso->window_bytes += size;
+  if (iso->window_start == 0)
+    iso->window_start = now;
+  elapsed = now - iso->window_start;
+  if (elapsed >= G_USEC_PER_SEC) {
+    iso->stats.cpu = (gdouble) iso->window_cpu * 100 / elapsed;
+    iso->stats.throughput = iso->window_bytes * G_USEC_PER_SEC / elapsed;
+    iso->window_start = now;
+    iso->window_cpu = 0;
+    iso->window_bytes = 0;
+  }
+  g_mutex_unlock (&iso->stats_lock);
+
+  gst_iso_release_slot (iso);
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @memberof GstIso
+ *
+ * Drop the frames to the files while the disk buffer is above its high
+ * water mark, resuming on a keyframe, as the composite recorder does.
+ */
+static GstPadProbeReturn
+gst_iso_disk_probe (GstPad * pad, GstPadProbeInfo * info, GstIso * iso)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  gboolean overrun = FALSE, dropping;
+
+  g_object_get (iso->disk, "overrun", &overrun, NULL);
+
+  g_mutex_lock (&iso->stats_lock);
+  if (overrun && !iso->disk_dropping) {
+    WARN ("Recording disk is too slow, dropping input %d", iso->sink_port);
+    iso->disk_dropping = TRUE;
+  } else if (!overrun && iso->disk_dropping
+      && !GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+    INFO ("Recording disk caught up, resuming input %d", iso->sink_port);
+    iso->disk_dropping = FALSE;
+  }
+  dropping = iso->disk_dropping;
+  g_mutex_unlock (&iso->stats_lock);
+
+  return dropping ? GST_PAD_PROBE_DROP : GST_PAD_PROBE_OK;
+}
+
+/**
+ * @param iso The GstIso instance.
+ * @memberof GstIso
+ * @return TRUE indicating the input recording is prepared, FALSE otherwise.
+ *
+ * Invoked when the GstWorker is preparing the pipeline. The pipeline takes
+ * the base time of the composite recorder, so that the same instant has
+ * the same timestamp in the composite and the input recordings.
+ */
+static gboolean
+gst_iso_prepare (GstIso * iso)
+{
+  GstElement *pipeline = GST_WORKER (iso)->pipeline;
+  GstElement *enc = NULL, *disk_sink = NULL, *disk_queue = NULL;
+  GstElement *mux, *ring, *old_ring;
+  GstPad *pad;
+
+  g_return_val_if_fail (GST_IS_ISO (iso), FALSE);
+
+  enc = gst_worker_get_element_unlocked (GST_WORKER (iso), "enc");
+  disk_sink = gst_worker_get_element_unlocked (GST_WORKER (iso), "disk_sink");
+  disk_queue = gst_worker_get_element_unlocked (GST_WORKER (iso),
+      "disk_queue");
+
+  if (!GST_IS_ELEMENT (enc) || !GST_IS_ELEMENT (disk_sink)
+      || !GST_IS_ELEMENT (disk_queue))
+    goto error_no_element;
+
+  // Without a composite recorder the pipeline keeps its own timeline
+  if (GST_CLOCK_TIME_IS_VALID (iso->base_time)) {
+    GstClock *clock = gst_system_clock_obtain ();
+    gst_pipeline_use_clock (GST_PIPELINE (pipeline), clock);
+    gst_element_set_start_time (pipeline, GST_CLOCK_TIME_NONE);
+    gst_element_set_base_time (pipeline, iso->base_time);
+    gst_object_unref (clock);
+  }
+
+  // A slot held by the last pipeline is given back
+  gst_iso_release_slot (iso);
+
+  // Only the video encoders take the shared encode slots
+  if (iso->serve_type == GST_SERVE_VIDEO_STREAM) {
+    pad = gst_element_get_static_pad (enc, "sink");
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+        (GstPadProbeCallback) gst_iso_acquire_probe, iso, NULL);
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM
+        | GST_PAD_PROBE_TYPE_EVENT_FLUSH,
+        (GstPadProbeCallback) gst_iso_release_probe, iso, NULL);
+    gst_object_unref (pad);
+  }
+
+  pad = gst_element_get_static_pad (enc, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) gst_iso_encode_probe, iso, NULL);
+  gst_object_unref (pad);
+
+  mux = gst_element_factory_make ("matroskamux", NULL);
+  if (!mux)
+    goto error_no_element;
+  g_object_set (mux, "writing-app", "gst-switch",
+      "min-index-interval", (guint64) 1000000, NULL);
+  g_object_set (disk_sink, "muxer", mux, NULL);
+  g_signal_connect (disk_sink, "format-location",
+      G_CALLBACK (gst_iso_format_location), iso);
+
+  // A quarter of the composite disk buffer for each input
+  ring = gst_element_factory_make ("ringsink", NULL);
+  if (ring) {
+    g_object_set (ring, "buffer-size",
+        (guint64) opts.record_buffer * 1024 * 1024 / 4, NULL);
+    g_object_set (disk_sink, "sink", ring, NULL);
+
+    pad = gst_element_get_static_pad (disk_queue, "src");
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+        (GstPadProbeCallback) gst_iso_disk_probe, iso, NULL);
+    gst_object_unref (pad);
+  }
+
+  g_mutex_lock (&iso->stats_lock);
+  iso->window_start = 0;
+  iso->window_cpu = 0;
+  iso->window_bytes = 0;
+  old_ring = iso->disk;
+  iso->disk = ring ? gst_object_ref (ring) : NULL;
+  iso->disk_dropping = FALSE;
+  g_mutex_unlock (&iso->stats_lock);
+
+  if (old_ring)
+    gst_object_unref (old_ring);
+
+  gst_object_unref (disk_queue);
+  gst_object_unref (disk_sink);
+  gst_object_unref (enc);
+  return TRUE;
+
+error_no_element:
+  {
+    ERROR ("%s: no encoder, muxer or disk sink", GST_WORKER (iso)->name);
+    if (disk_queue)
+      gst_object_unref (disk_queue);
+    if (disk_sink)
+      gst_object_unref (disk_sink);
+    if (enc)
+      gst_object_unref (enc);
+    return FALSE;
+  }
+}
+
+/**
+ * @param iso The GstIso instance.
+ * @memberof GstIso
+ * @return TRUE if the next file is being opened.
+ *
+ * Finalise the current input recording file and continue into a new one.
+ */
+gboolean
+gst_iso_new_fragment (GstIso * iso)
+{
+  GstElement *disk_sink;
+
+  g_return_val_if_fail (GST_IS_ISO (iso), FALSE);
+
+  disk_sink = gst_worker_get_element (GST_WORKER (iso), "disk_sink");
+  if (!disk_sink)
+    return FALSE;
+
+  g_signal_emit_by_name (disk_sink, "split-now");
+  gst_object_unref (disk_sink);
+  return TRUE;
+}
+
+/**
+ * @param iso The GstIso instance.
+ * @param stats The GstIsoStats to fill, free stats->location after use.
+ * @memberof GstIso
+ *
+ * Get a snapshot of the input recording statistics.
+ */
+void
+gst_iso_get_stats (GstIso * iso, GstIsoStats * stats)
+{
+  g_return_if_fail (GST_IS_ISO (iso));
+
+  g_mutex_lock (&iso->stats_lock);
+  *stats = iso->stats;
+  stats->location = g_strdup (iso->location ? iso->location : "");
+  g_mutex_unlock (&iso->stats_lock);
+}
+
+/**
+ * @brief Initialize the GstIsoClass.
+ * @param klass The GstIsoClass instance.
+ * @memberof GstIsoClass
+ */
+static void
+gst_iso_class_init (GstIsoClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstWorkerClass *worker_class = GST_WORKER_CLASS (klass);
+
+  object_class->dispose = (GObjectFinalizeFunc) gst_iso_dispose;
+  object_class->finalize = (GObjectFinalizeFunc) gst_iso_finalize;
+  object_class->set_property = (GObjectSetPropertyFunc) gst_iso_set_property;
+  object_class->get_property = (GObjectGetPropertyFunc) gst_iso_get_property;
+
+  g_object_class_install_property (object_class, PROP_PORT,
+      g_param_spec_uint ("port", "Port",
+          "Port of the recorded input",
+          GST_SWITCH_MIN_SINK_PORT,
+          GST_SWITCH_MAX_SINK_PORT,
+          GST_SWITCH_MIN_SINK_PORT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_SERVE,
+      g_param_spec_uint ("serve", "Serve",
+          "Video or audio input",
+          GST_SERVE_NOTHING,
+          GST_SERVE_AUDIO_STREAM,
+          GST_SERVE_VIDEO_STREAM,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_CODEC,
+      g_param_spec_uint ("codec", "Codec",
+          "Video codec of the input recording",
+          GST_RECORDER_CODEC_MJPEG,
+          GST_RECORDER_CODEC__LAST,
+          GST_RECORDER_CODEC_MJPEG,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_BASE_TIME,
+      g_param_spec_uint64 ("base-time", "Base Time",
+          "Base time of the composite recorder, to align the timestamps with",
+          0, G_MAXUINT64,
+          GST_CLOCK_TIME_NONE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  worker_class->prepare = (GstWorkerPrepareFunc) gst_iso_prepare;
+  worker_class->get_pipeline_string = (GstWorkerGetPipelineStringFunc)
+      gst_iso_get_pipeline_string;
+}
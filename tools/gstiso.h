@@ -0,0 +1,101 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_ISO_H__
+#define __GST_ISO_H__
+
+#include "gstworker.h"
+#include "gstcase.h"
+#include "gstrecorder.h"
+
+#define GST_TYPE_ISO (gst_iso_get_type ())
+#define GST_ISO(object) (G_TYPE_CHECK_INSTANCE_CAST ((object), GST_TYPE_ISO, GstIso))
+#define GST_ISO_CLASS(class) (G_TYPE_CHECK_CLASS_CAST ((class), GST_TYPE_ISO, GstIsoClass))
+#define GST_IS_ISO(object) (G_TYPE_CHECK_INSTANCE_TYPE ((object), GST_TYPE_ISO))
+#define GST_IS_ISO_CLASS(class) (G_TYPE_CHECK_CLASS_TYPE ((class), GST_TYPE_ISO))
+
+#define GST_ISO_QUALITY 85      /* MJPEG quality of the input recordings */
+#define GST_ISO_SLOT_WAIT 100000        /* usec between flushing checks */
+
+typedef struct _GstIso GstIso;
+typedef struct _GstIsoClass GstIsoClass;
+typedef struct _GstIsoStats GstIsoStats;
+
+/**
+ *  @brief Snapshot of the input recording statistics.
+ */
+struct _GstIsoStats
+{
+  gchar *location;              /*!< the file being written, free with g_free */
+  guint64 frames;               /*!< frames out of the encoder */
+  guint64 bytes;                /*!< bytes out of the encoder */
+  gdouble cpu;                  /*!< encoder CPU time, percent of one core */
+  guint64 throughput;           /*!< bytes/s to the files in the last second */
+  guint64 wait;                 /*!< time waited for an encode slot, usec */
+};
+
+/**
+ *  @class GstIso
+ *  @struct _GstIso
+ *  @brief Record one input into its own file, next to the composite.
+ */
+struct _GstIso
+{
+  GstWorker base;               /*!< the parent object */
+
+  gint sink_port;               /*!< the port of the recorded input */
+  GstSwitchServeStreamType serve_type;  /*!< video or audio input */
+  GstRecorderCodec codec;       /*!< the video codec */
+  GstClockTime base_time;       /*!< the base time of the composite recorder */
+
+  GMutex stats_lock;            /*!< the lock for the stats below */
+  gchar *location;              /*!< the file being written */
+  GstIsoStats stats;            /*!< the statistics */
+  gboolean holding;             /*!< an encode slot is held */
+  gint64 encode_start;          /*!< thread CPU time at the encoder input */
+  gint64 window_start;          /*!< start of the stats window, usec */
+  gint64 window_cpu;            /*!< encoder CPU time in the window, usec */
+  guint64 window_bytes;         /*!< bytes encoded in the window */
+  GstElement *disk;             /*!< the write-behind sink of the files */
+  gboolean disk_dropping;       /*!< dropping frames for the disk buffer */
+};
+
+/**
+ *  @class GstIsoClass
+ *  @struct _GstIsoClass
+ *  @brief The class of GstIso.
+ */
+struct _GstIsoClass
+{
+  GstWorkerClass base_class;    /*!< the parent class */
+};
+
+/**
+ *  @internal Use GST_TYPE_ISO instead.
+ *  @see GST_TYPE_ISO
+ */
+GType gst_iso_get_type (void);
+
+void gst_iso_set_threads (guint threads);
+gboolean gst_iso_new_fragment (GstIso * iso);
+void gst_iso_get_stats (GstIso * iso, GstIsoStats * stats);
+
+#endif //__GST_ISO_H__
@@ -0,0 +1,274 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include <string.h>
+#include "gstloudness.h"
+
+/* the two K-weighting stages at 48 kHz, the high shelf and the high pass of
+   BS.1770-4, as b0, b1, b2, a1, a2 */
+static const gdouble gst_loudness_kweight[2][5] = {
+  {1.53512485958697, -2.69169618940638, 1.19839281085285,
+      -1.69065929318241, 0.73248077421585},
+  {1.0, -2.0, 1.0, -1.99004745483398, 0.99007225036621},
+};
+
+/* the 4 phase interpolation filter of BS.1770-4 annex 2, each phase
+   computes one of the oversampled samples from the last 12 samples */
+static const gfloat gst_loudness_fir[GST_LOUDNESS_PHASES][GST_LOUDNESS_TAPS]
+    = {
+  {0.0017089843750, 0.0109863281250, -0.0196533203125, 0.0332031250000,
+      -0.0594482421875, 0.1373291015625, 0.9721679687500, -0.1022949218750,
+      0.0476074218750, -0.0266113281250, 0.0148925781250, -0.0083007812500},
+  {-0.0291748046875, 0.0292968750000, -0.0517578125000, 0.0891113281250,
+      -0.1665039062500, 0.4650878906250, 0.7797851562500, -0.2003173828125,
+      0.1015625000000, -0.0582275390625, 0.0330810546875, -0.0189208984375},
+  {-0.0189208984375, 0.0330810546875, -0.0582275390625, 0.1015625000000,
+      -0.2003173828125, 0.7797851562500, 0.4650878906250, -0.1665039062500,
+      0.0891113281250, -0.0517578125000, 0.0292968750000, -0.0291748046875},
+  {-0.0083007812500, 0.0148925781250, -0.0266113281250, 0.0476074218750,
+      -0.1022949218750, 0.9721679687500, 0.1373291015625, -0.0594482421875,
+      0.0332031250000, -0.0196533203125, 0.0109863281250, 0.0017089843750},
+};
+
+/**
+ * @brief The loudness of a mean square, summed over the channels.
+ */
+static gdouble
+gst_loudness_lufs (gdouble energy)
+{
+  if (energy <= 0.0)
+    return GST_LOUDNESS_FLOOR;
+  return MAX (GST_LOUDNESS_FLOOR, -0.691 + 10.0 * log10 (energy));
+}
+
+/**
+ * @brief The mean energy of the last blocks, fewer while starting.
+ */
+static gdouble
+gst_loudness_window (GstLoudness * loudness, guint blocks)
+{
+  gdouble sum = 0.0;
+  guint i, n = MIN (blocks, loudness->count);
+
+  for (i = 0; i < n; ++i)
+    sum += loudness->blocks[(loudness->count - 1 - i) %
+        GST_LOUDNESS_SHORT_TERM];
+  return n ? sum / n : 0.0;
+}
+
+/**
+ * @brief The integrated loudness of the histogram.
+ *
+ * Windows below the floor were never counted, which is the absolute gate.
+ * The relative gate, 10 LU below the loudness of what is left, is applied
+ * to whole bins.
+ */
+static gdouble
+gst_loudness_integrate (GstLoudness * loudness)
+{
+  gdouble sum = 0.0, gate;
+  guint64 n = 0;
+  gint i, first;
+
+  for (i = 0; i < GST_LOUDNESS_BINS; ++i) {
+    n += loudness->bins[i];
+    sum += loudness->energy[i];
+  }
+  if (n == 0)
+    return GST_LOUDNESS_FLOOR;
+
+  gate = gst_loudness_lufs (sum / n) - 10.0;
+  first = CLAMP ((gint) ((gate - GST_LOUDNESS_FLOOR) * 10.0), 0,
+      GST_LOUDNESS_BINS - 1);
+
+  sum = 0.0;
+  n = 0;
+  for (i = first; i < GST_LOUDNESS_BINS; ++i) {
+    n += loudness->bins[i];
+    sum += loudness->energy[i];
+  }
+  return n ? gst_loudness_lufs (sum / n) : GST_LOUDNESS_FLOOR;
+}
+
+/**
+ * @brief Complete a 100 ms block and update the level.
+ */
+static void
+gst_loudness_block (GstLoudness * loudness)
+{
+  gdouble energy;
+  gint bin;
+
+  loudness->blocks[loudness->count % GST_LOUDNESS_SHORT_TERM] =
+      loudness->sum / GST_LOUDNESS_BLOCK;
+  loudness->count += 1;
+  loudness->sum = 0.0;
+  loudness->frames = 0;
+
+  energy = gst_loudness_window (loudness, GST_LOUDNESS_MOMENTARY);
+  loudness->level.momentary = gst_loudness_lufs (energy);
+  loudness->level.short_term = gst_loudness_lufs (gst_loudness_window
+      (loudness, GST_LOUDNESS_SHORT_TERM));
+
+  /* the gating windows overlap by 75%, one ends with every block */
+  if (loudness->count >= GST_LOUDNESS_MOMENTARY &&
+      loudness->level.momentary > GST_LOUDNESS_FLOOR) {
+    bin = (gint) ((loudness->level.momentary - GST_LOUDNESS_FLOOR) * 10.0);
+    bin = MIN (bin, GST_LOUDNESS_BINS - 1);
+    loudness->bins[bin] += 1;
+    loudness->energy[bin] += energy;
+    loudness->level.integrated = gst_loudness_integrate (loudness);
+  }
+}
+
+/**
+ * @brief Initialize a loudness meter, nothing is measured yet.
+ * @param loudness The GstLoudness.
+ */
+void
+gst_loudness_init (GstLoudness * loudness)
+{
+  memset (loudness, 0, sizeof (*loudness));
+  loudness->level.momentary = GST_LOUDNESS_FLOOR;
+  loudness->level.short_term = GST_LOUDNESS_FLOOR;
+  loudness->level.integrated = GST_LOUDNESS_FLOOR;
+  loudness->level.true_peak = GST_LOUDNESS_FLOOR;
+
+  g_mutex_init (&loudness->lock);
+}
+
+/**
+ * @brief Release a loudness meter.
+ * @param loudness The GstLoudness.
+ */
+void
+gst_loudness_clear (GstLoudness * loudness)
+{
+  g_mutex_clear (&loudness->lock);
+}
+
+/**
+ * @brief Start the integrated loudness and the true-peak over.
+ * @param loudness The GstLoudness.
+ *
+ * The momentary and short-term loudness carry on.
+ */
+void
+gst_loudness_reset (GstLoudness * loudness)
+{
+  g_mutex_lock (&loudness->lock);
+  memset (loudness->bins, 0, sizeof (loudness->bins));
+  memset (loudness->energy, 0, sizeof (loudness->energy));
+  loudness->peak = 0.0;
+  loudness->level.integrated = GST_LOUDNESS_FLOOR;
+  loudness->level.true_peak = GST_LOUDNESS_FLOOR;
+  g_mutex_unlock (&loudness->lock);
+}
+
+/**
+ * @brief Measure interleaved S16 stereo samples.
+ * @param loudness The GstLoudness.
+ * @param data the samples
+ * @param frames the number of frames in %data
+ *
+ * Invoked from the streaming thread for every buffer. The loops over the
+ * channels and the taps have fixed counts and no dependencies between
+ * their iterations, the compiler turns them into SIMD code.
+ */
+void
+gst_loudness_process_s16 (GstLoudness * loudness, const gint16 * data,
+    guint frames)
+{
+  const gdouble (*k)[5] = gst_loudness_kweight;
+  gdouble (*z)[GST_LOUDNESS_CHANNELS][2] = loudness->state;
+  gfloat peak;
+  guint i, c, p, t;
+
+  g_mutex_lock (&loudness->lock);
+  peak = loudness->peak;
+  for (i = 0; i < frames; ++i, data += GST_LOUDNESS_CHANNELS) {
+    gfloat *history;
+    gdouble sum = 0.0;
+
+    loudness->pos = (loudness->pos + GST_LOUDNESS_TAPS - 1) %
+        GST_LOUDNESS_TAPS;
+
+    for (c = 0; c < GST_LOUDNESS_CHANNELS; ++c) {
+      gdouble x = data[c] / 32768.0, y;
+
+      /* both stages in transposed direct form II */
+      y = k[0][0] * x + z[0][c][0];
+      z[0][c][0] = k[0][1] * x - k[0][3] * y + z[0][c][1];
+      z[0][c][1] = k[0][2] * x - k[0][4] * y;
+      x = y;
+      y = k[1][0] * x + z[1][c][0];
+      z[1][c][0] = k[1][1] * x - k[1][3] * y + z[1][c][1];
+      z[1][c][1] = k[1][2] * x - k[1][4] * y;
+      sum += y * y;
+
+      history = loudness->history[c];
+      history[loudness->pos] = history[loudness->pos + GST_LOUDNESS_TAPS] =
+          data[c] / 32768.0f;
+    }
+    loudness->sum += sum;
+
+    for (c = 0; c < GST_LOUDNESS_CHANNELS; ++c) {
+      history = loudness->history[c] + loudness->pos;
+      for (p = 0; p < GST_LOUDNESS_PHASES; ++p) {
+        gfloat v = 0.0f;
+        for (t = 0; t < GST_LOUDNESS_TAPS; ++t)
+          v += gst_loudness_fir[p][t] * history[t];
+        peak = MAX (peak, fabsf (v));
+      }
+    }
+
+    if (++loudness->frames == GST_LOUDNESS_BLOCK)
+      gst_loudness_block (loudness);
+  }
+  loudness->peak = peak;
+  if (peak > 0.0f)
+    loudness->level.true_peak = MAX (GST_LOUDNESS_FLOOR,
+        20.0 * log10 (peak));
+  g_mutex_unlock (&loudness->lock);
+}
+
+/**
+ * @brief Get the latest level.
+ * @param loudness The GstLoudness.
+ * @param level (output) the level
+ * @return TRUE if 400 ms have been measured, FALSE otherwise
+ */
+gboolean
+gst_loudness_get (GstLoudness * loudness, GstLoudnessLevel * level)
+{
+  gboolean measured;
+
+  g_mutex_lock (&loudness->lock);
+  *level = loudness->level;
+  measured = loudness->count >= GST_LOUDNESS_MOMENTARY;
+  g_mutex_unlock (&loudness->lock);
+  return measured;
+}
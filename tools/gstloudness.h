@@ -0,0 +1,89 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_LOUDNESS_H__
+#define __GST_LOUDNESS_H__
+
+#include <glib.h>
+
+#define GST_LOUDNESS_RATE 48000 /* the rate the K-weighting is designed for */
+#define GST_LOUDNESS_CHANNELS 2 /* the program audio is stereo */
+#define GST_LOUDNESS_BLOCK (GST_LOUDNESS_RATE / 10)     /* frames in 100 ms */
+#define GST_LOUDNESS_MOMENTARY 4        /* blocks in the 400 ms window */
+#define GST_LOUDNESS_SHORT_TERM 30      /* blocks in the 3 s window */
+#define GST_LOUDNESS_FLOOR -70.0        /* LUFS and dBTP reported for silence */
+#define GST_LOUDNESS_BINS 750   /* 0.1 LU from the floor to +5 LUFS */
+#define GST_LOUDNESS_PHASES 4   /* true-peak oversampling */
+#define GST_LOUDNESS_TAPS 12    /* true-peak filter taps per phase */
+
+typedef struct _GstLoudness GstLoudness;
+typedef struct _GstLoudnessLevel GstLoudnessLevel;
+
+/**
+ *  @brief The loudness of a stream as of ITU-R BS.1770-4 and EBU R 128.
+ */
+struct _GstLoudnessLevel
+{
+  gdouble momentary;            /*!< LUFS of the last 400 ms */
+  gdouble short_term;           /*!< LUFS of the last 3 s */
+  gdouble integrated;           /*!< gated LUFS since the last reset */
+  gdouble true_peak;            /*!< dBTP since the last reset */
+};
+
+/**
+ *  @struct _GstLoudness
+ *  @brief A streaming loudness meter of 48 kHz stereo.
+ *
+ *  Samples are K-weighted and summed in 100 ms blocks, the momentary and
+ *  short-term loudness are read from the last blocks. Every 400 ms window
+ *  goes into a histogram of 0.1 LU bins, from which the gated integrated
+ *  loudness is found without keeping the windows. The true-peak is the
+ *  largest sample of a 4 times oversampled signal.
+ */
+struct _GstLoudness
+{
+  GMutex lock;                  /*!< the lock for the fields below */
+
+  gdouble state[2][GST_LOUDNESS_CHANNELS][2];   /*!< the K-weighting filters */
+  gdouble sum;                  /*!< weighted energy of the current block */
+  guint frames;                 /*!< frames in the current block */
+  gdouble blocks[GST_LOUDNESS_SHORT_TERM];      /*!< the last block energies */
+  guint64 count;                /*!< blocks completed */
+
+  guint64 bins[GST_LOUDNESS_BINS];      /*!< windows in each 0.1 LU */
+  gdouble energy[GST_LOUDNESS_BINS];    /*!< their energy */
+
+  /*! the last samples twice over, so the filter reads them in one run */
+  gfloat history[GST_LOUDNESS_CHANNELS][2 * GST_LOUDNESS_TAPS];
+  guint pos;                    /*!< the newest sample in %history */
+  gfloat peak;                  /*!< the largest oversampled sample */
+
+  GstLoudnessLevel level;       /*!< the latest level */
+};
+
+void gst_loudness_init (GstLoudness * loudness);
+void gst_loudness_clear (GstLoudness * loudness);
+void gst_loudness_reset (GstLoudness * loudness);
+void gst_loudness_process_s16 (GstLoudness * loudness, const gint16 * data,
+    guint frames);
+gboolean gst_loudness_get (GstLoudness * loudness, GstLoudnessLevel * level);
+
+#endif //__GST_LOUDNESS_H__
@@ -0,0 +1,139 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstmeter.h"
+
+/**
+ * @brief Initialize a meter, nothing is metered yet.
+ * @param meter The GstMeter.
+ */
+void
+gst_meter_init (GstMeter * meter)
+{
+  meter->level.rms = GST_METER_FLOOR;
+  meter->level.peak = GST_METER_FLOOR;
+  meter->level.decay = GST_METER_FLOOR;
+  meter->time = 0;
+
+  g_mutex_init (&meter->lock);
+}
+
+/**
+ * @brief Release a meter.
+ * @param meter The GstMeter.
+ */
+void
+gst_meter_clear (GstMeter * meter)
+{
+  g_mutex_clear (&meter->lock);
+}
+
+/**
+ * @brief Append the "level" element to a pipeline string.
+ * @param desc the pipeline string
+ * @param interval msec between levels, nothing is appended if 0
+ */
+void
+gst_meter_append_element (GString * desc, guint interval)
+{
+  if (interval == 0)
+    return;
+
+  g_string_append_printf (desc, "! level name=level post-messages=true "
+      "interval=%" G_GUINT64_FORMAT " ", (guint64) interval * GST_MSECOND);
+}
+
+/**
+ * @brief The loudest channel of a "level" message field.
+ */
+static gdouble
+gst_meter_loudest (const GstStructure * s, const gchar * field)
+{
+  const GValue *value = gst_structure_get_value (s, field);
+  gdouble loudest = GST_METER_FLOOR;
+  GValueArray *channels;
+  guint i;
+
+  if (value == NULL || !G_VALUE_HOLDS (value, G_TYPE_VALUE_ARRAY))
+    return loudest;
+
+  G_GNUC_BEGIN_IGNORE_DEPRECATIONS;
+  channels = (GValueArray *) g_value_get_boxed (value);
+  for (i = 0; channels && i < channels->n_values; ++i) {
+    gdouble db = g_value_get_double (g_value_array_get_nth (channels, i));
+    loudest = MAX (loudest, db);
+  }
+  G_GNUC_END_IGNORE_DEPRECATIONS;
+  return loudest;
+}
+
+/**
+ * @brief Take the level from a pipeline message.
+ * @param meter The GstMeter.
+ * @param message a bus message of the metered pipeline
+ * @return TRUE if the message was a level, FALSE otherwise
+ */
+gboolean
+gst_meter_message (GstMeter * meter, GstMessage * message)
+{
+  const GstStructure *s;
+  GstMeterLevel level;
+
+  if (GST_MESSAGE_TYPE (message) != GST_MESSAGE_ELEMENT)
+    return FALSE;
+
+  s = gst_message_get_structure (message);
+  if (!gst_structure_has_name (s, "level"))
+    return FALSE;
+
+  level.rms = gst_meter_loudest (s, "rms");
+  level.peak = gst_meter_loudest (s, "peak");
+  level.decay = gst_meter_loudest (s, "decay");
+
+  g_mutex_lock (&meter->lock);
+  meter->level = level;
+  meter->time = g_get_monotonic_time ();
+  g_mutex_unlock (&meter->lock);
+  return TRUE;
+}
+
+/**
+ * @brief Get the latest level.
+ * @param meter The GstMeter.
+ * @param level (output) the level
+ * @return TRUE if there is a level no older than GST_METER_STALE
+ */
+gboolean
+gst_meter_get_level (GstMeter * meter, GstMeterLevel * level)
+{
+  gboolean fresh;
+
+  g_mutex_lock (&meter->lock);
+  fresh = meter->time != 0 &&
+      g_get_monotonic_time () - meter->time <= GST_METER_STALE;
+  *level = meter->level;
+  g_mutex_unlock (&meter->lock);
+  return fresh;
+}
@@ -0,0 +1,64 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_METER_H__
+#define __GST_METER_H__
+
+#include <gst/gst.h>
+
+#define GST_METER_DEFAULT_INTERVAL 100  /* msec between audio level signals */
+#define GST_METER_FLOOR -90.0   /* dB reported for silence */
+#define GST_METER_STALE G_USEC_PER_SEC  /* levels older than this are dropped */
+
+typedef struct _GstMeter GstMeter;
+typedef struct _GstMeterLevel GstMeterLevel;
+
+/**
+ *  @brief The audio level of a stream, the loudest channel in dB.
+ */
+struct _GstMeterLevel
+{
+  gdouble rms;                  /*!< the RMS level of the last interval */
+  gdouble peak;                 /*!< the peak of the last interval */
+  gdouble decay;                /*!< the peak, falling off slowly */
+};
+
+/**
+ *  @struct _GstMeter
+ *  @brief The latest level posted by the "level" element of a pipeline.
+ *
+ *  Embedded in the workers metering their audio, the level is written from
+ *  the bus handler and read by the server when it publishes the levels.
+ */
+struct _GstMeter
+{
+  GMutex lock;                  /*!< the lock for the fields below */
+  GstMeterLevel level;          /*!< the latest level */
+  gint64 time;                  /*!< when %level was posted, 0 if never */
+};
+
+void gst_meter_init (GstMeter * meter);
+void gst_meter_clear (GstMeter * meter);
+void gst_meter_append_element (GString * desc, guint interval);
+gboolean gst_meter_message (GstMeter * meter, GstMessage * message);
+gboolean gst_meter_get_level (GstMeter * meter, GstMeterLevel * level);
+
+#endif //__GST_METER_H__
@@ -0,0 +1,445 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <gst/controller/gstinterpolationcontrolsource.h>
+#include <gst/controller/gstdirectcontrolbinding.h>
+#include "gstswitchserver.h"
+#include "gstmixer.h"
+#include "gstaudioengine.h"
+
+/* the format everything is mixed in, audiomixer and volume run ORC
+   (SIMD) loops for it */
+#define GST_MIXER_CAPS "audio/x-raw,format=F32LE,rate=48000,channels=2," \
+  "layout=interleaved"
+
+extern gboolean verbose;
+
+#define parent_class gst_mixer_parent_class
+
+G_DEFINE_TYPE (GstMixer, gst_mixer, GST_TYPE_WORKER);
+
+/**
+ * @brief Initialize the GstMixer instance.
+ * @param mixer The GstMixer instance.
+ * @memberof GstMixer
+ */
+static void
+gst_mixer_init (GstMixer * mixer)
+{
+  mixer->channels = g_array_new (FALSE, TRUE, sizeof (GstMixerChannel));
+  mixer->follow = 0;
+
+  g_mutex_init (&mixer->channels_lock);
+  gst_meter_init (&mixer->meter);
+
+  if (opts.audio_realtime)
+    GST_WORKER (mixer)->priority = GST_AUDIO_ENGINE_PRIORITY;
+}
+
+/**
+ * @brief Destroying the GstMixer instance.
+ * @param mixer The GstMixer instance.
+ * @memberof GstMixer
+ */
+static void
+gst_mixer_finalize (GstMixer * mixer)
+{
+  g_array_free (mixer->channels, TRUE);
+  mixer->channels = NULL;
+
+  g_mutex_clear (&mixer->channels_lock);
+  gst_meter_clear (&mixer->meter);
+
+  if (G_OBJECT_CLASS (parent_class)->finalize)
+    (*G_OBJECT_CLASS (parent_class)->finalize) (G_OBJECT (mixer));
+}
+
+/**
+ * @brief The gain an input is mixed with.
+ * @param channel the input
+ * @param follow the only input mixed, 0 for all
+ */
+static gdouble
+gst_mixer_channel_gain (const GstMixerChannel * channel, gint follow)
+{
+  if (channel->mute || (follow != 0 && channel->port != follow))
+    return 0.0;
+  return channel->gain;
+}
+
+/**
+ * @param mixer The GstMixer instance.
+ * @memberof GstMixer
+ * @return The mixer pipeline string, needs freeing when used
+ *
+ * Fetching the mixer pipeline, invoked by the GstWorker. Every audio input
+ * is read from the "mix_%d" channel fed by its case, converted to float,
+ * then goes through its gain and pan into the audiomixer. A live silence
+ * keeps the mix running while there are no inputs. All sources and the
+ * mixer work on GST_MIXER_PERIOD buffers, or the --audio-period of the
+ * audio engine, so the mix adds a fixed latency of one period.
+ */
+static GString *
+gst_mixer_get_pipeline_string (GstMixer * mixer)
+{
+  const gchar *caps = gst_switch_server_get_audio_caps_str ();
+  const guint64 period = opts.audio_period ?
+      opts.audio_period * GST_MSECOND : GST_MIXER_PERIOD;
+  GString *desc;
+  guint i;
+
+  desc = g_string_new ("");
+
+  g_string_append_printf (desc, "audiomixer name=mix "
+      "output-buffer-duration=%" G_GUINT64_FORMAT " ", period);
+  g_string_append_printf (desc, "! audioconvert ! %s ", caps);
+  gst_meter_append_element (desc, opts.meter_interval);
+  g_string_append_printf (desc,
+      "! interaudiosink name=sink channel=composite_audio ");
+
+  g_string_append_printf (desc,
+      "audiotestsrc name=silence wave=silence is-live=true "
+      "samplesperbuffer=%d ! %s ! mix. ",
+      (gint) gst_util_uint64_scale (48000, period, GST_SECOND),
+      GST_MIXER_CAPS);
+
+  g_mutex_lock (&mixer->channels_lock);
+  for (i = 0; i < mixer->channels->len; ++i) {
+    GstMixerChannel *channel =
+        &g_array_index (mixer->channels, GstMixerChannel, i);
+    g_string_append_printf (desc,
+        "interaudiosrc name=source_%d channel=mix_%d ",
+        channel->port, channel->port);
+    if (opts.audio_period)
+      gst_audio_engine_append_source (desc, opts.audio_period);
+    else
+      g_string_append_printf (desc, "period-time=%" G_GUINT64_FORMAT " ",
+          period);
+    g_string_append_printf (desc, "! %s ", caps);
+    g_string_append_printf (desc, "! audioconvert ! %s ", GST_MIXER_CAPS);
+    g_string_append_printf (desc, "! volume name=gain_%d volume=%f ",
+        channel->port, gst_mixer_channel_gain (channel, mixer->follow));
+    g_string_append_printf (desc,
+        "! audiopanorama name=pan_%d method=simple panorama=%f ",
+        channel->port, channel->pan);
+    g_string_append_printf (desc, "! %s ! mix. ", GST_MIXER_CAPS);
+  }
+  g_mutex_unlock (&mixer->channels_lock);
+
+  return desc;
+}
+
+/**
+ * @brief Ramp a controllable property of a running element.
+ * @param element the volume or audiopanorama element
+ * @param property the property name
+ * @param from the value the property had before this change
+ * @param to the new value
+ * @param duration how long the ramp takes
+ *
+ * The ramp starts from wherever a previous ramp has got to, so changes
+ * coming in quick succession never jump.
+ */
+static void
+gst_mixer_ramp (GstElement * element, const gchar * property,
+    gdouble from, gdouble to, GstClockTime duration)
+{
+  GstObject *object = GST_OBJECT (element);
+  GstControlBinding *binding;
+  GstControlSource *source = NULL;
+  GstTimedValueControlSource *values;
+  GstClock *clock;
+  GstClockTime now;
+  gdouble current = from;
+
+  clock = gst_element_get_clock (element);
+  if (clock == NULL) {
+    g_object_set (element, property, to, NULL);
+    return;
+  }
+  now = gst_clock_get_time (clock) - gst_element_get_base_time (element);
+  gst_object_unref (clock);
+
+  binding = gst_object_get_control_binding (object, property);
+  if (binding) {
+    g_object_get (binding, "control-source", &source, NULL);
+    gst_control_source_get_value (source, now, &current);
+    gst_object_unref (binding);
+  } else {
+    source = gst_interpolation_control_source_new ();
+    g_object_set (source, "mode", GST_INTERPOLATION_MODE_LINEAR, NULL);
+    gst_object_add_control_binding (object,
+        gst_direct_control_binding_new_absolute (object, property, source));
+  }
+
+  values = GST_TIMED_VALUE_CONTROL_SOURCE (source);
+  gst_timed_value_control_source_unset_all (values);
+  gst_timed_value_control_source_set (values, now, current);
+  gst_timed_value_control_source_set (values, now + duration, to);
+  gst_object_unref (source);
+}
+
+/**
+ * @brief Update the inputs of the mix.
+ * @param mixer The GstMixer instance.
+ * @param ports the audio input ports
+ * @param n the number of %ports
+ * @memberof GstMixer
+ *
+ * Inputs keep their settings while they stay, new inputs are mixed at unity
+ * gain in the center. The pipeline is rebuilt only when the set of inputs
+ * changed.
+ */
+void
+gst_mixer_update (GstMixer * mixer, const gint * ports, guint n)
+{
+  GstWorker *worker = GST_WORKER (mixer);
+  GstWorkerClass *worker_class;
+  gboolean relayout;
+  GArray *channels;
+  guint i, j;
+
+  g_return_if_fail (GST_IS_MIXER (mixer));
+
+  channels = g_array_sized_new (FALSE, TRUE, sizeof (GstMixerChannel), n);
+
+  g_mutex_lock (&mixer->channels_lock);
+  relayout = (mixer->channels->len != n);
+  for (i = 0; i < n; ++i) {
+    GstMixerChannel channel = { ports[i], 1.0, FALSE, 0.0 };
+    for (j = 0; j < mixer->channels->len; ++j) {
+      GstMixerChannel *old =
+          &g_array_index (mixer->channels, GstMixerChannel, j);
+      if (old->port == ports[i]) {
+        channel = *old;
+        break;
+      }
+    }
+    if (j == mixer->channels->len)
+      relayout = TRUE;
+    g_array_append_val (channels, channel);
+  }
+  g_array_free (mixer->channels, TRUE);
+  mixer->channels = channels;
+  g_mutex_unlock (&mixer->channels_lock);
+
+  if (worker->pipeline == NULL || !relayout)
+    return;
+
+  INFO ("%s: remix %d audio inputs", worker->name, n);
+  worker_class = GST_WORKER_CLASS (G_OBJECT_GET_CLASS (mixer));
+  if (!worker_class->reset (worker) || !gst_worker_start (worker))
+    ERROR ("%s: failed to remix", worker->name);
+}
+
+/**
+ * @brief Change the mix of an audio input.
+ * @param mixer The GstMixer instance.
+ * @param port the audio input port
+ * @param gain the linear gain, 0 to GST_MIXER_MAX_GAIN
+ * @param mute TRUE to leave the input out of the mix
+ * @param pan -1.0 left to 1.0 right
+ * @return TRUE if the port is mixed, FALSE otherwise
+ * @memberof GstMixer
+ *
+ * The change is ramped over GST_MIXER_RAMP on the running pipeline, it
+ * never restarts the mix.
+ */
+gboolean
+gst_mixer_set_channel (GstMixer * mixer, gint port, gdouble gain,
+    gboolean mute, gdouble pan)
+{
+  GstWorker *worker = GST_WORKER (mixer);
+  GstMixerChannel old = { 0 }, now = { 0 }, *channel;
+  GstElement *element;
+  gboolean found = FALSE;
+  gint follow;
+  gchar *name;
+  guint i;
+
+  g_return_val_if_fail (GST_IS_MIXER (mixer), FALSE);
+
+  gain = CLAMP (gain, 0.0, GST_MIXER_MAX_GAIN);
+  pan = CLAMP (pan, -1.0, 1.0);
+
+  g_mutex_lock (&mixer->channels_lock);
+  for (i = 0; i < mixer->channels->len; ++i) {
+    channel = &g_array_index (mixer->channels, GstMixerChannel, i);
+    if (channel->port == port) {
+      old = *channel;
+      channel->gain = gain;
+      channel->mute = mute;
+      channel->pan = pan;
+      now = *channel;
+      found = TRUE;
+      break;
+    }
+  }
+  follow = mixer->follow;
+  g_mutex_unlock (&mixer->channels_lock);
+
+  if (!found)
+    return FALSE;
+
+  INFO ("%s: %d: gain=%f mute=%d pan=%f", worker->name, port, gain, mute,
+      pan);
+
+  name = g_strdup_printf ("gain_%d", port);
+  element = gst_worker_get_element (worker, name);
+  if (element) {
+    gst_mixer_ramp (element, "volume", gst_mixer_channel_gain (&old, follow),
+        gst_mixer_channel_gain (&now, follow), GST_MIXER_RAMP);
+    gst_object_unref (element);
+  }
+  g_free (name);
+
+  name = g_strdup_printf ("pan_%d", port);
+  element = gst_worker_get_element (worker, name);
+  if (element) {
+    gst_mixer_ramp (element, "panorama", old.pan, pan, GST_MIXER_RAMP);
+    gst_object_unref (element);
+  }
+  g_free (name);
+  return TRUE;
+}
+
+/**
+ * @brief Let the mix follow one audio input.
+ * @param mixer The GstMixer instance.
+ * @param port the only audio input to mix, 0 to mix all again
+ * @memberof GstMixer
+ *
+ * The inputs are crossfaded over GST_MIXER_CROSSFADE on the running
+ * pipeline, gain, mute and pan settings are kept. The port needs not be
+ * mixed yet, the mix is silent until it is.
+ */
+void
+gst_mixer_follow (GstMixer * mixer, gint port)
+{
+  GstWorker *worker = GST_WORKER (mixer);
+  GArray *channels;
+  gint old;
+  guint i;
+
+  g_return_if_fail (GST_IS_MIXER (mixer));
+
+  g_mutex_lock (&mixer->channels_lock);
+  old = mixer->follow;
+  mixer->follow = port;
+  g_mutex_unlock (&mixer->channels_lock);
+
+  if (old == port)
+    return;
+
+  INFO ("%s: follow %d", worker->name, port);
+
+  channels = gst_mixer_get_channels (mixer);
+  for (i = 0; i < channels->len; ++i) {
+    GstMixerChannel *channel = &g_array_index (channels, GstMixerChannel, i);
+    gdouble from = gst_mixer_channel_gain (channel, old);
+    gdouble to = gst_mixer_channel_gain (channel, port);
+    GstElement *element;
+    gchar *name;
+
+    if (from == to)
+      continue;
+
+    name = g_strdup_printf ("gain_%d", channel->port);
+    element = gst_worker_get_element (worker, name);
+    if (element) {
+      gst_mixer_ramp (element, "volume", from, to, GST_MIXER_CROSSFADE);
+      gst_object_unref (element);
+    }
+    g_free (name);
+  }
+  g_array_free (channels, TRUE);
+}
+
+/**
+ * @brief Get the mix settings of all audio inputs.
+ * @param mixer The GstMixer instance.
+ * @return A GArray of GstMixerChannel, free it with g_array_free
+ * @memberof GstMixer
+ */
+GArray *
+gst_mixer_get_channels (GstMixer * mixer)
+{
+  GArray *channels;
+
+  g_return_val_if_fail (GST_IS_MIXER (mixer), NULL);
+
+  g_mutex_lock (&mixer->channels_lock);
+  channels = g_array_sized_new (FALSE, TRUE, sizeof (GstMixerChannel),
+      mixer->channels->len);
+  g_array_append_vals (channels, mixer->channels->data,
+      mixer->channels->len);
+  g_mutex_unlock (&mixer->channels_lock);
+  return channels;
+}
+
+/**
+ * @brief Get the latest level of the mix.
+ * @param mixer The GstMixer instance.
+ * @param level (output) the level
+ * @return TRUE if the mix is metered and the level is fresh
+ * @memberof GstMixer
+ */
+gboolean
+gst_mixer_get_level (GstMixer * mixer, GstMeterLevel * level)
+{
+  g_return_val_if_fail (GST_IS_MIXER (mixer), FALSE);
+
+  return gst_meter_get_level (&mixer->meter, level);
+}
+
+/**
+ * @brief Handling pipeline messages, the levels of the mix.
+ * @memberof GstMixer
+ */
+static gboolean
+gst_mixer_message (GstMixer * mixer, GstMessage * message)
+{
+  gst_meter_message (&mixer->meter, message);
+  return TRUE;
+}
+
+/**
+ * @brief Initialize the GstMixerClass.
+ * @param klass The GstMixerClass instance.
+ * @memberof GstMixerClass
+ */
+static void
+gst_mixer_class_init (GstMixerClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstWorkerClass *worker_class = GST_WORKER_CLASS (klass);
+
+  object_class->finalize = (GObjectFinalizeFunc) gst_mixer_finalize;
+
+  worker_class->get_pipeline_string = (GstWorkerGetPipelineStringFunc)
+      gst_mixer_get_pipeline_string;
+  worker_class->message = (GstWorkerMessageFunc) gst_mixer_message;
+}
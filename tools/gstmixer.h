@@ -0,0 +1,98 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_MIXER_H__
+#define __GST_MIXER_H__
+
+#include "gstworker.h"
+#include "gstmeter.h"
+
+#define GST_TYPE_MIXER (gst_mixer_get_type ())
+#define GST_MIXER(object) (G_TYPE_CHECK_INSTANCE_CAST ((object), GST_TYPE_MIXER, GstMixer))
+#define GST_MIXER_CLASS(class) (G_TYPE_CHECK_CLASS_CAST ((class), GST_TYPE_MIXER, GstMixerClass))
+#define GST_IS_MIXER(object) (G_TYPE_CHECK_INSTANCE_TYPE ((object), GST_TYPE_MIXER))
+#define GST_IS_MIXER_CLASS(class) (G_TYPE_CHECK_CLASS_TYPE ((class), GST_TYPE_MIXER))
+
+#define GST_MIXER_PERIOD (10 * GST_MSECOND)     /* duration of a mix buffer */
+#define GST_MIXER_RAMP (50 * GST_MSECOND)       /* gain and pan changes take this long */
+#define GST_MIXER_CROSSFADE (250 * GST_MSECOND) /* audio following a switch */
+#define GST_MIXER_MAX_GAIN 10.0 /* +20 dB */
+
+typedef struct _GstMixer GstMixer;
+typedef struct _GstMixerClass GstMixerClass;
+typedef struct _GstMixerChannel GstMixerChannel;
+
+/**
+ *  @brief The mix settings of one audio input.
+ */
+struct _GstMixerChannel
+{
+  gint port;                    /*!< the audio input port */
+  gdouble gain;                 /*!< linear gain, 1.0 leaves the input as is */
+  gboolean mute;                /*!< TRUE to leave the input out of the mix */
+  gdouble pan;                  /*!< -1.0 left to 1.0 right */
+};
+
+/**
+ *  @class GstMixer
+ *  @struct _GstMixer
+ *  @brief Mix all audio inputs into the composite audio.
+ *
+ *  Each input goes through its own gain and pan before the mixer. The
+ *  pipeline is rebuilt only when inputs come and go, gain, mute and pan
+ *  changes are ramped on the running pipeline. When the mix follows an
+ *  input, all other inputs are faded out.
+ */
+struct _GstMixer
+{
+  GstWorker base;               /*!< the parent object */
+
+  GMutex channels_lock;         /*!< the lock for %channels */
+  GArray *channels;             /*!< the GstMixerChannel of the inputs */
+  gint follow;                  /*!< the only input mixed, 0 mixes all */
+
+  GstMeter meter;               /*!< the level of the mix */
+};
+
+/**
+ *  @class GstMixerClass
+ *  @struct _GstMixerClass
+ *  @brief The class of GstMixer.
+ */
+struct _GstMixerClass
+{
+  GstWorkerClass base_class;    /*!< the parent class */
+};
+
+/**
+ *  @internal Use GST_TYPE_MIXER instead.
+ *  @see GST_TYPE_MIXER
+ */
+GType gst_mixer_get_type (void);
+
+void gst_mixer_update (GstMixer * mixer, const gint * ports, guint n);
+gboolean gst_mixer_set_channel (GstMixer * mixer, gint port, gdouble gain,
+    gboolean mute, gdouble pan);
+GArray *gst_mixer_get_channels (GstMixer * mixer);
+void gst_mixer_follow (GstMixer * mixer, gint port);
+gboolean gst_mixer_get_level (GstMixer * mixer, GstMeterLevel * level);
+
+#endif //__GST_MIXER_H__
@@ -0,0 +1,524 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include <string.h>
+#include "gstswitchserver.h"
+#include "gstmultiview.h"
+
+/* videobox "fill" values used for the tally borders */
+#define GST_MULTIVIEW_FILL_BLACK 0
+#define GST_MULTIVIEW_FILL_GREEN 1
+#define GST_MULTIVIEW_FILL_RED 3
+
+enum
+{
+  PROP_0,
+  PROP_PORT,
+  PROP_WIDTH,
+  PROP_HEIGHT,
+  PROP_COLUMNS,
+  PROP_JPEG,
+};
+
+extern gboolean verbose;
+
+#define parent_class gst_multiview_parent_class
+
+G_DEFINE_TYPE (GstMultiview, gst_multiview, GST_TYPE_WORKER);
+
+/**
+ * @brief Initialize the GstMultiview instance.
+ * @param mv The GstMultiview instance.
+ * @memberof GstMultiview
+ */
+static void
+gst_multiview_init (GstMultiview * mv)
+{
+  mv->sink_port = 0;
+  mv->width = GST_MULTIVIEW_DEFAULT_WIDTH;
+  mv->height = GST_MULTIVIEW_DEFAULT_HEIGHT;
+  mv->columns = 0;
+  mv->jpeg = FALSE;
+  mv->tiles = g_array_new (FALSE, TRUE, sizeof (GstMultiviewTile));
+  mv->output = NULL;
+
+  g_mutex_init (&mv->tiles_lock);
+}
+
+/**
+ * @brief Invoked to unref objects.
+ * @param mv The GstMultiview instance.
+ * @memberof GstMultiview
+ */
+static void
+gst_multiview_dispose (GstMultiview * mv)
+{
+  if (mv->output) {
+    g_object_unref (mv->output);
+    mv->output = NULL;
+  }
+
+  INFO ("dispose %p", mv);
+  G_OBJECT_CLASS (parent_class)->dispose (G_OBJECT (mv));
+}
+
+/**
+ * @brief Destroying the GstMultiview instance.
+ * @param mv The GstMultiview instance.
+ * @memberof GstMultiview
+ */
+static void
+gst_multiview_finalize (GstMultiview * mv)
+{
+  g_array_free (mv->tiles, TRUE);
+  mv->tiles = NULL;
+
+  g_mutex_clear (&mv->tiles_lock);
+
+  if (G_OBJECT_CLASS (parent_class)->finalize)
+    (*G_OBJECT_CLASS (parent_class)->finalize) (G_OBJECT (mv));
+}
+
+/**
+ * @brief Fetching the GstMultiview property.
+ * @param mv The GstMultiview instance.
+ * @param property_id
+ * @param value
+ * @param pspec
+ * @memberof GstMultiview
+ */
+static void
+gst_multiview_get_property (GstMultiview * mv, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_PORT:
+      g_value_set_uint (value, mv->sink_port);
+      break;
+    case PROP_WIDTH:
+      g_value_set_uint (value, mv->width);
+      break;
+    case PROP_HEIGHT:
+      g_value_set_uint (value, mv->height);
+      break;
+    case PROP_COLUMNS:
+      g_value_set_uint (value, mv->columns);
+      break;
+    case PROP_JPEG:
+      g_value_set_boolean (value, mv->jpeg);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (mv, property_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Changing the GstMultiview properties.
+ * @param mv The GstMultiview instance.
+ * @param property_id
+ * @param value
+ * @param pspec
+ * @memberof GstMultiview
+ */
+static void
+gst_multiview_set_property (GstMultiview * mv, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_PORT:
+      mv->sink_port = g_value_get_uint (value);
+      break;
+    case PROP_WIDTH:
+      mv->width = g_value_get_uint (value);
+      break;
+    case PROP_HEIGHT:
+      mv->height = g_value_get_uint (value);
+      break;
+    case PROP_COLUMNS:
+      mv->columns = g_value_get_uint (value);
+      break;
+    case PROP_JPEG:
+      mv->jpeg = g_value_get_boolean (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (mv), property_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Get the frame rate of the server video caps.
+ */
+static void
+gst_multiview_get_framerate (gint * fps_n, gint * fps_d)
+{
+  GstStructure *s = gst_caps_get_structure (gst_switch_server_getcaps (), 0);
+
+  if (!gst_structure_get_fraction (s, "framerate", fps_n, fps_d) ||
+      *fps_n <= 0) {
+    *fps_n = 30;
+    *fps_d = 1;
+  }
+}
+
+/**
+ * @brief Map a tally state to the videobox border fill.
+ */
+static gint
+gst_multiview_tally_fill (GstMultiviewTally tally)
+{
+  switch (tally) {
+    case GST_MULTIVIEW_TALLY_PROGRAM:
+      return GST_MULTIVIEW_FILL_RED;
+    case GST_MULTIVIEW_TALLY_PREVIEW:
+      return GST_MULTIVIEW_FILL_GREEN;
+    case GST_MULTIVIEW_TALLY_NONE:
+      break;
+  }
+  return GST_MULTIVIEW_FILL_BLACK;
+}
+
+/**
+ * @param mv The GstMultiview instance.
+ * @memberof GstMultiview
+ * @return The render pipeline string, needs freeing when used
+ *
+ * Fetching the multiview render pipeline, invoked by the GstWorker. Every
+ * input preview is scaled into its tile, labelled with its port and framed
+ * by a videobox border showing its tally. A black live background keeps the
+ * output running while there are no inputs.
+ */
+static GString *
+gst_multiview_get_pipeline_string (GstMultiview * mv)
+{
+  const gchar *caps = gst_switch_server_get_video_caps_str ();
+  const guint border = GST_MULTIVIEW_TALLY_BORDER;
+  guint n, cols, rows, tw, th, i;
+  gint fps_n, fps_d;
+  GString *desc;
+
+  gst_multiview_get_framerate (&fps_n, &fps_d);
+
+  g_mutex_lock (&mv->tiles_lock);
+
+  n = mv->tiles->len;
+  cols = mv->columns ? mv->columns : (guint) ceil (sqrt (n));
+  cols = MAX (cols, 1);
+  rows = MAX ((n + cols - 1) / cols, 1);
+  tw = (mv->width / cols) & ~1;
+  th = (mv->height / rows) & ~1;
+
+  desc = g_string_new ("");
+
+  g_string_append_printf (desc, "videomixer name=mix ");
+  for (i = 0; i < n; ++i) {
+    g_string_append_printf (desc,
+        "sink_%d::xpos=%d sink_%d::ypos=%d sink_%d::zorder=1 ",
+        i + 1, (i % cols) * tw, i + 1, (i / cols) * th, i + 1);
+  }
+  g_string_append_printf (desc, "! video/x-raw,width=%d,height=%d ",
+      mv->width, mv->height);
+  g_string_append_printf (desc,
+      "! intervideosink name=sink sync=false channel=multiview ");
+
+  g_string_append_printf (desc,
+      "videotestsrc name=background pattern=black is-live=true "
+      "! video/x-raw,format=I420,width=%d,height=%d,framerate=%d/%d "
+      "! mix.sink_0 ", mv->width, mv->height, fps_n, fps_d);
+
+  for (i = 0; i < n && tw > 2 * border && th > 2 * border; ++i) {
+    GstMultiviewTile *tile = &g_array_index (mv->tiles, GstMultiviewTile, i);
+    g_string_append_printf (desc,
+        "intervideosrc name=source_%d channel=branch_%d ! %s ",
+        tile->port, tile->port, caps);
+    g_string_append_printf (desc,
+        "! queue max-size-buffers=2 leaky=downstream ");
+    g_string_append_printf (desc,
+        "! videoscale ! video/x-raw,width=%d,height=%d ",
+        tw - 2 * border, th - 2 * border);
+    g_string_append_printf (desc,
+        "! textoverlay text=\"%d\" valignment=top halignment=left "
+        "shaded-background=true font-desc=\"Sans %d\" ",
+        tile->port, MAX (th / 16, 6));
+    g_string_append_printf (desc,
+        "! videobox name=tally_%d top=-%d bottom=-%d left=-%d right=-%d "
+        "fill=%d ", tile->port, border, border, border, border,
+        gst_multiview_tally_fill (tile->tally));
+    g_string_append_printf (desc, "! mix.sink_%d ", i + 1);
+  }
+
+  g_mutex_unlock (&mv->tiles_lock);
+
+  return desc;
+}
+
+/**
+ * @brief Fetching the pipeline serving the rendered multiview.
+ * @memberof GstMultiview
+ */
+static GString *
+gst_multiview_get_output_string (GstWorker * worker, GstMultiview * mv)
+{
+  GString *desc;
+  gint fps_n, fps_d;
+
+  gst_multiview_get_framerate (&fps_n, &fps_d);
+
+  desc = g_string_new ("");
+
+  g_string_append_printf (desc, "intervideosrc name=source "
+      "channel=multiview ");
+  g_string_append_printf (desc,
+      "! video/x-raw,format=I420,width=%d,height=%d,framerate=%d/%d ",
+      mv->width, mv->height, fps_n, fps_d);
+  if (mv->jpeg) {
+    g_string_append_printf (desc, "! jpegenc quality=75 ");
+  }
+  g_string_append_printf (desc, "! gdppay ! tcpserversink name=sink "
+      "sync=false " GST_SWITCH_SERVE_LATEST_BUFFER " port=%d ",
+      mv->sink_port);
+
+  return desc;
+}
+
+/**
+ * @brief Invoked when a client is attached to the multiview.
+ * @memberof GstMultiview
+ */
+static void
+gst_multiview_client_socket_added (GstElement * element,
+    GSocket * socket, GstMultiview * mv)
+{
+  g_return_if_fail (G_IS_SOCKET (socket));
+
+  INFO ("%s: client-socket-added: %d", GST_WORKER (mv)->name,
+      g_socket_get_fd (socket));
+}
+
+/**
+ * @brief Invoked when a client leaves the multiview. We need to close
+ * the socket manually to avoid FD leaks.
+ * @memberof GstMultiview
+ */
+static void
+gst_multiview_client_socket_removed (GstElement * element,
+    GSocket * socket, GstMultiview * mv)
+{
+  g_return_if_fail (G_IS_SOCKET (socket));
+
+  INFO ("%s: client-socket-removed: %d", GST_WORKER (mv)->name,
+      g_socket_get_fd (socket));
+
+  g_socket_close (socket, NULL);
+}
+
+/**
+ * @brief Invoked when the output worker is prepared.
+ * @memberof GstMultiview
+ */
+static void
+gst_multiview_prepare_output (GstWorker * worker, GstMultiview * mv)
+{
+  GstElement *sink = gst_worker_get_element_unlocked (worker, "sink");
+
+  g_return_if_fail (GST_IS_ELEMENT (sink));
+
+  g_signal_connect (sink, "client-added",
+      G_CALLBACK (gst_multiview_client_socket_added), mv);
+  g_signal_connect (sink, "client-socket-removed",
+      G_CALLBACK (gst_multiview_client_socket_removed), mv);
+  gst_worker_watch_clients (worker, sink, FALSE);
+
+  gst_object_unref (sink);
+}
+
+/**
+ * @param mv The GstMultiview instance.
+ * @memberof GstMultiview
+ * @return TRUE indicating the multiview is prepared, FALSE otherwise.
+ *
+ * Invoked when the GstWorker is preparing the render pipeline. The output
+ * worker is created once and survives re-layouts of the render pipeline.
+ */
+static gboolean
+gst_multiview_prepare (GstMultiview * mv)
+{
+  gchar *name;
+
+  g_return_val_if_fail (GST_IS_MULTIVIEW (mv), FALSE);
+
+  if (mv->output == NULL) {
+    name = g_strdup_printf ("%s-output", GST_WORKER (mv)->name);
+    mv->output = GST_WORKER (g_object_new (GST_TYPE_WORKER,
+            "name", name, NULL));
+    g_free (name);
+    mv->output->pipeline_func_data = mv;
+    mv->output->pipeline_func = (GstWorkerGetPipelineString)
+        gst_multiview_get_output_string;
+    g_signal_connect (mv->output, "prepare-worker",
+        G_CALLBACK (gst_multiview_prepare_output), mv);
+  }
+  return TRUE;
+}
+
+/**
+ * @brief Invoked when the render pipeline is started.
+ * @memberof GstMultiview
+ */
+static void
+gst_multiview_start (GstMultiview * mv)
+{
+  g_return_if_fail (GST_IS_MULTIVIEW (mv));
+
+  if (mv->output->pipeline == NULL ||
+      GST_STATE (mv->output->pipeline) == GST_STATE_NULL)
+    gst_worker_start (mv->output);
+}
+
+/**
+ * @brief Invoked when the render pipeline is ended.
+ * @memberof GstMultiview
+ */
+static void
+gst_multiview_end (GstMultiview * mv)
+{
+  g_return_if_fail (GST_IS_MULTIVIEW (mv));
+
+  if (mv->output)
+    gst_worker_stop (mv->output);
+}
+
+/**
+ * @brief Update the inputs shown on the multiview.
+ * @param mv The GstMultiview instance.
+ * @param tiles the inputs, in display order
+ * @param n the number of %tiles
+ * @memberof GstMultiview
+ *
+ * The render pipeline is rebuilt only when the set of inputs changed, tally
+ * changes are applied to the running pipeline.
+ */
+void
+gst_multiview_update (GstMultiview * mv, const GstMultiviewTile * tiles,
+    guint n)
+{
+  GstWorker *worker = GST_WORKER (mv);
+  GstWorkerClass *worker_class;
+  gboolean relayout = FALSE;
+  guint i;
+
+  g_return_if_fail (GST_IS_MULTIVIEW (mv));
+
+  g_mutex_lock (&mv->tiles_lock);
+  relayout = (mv->tiles->len != n);
+  for (i = 0; !relayout && i < n; ++i) {
+    if (g_array_index (mv->tiles, GstMultiviewTile, i).port != tiles[i].port)
+      relayout = TRUE;
+  }
+  g_array_set_size (mv->tiles, 0);
+  g_array_append_vals (mv->tiles, tiles, n);
+  g_mutex_unlock (&mv->tiles_lock);
+
+  if (worker->pipeline == NULL)
+    return;
+
+  if (relayout) {
+    INFO ("%s: relayout for %d inputs", worker->name, n);
+    worker_class = GST_WORKER_CLASS (G_OBJECT_GET_CLASS (mv));
+    if (!worker_class->reset (worker) || !gst_worker_start (worker))
+      ERROR ("%s: failed to relayout", worker->name);
+    return;
+  }
+
+  for (i = 0; i < n; ++i) {
+    gchar *name = g_strdup_printf ("tally_%d", tiles[i].port);
+    GstElement *box = gst_worker_get_element (worker, name);
+    if (box) {
+      g_object_set (box, "fill", gst_multiview_tally_fill (tiles[i].tally),
+          NULL);
+      gst_object_unref (box);
+    }
+    g_free (name);
+  }
+}
+
+/**
+ * @brief Initialize the GstMultiviewClass.
+ * @param klass The GstMultiviewClass instance.
+ * @memberof GstMultiviewClass
+ */
+static void
+gst_multiview_class_init (GstMultiviewClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstWorkerClass *worker_class = GST_WORKER_CLASS (klass);
+
+  object_class->dispose = (GObjectFinalizeFunc) gst_multiview_dispose;
+  object_class->finalize = (GObjectFinalizeFunc) gst_multiview_finalize;
+  object_class->set_property =
+      (GObjectSetPropertyFunc) gst_multiview_set_property;
+  object_class->get_property =
+      (GObjectGetPropertyFunc) gst_multiview_get_property;
+
+  g_object_class_install_property (object_class, PROP_PORT,
+      g_param_spec_uint ("port", "Port",
+          "Sink port",
+          GST_SWITCH_MIN_SINK_PORT,
+          GST_SWITCH_MAX_SINK_PORT,
+          GST_SWITCH_MIN_SINK_PORT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_WIDTH,
+      g_param_spec_uint ("width", "Width",
+          "Multiview frame width",
+          16, G_MAXINT,
+          GST_MULTIVIEW_DEFAULT_WIDTH,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_HEIGHT,
+      g_param_spec_uint ("height", "Height",
+          "Multiview frame height",
+          16, G_MAXINT,
+          GST_MULTIVIEW_DEFAULT_HEIGHT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_COLUMNS,
+      g_param_spec_uint ("columns", "Columns",
+          "Tile columns, 0 for a square grid",
+          0, 64, 0, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_JPEG,
+      g_param_spec_boolean ("jpeg", "JPEG",
+          "Serve JPEG frames instead of raw video",
+          FALSE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  worker_class->prepare = (GstWorkerPrepareFunc) gst_multiview_prepare;
+  worker_class->start_worker = (GstWorkerAliveFunc) gst_multiview_start;
+  worker_class->end_worker = (GstWorkerAliveFunc) gst_multiview_end;
+  worker_class->get_pipeline_string = (GstWorkerGetPipelineStringFunc)
+      gst_multiview_get_pipeline_string;
+}
@@ -0,0 +1,106 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_MULTIVIEW_H__
+#define __GST_MULTIVIEW_H__
+
+#include "gstworker.h"
+
+#define GST_TYPE_MULTIVIEW (gst_multiview_get_type ())
+#define GST_MULTIVIEW(object) (G_TYPE_CHECK_INSTANCE_CAST ((object), GST_TYPE_MULTIVIEW, GstMultiview))
+#define GST_MULTIVIEW_CLASS(class) (G_TYPE_CHECK_CLASS_CAST ((class), GST_TYPE_MULTIVIEW, GstMultiviewClass))
+#define GST_IS_MULTIVIEW(object) (G_TYPE_CHECK_INSTANCE_TYPE ((object), GST_TYPE_MULTIVIEW))
+#define GST_IS_MULTIVIEW_CLASS(class) (G_TYPE_CHECK_CLASS_TYPE ((class), GST_TYPE_MULTIVIEW))
+
+#define GST_MULTIVIEW_DEFAULT_WIDTH 1280
+#define GST_MULTIVIEW_DEFAULT_HEIGHT 720
+#define GST_MULTIVIEW_TALLY_BORDER 4    /* pixels */
+
+typedef struct _GstMultiview GstMultiview;
+typedef struct _GstMultiviewClass GstMultiviewClass;
+typedef struct _GstMultiviewTile GstMultiviewTile;
+
+/**
+ *  @enum GstMultiviewTally
+ *
+ *  Tally state of a multiview tile, drawn as the tile border.
+ */
+typedef enum
+{
+  GST_MULTIVIEW_TALLY_NONE,     /*!< not used by the composite */
+  GST_MULTIVIEW_TALLY_PREVIEW,  /*!< on a composite channel, but not visible */
+  GST_MULTIVIEW_TALLY_PROGRAM,  /*!< visible in the composite output */
+} GstMultiviewTally;
+
+/**
+ *  @brief One input shown on the multiview.
+ */
+struct _GstMultiviewTile
+{
+  gint port;                    /*!< the input port, also the tile label */
+  GstMultiviewTally tally;      /*!< the tally state */
+};
+
+/**
+ *  @class GstMultiview
+ *  @struct _GstMultiview
+ *  @brief Tile all inputs into one monitor output.
+ *
+ *  The tiles are rendered by the multiview pipeline into the "multiview"
+ *  channel, and served to clients by the %output worker. Only the render
+ *  pipeline is rebuilt when inputs come and go, so clients stay connected.
+ */
+struct _GstMultiview
+{
+  GstWorker base;               /*!< the parent object */
+
+  gint sink_port;               /*!< the tcp port the multiview is served on */
+  guint width;                  /*!< the multiview width */
+  guint height;                 /*!< the multiview height */
+  guint columns;                /*!< tile columns, 0 to pick automatically */
+  gboolean jpeg;                /*!< serve JPEG frames instead of raw */
+
+  GMutex tiles_lock;            /*!< the lock for %tiles */
+  GArray *tiles;                /*!< the GstMultiviewTile shown */
+
+  GstWorker *output;            /*!< the worker serving the multiview */
+};
+
+/**
+ *  @class GstMultiviewClass
+ *  @struct _GstMultiviewClass
+ *  @brief The class of GstMultiview.
+ */
+struct _GstMultiviewClass
+{
+  GstWorkerClass base_class;    /*!< the parent class */
+};
+
+/**
+ *  @internal Use GST_TYPE_MULTIVIEW instead.
+ *  @see GST_TYPE_MULTIVIEW
+ */
+GType gst_multiview_get_type (void);
+
+void gst_multiview_update (GstMultiview * mv, const GstMultiviewTile * tiles,
+    guint n);
+
+#endif //__GST_MULTIVIEW_H__
@@ -39,6 +39,9 @@ enum
   PROP_PORT,
   PROP_WIDTH,
   PROP_HEIGHT,
+  PROP_CODEC,
+  PROP_QUALITY,
+  PROP_THREADS,
 };
 
 enum
@@ -65,6 +68,20 @@ gst_recorder_init (GstRecorder * rec)
   rec->mode = 0;
   rec->width = 0;
   rec->height = 0;
+  rec->codec = GST_RECORDER_CODEC_MJPEG;
+  rec->quality = GST_RECORDER_DEFAULT_QUALITY;
+  rec->threads = 0;
+  rec->base_time = GST_CLOCK_TIME_NONE;
+
+  g_mutex_init (&rec->stats_lock);
+  rec->frame_count = 0;
+  rec->last_frame = 0;
+  rec->rollover = FALSE;
+  rec->location = NULL;
+  memset (&rec->stats, 0, sizeof (rec->stats));
+  rec->window_start = 0;
+  rec->window_frames = 0;
+  rec->index = NULL;
 
   // Recording pipeline needs clean shut-down
   // via EOS to close out each recording
@@ -82,6 +99,14 @@ static void
 gst_recorder_dispose (GstRecorder * rec)
 {
   INFO ("dispose %p", rec);
+  if (rec->disk) {
+    gst_object_unref (rec->disk);
+    rec->disk = NULL;
+  }
+  if (rec->index) {
+    gst_record_index_close (rec->index);
+    rec->index = NULL;
+  }
   G_OBJECT_CLASS (parent_class)->dispose (G_OBJECT (rec));
 }
 
@@ -96,6 +121,10 @@ gst_recorder_dispose (GstRecorder * rec)
 static void
 gst_recorder_finalize (GstRecorder * rec)
 {
+  g_free (rec->location);
+  rec->location = NULL;
+  g_mutex_clear (&rec->stats_lock);
+
   if (G_OBJECT_CLASS (parent_class)->finalize)
     (*G_OBJECT_CLASS (parent_class)->finalize) (G_OBJECT (rec));
 }
@@ -128,6 +157,15 @@ gst_recorder_get_property (GstRecorder * rec, guint property_id,
     case PROP_HEIGHT:
       g_value_set_uint (value, rec->height);
       break;
+    case PROP_CODEC:
+      g_value_set_uint (value, rec->codec);
+      break;
+    case PROP_QUALITY:
+      g_value_set_uint (value, rec->quality);
+      break;
+    case PROP_THREADS:
+      g_value_set_uint (value, rec->threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (rec, property_id, pspec);
       break;
@@ -162,12 +200,60 @@ gst_recorder_set_property (GstRecorder * rec, guint property_id,
     case PROP_HEIGHT:
       rec->height = g_value_get_uint (value);
       break;
+    case PROP_CODEC:
+      rec->codec = (GstRecorderCodec) (g_value_get_uint (value));
+      break;
+    case PROP_QUALITY:
+      rec->quality = g_value_get_uint (value);
+      break;
+    case PROP_THREADS:
+      rec->threads = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (rec), property_id, pspec);
       break;
   }
 }
 
+/**
+ * @brief Parse the name of a recording codec.
+ * @param name "mjpeg", "h264", "ffv1" or "raw"
+ * @param codec return location of the codec
+ * @return TRUE if the name is a valid codec.
+ */
+gboolean
+gst_recorder_parse_codec (const gchar * name, GstRecorderCodec * codec)
+{
+  GstRecorderCodec c;
+  for (c = 0; c <= GST_RECORDER_CODEC__LAST; ++c) {
+    if (g_strcmp0 (name, gst_recorder_codec_to_string (c)) == 0) {
+      *codec = c;
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/**
+ * @brief Get the name of a recording codec.
+ * @param codec the codec
+ */
+const gchar *
+gst_recorder_codec_to_string (GstRecorderCodec codec)
+{
+  switch (codec) {
+    case GST_RECORDER_CODEC_MJPEG:
+      return "mjpeg";
+    case GST_RECORDER_CODEC_H264:
+      return "h264";
+    case GST_RECORDER_CODEC_FFV1:
+      return "ffv1";
+    case GST_RECORDER_CODEC_RAW:
+      return "raw";
+  }
+  return "unknown";
+}
+
 /*
  * @param dir - directory to create
  * @return nothing
@@ -222,9 +308,10 @@ gst_recorder_pathlen (const char *filepath)
  * @param filename Template name of the file to save
  * @return the file name string, need to be freed after used
  *
- * This is used to generate a new recording file name for the recorder.
+ * This is used to generate a new recording file name for the recorder and
+ * the input recordings.
  */
-static const gchar *
+const gchar *
 gst_recorder_new_filename (const gchar * filename)
 {
   if (!filename)
@@ -232,9 +319,11 @@ gst_recorder_new_filename (const gchar * filename)
 
   gchar fnbuf[256];
   time_t t = time (NULL);
-  struct tm *tm = localtime (&t);
+  struct tm tm;
+  // Note: called from the streaming threads of several recordings at once
+  localtime_r (&t, &tm);
   // Note: reserve some space for collision suffix
-  strftime (fnbuf, sizeof (fnbuf) - 5, filename, tm);
+  strftime (fnbuf, sizeof (fnbuf) - 5, filename, &tm);
   // We now have a fully built name in our buffer
   // If there is at least one directory present, make sure they exist
   size_t pathlen = gst_recorder_pathlen (fnbuf);
@@ -266,6 +355,20 @@ gst_recorder_new_filename (const gchar * filename)
   return g_strdup (fnbuf);
 }
 
+/**
+ * @param name The element factory name.
+ * @return TRUE if elements of the factory can be made.
+ */
+static gboolean
+gst_recorder_has_element (const gchar * name)
+{
+  GstElementFactory *factory = gst_element_factory_find (name);
+  if (factory == NULL)
+    return FALSE;
+  gst_object_unref (factory);
+  return TRUE;
+}
+
 /**
  * @param rec The GstRecorder instance.
  * @memberof GstRecorder
@@ -276,44 +379,296 @@ gst_recorder_new_filename (const gchar * filename)
 static GString *
 gst_recorder_get_pipeline_string (GstRecorder * rec)
 {
-  const gchar *filename =
-      gst_recorder_new_filename (gst_switch_server_get_record_filename ());
   GString *desc;
 
-  //INFO ("Recording to %s and port %d", filename, rec->sink_port);
-
   desc = g_string_new ("");
 
-  // Encode the video with lossless jpeg
   g_string_append_printf (desc,
       "intervideosrc name=source_video channel=composite_video "
-      "! video/x-raw,width=%d,height=%d "
-      "! queue ! jpegenc quality=100 ! mux. \n", rec->width, rec->height);
+      "! video/x-raw,width=%d,height=%d ! queue ", rec->width, rec->height);
+
+  // The encoder is always named "enc" for the throughput probe
+  switch (rec->codec) {
+    case GST_RECORDER_CODEC_MJPEG:
+      // Encode the slices of each frame in parallel if we can
+      if (gst_recorder_has_element ("pjpegenc")) {
+        g_string_append_printf (desc, "! pjpegenc name=enc quality=%d "
+            "threads=%d ", rec->quality, rec->threads);
+      } else {
+        g_string_append_printf (desc, "! jpegenc name=enc quality=%d ",
+            rec->quality);
+      }
+      break;
+    case GST_RECORDER_CODEC_H264:
+      // Keyframes every second or so, the files are cut on keyframes
+      g_string_append_printf (desc, "! x264enc name=enc speed-preset=veryfast "
+          "pass=quant quantizer=%d threads=%d key-int-max=%d ! h264parse ",
+          GST_RECORDER_H264_QUANTIZER, rec->threads,
+          GST_RECORDER_KEYFRAME_INTERVAL);
+      break;
+    case GST_RECORDER_CODEC_FFV1:
+      g_string_append_printf (desc, "! avenc_ffv1 name=enc ");
+      break;
+    case GST_RECORDER_CODEC_RAW:
+      g_string_append_printf (desc, "! identity name=enc ");
+      break;
+  }
+  g_string_append_printf (desc, "! tee name=video \n");
 
   // Don't encode the audio
   g_string_append_printf (desc,
-      "interaudiosrc name=source_audio channel=composite_audio ! queue ! mux. \n");
+      "interaudiosrc name=source_audio channel=composite_audio ! queue "
+      "! tee name=audio \n");
 
-  // Output in streamable mkv format
+  // Serve in streamable mkv format
+  g_string_append_printf (desc, "video. ! queue ! mux. "
+      "audio. ! queue ! mux. \n");
   g_string_append_printf (desc,
       "matroskamux name=mux streamable=true "
       " writing-app='gst-switch' min-index-interval=1000000 ");
+  g_string_append_printf (desc, "! queue max-size-buffers=1 ! gdppay "
+      "! tcpserversink name=tcp_sink sync=false port=%d \n", rec->sink_port);
+
+  // Record into a sequence of files, the muxer is set when preparing and
+  // the file names are given by gst_recorder_format_location
+  if (gst_switch_server_get_record_filename ()) {
+    g_string_append_printf (desc, "video. ! queue name=disk_video "
+        "! disk_sink.video "
+        "audio. ! queue ! disk_sink.audio_0 ");
+    g_string_append_printf (desc, "splitmuxsink name=disk_sink "
+        "max-size-bytes=%" G_GUINT64_FORMAT " "
+        "max-size-time=%" G_GUINT64_FORMAT " ",
+        (guint64) opts.record_max_size * 1024 * 1024,
+        (guint64) opts.record_max_time * GST_SECOND);
+  }
+
+  INFO ("Recording pipeline\n----\n%s\n---", desc->str);
 
-  g_string_append_printf (desc, "! tee name=result ");
-  g_string_append_printf (desc, "\n");
+  return desc;
+}
+
+/**
+ * @param sink The disk sink.
+ * @param fragment_id The number of the file to open.
+ * @param rec The GstRecorder instance.
+ * @memberof GstRecorder
+ * @return The name of the next file.
+ *
+ * Invoked when the disk sink is about to open the next file, at start up,
+ * on gst_recorder_new_fragment, or when the size or duration limit is hit.
+ */
+static gchar *
+gst_recorder_format_location (GstElement * sink, guint fragment_id,
+    GstRecorder * rec)
+{
+  gchar *filename = (gchar *)
+      gst_recorder_new_filename (gst_switch_server_get_record_filename ());
 
-  if (filename) {
-    g_string_append_printf (desc, "result. ! queue max-size-buffers=1 "
-        "! filesink name=disk_sink sync=false location=\"%s\" ", filename);
-    g_free ((gpointer) filename);
+  g_mutex_lock (&rec->stats_lock);
+  if (!filename) {
+    /* Don't stop recording if the template can't give a new name. */
+    filename = g_strdup_printf ("%s.%05u",
+        rec->location ? rec->location : "recording", fragment_id);
+    WARN ("no new record filename, using %s", filename);
   }
+  g_free (rec->location);
+  rec->location = g_strdup (filename);
+  rec->stats.fragments += 1;
 
-  g_string_append_printf (desc, "result. ! queue max-size-buffers=1 ! gdppay "
-      "! tcpserversink name=tcp_sink sync=false port=%d ", rec->sink_port);
+  // Index the new file from its first byte, starting with the mode it
+  // opens in
+  if (rec->index)
+    gst_record_index_close (rec->index);
+  rec->index = gst_record_index_new (filename);
+  g_mutex_unlock (&rec->stats_lock);
 
-  INFO ("Recording pipeline\n----\n%s\n---", desc->str);
+  gst_recorder_mark (rec, NULL);
 
-  return desc;
+  INFO ("Recording to %s", filename);
+  return filename;
+}
+
+/**
+ * @memberof GstRecorder
+ *
+ * Index the file being written, as it leaves the file muxer. Byte
+ * segments are the muxer seeking back to rewrite the headers, an EOS
+ * completes the file and its index.
+ */
+static GstPadProbeReturn
+gst_recorder_index_probe (GstPad * pad, GstPadProbeInfo * info,
+    GstRecorder * rec)
+{
+  g_mutex_lock (&rec->stats_lock);
+  if (rec->index == NULL) {
+    // not indexing
+  } else if (info->type & GST_PAD_PROBE_TYPE_BUFFER) {
+    gst_record_index_add_buffer (rec->index,
+        GST_PAD_PROBE_INFO_BUFFER (info));
+  } else {
+    GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+    const GstSegment *segment;
+
+    switch (GST_EVENT_TYPE (event)) {
+      case GST_EVENT_SEGMENT:
+        gst_event_parse_segment (event, &segment);
+        if (segment->format == GST_FORMAT_BYTES)
+          gst_record_index_seek (rec->index, segment->start);
+        break;
+      case GST_EVENT_EOS:
+        gst_record_index_close (rec->index);
+        rec->index = NULL;
+        break;
+      default:
+        break;
+    }
+  }
+  g_mutex_unlock (&rec->stats_lock);
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @memberof GstRecorder
+ *
+ * Number the video frames on their way to the disk sink, so frames lost
+ * between two files can be counted.
+ */
+static GstPadProbeReturn
+gst_recorder_stamp_probe (GstPad * pad, GstPadProbeInfo * info,
+    GstRecorder * rec)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+
+  buffer = gst_buffer_make_writable (buffer);
+  GST_BUFFER_OFFSET (buffer) = rec->frame_count++;
+  GST_PAD_PROBE_INFO_DATA (info) = buffer;
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @memberof GstRecorder
+ *
+ * Watch the video frames written by the file muxer. An EOS finalises a
+ * file, the first frame after it is the first of the next file.
+ */
+static GstPadProbeReturn
+gst_recorder_mux_probe (GstPad * pad, GstPadProbeInfo * info,
+    GstRecorder * rec)
+{
+  g_mutex_lock (&rec->stats_lock);
+  if (info->type & GST_PAD_PROBE_TYPE_BUFFER) {
+    guint64 frame = GST_BUFFER_OFFSET (GST_PAD_PROBE_INFO_BUFFER (info));
+    guint64 gap = 0;
+    if (rec->stats.frames && frame > rec->last_frame + 1)
+      gap = frame - rec->last_frame - 1;
+    rec->stats.total_gap += gap;
+    if (rec->rollover) {
+      rec->stats.last_gap = gap;
+      rec->rollover = FALSE;
+      INFO ("Recording rolled over, %" G_GUINT64_FORMAT " frames lost", gap);
+    }
+    rec->last_frame = frame;
+    rec->stats.frames += 1;
+  } else {
+    GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+    if (GST_EVENT_TYPE (event) == GST_EVENT_EOS)
+      rec->rollover = TRUE;
+  }
+  g_mutex_unlock (&rec->stats_lock);
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @memberof GstRecorder
+ *
+ * Measure the frame rate the encoder achieves, against the frame rate of
+ * the composite it is fed with, once a second.
+ */
+static GstPadProbeReturn
+gst_recorder_encode_probe (GstPad * pad, GstPadProbeInfo * info,
+    GstRecorder * rec)
+{
+  gint64 now = g_get_monotonic_time ();
+  gint64 elapsed;
+
+  g_mutex_lock (&rec->stats_lock);
+  if (rec->window_start == 0)
+    rec->window_start = now;
+  rec->window_frames += 1;
+  elapsed = now - rec->window_start;
+  if (elapsed >= G_USEC_PER_SEC) {
+    GstElement *enc = gst_pad_get_parent_element (pad);
+    GstPad *sink = enc ? gst_element_get_static_pad (enc, "sink") : NULL;
+    GstCaps *caps = sink ? gst_pad_get_current_caps (sink) : NULL;
+    gint num, den;
+
+    rec->stats.encode_fps = (gdouble) rec->window_frames * G_USEC_PER_SEC
+        / elapsed;
+    if (caps && gst_structure_get_fraction (gst_caps_get_structure (caps, 0),
+            "framerate", &num, &den) && den) {
+      rec->stats.required_fps = (gdouble) num / den;
+    }
+    rec->window_start = now;
+    rec->window_frames = 0;
+
+    if (caps)
+      gst_caps_unref (caps);
+    if (sink)
+      gst_object_unref (sink);
+    if (enc)
+      gst_object_unref (enc);
+  }
+  g_mutex_unlock (&rec->stats_lock);
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @memberof GstRecorder
+ *
+ * Drop the video frames to the files while the disk buffer is above its
+ * high water mark, so the muxer keeps writing valid files and the buffer
+ * drains. After an overrun the files resume on a keyframe.
+ */
+static GstPadProbeReturn
+gst_recorder_disk_probe (GstPad * pad, GstPadProbeInfo * info,
+    GstRecorder * rec)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  gboolean overrun = FALSE, dropping;
+
+  g_object_get (rec->disk, "overrun", &overrun, NULL);
+
+  g_mutex_lock (&rec->stats_lock);
+  if (overrun && !rec->disk_dropping) {
+    WARN ("Recording disk is too slow, dropping frames");
+    rec->disk_dropping = TRUE;
+  } else if (!overrun && rec->disk_dropping
+      && !GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+    INFO ("Recording disk caught up, %" G_GUINT64_FORMAT " frames dropped",
+        rec->stats.disk_dropped);
+    rec->disk_dropping = FALSE;
+  }
+  dropping = rec->disk_dropping;
+  if (dropping)
+    rec->stats.disk_dropped += 1;
+  g_mutex_unlock (&rec->stats_lock);
+
+  return dropping ? GST_PAD_PROBE_DROP : GST_PAD_PROBE_OK;
+}
+
+/**
+ * @memberof GstRecorder
+ *
+ * Invoked when the disk sink requests a pad from the file muxer.
+ */
+static void
+gst_recorder_mux_pad_added (GstElement * mux, GstPad * pad, GstRecorder * rec)
+{
+  if (GST_PAD_IS_SINK (pad) && g_str_has_prefix (GST_PAD_NAME (pad), "video")) {
+    gst_pad_add_probe (pad,
+        GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+        (GstPadProbeCallback) gst_recorder_mux_probe, rec, NULL);
+  }
 }
 
 /**
@@ -363,10 +718,104 @@ gst_recorder_client_socket_removed (GstElement * element,
 static gboolean
 gst_recorder_prepare (GstRecorder * rec)
 {
-  GstElement *tcp_sink = NULL;
+  GstElement *tcp_sink = NULL, *disk_sink = NULL, *enc = NULL;
+  GstElement *ring = NULL, *old_ring = NULL;
+  GstElement *pipeline = GST_WORKER (rec)->pipeline;
+  GstClock *clock;
+  GstPad *pad;
 
   g_return_val_if_fail (GST_IS_RECORDER (rec), FALSE);
 
+  // Pin the timeline of the recording, so that the input recordings can
+  // share it, see GstIso
+  clock = gst_system_clock_obtain ();
+  rec->base_time = gst_clock_get_time (clock);
+  gst_pipeline_use_clock (GST_PIPELINE (pipeline), clock);
+  gst_element_set_start_time (pipeline, GST_CLOCK_TIME_NONE);
+  gst_element_set_base_time (pipeline, rec->base_time);
+  gst_object_unref (clock);
+
+  enc = gst_worker_get_element_unlocked (GST_WORKER (rec), "enc");
+  g_return_val_if_fail (GST_IS_ELEMENT (enc), FALSE);
+
+  pad = gst_element_get_static_pad (enc, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) gst_recorder_encode_probe, rec, NULL);
+  gst_object_unref (pad);
+  gst_object_unref (enc);
+
+  g_mutex_lock (&rec->stats_lock);
+  rec->window_start = 0;
+  rec->window_frames = 0;
+  g_mutex_unlock (&rec->stats_lock);
+
+  disk_sink = gst_worker_get_element_unlocked (GST_WORKER (rec), "disk_sink");
+  if (disk_sink) {
+    GstElement *video = gst_worker_get_element_unlocked (GST_WORKER (rec),
+        "video");
+    GstElement *mux = gst_element_factory_make ("matroskamux", NULL);
+
+    g_return_val_if_fail (GST_IS_ELEMENT (video), FALSE);
+    g_return_val_if_fail (GST_IS_ELEMENT (mux), FALSE);
+
+    g_object_set (mux, "writing-app", "gst-switch",
+        "min-index-interval", (guint64) 1000000, NULL);
+    g_signal_connect (mux, "pad-added",
+        G_CALLBACK (gst_recorder_mux_pad_added), rec);
+    pad = gst_element_get_static_pad (mux, "src");
+    gst_pad_add_probe (pad,
+        GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+        (GstPadProbeCallback) gst_recorder_index_probe, rec, NULL);
+    gst_object_unref (pad);
+    g_object_set (disk_sink, "muxer", mux, NULL);
+
+    g_signal_connect (disk_sink, "format-location",
+        G_CALLBACK (gst_recorder_format_location), rec);
+
+    // Write the files from memory, so that a slow disk never stalls the
+    // recorder, and drop frames before the muxer if it falls too far behind
+    ring = gst_element_factory_make ("ringsink", NULL);
+    if (ring) {
+      GstElement *disk_video = gst_worker_get_element_unlocked (GST_WORKER
+          (rec), "disk_video");
+      g_return_val_if_fail (GST_IS_ELEMENT (disk_video), FALSE);
+
+      g_object_set (ring, "buffer-size",
+          (guint64) opts.record_buffer * 1024 * 1024, NULL);
+      g_object_set (disk_sink, "sink", ring, NULL);
+
+      pad = gst_element_get_static_pad (disk_video, "src");
+      gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+          (GstPadProbeCallback) gst_recorder_disk_probe, rec, NULL);
+      gst_object_unref (pad);
+      gst_object_unref (disk_video);
+    } else {
+      WARN ("no ringsink, recording straight to disk");
+    }
+
+    pad = gst_element_get_static_pad (video, "sink");
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+        (GstPadProbeCallback) gst_recorder_stamp_probe, rec, NULL);
+    gst_object_unref (pad);
+
+    g_mutex_lock (&rec->stats_lock);
+    rec->frame_count = 0;
+    rec->last_frame = 0;
+    rec->rollover = FALSE;
+    rec->stats.frames = 0;
+    old_ring = rec->disk;
+    rec->disk = ring ? gst_object_ref (ring) : NULL;
+    rec->disk_dropping = FALSE;
+    g_mutex_unlock (&rec->stats_lock);
+
+    // The sink of the last pipeline finishes its files when freed
+    if (old_ring)
+      gst_object_unref (old_ring);
+
+    gst_object_unref (video);
+    gst_object_unref (disk_sink);
+  }
+
   tcp_sink = gst_worker_get_element_unlocked (GST_WORKER (rec), "tcp_sink");
 
   g_return_val_if_fail (GST_IS_ELEMENT (tcp_sink), FALSE);
@@ -377,10 +826,98 @@ gst_recorder_prepare (GstRecorder * rec)
   g_signal_connect (tcp_sink, "client-socket-removed",
       G_CALLBACK (gst_recorder_client_socket_removed), rec);
 
+  gst_worker_watch_clients (GST_WORKER (rec), tcp_sink, TRUE);
+
   gst_object_unref (tcp_sink);
   return TRUE;
 }
 
+/**
+ * @param rec The GstRecorder instance.
+ * @memberof GstRecorder
+ * @return TRUE if the next file is being opened.
+ *
+ * Finalise the current recording file and continue into a new one, inside
+ * the running pipeline. The cut is made on a frame boundary, no frame is
+ * dropped.
+ */
+gboolean
+gst_recorder_new_fragment (GstRecorder * rec)
+{
+  GstElement *disk_sink;
+
+  g_return_val_if_fail (GST_IS_RECORDER (rec), FALSE);
+
+  disk_sink = gst_worker_get_element (GST_WORKER (rec), "disk_sink");
+  if (!disk_sink)
+    return FALSE;
+
+  g_signal_emit_by_name (disk_sink, "split-now");
+  gst_object_unref (disk_sink);
+  return TRUE;
+}
+
+/**
+ * @param rec The GstRecorder instance.
+ * @param stats The GstRecorderStats to fill, free stats->location after use.
+ * @memberof GstRecorder
+ *
+ * Get a snapshot of the recorder statistics.
+ */
+void
+gst_recorder_get_stats (GstRecorder * rec, GstRecorderStats * stats)
+{
+  GstElement *disk;
+
+  g_return_if_fail (GST_IS_RECORDER (rec));
+
+  g_mutex_lock (&rec->stats_lock);
+  *stats = rec->stats;
+  stats->location = g_strdup (rec->location ? rec->location : "");
+  disk = rec->disk ? gst_object_ref (rec->disk) : NULL;
+  g_mutex_unlock (&rec->stats_lock);
+
+  if (disk) {
+    g_object_get (disk, "fill", &stats->disk_fill,
+        "max-fill", &stats->disk_max_fill,
+        "throughput", &stats->disk_throughput, NULL);
+    gst_object_unref (disk);
+  }
+}
+
+/**
+ * @param rec The GstRecorder instance.
+ * @param what The event, or NULL for the composite mode.
+ * @memberof GstRecorder
+ *
+ * Record an event, like a switch, in the index of the file being written,
+ * at the running time of the recording.
+ */
+void
+gst_recorder_mark (GstRecorder * rec, const gchar * what)
+{
+  GstClockTime pts = GST_CLOCK_TIME_NONE;
+  gchar *mode = NULL;
+  GstClock *clock;
+
+  g_return_if_fail (GST_IS_RECORDER (rec));
+
+  clock = gst_system_clock_obtain ();
+  if (GST_CLOCK_TIME_IS_VALID (rec->base_time))
+    pts = gst_clock_get_time (clock) - rec->base_time;
+  gst_object_unref (clock);
+
+  if (what == NULL)
+    what = mode = g_strdup_printf ("mode %d", rec->mode);
+
+  g_mutex_lock (&rec->stats_lock);
+  if (rec->index)
+    gst_record_index_add_event (rec->index, pts, what);
+  g_mutex_unlock (&rec->stats_lock);
+
+  g_free (mode);
+}
+
 /**
  * @brief Initialize the GstRecorderClass.
  * @param klass The GstRecorderClass instance.
@@ -429,6 +966,27 @@ gst_recorder_class_init (GstRecorderClass * klass)
           gst_composite_default_height (),
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (object_class, PROP_CODEC,
+      g_param_spec_uint ("codec", "Codec",
+          "Recording codec",
+          GST_RECORDER_CODEC_MJPEG,
+          GST_RECORDER_CODEC__LAST,
+          GST_RECORDER_CODEC_MJPEG,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_QUALITY,
+      g_param_spec_uint ("quality", "Quality",
+          "MJPEG recording quality",
+          0, 100,
+          GST_RECORDER_DEFAULT_QUALITY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_THREADS,
+      g_param_spec_uint ("threads", "Threads",
+          "MJPEG or H.264 encoder threads, 0 for automatic",
+          0, G_MAXINT,
+          0, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   worker_class->prepare = (GstWorkerPrepareFunc) gst_recorder_prepare;
   worker_class->get_pipeline_string = (GstWorkerGetPipelineStringFunc)
       gst_recorder_get_pipeline_string;
@@ -24,6 +24,7 @@
 
 #include "gstworker.h"
 #include "gstcomposite.h"
+#include "gstrecordindex.h"
 #include <gio/gio.h>
 
 #define GST_TYPE_RECORDER (gst_recorder_get_type ())
@@ -32,7 +33,45 @@
 #define GST_IS_RECORDER(object) (G_TYPE_CHECK_INSTANCE_TYPE ((object), GST_TYPE_RECORDER))
 #define GST_IS_RECORDER_CLASS(class) (G_TYPE_CHECK_CLASS_TYPE ((class), GST_TYPE_RECORDER))
 
+#define GST_RECORDER_DEFAULT_QUALITY 100
+#define GST_RECORDER_DEFAULT_BUFFER 128         /* MB */
+#define GST_RECORDER_H264_QUANTIZER 18
+#define GST_RECORDER_KEYFRAME_INTERVAL 30       /* frames */
+
 typedef struct _GstRecorderClass GstRecorderClass;
+typedef struct _GstRecorderStats GstRecorderStats;
+
+/**
+ *  @enum GstRecorderCodec
+ *
+ *  Codecs of the composite recording.
+ */
+typedef enum
+{
+  GST_RECORDER_CODEC_MJPEG,     /*!< MJPEG by jpegenc */
+  GST_RECORDER_CODEC_H264,      /*!< H.264 by x264enc, constant quantizer */
+  GST_RECORDER_CODEC_FFV1,      /*!< lossless FFV1 by avenc_ffv1 */
+  GST_RECORDER_CODEC_RAW,       /*!< raw video, not encoded */
+  GST_RECORDER_CODEC__LAST = GST_RECORDER_CODEC_RAW
+} GstRecorderCodec;
+
+/**
+ *  @brief Snapshot of the recorder statistics.
+ */
+struct _GstRecorderStats
+{
+  gchar *location;              /*!< the file being written, free with g_free */
+  guint fragments;              /*!< files opened so far */
+  guint64 frames;               /*!< video frames written to the files */
+  guint64 last_gap;             /*!< frames lost by the last rollover */
+  guint64 total_gap;            /*!< frames lost in total */
+  gdouble encode_fps;           /*!< frames/s out of the encoder */
+  gdouble required_fps;         /*!< frames/s of the composite */
+  guint disk_fill;              /*!< disk buffer fill, percent */
+  guint disk_max_fill;          /*!< highest disk buffer fill, percent */
+  guint64 disk_throughput;      /*!< bytes/s written to disk */
+  guint64 disk_dropped;         /*!< frames dropped on a full disk buffer */
+};
 
 /**
  *  @class GstRecorder
@@ -48,6 +87,22 @@ struct _GstRecorder
   guint height;                 /*!< the video height */
 
   GstCompositeMode mode;        /*!< the composite mode which is the same as in GstComposite */
+  GstRecorderCodec codec;       /*!< the recording codec */
+  guint quality;                /*!< the MJPEG quality */
+  guint threads;                /*!< the encoder threads, 0 for auto */
+  GstClockTime base_time;       /*!< the base time of the pipeline */
+
+  GMutex stats_lock;            /*!< the lock for the stats below */
+  guint64 frame_count;          /*!< frames stamped on the way to the files */
+  guint64 last_frame;           /*!< the last frame written to a file */
+  gboolean rollover;            /*!< a file was just finalised */
+  gchar *location;              /*!< the file being written */
+  GstRecorderStats stats;       /*!< the statistics */
+  gint64 window_start;          /*!< start of the encode rate window, usec */
+  guint window_frames;          /*!< frames encoded in the window */
+  GstElement *disk;             /*!< the write-behind sink of the files */
+  gboolean disk_dropping;       /*!< dropping frames for the disk buffer */
+  GstRecordIndex *index;        /*!< the index of the file being written */
 };
 
 /**
@@ -66,4 +121,12 @@ struct _GstRecorderClass
  */
 GType gst_recorder_get_type (void);
 
+gboolean gst_recorder_parse_codec (const gchar * name,
+    GstRecorderCodec * codec);
+const gchar *gst_recorder_codec_to_string (GstRecorderCodec codec);
+const gchar *gst_recorder_new_filename (const gchar * filename);
+gboolean gst_recorder_new_fragment (GstRecorder * rec);
+void gst_recorder_get_stats (GstRecorder * rec, GstRecorderStats * stats);
+void gst_recorder_mark (GstRecorder * rec, const gchar * what);
+
 #endif //__GST_RECORDER_H__
@@ -0,0 +1,395 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "gstrecordindex.h"
+#include "../logutils.h"
+
+/**
+ * @brief Read an EBML variable size integer.
+ * @param data The bytes to read.
+ * @param size The number of bytes available.
+ * @param value The value read.
+ * @param marker TRUE to keep the length marker, as element IDs do.
+ * @return The width of the integer, 0 if it's incomplete, -1 if invalid.
+ */
+static gint
+gst_record_index_read_vint (const guint8 * data, gsize size,
+    guint64 * value, gboolean marker)
+{
+  gint width = 1, n;
+  guint8 mask = 0x80;
+
+  if (size == 0)
+    return 0;
+  while (width <= 8 && !(data[0] & mask)) {
+    width += 1;
+    mask >>= 1;
+  }
+  if (8 < width)
+    return -1;
+  if (size < width)
+    return 0;
+
+  *value = marker ? data[0] : data[0] & (mask - 1);
+  for (n = 1; n < width; ++n)
+    *value = (*value << 8) | data[n];
+  return width;
+}
+
+/**
+ * @brief Parse the head of the next element of the recording.
+ * @return The size of the head, 0 if it's incomplete, -1 if invalid.
+ *
+ * Clusters and blocks are written to the index. The payload of any other
+ * element is passed over, except for the segment, clusters and block
+ * groups, whose children are parsed in turn.
+ */
+static gint
+gst_record_index_parse (GstRecordIndex * index, const guint8 * data,
+    gsize size, GstBuffer * buffer)
+{
+  guint64 id, len, track;
+  gint n, m, t;
+  gboolean unknown;
+
+  if ((n = gst_record_index_read_vint (data, size, &id, TRUE)) <= 0)
+    return n;
+  if (4 < n)
+    return -1;
+  if ((m = gst_record_index_read_vint (data + n, size - n, &len, FALSE)) <= 0)
+    return m;
+  unknown = len == (G_GUINT64_CONSTANT (1) << (7 * m)) - 1;
+
+  switch (id) {
+    case GST_RECORD_INDEX_ID_CLUSTER:
+      g_string_append_printf (index->pending, "C %" G_GUINT64_FORMAT "\n",
+          index->pos);
+      // fall through
+    case GST_RECORD_INDEX_ID_SEGMENT:
+      index->skip = 0;
+      break;
+    case GST_RECORD_INDEX_ID_BLOCKGROUP:
+      if (unknown)
+        return -1;
+      index->group = index->pos;
+      index->group_end = index->pos + n + m + len;
+      index->skip = 0;
+      break;
+    case GST_RECORD_INDEX_ID_BLOCK:
+    case GST_RECORD_INDEX_ID_SIMPLEBLOCK:{
+      guint64 start = index->pos, end = index->pos + n + m + len;
+      GstClockTime pts = GST_BUFFER_PTS (buffer);
+      gint16 timecode;
+
+      if (unknown)
+        return -1;
+      t = gst_record_index_read_vint (data + n + m, size - n - m, &track,
+          FALSE);
+      if (t <= 0)
+        return t;
+      if (size < n + m + t + 3)
+        return 0;
+      timecode = (gint16) (data[n + m + t] << 8 | data[n + m + t + 1]);
+
+      if (id == GST_RECORD_INDEX_ID_BLOCK && index->pos < index->group_end) {
+        start = index->group;
+        end = index->group_end;
+      }
+      g_string_append_printf (index->pending, "B %" G_GUINT64_FORMAT
+          " %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT " %d %" G_GINT64_FORMAT
+          " %c\n", start, end, track, timecode,
+          GST_CLOCK_TIME_IS_VALID (pts) ? (gint64) pts : (gint64) - 1,
+          GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT)
+          ? '-' : 'K');
+      index->skip = len;
+      break;
+    }
+    default:
+      if (unknown)
+        return -1;
+      index->skip = len;
+      break;
+  }
+  return n + m;
+}
+
+/**
+ * @brief Follow the elements of the recording through the bytes.
+ * @param min Stop once this many bytes are used, 0 to use them all.
+ * @return The number of bytes used, the rest is an incomplete head.
+ */
+static gsize
+gst_record_index_follow (GstRecordIndex * index, const guint8 * data,
+    gsize size, gsize min, GstBuffer * buffer)
+{
+  gsize i = 0;
+
+  while (i < size && (min == 0 || i < min) && !index->lost) {
+    gint n;
+
+    if (index->skip) {
+      guint64 len = MIN (index->skip, size - i);
+      index->skip -= len;
+      index->pos += len;
+      i += len;
+      continue;
+    }
+
+    n = gst_record_index_parse (index, data + i, size - i, buffer);
+    if (n < 0)
+      index->lost = TRUE;
+    if (n <= 0)
+      break;
+    index->pos += n;
+    i += n;
+  }
+  return i;
+}
+
+/**
+ * @brief Write the bytes to the file, all of them.
+ */
+static gboolean
+gst_record_index_write_all (gint fd, const gchar * data, gsize size)
+{
+  while (0 < size) {
+    gssize n = write (fd, data, size);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return FALSE;
+    data += n;
+    size -= n;
+  }
+  return TRUE;
+}
+
+/**
+ * @brief The writer thread.
+ *
+ * Appends the pending lines to the index file and syncs them, once every
+ * GST_RECORD_INDEX_SYNC_INTERVAL. Frees the index once it's closed.
+ */
+static gpointer
+gst_record_index_writer (GstRecordIndex * index)
+{
+  GString *lines = g_string_new (NULL);
+  gboolean closed = FALSE;
+  gint fd;
+
+  fd = open (index->location, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND
+      | O_CLOEXEC, 0644);
+  if (fd < 0)
+    WARN ("%s: %s", index->location, g_strerror (errno));
+
+  while (!closed) {
+    GString *swap;
+
+    g_mutex_lock (&index->lock);
+    if (!index->closed)
+      g_cond_wait_until (&index->cond, &index->lock,
+          g_get_monotonic_time () + GST_RECORD_INDEX_SYNC_INTERVAL);
+    closed = index->closed;
+    swap = index->pending;
+    index->pending = lines;
+    lines = swap;
+    g_mutex_unlock (&index->lock);
+
+    if (0 <= fd && lines->len) {
+      if (!gst_record_index_write_all (fd, lines->str, lines->len)
+          || fdatasync (fd) < 0) {
+        WARN ("%s: %s", index->location, g_strerror (errno));
+        close (fd);
+        fd = -1;
+      }
+    }
+    g_string_truncate (lines, 0);
+  }
+
+  if (0 <= fd)
+    close (fd);
+  INFO ("Written %s", index->location);
+
+  g_string_free (lines, TRUE);
+  g_string_free (index->pending, TRUE);
+  g_mutex_clear (&index->lock);
+  g_cond_clear (&index->cond);
+  g_free (index->location);
+  g_free (index);
+  return NULL;
+}
+
+/**
+ * @param recording The recording file to index.
+ * @return The new index, close it with gst_record_index_close.
+ *
+ * Start the index of a recording, written to the recording file name
+ * with GST_RECORD_INDEX_SUFFIX appended.
+ */
+GstRecordIndex *
+gst_record_index_new (const gchar * recording)
+{
+  GstRecordIndex *index = g_new0 (GstRecordIndex, 1);
+
+  index->location = g_strconcat (recording, GST_RECORD_INDEX_SUFFIX, NULL);
+  g_mutex_init (&index->lock);
+  g_cond_init (&index->cond);
+  index->pending = g_string_new (NULL);
+  g_string_append_printf (index->pending, "%s %d\n",
+      GST_RECORD_INDEX_MAGIC, GST_RECORD_INDEX_VERSION);
+  index->seek = -1;
+  index->writer = g_thread_new ("recordindex",
+      (GThreadFunc) gst_record_index_writer, index);
+  return index;
+}
+
+/**
+ * @param index The index to close.
+ *
+ * No more lines are added, the last ones are written in the background.
+ */
+void
+gst_record_index_close (GstRecordIndex * index)
+{
+  GThread *writer;
+
+  g_return_if_fail (index != NULL);
+
+  g_mutex_lock (&index->lock);
+  index->closed = TRUE;
+  writer = index->writer;
+  g_cond_signal (&index->cond);
+  g_mutex_unlock (&index->lock);
+
+  g_thread_unref (writer);
+}
+
+/**
+ * @param index The index.
+ * @param offset The file offset the next buffers are written to.
+ *
+ * Follow a byte segment of the muxer. The buffers written before the end
+ * of the file rewrite headers, and are not indexed.
+ */
+void
+gst_record_index_seek (GstRecordIndex * index, guint64 offset)
+{
+  g_mutex_lock (&index->lock);
+  index->seek = offset == index->end ? -1 : (gint64) offset;
+  g_mutex_unlock (&index->lock);
+}
+
+/**
+ * @param index The index.
+ * @param buffer The next buffer of the recording.
+ *
+ * Index the elements starting in the buffer.
+ */
+void
+gst_record_index_add_buffer (GstRecordIndex * index, GstBuffer * buffer)
+{
+  GstMapInfo map;
+  gsize i = 0;
+
+  g_mutex_lock (&index->lock);
+  if (0 <= index->seek) {
+    index->seek += gst_buffer_get_size (buffer);
+    if (index->seek == index->end)
+      index->seek = -1;
+    goto done;
+  }
+
+  index->end += gst_buffer_get_size (buffer);
+  if (index->lost || !gst_buffer_map (buffer, &map, GST_MAP_READ))
+    goto done;
+
+  // Complete the element head split over the last buffer
+  if (index->head_size) {
+    gsize room = sizeof (index->head) - index->head_size;
+    gsize take = MIN (room, map.size);
+    gsize size = index->head_size + take, n;
+
+    memcpy (index->head + index->head_size, map.data, take);
+    n = gst_record_index_follow (index, index->head, size, index->head_size,
+        buffer);
+    if (index->head_size <= n) {
+      i = n - index->head_size;
+      index->head_size = 0;
+    } else if (take < map.size) {
+      index->lost = TRUE;
+    } else {
+      memmove (index->head, index->head + n, size - n);
+      index->head_size = size - n;
+      i = map.size;
+    }
+  }
+
+  if (!index->lost && i < map.size) {
+    gsize rest;
+
+    i += gst_record_index_follow (index, map.data + i, map.size - i, 0,
+        buffer);
+    rest = map.size - i;
+    if (sizeof (index->head) <= rest) {
+      index->lost = TRUE;
+    } else if (rest && !index->lost) {
+      memcpy (index->head, map.data + i, rest);
+      index->head_size = rest;
+    }
+  }
+
+  if (index->lost)
+    WARN ("%s: can't follow the recording past %" G_GUINT64_FORMAT,
+        index->location, index->pos);
+  gst_buffer_unmap (buffer, &map);
+
+done:
+  g_mutex_unlock (&index->lock);
+}
+
+/**
+ * @param index The index.
+ * @param pts The running time of the event.
+ * @param text What happened, on a single line.
+ *
+ * Record an event of the recording, like a switch or a mode change.
+ */
+void
+gst_record_index_add_event (GstRecordIndex * index, GstClockTime pts,
+    const gchar * text)
+{
+  gchar *line = g_strdelimit (g_strdup (text), "\r\n", ' ');
+
+  g_mutex_lock (&index->lock);
+  g_string_append_printf (index->pending, "E %" G_GINT64_FORMAT " %s\n",
+      GST_CLOCK_TIME_IS_VALID (pts) ? (gint64) pts : (gint64) - 1, line);
+  g_mutex_unlock (&index->lock);
+
+  g_free (line);
+}
@@ -0,0 +1,86 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_RECORD_INDEX_H__
+#define __GST_RECORD_INDEX_H__
+
+#include <gst/gst.h>
+
+#define GST_RECORD_INDEX_SUFFIX ".idx"
+#define GST_RECORD_INDEX_MAGIC "gst-switch-index"
+#define GST_RECORD_INDEX_VERSION 1
+#define GST_RECORD_INDEX_SYNC_INTERVAL G_TIME_SPAN_SECOND
+#define GST_RECORD_INDEX_HEAD_SIZE 32   /* longest element head we parse */
+
+/* Matroska element IDs the index and gst-switch-reindex look at */
+#define GST_RECORD_INDEX_ID_SEGMENT 0x18538067
+#define GST_RECORD_INDEX_ID_CLUSTER 0x1F43B675
+#define GST_RECORD_INDEX_ID_BLOCKGROUP 0xA0
+#define GST_RECORD_INDEX_ID_BLOCK 0xA1
+#define GST_RECORD_INDEX_ID_SIMPLEBLOCK 0xA3
+
+typedef struct _GstRecordIndex GstRecordIndex;
+
+/**
+ *  @struct _GstRecordIndex
+ *  @brief Append-only index of a recording being written.
+ *
+ *  The index follows the matroska stream on its way to the file and
+ *  writes one line per cluster and block, with the file offsets, plus
+ *  the events of the recording, to a sidecar file next to it:
+ *
+ *    gst-switch-index 1
+ *    C <offset>
+ *    B <offset> <end> <track> <timecode> <pts> <K|->
+ *    E <pts> <text>
+ *
+ *  The lines are synced to disk every second by a thread of their own,
+ *  so after a crash gst-switch-reindex can make the recording seekable
+ *  again without reading it through.
+ */
+struct _GstRecordIndex
+{
+  gchar *location;              /*!< the index file */
+  GMutex lock;                  /*!< the lock for the fields below */
+  GCond cond;                   /*!< signalled when closed */
+  GString *pending;             /*!< lines not written yet */
+  gboolean closed;              /*!< no more lines will be added */
+  GThread *writer;              /*!< the thread writing the lines */
+
+  guint64 end;                  /*!< bytes appended to the recording */
+  gint64 seek;                  /*!< the position of a rewrite, or -1 */
+  guint64 pos;                  /*!< the offset of the next element head */
+  guint64 skip;                 /*!< payload bytes to pass over */
+  guint64 group;                /*!< the offset of the open block group */
+  guint64 group_end;            /*!< the end of the open block group */
+  gboolean lost;                /*!< the stream can't be followed */
+  guint8 head[GST_RECORD_INDEX_HEAD_SIZE];      /*!< a split element head */
+  guint head_size;              /*!< the bytes in %head */
+};
+
+GstRecordIndex *gst_record_index_new (const gchar * recording);
+void gst_record_index_close (GstRecordIndex * index);
+void gst_record_index_seek (GstRecordIndex * index, guint64 offset);
+void gst_record_index_add_buffer (GstRecordIndex * index, GstBuffer * buffer);
+void gst_record_index_add_event (GstRecordIndex * index, GstClockTime pts,
+    const gchar * text);
+
+#endif //__GST_RECORD_INDEX_H__
@@ -0,0 +1,724 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstswitchserver.h"
+#include "gstreplay.h"
+
+enum
+{
+  PROP_0,
+  PROP_PORT,
+  PROP_PROGRAM,
+  PROP_WIDTH,
+  PROP_HEIGHT,
+  PROP_SECONDS,
+  PROP_QUALITY,
+};
+
+enum
+{
+  PROP_PLAYER_0,
+  PROP_PLAYER_CLIP,
+  PROP_PLAYER_SPEED,
+};
+
+extern gboolean verbose;
+
+#define GST_REPLAY_DEFAULT_INTERVAL (G_USEC_PER_SEC / 25)
+
+G_DEFINE_TYPE (GstReplay, gst_replay, GST_TYPE_WORKER);
+G_DEFINE_TYPE (GstReplayPlayer, gst_replay_player, GST_TYPE_CASE);
+
+/**
+ * @brief Free a frame of the ring.
+ * @param frame The frame.
+ */
+static void
+gst_replay_frame_free (GstReplayFrame * frame)
+{
+  gst_buffer_unref (frame->buffer);
+  g_slice_free (GstReplayFrame, frame);
+}
+
+/**
+ * @brief Initialize the GstReplay instance.
+ * @param replay The GstReplay instance.
+ * @memberof GstReplay
+ */
+static void
+gst_replay_init (GstReplay * replay)
+{
+  replay->sink_port = 0;
+  replay->program = FALSE;
+  replay->width = 0;
+  replay->height = 0;
+  replay->seconds = 0;
+  replay->quality = GST_REPLAY_DEFAULT_QUALITY;
+
+  g_mutex_init (&replay->lock);
+  g_queue_init (&replay->frames);
+  replay->caps = NULL;
+  replay->bytes = 0;
+  replay->mark_in = 0;
+  replay->mark_out = 0;
+}
+
+/**
+ * @brief Invoked to unref objects.
+ * @param replay The GstReplay instance.
+ * @memberof GstReplay
+ */
+static void
+gst_replay_dispose (GstReplay * replay)
+{
+  INFO ("dispose %p", replay);
+
+  g_mutex_lock (&replay->lock);
+  g_queue_foreach (&replay->frames, (GFunc) gst_replay_frame_free, NULL);
+  g_queue_clear (&replay->frames);
+  replay->bytes = 0;
+  if (replay->caps) {
+    gst_caps_unref (replay->caps);
+    replay->caps = NULL;
+  }
+  g_mutex_unlock (&replay->lock);
+
+  G_OBJECT_CLASS (gst_replay_parent_class)->dispose (G_OBJECT (replay));
+}
+
+/**
+ * @brief Destroying the GstReplay instance.
+ * @param replay The GstReplay instance.
+ * @memberof GstReplay
+ */
+static void
+gst_replay_finalize (GstReplay * replay)
+{
+  g_mutex_clear (&replay->lock);
+
+  if (G_OBJECT_CLASS (gst_replay_parent_class)->finalize)
+    (*G_OBJECT_CLASS (gst_replay_parent_class)->finalize) (G_OBJECT (replay));
+}
+
+/**
+ * @brief Fetching the GstReplay property.
+ * @param replay The GstReplay instance.
+ * @param property_id
+ * @param value
+ * @param pspec
+ * @memberof GstReplay
+ */
+static void
+gst_replay_get_property (GstReplay * replay, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_PORT:
+      g_value_set_uint (value, replay->sink_port);
+      break;
+    case PROP_PROGRAM:
+      g_value_set_boolean (value, replay->program);
+      break;
+    case PROP_WIDTH:
+      g_value_set_uint (value, replay->width);
+      break;
+    case PROP_HEIGHT:
+      g_value_set_uint (value, replay->height);
+      break;
+    case PROP_SECONDS:
+      g_value_set_uint (value, replay->seconds);
+      break;
+    case PROP_QUALITY:
+      g_value_set_uint (value, replay->quality);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (replay, property_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Changing the GstReplay properties.
+ * @param replay The GstReplay instance.
+ * @param property_id
+ * @param value
+ * @param pspec
+ * @memberof GstReplay
+ */
+static void
+gst_replay_set_property (GstReplay * replay, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_PORT:
+      replay->sink_port = g_value_get_uint (value);
+      break;
+    case PROP_PROGRAM:
+      replay->program = g_value_get_boolean (value);
+      break;
+    case PROP_WIDTH:
+      replay->width = g_value_get_uint (value);
+      break;
+    case PROP_HEIGHT:
+      replay->height = g_value_get_uint (value);
+      break;
+    case PROP_SECONDS:
+      replay->seconds = g_value_get_uint (value);
+      break;
+    case PROP_QUALITY:
+      replay->quality = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (replay), property_id,
+          pspec);
+      break;
+  }
+}
+
+/**
+ * @param replay The GstReplay instance.
+ * @memberof GstReplay
+ * @return The replay ring pipeline string, needs freeing when used
+ *
+ * Fetching the replay ring pipeline invoked by the GstWorker. The frames
+ * are JPEG encoded each on their own, so any of them can start a clip and
+ * the oldest can be dropped without touching the others.
+ */
+static GString *
+gst_replay_get_pipeline_string (GstReplay * replay)
+{
+  GString *desc;
+
+  desc = g_string_new ("");
+
+  if (replay->program) {
+    g_string_append_printf (desc, "intervideosrc name=source "
+        "channel=composite_out ! video/x-raw,width=%d,height=%d ",
+        replay->width, replay->height);
+  } else {
+    g_string_append_printf (desc, "intervideosrc name=source "
+        "channel=input_%d ! %s ", replay->sink_port,
+        gst_switch_server_get_video_caps_str ());
+  }
+
+  g_string_append_printf (desc, "! queue max-size-buffers=2 leaky=downstream "
+      "! jpegenc name=enc quality=%d ", replay->quality);
+  g_string_append_printf (desc, "! appsink name=sink emit-signals=true "
+      "sync=false max-buffers=2 drop=true ");
+
+  INFO ("Replay pipeline\n----\n%s\n---", desc->str);
+
+  return desc;
+}
+
+/**
+ * @memberof GstReplay
+ *
+ * Add an encoded frame to the ring, dropping the frames which are older
+ * than the length of the ring.
+ */
+static GstFlowReturn
+gst_replay_new_sample (GstElement * sink, GstReplay * replay)
+{
+  gint64 now = g_get_monotonic_time ();
+  gint64 oldest = now - (gint64) replay->seconds * G_USEC_PER_SEC;
+  GstSample *sample = NULL;
+  GstReplayFrame *frame;
+  GstCaps *caps;
+
+  g_signal_emit_by_name (sink, "pull-sample", &sample);
+  if (!sample)
+    return GST_FLOW_OK;
+
+  frame = g_slice_new (GstReplayFrame);
+  frame->buffer = gst_buffer_ref (gst_sample_get_buffer (sample));
+  frame->time = now;
+  caps = gst_sample_get_caps (sample);
+
+  g_mutex_lock (&replay->lock);
+  if (caps && (!replay->caps || !gst_caps_is_equal (caps, replay->caps))) {
+    if (replay->caps)
+      gst_caps_unref (replay->caps);
+    replay->caps = gst_caps_ref (caps);
+  }
+  g_queue_push_tail (&replay->frames, frame);
+  replay->bytes += gst_buffer_get_size (frame->buffer);
+
+  while ((frame = g_queue_peek_head (&replay->frames))
+      && frame->time < oldest) {
+    g_queue_pop_head (&replay->frames);
+    replay->bytes -= gst_buffer_get_size (frame->buffer);
+    gst_replay_frame_free (frame);
+  }
+  g_mutex_unlock (&replay->lock);
+
+  gst_sample_unref (sample);
+  return GST_FLOW_OK;
+}
+
+/**
+ * @param replay The GstReplay instance.
+ * @memberof GstReplay
+ * @return TRUE indicating the replay ring is prepared, FALSE otherwise.
+ *
+ * Invoked when the GstWorker is preparing the pipeline. The frames kept
+ * by the last pipeline stay in the ring.
+ */
+static gboolean
+gst_replay_prepare (GstReplay * replay)
+{
+  GstElement *sink;
+
+  g_return_val_if_fail (GST_IS_REPLAY (replay), FALSE);
+
+  sink = gst_worker_get_element_unlocked (GST_WORKER (replay), "sink");
+  if (!GST_IS_ELEMENT (sink)) {
+    ERROR ("%s: no sink", GST_WORKER (replay)->name);
+    if (sink)
+      gst_object_unref (sink);
+    return FALSE;
+  }
+
+  g_signal_connect (sink, "new-sample",
+      G_CALLBACK (gst_replay_new_sample), replay);
+  gst_object_unref (sink);
+  return TRUE;
+}
+
+/**
+ * @param replay The GstReplay instance.
+ * @memberof GstReplay
+ *
+ * Mark the start of a clip, now. Any out point is cleared, a clip
+ * without one runs to the newest frame.
+ */
+void
+gst_replay_mark_in (GstReplay * replay)
+{
+  g_return_if_fail (GST_IS_REPLAY (replay));
+
+  g_mutex_lock (&replay->lock);
+  replay->mark_in = g_get_monotonic_time ();
+  replay->mark_out = 0;
+  g_mutex_unlock (&replay->lock);
+}
+
+/**
+ * @param replay The GstReplay instance.
+ * @memberof GstReplay
+ * @return TRUE if marked, FALSE if there is no in point.
+ *
+ * Mark the end of a clip, now.
+ */
+gboolean
+gst_replay_mark_out (GstReplay * replay)
+{
+  gboolean marked = FALSE;
+
+  g_return_val_if_fail (GST_IS_REPLAY (replay), FALSE);
+
+  g_mutex_lock (&replay->lock);
+  if (replay->mark_in) {
+    replay->mark_out = g_get_monotonic_time ();
+    marked = TRUE;
+  }
+  g_mutex_unlock (&replay->lock);
+  return marked;
+}
+
+/**
+ * @param replay The GstReplay instance.
+ * @memberof GstReplay
+ * @return The clip between the in and out points, NULL if there is none.
+ *         Free it with gst_replay_clip_free.
+ *
+ * Take the frames of a clip out of the ring. The frames are shared with
+ * the ring rather than copied. If the in point is older than the ring,
+ * the clip starts at the oldest frame.
+ */
+GstReplayClip *
+gst_replay_get_clip (GstReplay * replay)
+{
+  GstReplayClip *clip = NULL;
+  gint64 end;
+  GList *item;
+
+  g_return_val_if_fail (GST_IS_REPLAY (replay), NULL);
+
+  g_mutex_lock (&replay->lock);
+  if (!replay->mark_in || !replay->caps)
+    goto done;
+
+  end = replay->mark_out ? replay->mark_out : G_MAXINT64;
+  clip = g_new0 (GstReplayClip, 1);
+  clip->caps = gst_caps_ref (replay->caps);
+  clip->frames = g_array_new (FALSE, FALSE, sizeof (GstReplayFrame));
+  for (item = replay->frames.head; item; item = g_list_next (item)) {
+    GstReplayFrame frame = *(GstReplayFrame *) item->data;
+    if (frame.time < replay->mark_in || end < frame.time)
+      continue;
+    gst_buffer_ref (frame.buffer);
+    g_array_append_val (clip->frames, frame);
+  }
+
+done:
+  g_mutex_unlock (&replay->lock);
+
+  if (clip && clip->frames->len == 0) {
+    gst_replay_clip_free (clip);
+    clip = NULL;
+  } else if (clip) {
+    GstReplayFrame *first = &g_array_index (clip->frames, GstReplayFrame, 0);
+    GstReplayFrame *last = &g_array_index (clip->frames, GstReplayFrame,
+        clip->frames->len - 1);
+    clip->interval = clip->frames->len < 2 ? GST_REPLAY_DEFAULT_INTERVAL :
+        (last->time - first->time) / (clip->frames->len - 1);
+  }
+  return clip;
+}
+
+/**
+ * @param clip The clip to free.
+ */
+void
+gst_replay_clip_free (GstReplayClip * clip)
+{
+  guint n;
+
+  for (n = 0; n < clip->frames->len; ++n)
+    gst_buffer_unref (g_array_index (clip->frames, GstReplayFrame, n).buffer);
+  g_array_free (clip->frames, TRUE);
+  gst_caps_unref (clip->caps);
+  g_free (clip);
+}
+
+/**
+ * @param replay The GstReplay instance.
+ * @param stats The GstReplayStats to fill.
+ * @memberof GstReplay
+ *
+ * Get a snapshot of the replay ring. The memory per second of ring is
+ * measured over the frames it holds.
+ */
+void
+gst_replay_get_stats (GstReplay * replay, GstReplayStats * stats)
+{
+  gint64 now = g_get_monotonic_time ();
+  GstReplayFrame *oldest, *newest;
+  gint64 span = 0;
+
+  g_return_if_fail (GST_IS_REPLAY (replay));
+
+  g_mutex_lock (&replay->lock);
+  oldest = g_queue_peek_head (&replay->frames);
+  newest = g_queue_peek_tail (&replay->frames);
+  if (oldest && newest)
+    span = newest->time - oldest->time;
+  stats->seconds = (gdouble) span / G_USEC_PER_SEC;
+  stats->frames = g_queue_get_length (&replay->frames);
+  stats->bytes = replay->bytes;
+  stats->bytes_per_second = span > 0 ?
+      replay->bytes * G_USEC_PER_SEC / span : replay->bytes;
+  stats->mark_in = replay->mark_in ? now - replay->mark_in : -1;
+  stats->mark_out = replay->mark_out ? now - replay->mark_out : -1;
+  g_mutex_unlock (&replay->lock);
+}
+
+/**
+ * @brief Initialize the GstReplayClass.
+ * @param klass The GstReplayClass instance.
+ * @memberof GstReplayClass
+ */
+static void
+gst_replay_class_init (GstReplayClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstWorkerClass *worker_class = GST_WORKER_CLASS (klass);
+
+  object_class->dispose = (GObjectFinalizeFunc) gst_replay_dispose;
+  object_class->finalize = (GObjectFinalizeFunc) gst_replay_finalize;
+  object_class->set_property = (GObjectSetPropertyFunc)
+      gst_replay_set_property;
+  object_class->get_property = (GObjectGetPropertyFunc)
+      gst_replay_get_property;
+
+  g_object_class_install_property (object_class, PROP_PORT,
+      g_param_spec_uint ("port", "Port",
+          "Port of the input, or the compose port for the program",
+          GST_SWITCH_MIN_SINK_PORT,
+          GST_SWITCH_MAX_SINK_PORT,
+          GST_SWITCH_MIN_SINK_PORT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_PROGRAM,
+      g_param_spec_boolean ("program", "Program",
+          "Keep the program rather than an input", FALSE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_WIDTH,
+      g_param_spec_uint ("width", "Width",
+          "Program width", 0, G_MAXINT, 0,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_HEIGHT,
+      g_param_spec_uint ("height", "Height",
+          "Program height", 0, G_MAXINT, 0,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_SECONDS,
+      g_param_spec_uint ("seconds", "Seconds",
+          "Seconds of video to keep", 0, GST_REPLAY_MAX_SECONDS, 0,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_QUALITY,
+      g_param_spec_uint ("quality", "Quality",
+          "JPEG quality of the kept frames", 0, 100,
+          GST_REPLAY_DEFAULT_QUALITY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  worker_class->prepare = (GstWorkerPrepareFunc) gst_replay_prepare;
+  worker_class->get_pipeline_string = (GstWorkerGetPipelineStringFunc)
+      gst_replay_get_pipeline_string;
+}
+
+/**
+ * @brief Initialize the GstReplayPlayer instance.
+ * @param player The GstReplayPlayer instance.
+ * @memberof GstReplayPlayer
+ */
+static void
+gst_replay_player_init (GstReplayPlayer * player)
+{
+  player->clip = NULL;
+  player->speed = 1.0;
+  player->next = 0;
+  player->loop_start = 0;
+}
+
+/**
+ * @brief Destroying the GstReplayPlayer instance.
+ * @param player The GstReplayPlayer instance.
+ * @memberof GstReplayPlayer
+ */
+static void
+gst_replay_player_finalize (GstReplayPlayer * player)
+{
+  if (player->clip) {
+    gst_replay_clip_free (player->clip);
+    player->clip = NULL;
+  }
+
+  if (G_OBJECT_CLASS (gst_replay_player_parent_class)->finalize)
+    (*G_OBJECT_CLASS (gst_replay_player_parent_class)->finalize)
+        (G_OBJECT (player));
+}
+
+/**
+ * @brief Fetching the GstReplayPlayer property.
+ * @param player The GstReplayPlayer instance.
+ * @param property_id
+ * @param value
+ * @param pspec
+ * @memberof GstReplayPlayer
+ */
+static void
+gst_replay_player_get_property (GstReplayPlayer * player, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_PLAYER_CLIP:
+      g_value_set_pointer (value, player->clip);
+      break;
+    case PROP_PLAYER_SPEED:
+      g_value_set_double (value, player->speed);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (player, property_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Changing the GstReplayPlayer properties.
+ * @param player The GstReplayPlayer instance.
+ * @param property_id
+ * @param value
+ * @param pspec
+ * @memberof GstReplayPlayer
+ */
+static void
+gst_replay_player_set_property (GstReplayPlayer * player, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_PLAYER_CLIP:
+      if (player->clip)
+        gst_replay_clip_free (player->clip);
+      player->clip = (GstReplayClip *) g_value_get_pointer (value);
+      break;
+    case PROP_PLAYER_SPEED:
+      player->speed = g_value_get_double (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (player), property_id,
+          pspec);
+      break;
+  }
+}
+
+/**
+ * @param player The GstReplayPlayer instance.
+ * @memberof GstReplayPlayer
+ * @return The playback pipeline string, needs freeing when used
+ *
+ * The clip is decoded and brought to the input format, then handed over
+ * like the frames of a real input, so the player can be switched to and
+ * previewed like any other input.
+ */
+static GString *
+gst_replay_player_get_pipeline_string (GstReplayPlayer * player)
+{
+  GString *desc;
+
+  desc = g_string_new ("");
+
+  g_string_append_printf (desc, "appsrc name=source is-live=true "
+      "format=time ! jpegdec ! videoconvert ! videoscale ! videorate ");
+  g_string_append_printf (desc, "! %s ! intervideosink name=sink "
+      "channel=input_%d ", gst_switch_server_get_video_caps_str (),
+      GST_CASE (player)->sink_port);
+
+  INFO ("Replay playback pipeline\n----\n%s\n---", desc->str);
+
+  return desc;
+}
+
+/**
+ * @memberof GstReplayPlayer
+ *
+ * Push the next frame of the clip. The frames keep the spacing they were
+ * taken with, stretched by the playback speed, and the clip starts over
+ * after its last frame.
+ */
+static void
+gst_replay_player_need_data (GstElement * source, guint length,
+    GstReplayPlayer * player)
+{
+  GArray *frames = player->clip->frames;
+  GstReplayFrame *first = &g_array_index (frames, GstReplayFrame, 0);
+  GstReplayFrame *frame = &g_array_index (frames, GstReplayFrame,
+      player->next);
+  GstClockTime offset, duration;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstBuffer *buffer;
+
+  offset = (frame->time - first->time) * GST_USECOND / player->speed;
+  duration = player->clip->interval * GST_USECOND / player->speed;
+
+  // A shallow copy, the frame memory is shared with the ring
+  buffer = gst_buffer_copy (frame->buffer);
+  GST_BUFFER_PTS (buffer) = player->loop_start + offset;
+  GST_BUFFER_DTS (buffer) = GST_CLOCK_TIME_NONE;
+  GST_BUFFER_DURATION (buffer) = duration;
+  g_signal_emit_by_name (source, "push-buffer", buffer, &ret);
+  gst_buffer_unref (buffer);
+
+  player->next += 1;
+  if (player->next == frames->len) {
+    player->next = 0;
+    player->loop_start += offset + duration;
+  }
+}
+
+/**
+ * @param player The GstReplayPlayer instance.
+ * @memberof GstReplayPlayer
+ * @return TRUE indicating the player is prepared, FALSE otherwise.
+ *
+ * Invoked when the GstWorker is preparing the pipeline, the clip is
+ * played from its start.
+ */
+static gboolean
+gst_replay_player_prepare (GstReplayPlayer * player)
+{
+  GstElement *source;
+
+  g_return_val_if_fail (GST_IS_REPLAY_PLAYER (player), FALSE);
+
+  if (!player->clip) {
+    ERROR ("%s: no clip", GST_WORKER (player)->name);
+    return FALSE;
+  }
+
+  source = gst_worker_get_element_unlocked (GST_WORKER (player), "source");
+  if (!GST_IS_ELEMENT (source)) {
+    ERROR ("%s: no source", GST_WORKER (player)->name);
+    if (source)
+      gst_object_unref (source);
+    return FALSE;
+  }
+
+  player->next = 0;
+  player->loop_start = 0;
+
+  g_object_set (source, "caps", player->clip->caps, NULL);
+  g_signal_connect (source, "need-data",
+      G_CALLBACK (gst_replay_player_need_data), player);
+  gst_object_unref (source);
+  return TRUE;
+}
+
+/**
+ * @brief Initialize the GstReplayPlayerClass.
+ * @param klass The GstReplayPlayerClass instance.
+ * @memberof GstReplayPlayerClass
+ */
+static void
+gst_replay_player_class_init (GstReplayPlayerClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstWorkerClass *worker_class = GST_WORKER_CLASS (klass);
+
+  object_class->finalize = (GObjectFinalizeFunc) gst_replay_player_finalize;
+  object_class->set_property = (GObjectSetPropertyFunc)
+      gst_replay_player_set_property;
+  object_class->get_property = (GObjectGetPropertyFunc)
+      gst_replay_player_get_property;
+
+  g_object_class_install_property (object_class, PROP_PLAYER_CLIP,
+      g_param_spec_pointer ("clip", "Clip",
+          "The GstReplayClip to play, owned by the player",
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_PLAYER_SPEED,
+      g_param_spec_double ("speed", "Speed",
+          "Playback speed, below 1 for slow motion",
+          GST_REPLAY_MIN_SPEED, GST_REPLAY_MAX_SPEED, 1.0,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  worker_class->prepare = (GstWorkerPrepareFunc) gst_replay_player_prepare;
+  worker_class->get_pipeline_string = (GstWorkerGetPipelineStringFunc)
+      gst_replay_player_get_pipeline_string;
+}
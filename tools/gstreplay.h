@@ -0,0 +1,162 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_REPLAY_H__
+#define __GST_REPLAY_H__
+
+#include "gstworker.h"
+#include "gstcase.h"
+
+#define GST_TYPE_REPLAY (gst_replay_get_type ())
+#define GST_REPLAY(object) (G_TYPE_CHECK_INSTANCE_CAST ((object), GST_TYPE_REPLAY, GstReplay))
+#define GST_REPLAY_CLASS(class) (G_TYPE_CHECK_CLASS_CAST ((class), GST_TYPE_REPLAY, GstReplayClass))
+#define GST_IS_REPLAY(object) (G_TYPE_CHECK_INSTANCE_TYPE ((object), GST_TYPE_REPLAY))
+#define GST_IS_REPLAY_CLASS(class) (G_TYPE_CHECK_CLASS_TYPE ((class), GST_TYPE_REPLAY))
+
+#define GST_TYPE_REPLAY_PLAYER (gst_replay_player_get_type ())
+#define GST_REPLAY_PLAYER(object) (G_TYPE_CHECK_INSTANCE_CAST ((object), GST_TYPE_REPLAY_PLAYER, GstReplayPlayer))
+#define GST_REPLAY_PLAYER_CLASS(class) (G_TYPE_CHECK_CLASS_CAST ((class), GST_TYPE_REPLAY_PLAYER, GstReplayPlayerClass))
+#define GST_IS_REPLAY_PLAYER(object) (G_TYPE_CHECK_INSTANCE_TYPE ((object), GST_TYPE_REPLAY_PLAYER))
+#define GST_IS_REPLAY_PLAYER_CLASS(class) (G_TYPE_CHECK_CLASS_TYPE ((class), GST_TYPE_REPLAY_PLAYER))
+
+#define GST_REPLAY_DEFAULT_QUALITY 50   /* JPEG quality of the replay rings */
+#define GST_REPLAY_MAX_SECONDS 600      /* longest replay ring */
+#define GST_REPLAY_MIN_SPEED 0.1        /* slowest playback */
+#define GST_REPLAY_MAX_SPEED 4.0        /* fastest playback */
+
+typedef struct _GstReplay GstReplay;
+typedef struct _GstReplayClass GstReplayClass;
+typedef struct _GstReplayFrame GstReplayFrame;
+typedef struct _GstReplayClip GstReplayClip;
+typedef struct _GstReplayStats GstReplayStats;
+typedef struct _GstReplayPlayer GstReplayPlayer;
+typedef struct _GstReplayPlayerClass GstReplayPlayerClass;
+
+/**
+ *  @brief A compressed frame of a replay ring.
+ */
+struct _GstReplayFrame
+{
+  GstBuffer *buffer;            /*!< the JPEG frame */
+  gint64 time;                  /*!< when the frame was taken, monotonic usec */
+};
+
+/**
+ *  @brief The frames between the in and out points of a replay ring.
+ */
+struct _GstReplayClip
+{
+  GstCaps *caps;                /*!< the caps of the frames */
+  GArray *frames;               /*!< the GstReplayFrame, oldest first */
+  gint64 interval;              /*!< the average time between frames, usec */
+};
+
+/**
+ *  @brief Snapshot of a replay ring.
+ */
+struct _GstReplayStats
+{
+  gdouble seconds;              /*!< from the oldest to the newest frame */
+  guint64 frames;               /*!< frames in the ring */
+  guint64 bytes;                /*!< bytes of frames in the ring */
+  guint64 bytes_per_second;     /*!< memory used per second of ring */
+  gint64 mark_in;               /*!< usec since the in point, -1 if none */
+  gint64 mark_out;              /*!< usec since the out point, -1 if none */
+};
+
+/**
+ *  @class GstReplay
+ *  @struct _GstReplay
+ *  @brief Keep the last seconds of an input or the program in memory.
+ */
+struct _GstReplay
+{
+  GstWorker base;               /*!< the parent object */
+
+  gint sink_port;               /*!< the input port, or the compose port */
+  gboolean program;             /*!< TRUE to keep the program, not an input */
+  guint width;                  /*!< the program width */
+  guint height;                 /*!< the program height */
+  guint seconds;                /*!< how much to keep */
+  guint quality;                /*!< the JPEG quality */
+
+  GMutex lock;                  /*!< the lock for the ring below */
+  GQueue frames;                /*!< the GstReplayFrame, oldest first */
+  GstCaps *caps;                /*!< the caps of the frames */
+  guint64 bytes;                /*!< bytes of frames in the ring */
+  gint64 mark_in;               /*!< the in point, monotonic usec, 0 if none */
+  gint64 mark_out;              /*!< the out point, monotonic usec, 0 if none */
+};
+
+/**
+ *  @class GstReplayClass
+ *  @struct _GstReplayClass
+ *  @brief The class of GstReplay.
+ */
+struct _GstReplayClass
+{
+  GstWorkerClass base_class;    /*!< the parent class */
+};
+
+/**
+ *  @class GstReplayPlayer
+ *  @struct _GstReplayPlayer
+ *  @brief Play a replay clip back as a video input, over and over.
+ */
+struct _GstReplayPlayer
+{
+  GstCase base;                 /*!< the parent object */
+
+  GstReplayClip *clip;          /*!< the clip being played */
+  gdouble speed;                /*!< the playback speed, below 1 is slower */
+  guint next;                   /*!< the next frame to push */
+  GstClockTime loop_start;      /*!< the timestamp of the current loop */
+};
+
+/**
+ *  @class GstReplayPlayerClass
+ *  @struct _GstReplayPlayerClass
+ *  @brief The class of GstReplayPlayer.
+ */
+struct _GstReplayPlayerClass
+{
+  GstCaseClass base_class;      /*!< the parent class */
+};
+
+/**
+ *  @internal Use GST_TYPE_REPLAY instead.
+ *  @see GST_TYPE_REPLAY
+ */
+GType gst_replay_get_type (void);
+
+/**
+ *  @internal Use GST_TYPE_REPLAY_PLAYER instead.
+ *  @see GST_TYPE_REPLAY_PLAYER
+ */
+GType gst_replay_player_get_type (void);
+
+void gst_replay_mark_in (GstReplay * replay);
+gboolean gst_replay_mark_out (GstReplay * replay);
+GstReplayClip *gst_replay_get_clip (GstReplay * replay);
+void gst_replay_clip_free (GstReplayClip * clip);
+void gst_replay_get_stats (GstReplay * replay, GstReplayStats * stats);
+
+#endif //__GST_REPLAY_H__
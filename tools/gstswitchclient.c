@@ -190,6 +190,62 @@ gst_switch_client_get_preview_ports (GstSwitchClient * client)
       NULL, G_VARIANT_TYPE ("(s)"));
 }
 
+/**
+ *  @memberof GstSwitchClient
+ *  @param client the GstSwitchClient instance
+ *  @param port the preview port
+ *  @param width the thumbnail width
+ *  @param height the thumbnail height, 0 to keep the aspect ratio
+ *  @param rate the thumbnail frame rate, 0 for the input rate
+ *  @param jpeg TRUE to get JPEG encoded thumbnail frames
+ *  @return the thumbnail port, or 0 if it's not available
+ *
+ *  Request a downscaled variant of a preview port.
+ *
+ */
+gint
+gst_switch_client_get_preview_thumbnail (GstSwitchClient * client,
+    gint port, gint width, gint height, gint rate, gboolean jpeg)
+{
+  gint thumbnail = 0;
+  GVariant *value =
+      gst_switch_client_call_controller (client, "get_preview_thumbnail",
+      g_variant_new ("(iiiib)", port, width, height, rate, jpeg),
+      G_VARIANT_TYPE ("(i)"));
+  if (value) {
+    g_variant_get (value, "(i)", &thumbnail);
+    g_variant_unref (value);
+  }
+  return thumbnail;
+}
+
+/**
+ *  @memberof GstSwitchClient
+ *  @param client the GstSwitchClient instance
+ *  @param width the multiview width, 0 to remove the multiview
+ *  @param height the multiview height, 0 to keep the aspect ratio
+ *  @param columns the number of tile columns, 0 for a square grid
+ *  @param jpeg TRUE to get JPEG encoded multiview frames
+ *  @return the multiview port, or 0 if it's not available
+ *
+ *  Set up the server rendered multiview of all inputs.
+ *
+ */
+gint
+gst_switch_client_set_multiview (GstSwitchClient * client, gint width,
+    gint height, gint columns, gboolean jpeg)
+{
+  gint port = 0;
+  GVariant *value = gst_switch_client_call_controller (client, "set_multiview",
+      g_variant_new ("(iiib)", width, height, columns, jpeg),
+      G_VARIANT_TYPE ("(i)"));
+  if (value) {
+    g_variant_get (value, "(i)", &port);
+    g_variant_unref (value);
+  }
+  return port;
+}
+
 /**
  *  @memberof GstSwitchClient
  *  @param client the GstSwitchClient instance
@@ -249,6 +305,15 @@ gst_switch_client_show_track_marker (GstSwitchClient * client, GVariant * faces)
     (*klass->show_track_marker) (client, faces);
 }
 
+static void
+gst_switch_client_audio_levels (GstSwitchClient * client, GVariant * levels)
+{
+  GstSwitchClientClass *klass =
+      GST_SWITCH_CLIENT_CLASS (G_OBJECT_GET_CLASS (client));
+  if (klass->audio_levels)
+    (*klass->audio_levels) (client, levels);
+}
+
 /**
  * User click on the video.
  */
@@ -568,6 +633,8 @@ gst_switch_client_on_signal_received (GDBusConnection * connection,
     gst_switch_client_show_face_marker (client, parameters);
   } else if (g_strcmp0 ("show_track_marker", signal_name) == 0) {
     gst_switch_client_show_track_marker (client, parameters);
+  } else if (g_strcmp0 ("audio_levels", signal_name) == 0) {
+    gst_switch_client_audio_levels (client, parameters);
   } else if (g_strcmp0 ("select_face", signal_name) == 0) {
     gint x = 0, y = 0;
     g_variant_get (parameters, "(ii)", &x, &y);
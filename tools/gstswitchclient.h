@@ -52,6 +52,8 @@ typedef void (*GstSwitchClientSelectFaceFunc) (GstSwitchClient * client,
     gint x, gint y);
 typedef void (*GstSwitchClientShowFaceMarkerFunc) (GstSwitchClient * client,
     GVariant * faces);
+typedef void (*GstSwitchClientAudioLevelsFunc) (GstSwitchClient * client,
+    GVariant * levels);
 
 /**
  *  @class GstSwitchClient
@@ -90,6 +92,7 @@ struct _GstSwitchClientClass
   void (*select_face) (GstSwitchClient * client, gint x, gint y);
   void (*show_face_marker) (GstSwitchClient * client, GVariant * faces);
   void (*show_track_marker) (GstSwitchClient * client, GVariant * faces);
+  void (*audio_levels) (GstSwitchClient * client, GVariant * levels);
 };
 
 GType gst_switch_client_get_type (void);
@@ -101,6 +104,10 @@ gint gst_switch_client_get_compose_port (GstSwitchClient * client);
 gint gst_switch_client_get_encode_port (GstSwitchClient * client);
 gint gst_switch_client_get_audio_port (GstSwitchClient * client);
 GVariant *gst_switch_client_get_preview_ports (GstSwitchClient * client);
+gint gst_switch_client_get_preview_thumbnail (GstSwitchClient * client,
+    gint port, gint width, gint height, gint rate, gboolean jpeg);
+gint gst_switch_client_set_multiview (GstSwitchClient * client, gint width,
+    gint height, gint columns, gboolean jpeg);
 gboolean gst_switch_client_switch (GstSwitchClient * client, gint channel,
     gint port);
 gboolean gst_switch_client_set_composite_mode (GstSwitchClient * client,
@@ -29,6 +29,8 @@
 
 #define GST_SWITCH_CONTROLLER_LOCK_CLIENTS(c) (g_mutex_lock (&(c)->clients_lock))
 #define GST_SWITCH_CONTROLLER_UNLOCK_CLIENTS(c) (g_mutex_unlock (&(c)->clients_lock))
+#define GST_SWITCH_CONTROLLER_LOCK_REQUESTS(c) (g_mutex_lock (&(c)->requests_lock))
+#define GST_SWITCH_CONTROLLER_UNLOCK_REQUESTS(c) (g_mutex_unlock (&(c)->requests_lock))
 
 G_DEFINE_TYPE (GstSwitchController, gst_switch_controller, G_TYPE_OBJECT);
 
@@ -48,6 +50,34 @@ gst_switch_controller_method_match (const gchar * key,
   return FALSE;
 }
 
+/**
+ * @brief The request latencies of a remote method, made on its first call.
+ * @memberof GstSwitchController
+ */
+static GstSwitchMetricsHistogram *
+gst_switch_controller_get_requests (GstSwitchController * controller,
+    const gchar * method_name)
+{
+  GstSwitchMetricsHistogram *h;
+
+  GST_SWITCH_CONTROLLER_LOCK_REQUESTS (controller);
+  h = g_hash_table_lookup (controller->requests, method_name);
+  if (h == NULL) {
+    h = g_new (GstSwitchMetricsHistogram, 1);
+    gst_switch_metrics_histogram_init (h);
+    g_hash_table_insert (controller->requests, g_strdup (method_name), h);
+  }
+  GST_SWITCH_CONTROLLER_UNLOCK_REQUESTS (controller);
+  return h;
+}
+
+static void
+gst_switch_controller_free_requests (GstSwitchMetricsHistogram * h)
+{
+  gst_switch_metrics_histogram_clear (h);
+  g_free (h);
+}
+
 /**
  * @brief Performing a remoting method call from a gst-switch client.
  * @memberof GstSwitchController
@@ -69,6 +99,7 @@ gst_switch_controller_do_method_call (GDBusConnection * connection,
       gst_switch_controller_method_match,
       (gpointer) method_name);
   GVariant *results;
+  gint64 start;
 
   if (!entry)
     goto error_no_method;
@@ -77,7 +108,10 @@ gst_switch_controller_do_method_call (GDBusConnection * connection,
      INFO ("calling: %s/%s", interface_name, method_name);
    */
 
+  start = g_get_monotonic_time ();
   results = (*entry) (G_OBJECT (controller), connection, parameters);
+  gst_switch_metrics_histogram_observe (gst_switch_controller_get_requests
+      (controller, method_name), g_get_monotonic_time () - start);
   g_dbus_method_invocation_return_value (invocation, results);
   return;
 
@@ -315,6 +349,10 @@ gst_switch_controller_init (GstSwitchController * controller)
   g_mutex_init (&controller->clients_lock);
   controller->clients = NULL;
 
+  g_mutex_init (&controller->requests_lock);
+  controller->requests = g_hash_table_new_full (g_str_hash, g_str_equal,
+      g_free, (GDestroyNotify) gst_switch_controller_free_requests);
+
   flags |= G_DBUS_SERVER_FLAGS_RUN_IN_THREAD;
   flags |= G_DBUS_SERVER_FLAGS_AUTHENTICATION_ALLOW_ANONYMOUS;
 
@@ -358,6 +396,9 @@ gst_switch_controller_finalize (GstSwitchController * controller)
 
   g_mutex_clear (&controller->clients_lock);
 
+  g_hash_table_destroy (controller->requests);
+  g_mutex_clear (&controller->requests_lock);
+
   if (G_OBJECT_CLASS (gst_switch_controller_parent_class)->finalize)
     (*G_OBJECT_CLASS (gst_switch_controller_parent_class)->finalize)
         (G_OBJECT (controller));
@@ -481,6 +522,69 @@ gst_switch_controller_show_track_marker (GstSwitchController * controller,
       g_variant_new_tuple (&faces, 1));
 }
 
+/**
+ *  @memberof GstSwitchController
+ *  @param controller the GstSwitchController instance
+ *  @param levels the audio levels, a(iddd)
+ *
+ *  Tell the clients the latest audio levels.
+ */
+void
+gst_switch_controller_tell_audio_levels (GstSwitchController * controller,
+    GVariant * levels)
+{
+  gst_switch_controller_emit_signal (controller, "audio_levels",
+      g_variant_new_tuple (&levels, 1));
+}
+
+/**
+ *  @memberof GstSwitchController
+ *  @param controller the GstSwitchController instance
+ *  @param stats the pipeline counters, a(sa(sttttux))
+ *
+ *  Tell the clients the latest pipeline counters.
+ */
+void
+gst_switch_controller_tell_stats (GstSwitchController * controller,
+    GVariant * stats)
+{
+  gst_switch_controller_emit_signal (controller, "stats",
+      g_variant_new_tuple (&stats, 1));
+}
+
+/**
+ *  @memberof GstSwitchController
+ *  @param controller the GstSwitchController instance
+ *  @param out the scrape
+ *
+ *  Append the latencies of the remote methods called so far, from the
+ *  call of the method to its results, in seconds.
+ */
+void
+gst_switch_controller_append_metrics (GstSwitchController * controller,
+    GString * out)
+{
+  const gchar *name = "gstswitch_dbus_request_seconds";
+  GList *methods, *m;
+  gchar *labels;
+
+  gst_switch_metrics_append_help (out, name, "histogram",
+      "Time the remote methods took to serve a request.");
+
+  /* the histograms are never removed, only the table is locked */
+  GST_SWITCH_CONTROLLER_LOCK_REQUESTS (controller);
+  methods = g_hash_table_get_keys (controller->requests);
+  GST_SWITCH_CONTROLLER_UNLOCK_REQUESTS (controller);
+  methods = g_list_sort (methods, (GCompareFunc) g_strcmp0);
+  for (m = methods; m; m = g_list_next (m)) {
+    labels = g_strdup_printf ("method=\"%s\"", (gchar *) m->data);
+    gst_switch_metrics_append_histogram (out, name, labels,
+        gst_switch_controller_get_requests (controller, m->data));
+    g_free (labels);
+  }
+  g_list_free (methods);
+}
+
 /**
  * @memberof GstSwitchController
  *  
@@ -720,6 +824,533 @@ gst_switch_controller__mark_tracking (GstSwitchController * controller,
   return result;
 }
 
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "add_encoded_output".
+ */
+static GVariant *
+gst_switch_controller__add_encoded_output (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  const gchar *codec, *preset;
+  guint bitrate;
+  gint port = 0;
+  g_variant_get (parameters, "(&s&su)", &codec, &preset, &bitrate);
+  if (controller->server) {
+    port = gst_switch_server_add_encoded_output (controller->server,
+        codec, preset, bitrate);
+    result = g_variant_new ("(i)", port);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "remove_encoded_output".
+ */
+static GVariant *
+gst_switch_controller__remove_encoded_output (GstSwitchController *
+    controller, GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  gboolean ok = FALSE;
+  gint port;
+  g_variant_get (parameters, "(i)", &port);
+  if (controller->server) {
+    ok = gst_switch_server_remove_encoded_output (controller->server, port);
+    result = g_variant_new ("(b)", ok);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_encoded_outputs".
+ */
+static GVariant *
+gst_switch_controller__get_encoded_outputs (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    GVariant *value =
+        gst_switch_server_get_encoded_outputs (controller->server);
+    gchar *res = g_variant_print (value, FALSE);
+    result = g_variant_new ("(s)", res);
+    g_variant_unref (g_variant_ref_sink (value));
+    g_free (res);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_preview_thumbnail".
+ */
+static GVariant *
+gst_switch_controller__get_preview_thumbnail (GstSwitchController *
+    controller, GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  gint port, width, height, rate;
+  gboolean jpeg;
+  g_variant_get (parameters, "(iiiib)", &port, &width, &height, &rate, &jpeg);
+  if (controller->server) {
+    port = gst_switch_server_get_preview_thumbnail (controller->server,
+        port, width, height, rate, jpeg);
+    result = g_variant_new ("(i)", port);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "set_multiview".
+ */
+static GVariant *
+gst_switch_controller__set_multiview (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  gint width, height, columns, port;
+  gboolean jpeg;
+  g_variant_get (parameters, "(iiib)", &width, &height, &columns, &jpeg);
+  if (controller->server) {
+    port = gst_switch_server_set_multiview (controller->server, width, height,
+        columns, jpeg);
+    result = g_variant_new ("(i)", port);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_multiview_port".
+ */
+static GVariant *
+gst_switch_controller__get_multiview_port (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    gint port = gst_switch_server_get_multiview_port (controller->server);
+    result = g_variant_new ("(i)", port);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_branch_stats".
+ */
+static GVariant *
+gst_switch_controller__get_branch_stats (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    GVariant *value = gst_switch_server_get_branch_stats (controller->server);
+    gchar *res = g_variant_print (value, FALSE);
+    result = g_variant_new ("(s)", res);
+    g_variant_unref (g_variant_ref_sink (value));
+    g_free (res);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_client_stats".
+ */
+static GVariant *
+gst_switch_controller__get_client_stats (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    GVariant *value = gst_switch_server_get_client_stats (controller->server);
+    gchar *res = g_variant_print (value, FALSE);
+    result = g_variant_new ("(s)", res);
+    g_variant_unref (g_variant_ref_sink (value));
+    g_free (res);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_record_stats".
+ */
+static GVariant *
+gst_switch_controller__get_record_stats (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    GVariant *value = gst_switch_server_get_record_stats (controller->server);
+    gchar *res = g_variant_print (value, FALSE);
+    result = g_variant_new ("(s)", res);
+    g_variant_unref (g_variant_ref_sink (value));
+    g_free (res);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_iso_stats".
+ */
+static GVariant *
+gst_switch_controller__get_iso_stats (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    GVariant *value = gst_switch_server_get_iso_stats (controller->server);
+    gchar *res = g_variant_print (value, FALSE);
+    result = g_variant_new ("(s)", res);
+    g_variant_unref (g_variant_ref_sink (value));
+    g_free (res);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "replay_mark_in".
+ */
+static GVariant *
+gst_switch_controller__replay_mark_in (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  gboolean ok = FALSE;
+  gint port;
+  g_variant_get (parameters, "(i)", &port);
+  if (controller->server) {
+    ok = gst_switch_server_replay_mark_in (controller->server, port);
+    result = g_variant_new ("(b)", ok);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "replay_mark_out".
+ */
+static GVariant *
+gst_switch_controller__replay_mark_out (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  gboolean ok = FALSE;
+  gint port;
+  g_variant_get (parameters, "(i)", &port);
+  if (controller->server) {
+    ok = gst_switch_server_replay_mark_out (controller->server, port);
+    result = g_variant_new ("(b)", ok);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "replay_play".
+ */
+static GVariant *
+gst_switch_controller__replay_play (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  gdouble speed;
+  gint port;
+  g_variant_get (parameters, "(id)", &port, &speed);
+  if (controller->server) {
+    port = gst_switch_server_replay_play (controller->server, port, speed);
+    result = g_variant_new ("(i)", port);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "replay_stop".
+ */
+static GVariant *
+gst_switch_controller__replay_stop (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  gboolean ok = FALSE;
+  gint port;
+  g_variant_get (parameters, "(i)", &port);
+  if (controller->server) {
+    ok = gst_switch_server_replay_stop (controller->server, port);
+    result = g_variant_new ("(b)", ok);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_replay_stats".
+ */
+static GVariant *
+gst_switch_controller__get_replay_stats (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    GVariant *value = gst_switch_server_get_replay_stats (controller->server);
+    gchar *res = g_variant_print (value, FALSE);
+    result = g_variant_new ("(s)", res);
+    g_variant_unref (g_variant_ref_sink (value));
+    g_free (res);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "set_audio_mix".
+ */
+static GVariant *
+gst_switch_controller__set_audio_mix (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  gboolean ok = FALSE, mute;
+  gdouble gain, pan;
+  gint port;
+  g_variant_get (parameters, "(idbd)", &port, &gain, &mute, &pan);
+  if (controller->server) {
+    ok = gst_switch_server_set_audio_mix (controller->server, port, gain,
+        mute, pan);
+    result = g_variant_new ("(b)", ok);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_audio_mix".
+ */
+static GVariant *
+gst_switch_controller__get_audio_mix (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    GVariant *value = gst_switch_server_get_audio_mix (controller->server);
+    gchar *res = g_variant_print (value, FALSE);
+    result = g_variant_new ("(s)", res);
+    g_variant_unref (g_variant_ref_sink (value));
+    g_free (res);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_audio_levels".
+ */
+static GVariant *
+gst_switch_controller__get_audio_levels (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    GVariant *value = gst_switch_server_get_audio_levels (controller->server);
+    gchar *res = g_variant_print (value, FALSE);
+    result = g_variant_new ("(s)", res);
+    g_variant_unref (g_variant_ref_sink (value));
+    g_free (res);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "set_av_offset".
+ */
+static GVariant *
+gst_switch_controller__set_av_offset (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  gboolean ok = FALSE;
+  gint64 offset;
+  gint port;
+  g_variant_get (parameters, "(ix)", &port, &offset);
+  if (controller->server) {
+    ok = gst_switch_server_set_av_offset (controller->server, port, offset);
+    result = g_variant_new ("(b)", ok);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_av_offsets".
+ */
+static GVariant *
+gst_switch_controller__get_av_offsets (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    GVariant *value = gst_switch_server_get_av_offsets (controller->server);
+    gchar *res = g_variant_print (value, FALSE);
+    result = g_variant_new ("(s)", res);
+    g_variant_unref (g_variant_ref_sink (value));
+    g_free (res);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "pair_audio".
+ */
+static GVariant *
+gst_switch_controller__pair_audio (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  gboolean ok = FALSE;
+  gint video_port, audio_port;
+  g_variant_get (parameters, "(ii)", &video_port, &audio_port);
+  if (controller->server) {
+    ok = gst_switch_server_pair_audio (controller->server, video_port,
+        audio_port);
+    result = g_variant_new ("(b)", ok);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_audio_latency".
+ */
+static GVariant *
+gst_switch_controller__get_audio_latency (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    GVariant *value = gst_switch_server_get_audio_latency (controller->server);
+    gchar *res = g_variant_print (value, FALSE);
+    result = g_variant_new ("(s)", res);
+    g_variant_unref (g_variant_ref_sink (value));
+    g_free (res);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_loudness".
+ */
+static GVariant *
+gst_switch_controller__get_loudness (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    GVariant *value = gst_switch_server_get_loudness (controller->server);
+    gchar *res = g_variant_print (value, FALSE);
+    result = g_variant_new ("(s)", res);
+    g_variant_unref (g_variant_ref_sink (value));
+    g_free (res);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_watchdog_stats".
+ */
+static GVariant *
+gst_switch_controller__get_watchdog_stats (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    GVariant *value =
+        gst_switch_server_get_watchdog_stats (controller->server);
+    gchar *res = g_variant_print (value, FALSE);
+    result = g_variant_new ("(s)", res);
+    g_variant_unref (g_variant_ref_sink (value));
+    g_free (res);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_stats".
+ */
+static GVariant *
+gst_switch_controller__get_stats (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    GVariant *value = gst_switch_server_get_stats (controller->server);
+    gchar *res = g_variant_print (value, FALSE);
+    result = g_variant_new ("(s)", res);
+    g_variant_unref (g_variant_ref_sink (value));
+    g_free (res);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_latency".
+ */
+static GVariant *
+gst_switch_controller__get_latency (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    GVariant *value = gst_switch_server_get_latency (controller->server);
+    gchar *res = g_variant_print (value, FALSE);
+    result = g_variant_new ("(s)", res);
+    g_variant_unref (g_variant_ref_sink (value));
+    g_free (res);
+  }
+  return result;
+}
+
 /**
  *
  * Remoting method table of the gst-switch controller.
@@ -740,6 +1371,39 @@ static MethodTableEntry gst_switch_controller_method_table[] = {
   {"mark_face", (MethodFunc) gst_switch_controller__mark_face},
   {"mark_tracking", (MethodFunc) gst_switch_controller__mark_tracking},
   {"switch", (MethodFunc) gst_switch_controller__switch},
+  {"add_encoded_output",
+      (MethodFunc) gst_switch_controller__add_encoded_output},
+  {"remove_encoded_output",
+      (MethodFunc) gst_switch_controller__remove_encoded_output},
+  {"get_encoded_outputs",
+      (MethodFunc) gst_switch_controller__get_encoded_outputs},
+  {"get_preview_thumbnail",
+      (MethodFunc) gst_switch_controller__get_preview_thumbnail},
+  {"set_multiview", (MethodFunc) gst_switch_controller__set_multiview},
+  {"get_multiview_port",
+      (MethodFunc) gst_switch_controller__get_multiview_port},
+  {"get_branch_stats", (MethodFunc) gst_switch_controller__get_branch_stats},
+  {"get_client_stats", (MethodFunc) gst_switch_controller__get_client_stats},
+  {"get_record_stats", (MethodFunc) gst_switch_controller__get_record_stats},
+  {"get_iso_stats", (MethodFunc) gst_switch_controller__get_iso_stats},
+  {"replay_mark_in", (MethodFunc) gst_switch_controller__replay_mark_in},
+  {"replay_mark_out", (MethodFunc) gst_switch_controller__replay_mark_out},
+  {"replay_play", (MethodFunc) gst_switch_controller__replay_play},
+  {"replay_stop", (MethodFunc) gst_switch_controller__replay_stop},
+  {"get_replay_stats", (MethodFunc) gst_switch_controller__get_replay_stats},
+  {"set_audio_mix", (MethodFunc) gst_switch_controller__set_audio_mix},
+  {"get_audio_mix", (MethodFunc) gst_switch_controller__get_audio_mix},
+  {"get_audio_levels", (MethodFunc) gst_switch_controller__get_audio_levels},
+  {"set_av_offset", (MethodFunc) gst_switch_controller__set_av_offset},
+  {"get_av_offsets", (MethodFunc) gst_switch_controller__get_av_offsets},
+  {"pair_audio", (MethodFunc) gst_switch_controller__pair_audio},
+  {"get_audio_latency",
+      (MethodFunc) gst_switch_controller__get_audio_latency},
+  {"get_loudness", (MethodFunc) gst_switch_controller__get_loudness},
+  {"get_watchdog_stats",
+      (MethodFunc) gst_switch_controller__get_watchdog_stats},
+  {"get_stats", (MethodFunc) gst_switch_controller__get_stats},
+  {"get_latency", (MethodFunc) gst_switch_controller__get_latency},
   {NULL, NULL}
 };
 
@@ -25,6 +25,7 @@
 #include <gio/gio.h>
 #include "../logutils.h"
 #include "gstworker.h"
+#include "gstswitchmetrics.h"
 
 #define GST_TYPE_SWITCH_CONTROLLER (gst_switch_controller_get_type ())
 #define GST_SWITCH_CONTROLLER(object) (G_TYPE_CHECK_INSTANCE_CAST ((object), GST_TYPE_SWITCH_CONTROLLER, GstSwitchController))
@@ -62,6 +63,9 @@ typedef struct _GstSwitchController
   GDBusServer *bus_server;      /*!< the dbus server instance */
   GMutex clients_lock;          /*!< the lock for %clients */
   GList *clients;               /*!< the client list */
+  GMutex requests_lock;         /*!< the lock for %requests */
+  GHashTable *requests;         /*!< the request latencies of each method,
+                                   GstSwitchMetricsHistogram */
 } GstSwitchController;
 
 /**
@@ -90,6 +94,12 @@ void gst_switch_controller_show_face_marker (GstSwitchController * controller,
     GVariant * faces);
 void gst_switch_controller_show_track_marker (GstSwitchController * controller,
     GVariant * faces);
+void gst_switch_controller_tell_audio_levels (GstSwitchController *
+    controller, GVariant * levels);
+void gst_switch_controller_tell_stats (GstSwitchController * controller,
+    GVariant * stats);
+void gst_switch_controller_append_metrics (GstSwitchController * controller,
+    GString * out);
 
 extern const gchar gstswitchcontroller_introspection_xml[];
 extern gint gst_switch_controller_dbus_timeout;
@@ -80,6 +80,110 @@ const gchar gstswitchcontroller_introspection_xml[] =
     "    <method name='mark_tracking'>"
     "      <arg type='a(iiii)' name='faces' direction='in'/>"
     "    </method>"
+    "    <method name='add_encoded_output'>"
+    "      <arg type='s' name='codec' direction='in'/>"
+    "      <arg type='s' name='preset' direction='in'/>"
+    "      <arg type='u' name='bitrate' direction='in'/>"
+    "      <arg type='i' name='port' direction='out'/>"
+    "    </method>"
+    "    <method name='remove_encoded_output'>"
+    "      <arg type='i' name='port' direction='in'/>"
+    "      <arg type='b' name='result' direction='out'/>"
+    "    </method>"
+    "    <method name='get_encoded_outputs'>"
+    "      <arg type='s' name='outputs' direction='out'/>"
+    "    </method>"
+    "    <method name='get_preview_thumbnail'>"
+    "      <arg type='i' name='port' direction='in'/>"
+    "      <arg type='i' name='width' direction='in'/>"
+    "      <arg type='i' name='height' direction='in'/>"
+    "      <arg type='i' name='rate' direction='in'/>"
+    "      <arg type='b' name='jpeg' direction='in'/>"
+    "      <arg type='i' name='thumbnail' direction='out'/>"
+    "    </method>"
+    "    <method name='set_multiview'>"
+    "      <arg type='i' name='width' direction='in'/>"
+    "      <arg type='i' name='height' direction='in'/>"
+    "      <arg type='i' name='columns' direction='in'/>"
+    "      <arg type='b' name='jpeg' direction='in'/>"
+    "      <arg type='i' name='port' direction='out'/>"
+    "    </method>"
+    "    <method name='get_multiview_port'>"
+    "      <arg type='i' name='port' direction='out'/>"
+    "    </method>"
+    "    <method name='get_branch_stats'>"
+    "      <arg type='s' name='stats' direction='out'/>"
+    "    </method>"
+    "    <method name='get_client_stats'>"
+    "      <arg type='s' name='stats' direction='out'/>"
+    "    </method>"
+    "    <method name='get_record_stats'>"
+    "      <arg type='s' name='stats' direction='out'/>"
+    "    </method>"
+    "    <method name='get_iso_stats'>"
+    "      <arg type='s' name='stats' direction='out'/>"
+    "    </method>"
+    "    <method name='replay_mark_in'>"
+    "      <arg type='i' name='port' direction='in'/>"
+    "      <arg type='b' name='result' direction='out'/>"
+    "    </method>"
+    "    <method name='replay_mark_out'>"
+    "      <arg type='i' name='port' direction='in'/>"
+    "      <arg type='b' name='result' direction='out'/>"
+    "    </method>"
+    "    <method name='replay_play'>"
+    "      <arg type='i' name='port' direction='in'/>"
+    "      <arg type='d' name='speed' direction='in'/>"
+    "      <arg type='i' name='replay' direction='out'/>"
+    "    </method>"
+    "    <method name='replay_stop'>"
+    "      <arg type='i' name='port' direction='in'/>"
+    "      <arg type='b' name='result' direction='out'/>"
+    "    </method>"
+    "    <method name='get_replay_stats'>"
+    "      <arg type='s' name='stats' direction='out'/>"
+    "    </method>"
+    "    <method name='set_audio_mix'>"
+    "      <arg type='i' name='port' direction='in'/>"
+    "      <arg type='d' name='gain' direction='in'/>"
+    "      <arg type='b' name='mute' direction='in'/>"
+    "      <arg type='d' name='pan' direction='in'/>"
+    "      <arg type='b' name='result' direction='out'/>"
+    "    </method>"
+    "    <method name='get_audio_mix'>"
+    "      <arg type='s' name='mix' direction='out'/>"
+    "    </method>"
+    "    <method name='get_audio_levels'>"
+    "      <arg type='s' name='levels' direction='out'/>"
+    "    </method>"
+    "    <method name='set_av_offset'>"
+    "      <arg type='i' name='port' direction='in'/>"
+    "      <arg type='x' name='offset' direction='in'/>"
+    "      <arg type='b' name='result' direction='out'/>"
+    "    </method>"
+    "    <method name='get_av_offsets'>"
+    "      <arg type='s' name='offsets' direction='out'/>"
+    "    </method>"
+    "    <method name='pair_audio'>"
+    "      <arg type='i' name='video_port' direction='in'/>"
+    "      <arg type='i' name='audio_port' direction='in'/>"
+    "      <arg type='b' name='result' direction='out'/>"
+    "    </method>"
+    "    <method name='get_audio_latency'>"
+    "      <arg type='s' name='latency' direction='out'/>"
+    "    </method>"
+    "    <method name='get_loudness'>"
+    "      <arg type='s' name='loudness' direction='out'/>"
+    "    </method>"
+    "    <method name='get_watchdog_stats'>"
+    "      <arg type='s' name='stats' direction='out'/>"
+    "    </method>"
+    "    <method name='get_stats'>"
+    "      <arg type='s' name='stats' direction='out'/>"
+    "    </method>"
+    "    <method name='get_latency'>"
+    "      <arg type='s' name='latency' direction='out'/>"
+    "    </method>"
     "    "
     "    <signal name='preview_port_added'>"
     "      <arg type='i' name='port'/>"
@@ -104,6 +208,12 @@ const gchar gstswitchcontroller_introspection_xml[] =
     "      <arg type='i' name='x'/>"
     "      <arg type='i' name='y'/>"
     "    </signal>"
+    "    <signal name='audio_levels'>"
+    "      <arg type='a(iddd)' name='levels'/>"
+    "    </signal>"
+    "    <signal name='stats'>"
+    "      <arg type='a(sa(sttttux))' name='stats'/>"
+    "    </signal>"
     "  </interface>"
     "</node>";
 /* *INDENT-ON* */
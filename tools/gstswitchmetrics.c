@@ -0,0 +1,308 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "gstswitchmetrics.h"
+
+/* the upper bounds of the buckets */
+static const struct
+{
+  const gchar *le;              /* in seconds, as scraped */
+  gint64 usec;
+} gst_switch_metrics_bounds[GST_SWITCH_METRICS_BUCKETS] = {
+  {"0.001", 1000}, {"0.0025", 2500}, {"0.005", 5000}, {"0.01", 10000},
+  {"0.025", 25000}, {"0.05", 50000}, {"0.1", 100000}, {"0.25", 250000},
+  {"0.5", 500000}, {"1", 1000000}, {"2.5", 2500000}, {"5", 5000000}
+};
+
+typedef struct _GstSwitchMetricsServer GstSwitchMetricsServer;
+struct _GstSwitchMetricsServer
+{
+  GstSwitchMetricsFunc func;
+  gpointer data;
+};
+
+/**
+ * @brief Initialize a histogram, nothing is observed yet.
+ * @param h The GstSwitchMetricsHistogram.
+ */
+void
+gst_switch_metrics_histogram_init (GstSwitchMetricsHistogram * h)
+{
+  memset (h, 0, sizeof (*h));
+  g_mutex_init (&h->lock);
+}
+
+/**
+ * @brief Release a histogram.
+ * @param h The GstSwitchMetricsHistogram.
+ */
+void
+gst_switch_metrics_histogram_clear (GstSwitchMetricsHistogram * h)
+{
+  g_mutex_clear (&h->lock);
+}
+
+/**
+ * @brief Count a latency into its bucket.
+ * @param h The GstSwitchMetricsHistogram.
+ * @param usec The latency.
+ */
+void
+gst_switch_metrics_histogram_observe (GstSwitchMetricsHistogram * h,
+    gint64 usec)
+{
+  guint i;
+
+  usec = MAX (usec, 0);
+  for (i = 0; i < GST_SWITCH_METRICS_BUCKETS; ++i)
+    if (usec <= gst_switch_metrics_bounds[i].usec)
+      break;
+
+  g_mutex_lock (&h->lock);
+  h->counts[i] += 1;
+  h->count += 1;
+  h->sum += usec;
+  g_mutex_unlock (&h->lock);
+}
+
+/**
+ * @brief Append the HELP and TYPE lines of a metric.
+ * @param out The scrape.
+ * @param name The metric name.
+ * @param type counter, gauge or histogram.
+ * @param help What the metric is.
+ */
+void
+gst_switch_metrics_append_help (GString * out, const gchar * name,
+    const gchar * type, const gchar * help)
+{
+  g_string_append_printf (out, "# HELP %s %s\n# TYPE %s %s\n", name, help,
+      name, type);
+}
+
+/**
+ * @brief Append a sample of a metric.
+ * @param out The scrape.
+ * @param name The metric name.
+ * @param labels The labels, like port="3000", or NULL for none.
+ * @param value The value.
+ */
+void
+gst_switch_metrics_append_value (GString * out, const gchar * name,
+    const gchar * labels, gdouble value)
+{
+  gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+  /* the text format wants a dot whatever the locale */
+  g_ascii_formatd (buf, sizeof (buf), "%.15g", value);
+  if (labels && *labels)
+    g_string_append_printf (out, "%s{%s} %s\n", name, labels, buf);
+  else
+    g_string_append_printf (out, "%s %s\n", name, buf);
+}
+
+/**
+ * @brief Append the cumulative buckets, sum and count of a histogram.
+ * @param out The scrape.
+ * @param name The metric name, in seconds.
+ * @param labels The labels, or NULL for none.
+ * @param h The histogram.
+ */
+void
+gst_switch_metrics_append_histogram (GString * out, const gchar * name,
+    const gchar * labels, GstSwitchMetricsHistogram * h)
+{
+  guint64 counts[GST_SWITCH_METRICS_BUCKETS + 1], count, total = 0;
+  const gchar *sep = labels && *labels ? "," : "";
+  gchar *bucket, *le;
+  gint64 sum;
+  guint i;
+
+  g_mutex_lock (&h->lock);
+  memcpy (counts, h->counts, sizeof (counts));
+  count = h->count;
+  sum = h->sum;
+  g_mutex_unlock (&h->lock);
+
+  bucket = g_strdup_printf ("%s_bucket", name);
+  for (i = 0; i <= GST_SWITCH_METRICS_BUCKETS; ++i) {
+    total += counts[i];
+    le = g_strdup_printf ("%s%sle=\"%s\"", labels ? labels : "", sep,
+        i < GST_SWITCH_METRICS_BUCKETS ? gst_switch_metrics_bounds[i].le :
+        "+Inf");
+    gst_switch_metrics_append_value (out, bucket, le, total);
+    g_free (le);
+  }
+  g_free (bucket);
+
+  bucket = g_strdup_printf ("%s_sum", name);
+  gst_switch_metrics_append_value (out, bucket, labels, sum / 1e6);
+  g_free (bucket);
+  bucket = g_strdup_printf ("%s_count", name);
+  gst_switch_metrics_append_value (out, bucket, labels, count);
+  g_free (bucket);
+}
+
+/**
+ * @brief Append the CPU time and the resident memory of the process, in
+ *        the names the client libraries of Prometheus use.
+ * @param out The scrape.
+ */
+void
+gst_switch_metrics_append_process (GString * out)
+{
+  struct rusage usage;
+  gchar *statm = NULL;
+  guint64 pages, resident;
+
+  if (getrusage (RUSAGE_SELF, &usage) == 0) {
+    gst_switch_metrics_append_help (out, "process_cpu_seconds_total",
+        "counter", "User and system CPU time spent in seconds.");
+    gst_switch_metrics_append_value (out, "process_cpu_seconds_total", NULL,
+        usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+        (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6);
+  }
+
+  /* the size and the resident set, in pages */
+  if (g_file_get_contents ("/proc/self/statm", &statm, NULL, NULL) &&
+      sscanf (statm, "%" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT, &pages,
+          &resident) == 2) {
+    gst_switch_metrics_append_help (out, "process_resident_memory_bytes",
+        "gauge", "Resident memory size in bytes.");
+    gst_switch_metrics_append_value (out, "process_resident_memory_bytes",
+        NULL, (gdouble) resident * sysconf (_SC_PAGESIZE));
+  }
+  g_free (statm);
+}
+
+/**
+ * @brief Answer one scrape, in a thread of the service.
+ *
+ * Only GET /metrics is served, the connection is closed after the answer.
+ */
+static gboolean
+gst_switch_metrics_run (GThreadedSocketService * service,
+    GSocketConnection * connection, GObject * source,
+    GstSwitchMetricsServer * server)
+{
+  GInputStream *input =
+      g_io_stream_get_input_stream (G_IO_STREAM (connection));
+  GOutputStream *output =
+      g_io_stream_get_output_stream (G_IO_STREAM (connection));
+  gchar request[GST_SWITCH_METRICS_REQUEST + 1];
+  GString *body, *response;
+  gsize size = 0;
+  gssize n;
+
+  g_socket_set_timeout (g_socket_connection_get_socket (connection),
+      GST_SWITCH_METRICS_TIMEOUT);
+
+  /* the request line and the headers, the rest is of no use */
+  do {
+    n = g_input_stream_read (input, request + size,
+        GST_SWITCH_METRICS_REQUEST - size, NULL, NULL);
+    if (n <= 0)
+      return TRUE;
+    size += n;
+    request[size] = '\0';
+  } while (!strstr (request, "\r\n\r\n") && !strstr (request, "\n\n")
+      && size < GST_SWITCH_METRICS_REQUEST);
+
+  response = g_string_new ("");
+  if (g_str_has_prefix (request, "GET /metrics ") ||
+      g_str_has_prefix (request, "GET /metrics?")) {
+    body = g_string_new ("");
+    server->func (body, server->data);
+    g_string_append_printf (response, "HTTP/1.0 200 OK\r\n"
+        "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+        "Content-Length: %" G_GSIZE_FORMAT "\r\n"
+        "Connection: close\r\n\r\n", body->len);
+    g_string_append_len (response, body->str, body->len);
+    g_string_free (body, TRUE);
+  } else {
+    g_string_append (response, "HTTP/1.0 404 Not Found\r\n"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: 10\r\n" "Connection: close\r\n\r\n" "Not Found\n");
+  }
+
+  g_output_stream_write_all (output, response->str, response->len, NULL,
+      NULL, NULL);
+  g_string_free (response, TRUE);
+  return TRUE;
+}
+
+/**
+ * @brief Serve the metrics over HTTP.
+ * @param address The local address to listen on, like 127.0.0.1.
+ * @param port The port to listen on, 0 for any, set to the one bound.
+ * @param func Appends the metrics of a scrape, called in the threads of the
+ *        service, never in the main loop.
+ * @param data The data of @func.
+ * @param error The error if the port could not be bound.
+ * @return The running service, NULL on error.
+ */
+GSocketService *
+gst_switch_metrics_serve (const gchar * address, guint16 * port,
+    GstSwitchMetricsFunc func, gpointer data, GError ** error)
+{
+  GstSwitchMetricsServer *server;
+  GSocketService *service;
+  GSocketAddress *bound = NULL, *sockaddr;
+  GInetAddress *inet;
+
+  inet = g_inet_address_new_from_string (address);
+  if (inet == NULL) {
+    g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+        "invalid address: %s", address);
+    return NULL;
+  }
+  sockaddr = g_inet_socket_address_new (inet, *port);
+  g_object_unref (inet);
+
+  service = g_threaded_socket_service_new (GST_SWITCH_METRICS_THREADS);
+  if (!g_socket_listener_add_address (G_SOCKET_LISTENER (service), sockaddr,
+          G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_TCP, NULL, &bound, error)) {
+    g_object_unref (sockaddr);
+    g_object_unref (service);
+    return NULL;
+  }
+  g_object_unref (sockaddr);
+  *port = g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (bound));
+  g_object_unref (bound);
+
+  server = g_new0 (GstSwitchMetricsServer, 1);
+  server->func = func;
+  server->data = data;
+  g_signal_connect_data (service, "run",
+      G_CALLBACK (gst_switch_metrics_run), server,
+      (GClosureNotify) g_free, 0);
+
+  g_socket_service_start (service);
+  return service;
+}
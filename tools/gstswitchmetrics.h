@@ -0,0 +1,70 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_SWITCH_METRICS_H__
+#define __GST_SWITCH_METRICS_H__
+
+#include <gio/gio.h>
+
+#define GST_SWITCH_METRICS_BUCKETS 12   /* bounds, +Inf not counted */
+#define GST_SWITCH_METRICS_THREADS 2    /* scrapes served at once */
+#define GST_SWITCH_METRICS_TIMEOUT 5    /* seconds a scraper may take */
+#define GST_SWITCH_METRICS_REQUEST 4096 /* the longest request read */
+
+typedef struct _GstSwitchMetricsHistogram GstSwitchMetricsHistogram;
+
+/**
+ *  @brief A latency histogram in the text format of Prometheus.
+ *
+ *  The buckets go from 1 ms to 5 s, and only take the lock for a moment,
+ *  it is never observed from a streaming thread.
+ */
+struct _GstSwitchMetricsHistogram
+{
+  GMutex lock;                  /*!< the lock for the fields below */
+  guint64 counts[GST_SWITCH_METRICS_BUCKETS + 1];       /*!< per bucket */
+  guint64 count;                /*!< observations */
+  gint64 sum;                   /*!< usec observed in total */
+};
+
+/**
+ *  @brief Append the metrics of a scrape to @out.
+ */
+typedef void (*GstSwitchMetricsFunc) (GString * out, gpointer data);
+
+void gst_switch_metrics_histogram_init (GstSwitchMetricsHistogram * h);
+void gst_switch_metrics_histogram_clear (GstSwitchMetricsHistogram * h);
+void gst_switch_metrics_histogram_observe (GstSwitchMetricsHistogram * h,
+    gint64 usec);
+
+void gst_switch_metrics_append_help (GString * out, const gchar * name,
+    const gchar * type, const gchar * help);
+void gst_switch_metrics_append_value (GString * out, const gchar * name,
+    const gchar * labels, gdouble value);
+void gst_switch_metrics_append_histogram (GString * out, const gchar * name,
+    const gchar * labels, GstSwitchMetricsHistogram * h);
+void gst_switch_metrics_append_process (GString * out);
+
+GSocketService *gst_switch_metrics_serve (const gchar * address,
+    guint16 * port, GstSwitchMetricsFunc func, gpointer data,
+    GError ** error);
+
+#endif //__GST_SWITCH_METRICS_H__
@@ -0,0 +1,829 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2012,2013 Duzy Chan <code@duzy.info>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file
+ *
+ * gst-switch-reindex makes a recording cut short by a crash seekable again,
+ * from the index written along with it by GstRecordIndex.
+ *
+ * The recording is repaired in place: the torn tail is cut off after the
+ * last complete block, the cues (and chapters for the recorded events)
+ * are appended, and the headers the muxer would have rewritten on a clean
+ * close are filled in. Only the headers and the index are read, so this
+ * takes seconds for hours of recording. The cues seek entry is written
+ * last, an interrupted repair can simply be run again.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "gstrecordindex.h"
+
+#define REINDEX_HEAD_SIZE (4 * 1024 * 1024)     /* max bytes of headers */
+
+#define ID_EBML 0x1A45DFA3
+#define ID_VOID 0xEC
+#define ID_SEEKHEAD 0x114D9B74
+#define ID_SEEKENTRY 0x4DBB
+#define ID_SEEKID 0x53AB
+#define ID_SEEKPOSITION 0x53AC
+#define ID_INFO 0x1549A966
+#define ID_TIMECODESCALE 0x2AD7B1
+#define ID_DURATION 0x4489
+#define ID_TRACKS 0x1654AE6B
+#define ID_TRACKENTRY 0xAE
+#define ID_TRACKNUMBER 0xD7
+#define ID_TRACKTYPE 0x83
+#define ID_CLUSTERTIMECODE 0xE7
+#define ID_CUES 0x1C53BB6B
+#define ID_CUEPOINT 0xBB
+#define ID_CUETIME 0xB3
+#define ID_CUETRACKPOSITIONS 0xB7
+#define ID_CUETRACK 0xF7
+#define ID_CUECLUSTERPOSITION 0xF1
+#define ID_CHAPTERS 0x1043A770
+#define ID_EDITIONENTRY 0x45B9
+#define ID_CHAPTERATOM 0xB6
+#define ID_CHAPTERUID 0x73C4
+#define ID_CHAPTERTIMESTART 0x91
+#define ID_CHAPTERDISPLAY 0x80
+#define ID_CHAPSTRING 0x85
+
+/**
+ * @brief A field of the headers, to be filled in.
+ */
+typedef struct _Slot
+{
+  guint64 offset;               /*!< the file offset of the value */
+  guint width;                  /*!< the bytes of the value */
+} Slot;
+
+/**
+ * @brief A seek head entry of the recording.
+ */
+typedef struct _SeekEntry
+{
+  guint64 id;                   /*!< the element it points to */
+  guint64 offset;               /*!< the file offset of the entry */
+  guint64 size;                 /*!< the size of the entry */
+  Slot position;                /*!< the position */
+  gboolean unset;               /*!< the position was never written */
+} SeekEntry;
+
+/**
+ * @brief A cluster in the index.
+ */
+typedef struct _Cluster
+{
+  guint64 offset;               /*!< the file offset */
+  guint64 timecode;             /*!< the cluster timecode */
+  gint key;                     /*!< the block to cue, or -1 */
+} Cluster;
+
+/**
+ * @brief A block in the index.
+ */
+typedef struct _Block
+{
+  guint64 end;                  /*!< the end of the block in the file */
+  guint track;                  /*!< the track number */
+  gint timecode;                /*!< the timecode in the cluster */
+  gint64 pts;                   /*!< the running time, or -1 */
+  guint cluster;                /*!< the cluster of the block */
+} Block;
+
+/**
+ * @brief An event in the index.
+ */
+typedef struct _Event
+{
+  gint64 pts;                   /*!< the running time */
+  gchar *text;                  /*!< what happened */
+} Event;
+
+/**
+ * @brief The recording being repaired.
+ */
+typedef struct _Recording
+{
+  gint fd;                      /*!< the file */
+  guint64 size;                 /*!< the file size */
+  guint64 segment;              /*!< the offset of the segment data */
+  Slot segment_size;            /*!< the segment size */
+  Slot duration;                /*!< the duration in the info */
+  guint64 timecode_scale;       /*!< ns per timecode */
+  guint video_track;            /*!< the video track number, 0 if none */
+  GArray *seek;                 /*!< the SeekEntry of the seek head */
+  GArray *clusters;             /*!< the Cluster in the index */
+  GArray *blocks;               /*!< the Block in the index */
+  GArray *events;               /*!< the Event in the index */
+  guint64 data_end;             /*!< the end of the last complete block */
+} Recording;
+
+static gchar **arguments = NULL;
+
+static GOptionEntry entries[] = {
+  {G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &arguments,
+      NULL, "RECORDING [INDEX]"},
+  {NULL}
+};
+
+static gboolean
+read_all (gint fd, guint8 * data, gsize size, guint64 offset)
+{
+  while (0 < size) {
+    gssize n = pread (fd, data, size, offset);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return FALSE;
+    data += n;
+    size -= n;
+    offset += n;
+  }
+  return TRUE;
+}
+
+static gboolean
+write_all (gint fd, const guint8 * data, gsize size, guint64 offset)
+{
+  while (0 < size) {
+    gssize n = pwrite (fd, data, size, offset);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return FALSE;
+    data += n;
+    size -= n;
+    offset += n;
+  }
+  return TRUE;
+}
+
+/**
+ * @brief Read an EBML variable size integer.
+ * @return The width of the integer, 0 if it's invalid or incomplete.
+ */
+static guint
+read_vint (const guint8 * data, gsize size, guint64 * value,
+    gboolean marker, gboolean * unknown)
+{
+  guint width = 1, n;
+  guint8 mask = 0x80;
+
+  if (size == 0)
+    return 0;
+  while (width <= 8 && !(data[0] & mask)) {
+    width += 1;
+    mask >>= 1;
+  }
+  if (8 < width || size < width)
+    return 0;
+
+  *value = marker ? data[0] : data[0] & (mask - 1);
+  for (n = 1; n < width; ++n)
+    *value = (*value << 8) | data[n];
+  if (unknown)
+    *unknown = !marker && *value == (G_GUINT64_CONSTANT (1) << (7 * width)) - 1;
+  return width;
+}
+
+/**
+ * @brief Read the head of an element.
+ * @return The size of the head, 0 if it's invalid or incomplete.
+ */
+static guint
+read_head (const guint8 * data, gsize size, guint64 * id, guint64 * len,
+    gboolean * unknown)
+{
+  guint n, m;
+
+  if (!(n = read_vint (data, size, id, TRUE, NULL)) || 4 < n)
+    return 0;
+  if (!(m = read_vint (data + n, size - n, len, FALSE, unknown)))
+    return 0;
+  return n + m;
+}
+
+static guint64
+read_uint (const guint8 * data, guint64 len)
+{
+  guint64 value = 0;
+  while (len--)
+    value = (value << 8) | *data++;
+  return value;
+}
+
+/**
+ * @brief Parse the top level elements of the segment, up to the first
+ * cluster.
+ */
+static gboolean
+parse_headers (Recording * rec)
+{
+  gsize size = MIN (rec->size, REINDEX_HEAD_SIZE);
+  guint8 *data = g_malloc (size);
+  guint64 id, len, pos = 0;
+  gboolean unknown, ok = FALSE;
+  guint head;
+
+  if (!read_all (rec->fd, data, size, 0))
+    goto end;
+
+  head = read_head (data, size, &id, &len, &unknown);
+  if (!head || id != ID_EBML || unknown)
+    goto end;
+  pos = head + len;
+
+  head = read_head (data + pos, size - pos, &id, &len, &unknown);
+  if (!head || id != GST_RECORD_INDEX_ID_SEGMENT)
+    goto end;
+  rec->segment_size.width = head - read_vint (data + pos, size - pos, &id,
+      TRUE, NULL);
+  rec->segment_size.offset = pos + head - rec->segment_size.width;
+  rec->segment = pos += head;
+
+  while ((head = read_head (data + pos, size - pos, &id, &len, &unknown))) {
+    guint64 start = pos + head, end = start + len, child, n;
+    guint8 *p;
+
+    if (id == GST_RECORD_INDEX_ID_CLUSTER) {
+      ok = TRUE;
+      break;
+    }
+    if (unknown || size < end)
+      break;
+
+    for (child = start; child < end; child += n + len) {
+      guint64 cid, sub, m, clen;
+
+      if (id != ID_SEEKHEAD && id != ID_INFO && id != ID_TRACKS)
+        break;
+      n = read_head (data + child, end - child, &cid, &len, &unknown);
+      if (!n || unknown || end < child + n + len)
+        break;
+      p = data + child + n;
+
+      if (cid == ID_SEEKENTRY) {
+        SeekEntry entry = { 0 };
+        entry.offset = child;
+        entry.size = n + len;
+        for (sub = 0; sub < len; sub += m + clen) {
+          m = read_head (p + sub, len - sub, &cid, &clen, &unknown);
+          if (!m || unknown)
+            break;
+          if (cid == ID_SEEKID) {
+            entry.id = read_uint (p + sub + m, clen);
+          } else if (cid == ID_SEEKPOSITION) {
+            guint64 i;
+            entry.position.offset = child + n + sub + m;
+            entry.position.width = clen;
+            entry.unset = TRUE;
+            for (i = 0; i < clen; ++i)
+              entry.unset = entry.unset && p[sub + m + i] == 0xFF;
+          }
+        }
+        g_array_append_val (rec->seek, entry);
+      } else if (cid == ID_TIMECODESCALE) {
+        rec->timecode_scale = read_uint (p, len);
+      } else if (cid == ID_DURATION) {
+        rec->duration.offset = child + n;
+        rec->duration.width = len;
+      } else if (cid == ID_TRACKENTRY) {
+        guint64 number = 0, type = 0;
+        for (sub = 0; sub < len; sub += m + clen) {
+          m = read_head (p + sub, len - sub, &cid, &clen, &unknown);
+          if (!m || unknown)
+            break;
+          if (cid == ID_TRACKNUMBER)
+            number = read_uint (p + sub + m, clen);
+          else if (cid == ID_TRACKTYPE)
+            type = read_uint (p + sub + m, clen);
+        }
+        if (type == 1 && rec->video_track == 0)
+          rec->video_track = number;
+      }
+    }
+    pos = end;
+  }
+
+end:
+  g_free (data);
+  return ok;
+}
+
+static SeekEntry *
+find_seek_entry (Recording * rec, guint64 id)
+{
+  guint n;
+  for (n = 0; n < rec->seek->len; ++n) {
+    SeekEntry *entry = &g_array_index (rec->seek, SeekEntry, n);
+    if (entry->id == id)
+      return entry;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Read the index, up to the last block complete in the file.
+ */
+static gboolean
+parse_index (Recording * rec, const gchar * path)
+{
+  gchar *contents = NULL, **lines, *torn;
+  gsize length;
+  GError *error = NULL;
+  guint n;
+
+  if (!g_file_get_contents (path, &contents, &length, &error)) {
+    g_printerr ("%s\n", error->message);
+    g_error_free (error);
+    return FALSE;
+  }
+
+  // The last line may have been cut short by the crash
+  torn = strrchr (contents, '\n');
+  if (torn)
+    torn[1] = '\0';
+  else
+    contents[0] = '\0';
+
+  lines = g_strsplit (contents, "\n", -1);
+  g_free (contents);
+
+  if (!lines[0] || !g_str_has_prefix (lines[0], GST_RECORD_INDEX_MAGIC " ")
+      || atoi (lines[0] + strlen (GST_RECORD_INDEX_MAGIC)) !=
+      GST_RECORD_INDEX_VERSION) {
+    g_printerr ("%s: not a recording index\n", path);
+    g_strfreev (lines);
+    return FALSE;
+  }
+
+  for (n = 1; lines[n] && lines[n][0]; ++n) {
+    gchar **fields = g_strsplit (lines[n], " ", 3);
+    guint64 offset, end;
+    gchar key;
+
+    if (!fields[0] || !fields[1]) {
+      g_strfreev (fields);
+      continue;
+    }
+
+    if (fields[0][0] == 'C') {
+      Cluster cluster = { 0 };
+      cluster.offset = g_ascii_strtoull (fields[1], NULL, 10);
+      cluster.key = -1;
+      if (rec->size <= cluster.offset) {
+        g_strfreev (fields);
+        break;
+      }
+      g_array_append_val (rec->clusters, cluster);
+    } else if (fields[0][0] == 'B' && rec->clusters->len) {
+      Block block = { 0 };
+      Cluster *cluster;
+      if (sscanf (lines[n], "B %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT
+              " %u %d %" G_GINT64_FORMAT " %c", &offset, &end, &block.track,
+              &block.timecode, &block.pts, &key) != 6) {
+        g_strfreev (fields);
+        continue;
+      }
+      if (rec->size < end) {
+        g_strfreev (fields);
+        break;
+      }
+      block.end = end;
+      block.cluster = rec->clusters->len - 1;
+      cluster = &g_array_index (rec->clusters, Cluster, block.cluster);
+      if (key == 'K' && cluster->key < 0 && (rec->video_track == 0
+              || block.track == rec->video_track))
+        cluster->key = rec->blocks->len;
+      g_array_append_val (rec->blocks, block);
+      rec->data_end = end;
+    } else if (fields[0][0] == 'E' && fields[2]) {
+      Event event = { 0 };
+      event.pts = g_ascii_strtoll (fields[1], NULL, 10);
+      event.text = g_strdup (fields[2]);
+      if (0 <= event.pts)
+        g_array_append_val (rec->events, event);
+      else
+        g_free (event.text);
+    }
+    g_strfreev (fields);
+  }
+  g_strfreev (lines);
+
+  // Drop the clusters with no complete block
+  while (rec->clusters->len && rec->data_end <= g_array_index (rec->clusters,
+          Cluster, rec->clusters->len - 1).offset)
+    g_array_set_size (rec->clusters, rec->clusters->len - 1);
+
+  return rec->clusters->len != 0;
+}
+
+/**
+ * @brief Read the timecode of each cluster, and give clusters still of
+ * unknown size their size.
+ */
+static gboolean
+fix_clusters (Recording * rec)
+{
+  guint n;
+
+  for (n = 0; n < rec->clusters->len; ++n) {
+    Cluster *cluster = &g_array_index (rec->clusters, Cluster, n);
+    guint64 end = rec->data_end, id, len, pos, value;
+    guint8 data[64];
+    gsize size = MIN (sizeof (data), rec->size - cluster->offset);
+    gboolean unknown, found = FALSE;
+    guint head, width;
+
+    if (n + 1 < rec->clusters->len)
+      end = g_array_index (rec->clusters, Cluster, n + 1).offset;
+
+    if (!read_all (rec->fd, data, size, cluster->offset))
+      return FALSE;
+    head = read_head (data, size, &id, &len, &unknown);
+    if (!head || id != GST_RECORD_INDEX_ID_CLUSTER)
+      return FALSE;
+
+    for (pos = head; !found && pos < size;) {
+      guint64 cid, clen;
+      guint m = read_head (data + pos, size - pos, &cid, &clen, NULL);
+      if (!m || size < pos + m + clen)
+        break;
+      if (cid == ID_CLUSTERTIMECODE) {
+        cluster->timecode = read_uint (data + pos + m, clen);
+        found = TRUE;
+      }
+      pos += m + clen;
+    }
+    if (!found)
+      return FALSE;
+
+    if (unknown) {
+      width = head - 4;
+      value = end - cluster->offset - head;
+      if (value >= (G_GUINT64_CONSTANT (1) << (7 * width)) - 1)
+        return FALSE;
+      value |= G_GUINT64_CONSTANT (1) << (7 * width);
+      for (pos = 0; pos < width; ++pos)
+        data[4 + pos] = value >> (8 * (width - pos - 1));
+      if (!write_all (rec->fd, data + 4, width, cluster->offset + 4))
+        return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+static void
+put_id (GByteArray * out, guint64 id)
+{
+  guint8 bytes[4];
+  guint n = 4;
+  while (id) {
+    bytes[--n] = id & 0xFF;
+    id >>= 8;
+  }
+  g_byte_array_append (out, bytes + n, 4 - n);
+}
+
+static void
+put_element (GByteArray * out, guint64 id, const guint8 * data, gsize size)
+{
+  guint8 bytes[8];
+  guint width = 1, n;
+
+  while (size >= (G_GUINT64_CONSTANT (1) << (7 * width)) - 1)
+    width += 1;
+  for (n = 0; n < width; ++n)
+    bytes[n] = size >> (8 * (width - n - 1));
+  bytes[0] |= 0x80 >> (width - 1);
+
+  put_id (out, id);
+  g_byte_array_append (out, bytes, width);
+  g_byte_array_append (out, data, size);
+}
+
+static void
+put_master (GByteArray * out, guint64 id, GByteArray * children)
+{
+  put_element (out, id, children->data, children->len);
+  g_byte_array_set_size (children, 0);
+}
+
+static void
+put_uint (GByteArray * out, guint64 id, guint64 value)
+{
+  guint8 bytes[8];
+  guint n = 8;
+  do {
+    bytes[--n] = value & 0xFF;
+    value >>= 8;
+  } while (value);
+  put_element (out, id, bytes + n, 8 - n);
+}
+
+static guint64
+block_time (Recording * rec, Block * block)
+{
+  Cluster *cluster = &g_array_index (rec->clusters, Cluster, block->cluster);
+  gint64 timecode = (gint64) cluster->timecode + block->timecode;
+  return MAX (timecode, 0);
+}
+
+/**
+ * @brief One cue per cluster, at its first video key frame.
+ */
+static void
+make_cues (Recording * rec, GByteArray * out)
+{
+  GByteArray *cues = g_byte_array_new ();
+  GByteArray *point = g_byte_array_new ();
+  GByteArray *positions = g_byte_array_new ();
+  guint n;
+
+  for (n = 0; n < rec->clusters->len; ++n) {
+    Cluster *cluster = &g_array_index (rec->clusters, Cluster, n);
+    Block *block;
+
+    if (cluster->key < 0)
+      continue;
+    block = &g_array_index (rec->blocks, Block, cluster->key);
+
+    put_uint (positions, ID_CUETRACK, block->track);
+    put_uint (positions, ID_CUECLUSTERPOSITION,
+        cluster->offset - rec->segment);
+    put_uint (point, ID_CUETIME, block_time (rec, block));
+    put_master (point, ID_CUETRACKPOSITIONS, positions);
+    put_master (cues, ID_CUEPOINT, point);
+  }
+  put_master (out, ID_CUES, cues);
+
+  g_byte_array_unref (positions);
+  g_byte_array_unref (point);
+  g_byte_array_unref (cues);
+}
+
+/**
+ * @brief One chapter per event, timed by the block closest before it.
+ */
+static void
+make_chapters (Recording * rec, GByteArray * out)
+{
+  GByteArray *edition = g_byte_array_new ();
+  GByteArray *atom = g_byte_array_new ();
+  GByteArray *display = g_byte_array_new ();
+  GByteArray *chapters = g_byte_array_new ();
+  Block *last = NULL;
+  guint n, b = 0;
+
+  for (n = 0; n < rec->events->len; ++n) {
+    Event *event = &g_array_index (rec->events, Event, n);
+    gint64 time;
+
+    for (; b < rec->blocks->len; ++b) {
+      Block *block = &g_array_index (rec->blocks, Block, b);
+      if (block->pts < 0)
+        continue;
+      if (last && event->pts < block->pts)
+        break;
+      last = block;
+    }
+    if (last == NULL)
+      break;
+
+    time = block_time (rec, last) * rec->timecode_scale
+        + (event->pts - last->pts);
+    put_uint (atom, ID_CHAPTERUID, n + 1);
+    put_uint (atom, ID_CHAPTERTIMESTART, MAX (time, 0));
+    put_element (display, ID_CHAPSTRING, (guint8 *) event->text,
+        strlen (event->text));
+    put_master (atom, ID_CHAPTERDISPLAY, display);
+    put_master (edition, ID_CHAPTERATOM, atom);
+  }
+  put_master (chapters, ID_EDITIONENTRY, edition);
+  put_master (out, ID_CHAPTERS, chapters);
+
+  g_byte_array_unref (chapters);
+  g_byte_array_unref (display);
+  g_byte_array_unref (atom);
+  g_byte_array_unref (edition);
+}
+
+static gboolean
+fill_slot (Recording * rec, Slot * slot, guint64 value)
+{
+  guint8 bytes[8];
+  guint n;
+
+  if (slot->width == 0 || 8 < slot->width)
+    return FALSE;
+  if (slot->width < 8 && (value >> (8 * slot->width)))
+    return FALSE;
+  for (n = 0; n < slot->width; ++n)
+    bytes[n] = value >> (8 * (slot->width - n - 1));
+  return write_all (rec->fd, bytes, slot->width, slot->offset);
+}
+
+/**
+ * @brief Repair the recording, see the file comment.
+ */
+static gboolean
+repair (Recording * rec)
+{
+  SeekEntry *cues_entry = find_seek_entry (rec, ID_CUES);
+  SeekEntry *chapters_entry = find_seek_entry (rec, ID_CHAPTERS);
+  GByteArray *out = g_byte_array_new ();
+  guint64 cues, chapters = 0, end, duration = 0;
+  guint n;
+  gboolean ok = FALSE;
+
+  cues = rec->data_end;
+  make_cues (rec, out);
+  if (chapters_entry && rec->events->len) {
+    chapters = cues + out->len;
+    make_chapters (rec, out);
+  }
+  end = cues + out->len;
+
+  if (ftruncate (rec->fd, rec->data_end) < 0
+      || !write_all (rec->fd, out->data, out->len, cues)
+      || fdatasync (rec->fd) < 0)
+    goto end;
+
+  for (n = 0; n < rec->blocks->len; ++n) {
+    Block *block = &g_array_index (rec->blocks, Block, n);
+    duration = MAX (duration, block_time (rec, block));
+  }
+  if (rec->duration.width == 8) {
+    union
+    {
+      gdouble d;
+      guint64 u;
+    } value;
+    value.d = duration;
+    fill_slot (rec, &rec->duration, value.u);
+  } else if (rec->duration.width == 4) {
+    union
+    {
+      gfloat f;
+      guint32 u;
+    } value;
+    value.f = duration;
+    fill_slot (rec, &rec->duration, value.u);
+  }
+
+  if (rec->segment_size.width < 8 && (end - rec->segment) >> (7 *
+          rec->segment_size.width))
+    goto end;
+  if (!fill_slot (rec, &rec->segment_size, (end - rec->segment)
+          | G_GUINT64_CONSTANT (1) << (7 * rec->segment_size.width)))
+    goto end;
+
+  // Void the entries of what the recording doesn't have
+  for (n = 0; n < rec->seek->len; ++n) {
+    SeekEntry *entry = &g_array_index (rec->seek, SeekEntry, n);
+    guint8 bytes[2] = { ID_VOID, 0x80 | (entry->size - 2) };
+
+    if (!entry->unset || entry == cues_entry || (entry == chapters_entry
+            && chapters))
+      continue;
+    if (2 < entry->size && entry->size - 2 < 0x7F) {
+      if (!write_all (rec->fd, bytes, 2, entry->offset))
+        goto end;
+    }
+  }
+  if (chapters && !fill_slot (rec, &chapters_entry->position,
+          chapters - rec->segment))
+    goto end;
+  if (fdatasync (rec->fd) < 0)
+    goto end;
+
+  // Last, the recording is complete from here on
+  if (!fill_slot (rec, &cues_entry->position, cues - rec->segment)
+      || fdatasync (rec->fd) < 0)
+    goto end;
+
+  g_print ("%u clusters, %u blocks, %u events, %" G_GUINT64_FORMAT
+      " bytes cut off\n", rec->clusters->len, rec->blocks->len,
+      chapters ? rec->events->len : 0, rec->size - rec->data_end);
+  ok = TRUE;
+
+end:
+  g_byte_array_unref (out);
+  return ok;
+}
+
+int
+main (int argc, char *argv[])
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  Recording rec = { 0 };
+  SeekEntry *cues_entry;
+  gboolean complete;
+  struct stat st;
+  gchar *index;
+  guint n;
+  int status = 1;
+
+  context = g_option_context_new ("- make a recording seekable again");
+  g_option_context_add_main_entries (context, entries, "gst-switch-reindex");
+  if (!g_option_context_parse (context, &argc, &argv, &error)) {
+    g_print ("option parsing failed: %s\n", error->message);
+    exit (1);
+  }
+  g_option_context_free (context);
+
+  if (!arguments || !arguments[0] || (arguments[1] && arguments[2])) {
+    g_print ("usage: gst-switch-reindex RECORDING [INDEX]\n");
+    exit (1);
+  }
+  index = arguments[1] ? g_strdup (arguments[1])
+      : g_strconcat (arguments[0], GST_RECORD_INDEX_SUFFIX, NULL);
+
+  rec.fd = open (arguments[0], O_RDWR | O_CLOEXEC);
+  if (rec.fd < 0 || fstat (rec.fd, &st) < 0) {
+    g_printerr ("%s: %s\n", arguments[0], g_strerror (errno));
+    goto end;
+  }
+  rec.size = st.st_size;
+  rec.timecode_scale = 1000000;
+  rec.seek = g_array_new (FALSE, TRUE, sizeof (SeekEntry));
+  rec.clusters = g_array_new (FALSE, TRUE, sizeof (Cluster));
+  rec.blocks = g_array_new (FALSE, TRUE, sizeof (Block));
+  rec.events = g_array_new (FALSE, TRUE, sizeof (Event));
+
+  if (!parse_headers (&rec)) {
+    g_printerr ("%s: not a matroska recording\n", arguments[0]);
+    goto end;
+  }
+
+  // A clean close fills in the seek head, the cues position last
+  cues_entry = find_seek_entry (&rec, ID_CUES);
+  complete = cues_entry == NULL;
+  for (n = 0; cues_entry == NULL && n < rec.seek->len; ++n)
+    complete = complete && !g_array_index (rec.seek, SeekEntry, n).unset;
+  if (cues_entry && !cues_entry->unset)
+    complete = TRUE;
+  if (rec.seek->len == 0) {
+    g_printerr ("%s: no seek head to repair\n", arguments[0]);
+    goto end;
+  }
+  if (complete) {
+    g_print ("%s: already seekable\n", arguments[0]);
+    status = 0;
+    goto end;
+  }
+
+  if (!parse_index (&rec, index)) {
+    g_printerr ("%s: no complete cluster in %s\n", arguments[0], index);
+    goto end;
+  }
+
+  if (!fix_clusters (&rec) || !repair (&rec)) {
+    g_printerr ("%s: can't repair: %s\n", arguments[0], g_strerror (errno));
+    goto end;
+  }
+  g_print ("%s: repaired\n", arguments[0]);
+  status = 0;
+
+end:
+  if (0 <= rec.fd)
+    close (rec.fd);
+  if (rec.events) {
+    for (n = 0; n < rec.events->len; ++n)
+      g_free (g_array_index (rec.events, Event, n).text);
+    g_array_unref (rec.events);
+    g_array_unref (rec.blocks);
+    g_array_unref (rec.clusters);
+    g_array_unref (rec.seek);
+  }
+  g_strfreev (arguments);
+  g_free (index);
+  return status;
+}
@@ -28,7 +28,12 @@
 #include <stdlib.h>
 #include "gstswitchserver.h"
 #include "gstrecorder.h"
+#include "gstencoder.h"
+#include "gstiso.h"
+#include "gstreplay.h"
 #include "gstcase.h"
+#include "gstmeter.h"
+#include "gstaudioengine.h"
 #include "./gio/gsocketinputstream.h"
 #include "../logutils.h"
 
@@ -65,6 +70,16 @@
 #define GST_SWITCH_SERVER_UNLOCK_PIP(srv) (g_mutex_unlock (&(srv)->pip_lock))
 #define GST_SWITCH_SERVER_LOCK_RECORDER(srv) (g_mutex_lock (&(srv)->recorder_lock))
 #define GST_SWITCH_SERVER_UNLOCK_RECORDER(srv) (g_mutex_unlock (&(srv)->recorder_lock))
+#define GST_SWITCH_SERVER_LOCK_ENCODERS(srv) (g_mutex_lock (&(srv)->encoders_lock))
+#define GST_SWITCH_SERVER_UNLOCK_ENCODERS(srv) (g_mutex_unlock (&(srv)->encoders_lock))
+#define GST_SWITCH_SERVER_LOCK_ISOS(srv) (g_mutex_lock (&(srv)->isos_lock))
+#define GST_SWITCH_SERVER_UNLOCK_ISOS(srv) (g_mutex_unlock (&(srv)->isos_lock))
+#define GST_SWITCH_SERVER_LOCK_REPLAYS(srv) (g_mutex_lock (&(srv)->replays_lock))
+#define GST_SWITCH_SERVER_UNLOCK_REPLAYS(srv) (g_mutex_unlock (&(srv)->replays_lock))
+#define GST_SWITCH_SERVER_LOCK_MULTIVIEW(srv) (g_mutex_lock (&(srv)->multiview_lock))
+#define GST_SWITCH_SERVER_UNLOCK_MULTIVIEW(srv) (g_mutex_unlock (&(srv)->multiview_lock))
+#define GST_SWITCH_SERVER_LOCK_MIXER(srv) (g_mutex_lock (&(srv)->mixer_lock))
+#define GST_SWITCH_SERVER_UNLOCK_MIXER(srv) (g_mutex_unlock (&(srv)->mixer_lock))
 #define GST_SWITCH_SERVER_LOCK_CLOCK(srv) (g_mutex_lock (&(srv)->clock_lock))
 #define GST_SWITCH_SERVER_UNLOCK_CLOCK(srv) (g_mutex_unlock (&(srv)->clock_lock))
 
@@ -78,7 +93,18 @@ GstSwitchServerOpts opts = {
   GST_SWITCH_SERVER_DEFAULT_AUDIO_ACCEPTOR_PORT,
 //FALSE,
   FALSE,
-  NULL, NULL
+  NULL, NULL, NULL,
+  GST_WORKER_CLIENT_DROP_TO_NEWEST,
+  GST_WORKER_DEFAULT_CLIENT_LAG,
+  0, 0,
+  NULL, GST_RECORDER_DEFAULT_QUALITY, 0, GST_RECORDER_DEFAULT_BUFFER,
+  FALSE, NULL, 0,
+  0, GST_REPLAY_DEFAULT_QUALITY,
+  FALSE, GST_METER_DEFAULT_INTERVAL, FALSE,
+  0, FALSE,
+  GST_WORKER_DEFAULT_POOL_SIZE, GST_WORKER_DEFAULT_STATE_TIMEOUT,
+  GST_WORKER_DEFAULT_WATCHDOG, GST_SWITCH_SERVER_DEFAULT_STATS_INTERVAL,
+  FALSE, 0, NULL
 };
 
 gboolean verbose = FALSE;
@@ -146,6 +172,18 @@ gparse_video_format (gchar * name, gchar * value, gpointer data,
   return TRUE;
 }
 
+static gboolean
+gparse_client_policy (gchar * name, gchar * value, gpointer data,
+    GError ** error)
+{
+  if (!gst_worker_parse_client_policy (value, &opts.client_policy)) {
+    g_set_error (error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "Unknown client policy: %s", value);
+    return FALSE;
+  }
+  return TRUE;
+}
+
 static gboolean caps_dumped = FALSE;
 
 /* gst_switch_server_getcaps:
@@ -213,6 +251,63 @@ static GOptionEntry entries[] = {
   {"record", 'r', G_OPTION_FLAG_OPTIONAL_ARG, G_OPTION_ARG_CALLBACK,
         (gpointer) gparse_record_filename,
       "Enable recorder and record into the specified FILENAME"},
+  {"record-max-size", 0, 0, G_OPTION_ARG_INT, &opts.record_max_size,
+      "Start a new recording file every NUM megabytes", "NUM"},
+  {"record-max-time", 0, 0, G_OPTION_ARG_INT, &opts.record_max_time,
+      "Start a new recording file every NUM seconds", "NUM"},
+  {"record-codec", 0, 0, G_OPTION_ARG_STRING, &opts.record_codec,
+      "Record with CODEC: mjpeg (default), h264, ffv1 (lossless) or raw",
+      "CODEC"},
+  {"record-quality", 0, 0, G_OPTION_ARG_INT, &opts.record_quality,
+        "Quality of mjpeg recordings, 0-100 (default "
+        G_STRINGIFY (GST_RECORDER_DEFAULT_QUALITY) ")",
+      "NUM"},
+  {"record-threads", 0, 0, G_OPTION_ARG_INT, &opts.record_threads,
+      "Encoder threads of mjpeg and h264 recordings (default 0, automatic)",
+      "NUM"},
+  {"record-buffer", 0, 0, G_OPTION_ARG_INT, &opts.record_buffer,
+        "Buffer NUM MB of recording in memory while the disk is slow "
+        "(default " G_STRINGIFY (GST_RECORDER_DEFAULT_BUFFER) ")",
+      "NUM"},
+  {"record-iso", 0, 0, G_OPTION_ARG_NONE, &opts.record_iso,
+      "Also record every input into its own file, next to the -r recording",
+      NULL},
+  {"iso-codec", 0, 0, G_OPTION_ARG_STRING, &opts.iso_codec,
+      "Record the inputs with CODEC: mjpeg (default), h264, ffv1 or raw",
+      "CODEC"},
+  {"iso-threads", 0, 0, G_OPTION_ARG_INT, &opts.iso_threads,
+        "Frames all input recordings may encode at once "
+        "(default 0, half the CPUs)",
+      "NUM"},
+  {"replay", 0, 0, G_OPTION_ARG_INT, &opts.replay_seconds,
+        "Keep the last SECONDS of every input and the program in memory "
+        "for instant replays (default 0, none)",
+      "SECONDS"},
+  {"replay-quality", 0, 0, G_OPTION_ARG_INT, &opts.replay_quality,
+        "JPEG quality of the instant replays, 0-100 (default "
+        G_STRINGIFY (GST_REPLAY_DEFAULT_QUALITY) ")",
+      "NUM"},
+  {"audio-mix", 0, 0, G_OPTION_ARG_NONE, &opts.audio_mix,
+        "Mix all audio inputs with their own gain, mute and pan, instead of "
+        "switching to one",
+      NULL},
+  {"meter-interval", 0, 0, G_OPTION_ARG_INT, &opts.meter_interval,
+        "Publish the audio levels every MSEC (default "
+        G_STRINGIFY (GST_METER_DEFAULT_INTERVAL) ", 0 for none)",
+      "MSEC"},
+  {"audio-follow-video", 0, 0, G_OPTION_ARG_NONE, &opts.audio_follow_video,
+        "Crossfade the audio mix to the audio paired with the video on "
+        "channel A (implies --audio-mix)",
+      NULL},
+  {"audio-period", 0, 0, G_OPTION_ARG_INT, &opts.audio_period,
+        "Run the audio engine on MSEC periods, "
+        G_STRINGIFY (GST_AUDIO_ENGINE_MIN_PERIOD) "-"
+        G_STRINGIFY (GST_AUDIO_ENGINE_MAX_PERIOD)
+        " (default 0, the default buffering)",
+      "MSEC"},
+  {"audio-realtime", 0, 0, G_OPTION_ARG_NONE, &opts.audio_realtime,
+        "Run the audio threads with realtime (SCHED_FIFO) priority",
+      NULL},
   {"low-resolution", 'l', 0, G_OPTION_ARG_NONE, &opts.low_res,
       "Enable low resolution mode (-f overrides)"},
   {"video-format", 'f', 0, G_OPTION_ARG_CALLBACK,
@@ -225,6 +320,45 @@ static GOptionEntry entries[] = {
   {"controller-address", 'c', 0, G_OPTION_ARG_STRING, &opts.controller_address,
       "Specify DBus-Address for remote control, defaults to "
         GST_SWITCH_SERVER_DEFAULT_CONTROLLER_ADDRESS ".", "ADDRESS"},
+  {"client-policy", 0, 0, G_OPTION_ARG_CALLBACK,
+        (gpointer) gparse_client_policy,
+        "What to do with clients falling behind: newest (skip to the newest "
+        "frame, default), keyframe (skip to the latest keyframe) or "
+      "disconnect", "POLICY"},
+  {"client-lag", 0, 0, G_OPTION_ARG_INT, &opts.client_lag,
+        "How far behind a client may fall before the client policy applies "
+        "(default " G_STRINGIFY (GST_WORKER_DEFAULT_CLIENT_LAG) " msec)",
+      "MSEC"},
+  {"pool-size", 0, 0, G_OPTION_ARG_INT, &opts.pool_size,
+        "Keep NUM stopped pipelines of every switched shape for reuse "
+        "(default " G_STRINGIFY (GST_WORKER_DEFAULT_POOL_SIZE) ", 0 for none)",
+      "NUM"},
+  {"state-timeout", 0, 0, G_OPTION_ARG_INT, &opts.state_timeout,
+        "Stop a pipeline taking longer than MSEC for a state change, or for "
+        "the EOS of a clean stop (default "
+        G_STRINGIFY (GST_WORKER_DEFAULT_STATE_TIMEOUT) ", 0 for no limit)",
+      "MSEC"},
+  {"watchdog", 0, 0, G_OPTION_ARG_INT, &opts.watchdog,
+        "Restart a live pipeline producing no buffers for MSEC (default "
+        G_STRINGIFY (GST_WORKER_DEFAULT_WATCHDOG) ", 0 for no watchdog)",
+      "MSEC"},
+  {"stats-interval", 0, 0, G_OPTION_ARG_INT, &opts.stats_interval,
+        "Publish the counters of all pipelines every MSEC (default "
+        G_STRINGIFY (GST_SWITCH_SERVER_DEFAULT_STATS_INTERVAL)
+        ", 0 for none)",
+      "MSEC"},
+  {"measure-latency", 0, 0, G_OPTION_ARG_NONE, &opts.measure_latency,
+        "Measure the latency of inputs stamped by latencystamp on the output "
+        "and the preview branches",
+      NULL},
+  {"metrics-port", 0, 0, G_OPTION_ARG_INT, &opts.metrics_port,
+        "Serve the metrics of the server to Prometheus over HTTP on PORT "
+        "(default 0 for none)",
+      "PORT"},
+  {"metrics-address", 0, 0, G_OPTION_ARG_STRING, &opts.metrics_address,
+        "Serve the metrics on ADDRESS (default "
+        GST_SWITCH_SERVER_DEFAULT_METRICS_ADDRESS ")",
+      "ADDRESS"},
   {NULL}
 };
 
@@ -238,6 +372,7 @@ gst_switch_server_parse_args (int argc, char *argv[])
 {
   GError *error = NULL;
   GOptionContext *context;
+  GstRecorderCodec codec;
 
   gst_init (NULL, NULL);
   context = g_option_context_new ("");
@@ -249,8 +384,78 @@ gst_switch_server_parse_args (int argc, char *argv[])
   } else if (argc > 1) {
     ERROR ("unknown option: %s", argv[1]);
     exit (1);
+  } else if (opts.client_lag <= 0) {
+    ERROR ("invalid client lag: %d", opts.client_lag);
+    exit (1);
+  } else if (opts.pool_size < 0) {
+    ERROR ("invalid pool size: %d", opts.pool_size);
+    exit (1);
+  } else if (opts.state_timeout < 0) {
+    ERROR ("invalid state timeout: %d msec", opts.state_timeout);
+    exit (1);
+  } else if (opts.watchdog < 0) {
+    ERROR ("invalid watchdog timeout: %d msec", opts.watchdog);
+    exit (1);
+  } else if (opts.record_max_size < 0 || opts.record_max_time < 0) {
+    ERROR ("invalid record limits: %d MB, %d s", opts.record_max_size,
+        opts.record_max_time);
+    exit (1);
+  } else if (opts.record_codec
+      && !gst_recorder_parse_codec (opts.record_codec, &codec)) {
+    ERROR ("unknown record codec: %s", opts.record_codec);
+    exit (1);
+  } else if (opts.record_quality < 0 || opts.record_quality > 100
+      || opts.record_threads < 0) {
+    ERROR ("invalid record quality or threads: %d, %d",
+        opts.record_quality, opts.record_threads);
+    exit (1);
+  } else if (opts.record_buffer <= 0) {
+    ERROR ("invalid record buffer: %d MB", opts.record_buffer);
+    exit (1);
+  } else if (opts.record_iso && !opts.record_filename) {
+    ERROR ("input recordings need a recording file (-r)");
+    exit (1);
+  } else if (opts.iso_codec
+      && !gst_recorder_parse_codec (opts.iso_codec, &codec)) {
+    ERROR ("unknown input record codec: %s", opts.iso_codec);
+    exit (1);
+  } else if (opts.iso_threads < 0) {
+    ERROR ("invalid input record threads: %d", opts.iso_threads);
+    exit (1);
+  } else if (opts.replay_seconds < 0
+      || opts.replay_seconds > GST_REPLAY_MAX_SECONDS
+      || opts.replay_quality < 0 || opts.replay_quality > 100) {
+    ERROR ("invalid replay length or quality: %d s, %d",
+        opts.replay_seconds, opts.replay_quality);
+    exit (1);
+  } else if (opts.meter_interval < 0) {
+    ERROR ("invalid meter interval: %d msec", opts.meter_interval);
+    exit (1);
+  } else if (opts.stats_interval < 0) {
+    ERROR ("invalid stats interval: %d msec", opts.stats_interval);
+    exit (1);
+  } else if (opts.metrics_port < 0 || opts.metrics_port > G_MAXUINT16) {
+    ERROR ("invalid metrics port: %d", opts.metrics_port);
+    exit (1);
+  } else if (opts.audio_period != 0
+      && (opts.audio_period < GST_AUDIO_ENGINE_MIN_PERIOD
+          || opts.audio_period > GST_AUDIO_ENGINE_MAX_PERIOD)) {
+    ERROR ("invalid audio period: %d msec", opts.audio_period);
+    exit (1);
   }
 
+  if (opts.audio_follow_video)
+    opts.audio_mix = TRUE;
+  if (!opts.metrics_address)
+    opts.metrics_address = g_strdup (GST_SWITCH_SERVER_DEFAULT_METRICS_ADDRESS);
+
+  gst_worker_set_client_policy (opts.client_policy, opts.client_lag);
+  gst_worker_set_pool_size (opts.pool_size);
+  gst_worker_set_state_timeout (opts.state_timeout);
+  gst_worker_set_watchdog (opts.watchdog);
+  gst_iso_set_threads (opts.iso_threads ? opts.iso_threads :
+      MAX (g_get_num_processors () / 2, 1));
+
   g_option_context_free (context);
 }
 
@@ -276,6 +481,13 @@ gst_switch_server_init (GstSwitchServer * srv)
   srv->main_loop = NULL;
   srv->cases = NULL;
   srv->composite = NULL;
+  srv->encoders = NULL;
+  srv->isos = NULL;
+  srv->replays = NULL;
+  srv->multiview = NULL;
+  srv->mixer = NULL;
+  srv->audio_pairs = g_hash_table_new (g_direct_hash, g_direct_equal);
+  gst_loudness_init (&srv->loudness);
   srv->alloc_port_count = 0;
 
   srv->pip_x = 0;
@@ -285,6 +497,11 @@ gst_switch_server_init (GstSwitchServer * srv)
 
   srv->clock = gst_system_clock_obtain ();
 
+  gst_switch_metrics_histogram_init (&srv->switch_latency);
+  gst_switch_metrics_histogram_init (&srv->mode_latency);
+  srv->mode_started = 0;
+  srv->metrics = NULL;
+
   g_mutex_init (&srv->main_loop_lock);
   g_mutex_init (&srv->video_acceptor_lock);
   g_mutex_init (&srv->audio_acceptor_lock);
@@ -293,6 +510,11 @@ gst_switch_server_init (GstSwitchServer * srv)
   g_mutex_init (&srv->alloc_port_lock);
   g_mutex_init (&srv->pip_lock);
   g_mutex_init (&srv->recorder_lock);
+  g_mutex_init (&srv->encoders_lock);
+  g_mutex_init (&srv->isos_lock);
+  g_mutex_init (&srv->replays_lock);
+  g_mutex_init (&srv->multiview_lock);
+  g_mutex_init (&srv->mixer_lock);
   g_mutex_init (&srv->clock_lock);
 }
 
@@ -310,6 +532,13 @@ gst_switch_server_finalize (GstSwitchServer * srv)
   g_free (srv->host);
   srv->host = NULL;
 
+  if (srv->metrics) {
+    g_socket_service_stop (srv->metrics);
+    g_socket_listener_close (G_SOCKET_LISTENER (srv->metrics));
+    g_object_unref (srv->metrics);
+    srv->metrics = NULL;
+  }
+
   if (srv->cancellable) {
     g_object_unref (srv->cancellable);
     srv->cancellable = NULL;
@@ -345,12 +574,44 @@ gst_switch_server_finalize (GstSwitchServer * srv)
     srv->cases = NULL;
   }
 
+  if (srv->encoders) {
+    g_list_free_full (srv->encoders, (GDestroyNotify) g_object_unref);
+    srv->encoders = NULL;
+  }
+
+  if (srv->isos) {
+    g_list_free_full (srv->isos, (GDestroyNotify) g_object_unref);
+    srv->isos = NULL;
+  }
+
+  if (srv->replays) {
+    g_list_free_full (srv->replays, (GDestroyNotify) g_object_unref);
+    srv->replays = NULL;
+  }
+
+  if (srv->multiview) {
+    g_object_unref (srv->multiview);
+    srv->multiview = NULL;
+  }
+
+  if (srv->mixer) {
+    g_object_unref (srv->mixer);
+    srv->mixer = NULL;
+  }
+
+  g_hash_table_destroy (srv->audio_pairs);
+  srv->audio_pairs = NULL;
+  gst_loudness_clear (&srv->loudness);
+
   if (srv->composite) {
     g_object_unref (srv->composite);
     srv->composite = NULL;
   }
 
+  gst_worker_pool_clear ();
   gst_object_unref (srv->clock);
+  gst_switch_metrics_histogram_clear (&srv->switch_latency);
+  gst_switch_metrics_histogram_clear (&srv->mode_latency);
 
   g_mutex_clear (&srv->main_loop_lock);
   g_mutex_clear (&srv->video_acceptor_lock);
@@ -360,6 +621,11 @@ gst_switch_server_finalize (GstSwitchServer * srv)
   g_mutex_clear (&srv->alloc_port_lock);
   g_mutex_clear (&srv->pip_lock);
   g_mutex_clear (&srv->recorder_lock);
+  g_mutex_clear (&srv->encoders_lock);
+  g_mutex_clear (&srv->isos_lock);
+  g_mutex_clear (&srv->replays_lock);
+  g_mutex_clear (&srv->multiview_lock);
+  g_mutex_clear (&srv->mixer_lock);
   g_mutex_clear (&srv->clock_lock);
 
   if (G_OBJECT_CLASS (parent_class)->finalize)
@@ -427,6 +693,17 @@ gst_switch_server_revoke_port (GstSwitchServer * srv, int port)
   g_mutex_unlock (&srv->alloc_port_lock);
 }
 
+static void gst_switch_server_update_multiview (GstSwitchServer * srv);
+static void gst_switch_server_update_mixer (GstSwitchServer * srv);
+static void gst_switch_server_follow_video (GstSwitchServer * srv);
+static void gst_switch_server_start_iso (GstSwitchServer * srv, gint port,
+    GstSwitchServeStreamType serve_type);
+static void gst_switch_server_stop_iso (GstSwitchServer * srv, gint port);
+static void gst_switch_server_new_iso_record (GstSwitchServer * srv);
+static void gst_switch_server_start_replay (GstSwitchServer * srv, gint port,
+    gboolean program);
+static void gst_switch_server_stop_replay (GstSwitchServer * srv, gint port);
+
 /**
  * gst_switch_server_end_case:
  *
@@ -445,7 +722,9 @@ gst_switch_server_end_case (GstCase * cas, GstSwitchServer * srv)
       srv->cases = g_list_remove (srv->cases, cas);
       INFO ("Removed %s (%p, %d) (%d cases left)", GST_WORKER (cas)->name,
           cas, G_OBJECT (cas)->ref_count, g_list_length (srv->cases));
-      caseport = cas->sink_port;
+      /* a thumbnail serves on a port of its own */
+      caseport = cas->type == GST_CASE_BRANCH_THUMBNAIL ?
+          cas->thumb_port : cas->sink_port;
       g_object_unref (cas);
       break;
     case GST_CASE_INPUT_AUDIO:
@@ -476,6 +755,17 @@ gst_switch_server_end_case (GstCase * cas, GstSwitchServer * srv)
   if (caseport)
     gst_switch_server_revoke_port (srv, caseport);
 
+  if (cas->type == GST_CASE_INPUT_VIDEO || cas->type == GST_CASE_INPUT_AUDIO)
+    gst_switch_server_stop_iso (srv, caseport);
+
+  if (cas->type == GST_CASE_INPUT_VIDEO)
+    gst_switch_server_stop_replay (srv, caseport);
+
+  if (cas->type == GST_CASE_INPUT_VIDEO)
+    gst_switch_server_update_multiview (srv);
+  else if (cas->type == GST_CASE_INPUT_AUDIO)
+    gst_switch_server_update_mixer (srv);
+
   switch (cas->type) {
     case GST_CASE_BRANCH_VIDEO_A:
     case GST_CASE_BRANCH_VIDEO_B:
@@ -603,40 +893,79 @@ gst_switch_server_suggest_case_type (GstSwitchServer * srv,
 }
 
 /**
- * gst_switch_server_serve:
+ * gst_switch_server_measure_loudness:
  *
- * The gst-switch-srv serving thread.
+ * Measure the loudness of a composite audio buffer, invoked from the
+ * streaming thread.
+ */
+static GstPadProbeReturn
+gst_switch_server_measure_loudness (GstPad * pad, GstPadProbeInfo * info,
+    GstSwitchServer * srv)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  GstMapInfo map;
+
+  if (gst_buffer_map (buffer, &map, GST_MAP_READ)) {
+    gst_loudness_process_s16 (&srv->loudness, (const gint16 *) map.data,
+        map.size / (sizeof (gint16) * GST_LOUDNESS_CHANNELS));
+    gst_buffer_unmap (buffer, &map);
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * gst_switch_server_prepare_loudness:
+ *
+ * Meter the loudness where the composite audio is written, which is the
+ * mixer with --audio-mix, the composite audio case otherwise.
  */
 static void
-gst_switch_server_serve (GstSwitchServer * srv, GSocket * client,
-    GstSwitchServeStreamType serve_type)
+gst_switch_server_prepare_loudness (GstWorker * worker, GstSwitchServer * srv)
 {
-  GSocketInputStreamX *stream =
-      G_SOCKET_INPUT_STREAM (g_object_new
-      (G_TYPE_SOCKET_INPUT_STREAM, "socket", client,
-          NULL));
+  gboolean mixer = GST_IS_MIXER (worker);
+  GstElement *sink;
+  GstPad *pad;
+
+  if (!mixer && opts.audio_mix)
+    return;
+
+  sink = gst_worker_get_element_unlocked (worker, mixer ? "sink" : "sink2");
+  g_return_if_fail (GST_IS_ELEMENT (sink));
+
+  /* a pooled pipeline is metered already */
+  if (!g_object_get_data (G_OBJECT (sink), "loudness")) {
+    pad = gst_element_get_static_pad (sink, "sink");
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+        (GstPadProbeCallback) gst_switch_server_measure_loudness, srv, NULL);
+    g_object_set_data (G_OBJECT (sink), "loudness", srv);
+    gst_object_unref (pad);
+  }
+  gst_object_unref (sink);
+}
+
+/**
+ * gst_switch_server_serve_input:
+ * @input: The new input case, taken over by the server.
+ * @return: TRUE if the input is served.
+ *
+ * Start a new input together with its branch and work case. Invoked with
+ * the serve lock held.
+ */
+static gboolean
+gst_switch_server_serve_input (GstSwitchServer * srv, GstCase * input)
+{
+  GstSwitchServeStreamType serve_type = input->serve_type;
   GstCaseType type = GST_CASE_UNKNOWN;
-  GstCaseType inputtype = GST_CASE_UNKNOWN;
   GstCaseType branchtype = GST_CASE_UNKNOWN;
-  gint num_cases = g_list_length (srv->cases);
-  GstCase *input = NULL, *branch = NULL, *workcase = NULL;
+  GstCase *branch = NULL, *workcase = NULL;
+  gint port = input->sink_port;
+  gint num_cases;
   gchar *name;
-  gint port = 0;
   GCallback start_callback = G_CALLBACK (gst_switch_server_start_case);
   GCallback end_callback = G_CALLBACK (gst_switch_server_end_case);
 
-  GST_SWITCH_SERVER_LOCK_SERVE (srv);
   GST_SWITCH_SERVER_LOCK_CASES (srv);
-  switch (serve_type) {
-    case GST_SERVE_AUDIO_STREAM:
-      inputtype = GST_CASE_INPUT_AUDIO;
-      break;
-    case GST_SERVE_VIDEO_STREAM:
-      inputtype = GST_CASE_INPUT_VIDEO;
-      break;
-    default:
-      goto error_unknown_serve_type;
-  }
+  num_cases = g_list_length (srv->cases);
 
   type = gst_switch_server_suggest_case_type (srv, serve_type);
   switch (type) {
@@ -656,18 +985,8 @@ gst_switch_server_serve (GstSwitchServer * srv, GSocket * client,
       goto error_unknown_case_type;
   }
 
-  port = gst_switch_server_alloc_port (srv);
-
   //INFO ("case-type: %d, %d, %d", type, branchtype, port);
 
-  name = g_strdup_printf ("input_%d", port);
-  input = GST_CASE (g_object_new (GST_TYPE_CASE, "name", name,
-          "type", inputtype, "port", port, "serve",
-          serve_type, "stream", stream, NULL));
-  g_object_unref (stream);
-  g_object_unref (client);
-  g_free (name);
-
   name = g_strdup_printf ("branch_%d", port);
   branch = GST_CASE (g_object_new (GST_TYPE_CASE, "name", name,
           "type", branchtype, "port", port, "serve", serve_type, NULL));
@@ -708,6 +1027,10 @@ gst_switch_server_serve (GstSwitchServer * srv, GSocket * client,
         "bheight", srv->composite->b_height, NULL);
   }
 
+  if (type == GST_CASE_COMPOSITE_AUDIO)
+    g_signal_connect (workcase, "prepare-worker",
+        G_CALLBACK (gst_switch_server_prepare_loudness), srv);
+
   g_signal_connect (branch, "start-worker", start_callback, srv);
   g_signal_connect (input, "end-worker", end_callback, srv);
   g_signal_connect (branch, "end-worker", end_callback, srv);
@@ -720,41 +1043,100 @@ gst_switch_server_serve (GstSwitchServer * srv, GSocket * client,
   if (!gst_worker_start (GST_WORKER (workcase)))
     goto error_start_workcase;
 
-  GST_SWITCH_SERVER_UNLOCK_SERVE (srv);
-  return;
+  if (serve_type == GST_SERVE_VIDEO_STREAM)
+    gst_switch_server_update_multiview (srv);
+  else
+    gst_switch_server_update_mixer (srv);
 
-  /* Errors Handling */
-error_unknown_serve_type:
-  {
-    ERROR ("unknown serve type %d", serve_type);
-    g_object_unref (stream);
-    g_object_unref (client);
-    GST_SWITCH_SERVER_UNLOCK_CASES (srv);
-    GST_SWITCH_SERVER_UNLOCK_SERVE (srv);
-    return;
-  }
+  return TRUE;
 
+  /* Errors Handling */
 error_unknown_case_type:
   {
     ERROR ("unknown case type (serve type %d)", serve_type);
-    g_object_unref (stream);
-    g_object_unref (client);
     GST_SWITCH_SERVER_UNLOCK_CASES (srv);
-    GST_SWITCH_SERVER_UNLOCK_SERVE (srv);
-    return;
+    g_object_unref (input);
+    return FALSE;
   }
 
 error_start_branch:
 error_start_workcase:
   {
-    ERROR ("failed serving new client");
     GST_SWITCH_SERVER_LOCK_CASES (srv);
     srv->cases = g_list_remove (srv->cases, branch);
     srv->cases = g_list_remove (srv->cases, workcase);
     GST_SWITCH_SERVER_UNLOCK_CASES (srv);
-    g_object_unref (stream);
     g_object_unref (branch);
     g_object_unref (workcase);
+    return FALSE;
+  }
+}
+
+/**
+ * gst_switch_server_serve:
+ *
+ * The gst-switch-srv serving thread.
+ */
+static void
+gst_switch_server_serve (GstSwitchServer * srv, GSocket * client,
+    GstSwitchServeStreamType serve_type)
+{
+  GSocketInputStreamX *stream =
+      G_SOCKET_INPUT_STREAM (g_object_new
+      (G_TYPE_SOCKET_INPUT_STREAM, "socket", client,
+          NULL));
+  GstCaseType inputtype = GST_CASE_UNKNOWN;
+  GstCase *input = NULL;
+  gchar *name;
+  gint port = 0;
+
+  GST_SWITCH_SERVER_LOCK_SERVE (srv);
+  switch (serve_type) {
+    case GST_SERVE_AUDIO_STREAM:
+      inputtype = GST_CASE_INPUT_AUDIO;
+      break;
+    case GST_SERVE_VIDEO_STREAM:
+      inputtype = GST_CASE_INPUT_VIDEO;
+      break;
+    default:
+      goto error_unknown_serve_type;
+  }
+
+  port = gst_switch_server_alloc_port (srv);
+
+  name = g_strdup_printf ("input_%d", port);
+  input = GST_CASE (g_object_new (GST_TYPE_CASE, "name", name,
+          "type", inputtype, "port", port, "serve",
+          serve_type, "stream", stream, NULL));
+  g_object_unref (stream);
+  g_object_unref (client);
+  g_free (name);
+
+  if (!gst_switch_server_serve_input (srv, input))
+    goto error_serve_input;
+
+  if (opts.record_iso)
+    gst_switch_server_start_iso (srv, port, serve_type);
+
+  if (opts.replay_seconds && serve_type == GST_SERVE_VIDEO_STREAM)
+    gst_switch_server_start_replay (srv, port, FALSE);
+
+  GST_SWITCH_SERVER_UNLOCK_SERVE (srv);
+  return;
+
+  /* Errors Handling */
+error_unknown_serve_type:
+  {
+    ERROR ("unknown serve type %d", serve_type);
+    g_object_unref (stream);
+    g_object_unref (client);
+    GST_SWITCH_SERVER_UNLOCK_SERVE (srv);
+    return;
+  }
+
+error_serve_input:
+  {
+    ERROR ("failed serving new client");
     gst_switch_server_revoke_port (srv, port);
     GST_SWITCH_SERVER_UNLOCK_SERVE (srv);
     return;
@@ -1073,6 +1455,23 @@ gst_switch_server_get_preview_sink_ports (GstSwitchServer * srv,
   return a;
 }
 
+/**
+ * gst_switch_server_mark_record:
+ *
+ *  Record an event in the index of the recording, see GstRecordIndex. A
+ *  NULL event records the composite mode.
+ */
+static void
+gst_switch_server_mark_record (GstSwitchServer * srv, const gchar * what)
+{
+  GST_SWITCH_SERVER_LOCK_RECORDER (srv);
+  if (srv->recorder) {
+    g_object_set (srv->recorder, "mode", srv->composite->mode, NULL);
+    gst_recorder_mark (srv->recorder, what);
+  }
+  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+}
+
 /**
  * gst_switch_server_set_composite_mode:
  *  @return: TRUE if succeeded.
@@ -1101,10 +1500,15 @@ gst_switch_server_set_composite_mode (GstSwitchServer * srv, gint mode)
     srv->pip_y = srv->composite->b_y;
     srv->pip_w = srv->composite->b_width;
     srv->pip_h = srv->composite->b_height;
+    srv->mode_started = g_get_monotonic_time ();
   }
 
 end:
   GST_SWITCH_SERVER_UNLOCK_PIP (srv);
+  if (result) {
+    gst_switch_server_update_multiview (srv);
+    gst_switch_server_mark_record (srv, NULL);
+  }
   return result;
 }
 
@@ -1120,40 +1524,134 @@ gst_switch_server_start_audio (GstCase * cas, GstSwitchServer * srv)
   INFO ("audio %d started", cas->sink_port);
 }
 
+/**
+ * gst_switch_server_restart_recorder:
+ *  @return: TRUE if the recorder started.
+ *
+ *  Start the stopped recorder over with the composite size. The recorder
+ *  must be locked.
+ */
+static gboolean
+gst_switch_server_restart_recorder (GstSwitchServer * srv)
+{
+  GstWorkerClass *worker_class;
+
+  g_object_set (G_OBJECT (srv->recorder),
+      "mode", srv->composite->mode,
+      "port", srv->composite->encode_sink_port,
+      "width", srv->composite->width,
+      "height", srv->composite->height, NULL);
+  worker_class = GST_WORKER_CLASS (G_OBJECT_GET_CLASS (srv->recorder));
+  if (worker_class->reset (GST_WORKER (srv->recorder)))
+    return gst_worker_start (GST_WORKER (srv->recorder));
+
+  ERROR ("failed to reset composite recorder");
+  return FALSE;
+}
+
+/**
+ * gst_switch_server_recorder_stopped:
+ *
+ *  Invoked when the recorder has closed out its file for a new recording.
+ */
+static void
+gst_switch_server_recorder_stopped (GstWorker * worker, gboolean stopped,
+    GstSwitchServer * srv)
+{
+  gboolean result = FALSE;
+
+  /* a newer request took over */
+  if (!stopped)
+    return;
+
+  GST_SWITCH_SERVER_LOCK_RECORDER (srv);
+  if (srv->recorder && GST_WORKER (srv->recorder) == worker)
+    result = gst_switch_server_restart_recorder (srv);
+  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+
+  if (result)
+    gst_switch_server_new_iso_record (srv);
+}
+
 /**
  * gst_switch_server_new_record:
  *  @return: TRUE if succeeded.
  *
- *  Start a new recording.
- *  
+ *  Start a new recording. The recording rolls over to a new file without
+ *  stopping the recorder, unless the composite size changed. The input
+ *  recordings roll over with it. The index of the finished recording gets
+ *  its integrated loudness and true-peak, which start over for the new one.
+ *  A stopping recorder starts over once it has closed out its file, without
+ *  waiting for it here.
  */
 gboolean
 gst_switch_server_new_record (GstSwitchServer * srv)
 {
-  GstWorkerClass *worker_class;
-  gboolean result = FALSE;
+  GstLoudnessLevel level;
+  gboolean result = FALSE, restarting = FALSE;
 
   g_return_val_if_fail (GST_IS_RECORDER (srv->recorder), FALSE);
 
+  if (gst_loudness_get (&srv->loudness, &level)) {
+    gchar *what = g_strdup_printf ("loudness I=%.1f LUFS TP=%.1f dBTP",
+        level.integrated, level.true_peak);
+    gst_switch_server_mark_record (srv, what);
+    g_free (what);
+  }
+  gst_loudness_reset (&srv->loudness);
+
   if (srv->recorder) {
     GST_SWITCH_SERVER_LOCK_RECORDER (srv);
-    if (srv->recorder) {
-      gst_worker_stop (GST_WORKER (srv->recorder));
-      g_object_set (G_OBJECT (srv->recorder),
-          "mode", srv->composite->mode,
-          "port", srv->composite->encode_sink_port,
-          "width", srv->composite->width,
-          "height", srv->composite->height, NULL);
-      worker_class = GST_WORKER_CLASS (G_OBJECT_GET_CLASS (srv->recorder));
-      if (worker_class->reset (GST_WORKER (srv->recorder))) {
-        result = gst_worker_start (GST_WORKER (srv->recorder));
-      } else {
-        ERROR ("failed to reset composite recorder");
-      }
+    if (srv->recorder && srv->recorder->width == srv->composite->width
+        && srv->recorder->height == srv->composite->height
+        && gst_recorder_new_fragment (srv->recorder)) {
+      result = TRUE;
+    } else if (srv->recorder) {
+      restarting = gst_worker_stop_async (GST_WORKER (srv->recorder), FALSE,
+          (GstWorkerDoneFunc) gst_switch_server_recorder_stopped, srv);
+      if (!restarting)
+        result = gst_switch_server_restart_recorder (srv);
     }
     GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
   }
-  return result;
+
+  if (result)
+    gst_switch_server_new_iso_record (srv);
+  return result || restarting;
+}
+
+/**
+ * gst_switch_server_get_record_stats:
+ *  @return a floating GVariant of type (sutttsdduutt): the file being
+ *          written, files written, frames written, frames lost by the last
+ *          rollover, frames lost in total, the codec, the frame rate
+ *          achieved by the encoder against the frame rate required, the
+ *          disk buffer fill and its peak in percent, the bytes/s written to
+ *          disk, and the frames dropped while the disk buffer was full.
+ *
+ *  Get the recorder statistics.
+ */
+GVariant *
+gst_switch_server_get_record_stats (GstSwitchServer * srv)
+{
+  GstRecorderStats stats = { 0 };
+  const gchar *codec = "";
+  GVariant *value;
+
+  GST_SWITCH_SERVER_LOCK_RECORDER (srv);
+  if (srv->recorder) {
+    gst_recorder_get_stats (srv->recorder, &stats);
+    codec = gst_recorder_codec_to_string (srv->recorder->codec);
+  }
+  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+
+  value = g_variant_new ("(sutttsdduutt)",
+      stats.location ? stats.location : "", stats.fragments, stats.frames,
+      stats.last_gap, stats.total_gap, codec, stats.encode_fps,
+      stats.required_fps, stats.disk_fill, stats.disk_max_fill,
+      stats.disk_throughput, stats.disk_dropped);
+  g_free (stats.location);
+  return value;
 }
 
 /**
@@ -1200,6 +1698,7 @@ gst_switch_server_adjust_pip (GstSwitchServer * srv,
 }
 
 static void gst_switch_server_worker_start (GstWorker *, GstSwitchServer *);
+static void gst_switch_server_switch_done (GstWorker *, GstSwitchServer *);
 static void gst_switch_server_worker_null (GstWorker *, GstSwitchServer *);
 
 /**
@@ -1217,6 +1716,7 @@ gst_switch_server_switch (GstSwitchServer * srv, gint channel, gint port)
   GstCase *compose_case, *candidate_case;
   GstCase *work1, *work2;
   GCallback callback = G_CALLBACK (gst_switch_server_end_case);
+  gint64 start = g_get_monotonic_time (), *started;
   gchar *name;
 
   compose_case = NULL;
@@ -1319,6 +1819,9 @@ gst_switch_server_switch (GstSwitchServer * srv, gint channel, gint port)
   } else {
     g_signal_connect (G_OBJECT (work1), "start-worker",
         G_CALLBACK (gst_switch_server_start_audio), srv);
+    if (work1->type == GST_CASE_COMPOSITE_AUDIO)
+      g_signal_connect (work1, "prepare-worker",
+          G_CALLBACK (gst_switch_server_prepare_loudness), srv);
   }
 
   compose_case->switching = TRUE;
@@ -1337,6 +1840,14 @@ gst_switch_server_switch (GstSwitchServer * srv, gint channel, gint port)
   g_signal_connect (work2, "start-worker",
       G_CALLBACK (gst_switch_server_worker_start), srv);
 
+  /* the switch is done once the new input of the channel flows */
+  started = g_new (gint64, 1);
+  *started = start;
+  g_object_set_data_full (G_OBJECT (work1), "gst-switch-started", started,
+      g_free);
+  g_signal_connect (work1, "start-worker",
+      G_CALLBACK (gst_switch_server_switch_done), srv);
+
   g_signal_connect (work1, "end-worker", callback, srv);
   g_signal_connect (work2, "end-worker", callback, srv);
 
@@ -1355,6 +1866,14 @@ gst_switch_server_switch (GstSwitchServer * srv, gint channel, gint port)
 
 end:
   GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+  if (result) {
+    gchar *what = g_strdup_printf ("switch %c %d", (gchar) channel, port);
+    gst_switch_server_update_multiview (srv);
+    gst_switch_server_mark_record (srv, what);
+    g_free (what);
+    if (channel == 'A')
+      gst_switch_server_follow_video (srv);
+  }
   return result;
 
 error_start_work:
@@ -1481,6 +2000,25 @@ gst_switch_server_worker_start (GstWorker * worker, GstSwitchServer * srv)
   g_print ("online: %s @%lld\n", worker->name, (long long int) t);
 }
 
+/**
+ * gst_switch_server_switch_done:
+ *
+ * Invoked when the new case of a switched channel is started, only the
+ * first start after the switch is timed.
+ */
+static void
+gst_switch_server_switch_done (GstWorker * worker, GstSwitchServer * srv)
+{
+  gint64 *started = g_object_get_data (G_OBJECT (worker),
+      "gst-switch-started");
+
+  if (started == NULL)
+    return;
+  gst_switch_metrics_histogram_observe (&srv->switch_latency,
+      g_get_monotonic_time () - *started);
+  g_object_set_data (G_OBJECT (worker), "gst-switch-started", NULL);
+}
+
 /**
  * gst_switch_server_worker_null:
  *
@@ -1530,8 +2068,18 @@ gst_switch_server_start_recorder (GstWorker * worker, GstSwitchServer * srv)
 static void
 gst_switch_server_end_transition (GstWorker * worker, GstSwitchServer * srv)
 {
+  gint64 started;
+
   g_return_if_fail (GST_IS_WORKER (worker));
 
+  GST_SWITCH_SERVER_LOCK_PIP (srv);
+  started = srv->mode_started;
+  srv->mode_started = 0;
+  GST_SWITCH_SERVER_UNLOCK_PIP (srv);
+  if (started)
+    gst_switch_metrics_histogram_observe (&srv->mode_latency,
+        g_get_monotonic_time () - started);
+
   GST_SWITCH_SERVER_LOCK_CONTROLLER (srv);
   if (srv->controller) {
     gint mode = srv->composite->mode;
@@ -1647,9 +2195,10 @@ gst_switch_server_get_output_string (GstWorker * worker, GstSwitchServer * srv)
   g_string_append_printf (desc, "intervideosrc name=source "
       "channel=composite_out ");
   g_string_append_printf (desc, "tcpserversink name=sink "
-      "port=%d ", srv->composite->sink_port);
+      GST_SWITCH_SERVE_LATEST_BUFFER " port=%d ", srv->composite->sink_port);
   g_string_append_printf (desc, "source. ! video/x-raw,width=%d,height=%d ",
       srv->composite->width, srv->composite->height);
+  gst_switch_server_append_latency_detect (desc, "output");
   ASSESS ("assess-output");
   g_string_append_printf (desc, "! gdppay ");
   /*
@@ -1679,65 +2228,1912 @@ gst_switch_server_prepare_output (GstWorker * worker, GstSwitchServer * srv)
   g_signal_connect (sink, "client-socket-removed",
       G_CALLBACK (gst_switch_server_output_client_socket_removed), srv);
 
+  gst_worker_watch_clients (worker, sink, FALSE);
+
   gst_object_unref (sink);
 }
 
 /**
- * gst_switch_server_create_output:
- * @return TRUE if the composite output worker is created.
+ * gst_switch_server_create_output:
+ * @return TRUE if the composite output worker is created.
+ *
+ * Create the composite output worker.
+ */
+static gboolean
+gst_switch_server_create_output (GstSwitchServer * srv)
+{
+  if (srv->output) {
+    return TRUE;
+  }
+
+  srv->output = GST_WORKER (g_object_new (GST_TYPE_WORKER,
+          "name", "output", NULL));
+  srv->output->pipeline_func_data = srv;
+  srv->output->pipeline_func = (GstWorkerGetPipelineString)
+      gst_switch_server_get_output_string;
+
+  g_signal_connect (srv->output, "prepare-worker",
+      G_CALLBACK (gst_switch_server_prepare_output), srv);
+  g_signal_connect (srv->output, "start-worker",
+      G_CALLBACK (gst_switch_server_start_output), srv);
+
+  gst_worker_start (srv->output);
+  return TRUE;
+}
+
+/**
+ * gst_switch_server_create_recorder:
+ * @return TRUE if the recorder is created successfully.
+ *
+ * Creating the recorder.
+ */
+static gboolean
+gst_switch_server_create_recorder (GstSwitchServer * srv)
+{
+  GstRecorderCodec codec = GST_RECORDER_CODEC_MJPEG;
+
+  if (srv->recorder) {
+    return TRUE;
+  }
+
+  if (opts.record_codec)
+    gst_recorder_parse_codec (opts.record_codec, &codec);
+
+  GST_SWITCH_SERVER_LOCK_RECORDER (srv);
+  srv->recorder = GST_RECORDER (g_object_new (GST_TYPE_RECORDER,
+          "name", "recorder", "port",
+          srv->composite->encode_sink_port, "mode",
+          srv->composite->mode, "width",
+          srv->composite->width, "height", srv->composite->height,
+          "codec", codec, "quality", opts.record_quality,
+          "threads", opts.record_threads, NULL));
+
+  g_signal_connect (srv->recorder, "start-worker",
+      G_CALLBACK (gst_switch_server_start_recorder), srv);
+
+  gst_worker_start (GST_WORKER (srv->recorder));
+  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+  return TRUE;
+}
+
+/**
+ * gst_switch_server_get_preview_thumbnail:
+ *  @param port the preview port of the input
+ *  @param width the thumbnail width, 0 to keep the aspect ratio
+ *  @param height the thumbnail height, 0 to keep the aspect ratio
+ *  @param rate the thumbnail frame rate, 0 for the input rate
+ *  @param jpeg TRUE to JPEG encode the thumbnail
+ *  @return the port serving the thumbnail, 0 on failure
+ *
+ *  Get a downscaled variant of a preview. Thumbnails with the same
+ *  parameters are shared between clients. A thumbnail ends with its
+ *  input, or when it had no client for GST_CASE_THUMBNAIL_LINGER seconds
+ *  after it was handed out or its last client left.
+ */
+gint
+gst_switch_server_get_preview_thumbnail (GstSwitchServer * srv,
+    gint port, gint width, gint height, gint rate, gboolean jpeg)
+{
+  GstCase *thumb = NULL;
+  gboolean has_video = FALSE;
+  GList *item;
+  gchar *name;
+  gint thumb_port = 0;
+
+  if (width < 0 || height < 0 || (width == 0 && height == 0) || rate < 0)
+    goto error_bad_size;
+
+  if (width == 0)
+    width = height * srv->composite->width / srv->composite->height;
+  else if (height == 0)
+    height = width * srv->composite->height / srv->composite->width;
+
+  /* I420 needs even dimensions */
+  width = (width + 1) & ~1;
+  height = (height + 1) & ~1;
+
+  GST_SWITCH_SERVER_LOCK_CASES (srv);
+  for (item = srv->cases; item; item = g_list_next (item)) {
+    GstCase *cas = GST_CASE (item->data);
+    if (cas->sink_port != port)
+      continue;
+    if (cas->type == GST_CASE_INPUT_VIDEO)
+      has_video = TRUE;
+    if (cas->type == GST_CASE_BRANCH_THUMBNAIL && cas->width == width &&
+        cas->height == height && cas->rate == rate && cas->jpeg == jpeg) {
+      thumb = cas;
+      thumb_port = cas->thumb_port;
+    }
+  }
+
+  if (!has_video) {
+    GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+    goto error_no_video;
+  }
+
+  if (thumb_port == 0) {
+    thumb_port = gst_switch_server_alloc_port (srv);
+    name = g_strdup_printf ("thumbnail_%d", thumb_port);
+    thumb = GST_CASE (g_object_new (GST_TYPE_CASE, "name", name,
+            "type", GST_CASE_BRANCH_THUMBNAIL, "port", port,
+            "serve", GST_SERVE_VIDEO_STREAM, "thumbport", thumb_port,
+            "width", width, "height", height, "rate", rate, "jpeg", jpeg,
+            NULL));
+    g_free (name);
+
+    g_signal_connect (thumb, "end-worker",
+        G_CALLBACK (gst_switch_server_end_case), srv);
+
+    if (gst_worker_start (GST_WORKER (thumb))) {
+      srv->cases = g_list_append (srv->cases, thumb);
+      INFO ("thumbnail of %d (%dx%d@%d%s) on %d", port, width, height, rate,
+          jpeg ? ",jpeg" : "", thumb_port);
+    } else {
+      ERROR ("failed to start thumbnail of %d", port);
+      g_object_unref (thumb);
+      gst_switch_server_revoke_port (srv, thumb_port);
+      thumb = NULL;
+      thumb_port = 0;
+    }
+  }
+
+  /* the client has a while to connect */
+  if (thumb)
+    gst_case_linger (thumb);
+  GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+  return thumb_port;
+
+error_bad_size:
+  {
+    ERROR ("invalid thumbnail %dx%d@%d", width, height, rate);
+    return 0;
+  }
+error_no_video:
+  {
+    ERROR ("no video preview on %d", port);
+    return 0;
+  }
+}
+
+/**
+ * gst_switch_server_get_branch_stats:
+ *  @return a floating GVariant of type a(iiutxxx), one entry per branch:
+ *          served port, case type, clients, buffers dropped while idle,
+ *          idle time, cost of serving a buffer and estimated time saved
+ *          (all times in usec).
+ *
+ *  Get the demand statistics of the preview branches. Branches only do
+ *  work while clients are attached, this shows what idling saved.
+ */
+GVariant *
+gst_switch_server_get_branch_stats (GstSwitchServer * srv)
+{
+  GVariantBuilder *builder;
+  GVariant *value;
+  GList *item;
+
+  builder = g_variant_builder_new (G_VARIANT_TYPE ("a(iiutxxx)"));
+  GST_SWITCH_SERVER_LOCK_CASES (srv);
+  for (item = srv->cases; item; item = g_list_next (item)) {
+    GstCase *cas = GST_CASE (item->data);
+    GstCaseBranchStats stats;
+    switch (cas->type) {
+      case GST_CASE_BRANCH_VIDEO_A:
+      case GST_CASE_BRANCH_VIDEO_B:
+      case GST_CASE_BRANCH_AUDIO:
+      case GST_CASE_BRANCH_PREVIEW:
+      case GST_CASE_BRANCH_THUMBNAIL:
+        gst_case_get_branch_stats (cas, &stats);
+        g_variant_builder_add (builder, "(iiutxxx)",
+            cas->type == GST_CASE_BRANCH_THUMBNAIL ?
+            cas->thumb_port : cas->sink_port, cas->type, stats.clients,
+            stats.idle_buffers, stats.idle_time, stats.buffer_cost,
+            stats.saved_time);
+        break;
+      default:
+        break;
+    }
+  }
+  GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+  value = g_variant_builder_end (builder);
+  g_variant_builder_unref (builder);
+  return value;
+}
+
+/**
+ * gst_switch_server_add_client_stats:
+ *
+ *  Add the statistics of the clients of a serving point to @builder.
+ */
+static void
+gst_switch_server_add_client_stats (GVariantBuilder * builder,
+    GstWorker * worker, gint port)
+{
+  GArray *clients = gst_worker_get_client_stats (worker);
+  guint n;
+
+  for (n = 0; n < clients->len; ++n) {
+    GstWorkerClientStats *stats =
+        &g_array_index (clients, GstWorkerClientStats, n);
+    g_variant_builder_add (builder, "(iixttt)", port, stats->fd, stats->lag,
+        stats->dropped, stats->bytes, stats->throughput);
+  }
+  g_array_unref (clients);
+}
+
+/**
+ * gst_switch_server_get_client_stats:
+ *  @return a floating GVariant of type a(iixttt), one entry per client:
+ *          served port, client socket, lag (usec), buffers dropped, bytes
+ *          sent and send throughput (bit/s).
+ *
+ *  Get the statistics of every client of every serving point.
+ */
+GVariant *
+gst_switch_server_get_client_stats (GstSwitchServer * srv)
+{
+  GVariantBuilder *builder;
+  GVariant *value;
+  GList *item;
+
+  builder = g_variant_builder_new (G_VARIANT_TYPE ("a(iixttt)"));
+
+  if (srv->output) {
+    gst_switch_server_add_client_stats (builder, srv->output,
+        srv->composite->sink_port);
+  }
+
+  GST_SWITCH_SERVER_LOCK_CASES (srv);
+  for (item = srv->cases; item; item = g_list_next (item)) {
+    GstCase *cas = GST_CASE (item->data);
+    gst_switch_server_add_client_stats (builder, GST_WORKER (cas),
+        cas->type == GST_CASE_BRANCH_THUMBNAIL ?
+        cas->thumb_port : cas->sink_port);
+  }
+  GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+
+  GST_SWITCH_SERVER_LOCK_ENCODERS (srv);
+  for (item = srv->encoders; item; item = g_list_next (item)) {
+    GstEncoder *enc = GST_ENCODER (item->data);
+    gst_switch_server_add_client_stats (builder, GST_WORKER (enc),
+        enc->sink_port);
+  }
+  GST_SWITCH_SERVER_UNLOCK_ENCODERS (srv);
+
+  GST_SWITCH_SERVER_LOCK_MULTIVIEW (srv);
+  if (srv->multiview && srv->multiview->output) {
+    gst_switch_server_add_client_stats (builder, srv->multiview->output,
+        srv->multiview->sink_port);
+  }
+  GST_SWITCH_SERVER_UNLOCK_MULTIVIEW (srv);
+
+  GST_SWITCH_SERVER_LOCK_RECORDER (srv);
+  if (srv->recorder) {
+    gst_switch_server_add_client_stats (builder, GST_WORKER (srv->recorder),
+        srv->recorder->sink_port);
+  }
+  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+
+  value = g_variant_builder_end (builder);
+  g_variant_builder_unref (builder);
+  return value;
+}
+
+/**
+ * gst_switch_server_compare_tiles:
+ *
+ * Order multiview tiles by input port.
+ */
+static gint
+gst_switch_server_compare_tiles (gconstpointer a, gconstpointer b)
+{
+  return ((const GstMultiviewTile *) a)->port -
+      ((const GstMultiviewTile *) b)->port;
+}
+
+/**
+ * gst_switch_server_update_multiview:
+ *
+ * Push the current inputs and their tally to the multiview. This is called
+ * whenever inputs come and go, channels are switched or the composite mode
+ * changes.
+ */
+static void
+gst_switch_server_update_multiview (GstSwitchServer * srv)
+{
+  GArray *tiles;
+  GList *item;
+  guint i;
+
+  GST_SWITCH_SERVER_LOCK_MULTIVIEW (srv);
+  if (srv->multiview == NULL)
+    goto end;
+
+  tiles = g_array_new (FALSE, TRUE, sizeof (GstMultiviewTile));
+
+  GST_SWITCH_SERVER_LOCK_CASES (srv);
+  for (item = srv->cases; item; item = g_list_next (item)) {
+    GstCase *cas = GST_CASE (item->data);
+    if (cas->type == GST_CASE_INPUT_VIDEO) {
+      GstMultiviewTile tile = { cas->sink_port, GST_MULTIVIEW_TALLY_NONE };
+      g_array_append_val (tiles, tile);
+    }
+  }
+  for (item = srv->cases; item; item = g_list_next (item)) {
+    GstCase *cas = GST_CASE (item->data);
+    GstMultiviewTally tally;
+    if (cas->switching)
+      continue;
+    if (cas->type == GST_CASE_COMPOSITE_VIDEO_A)
+      tally = GST_MULTIVIEW_TALLY_PROGRAM;
+    else if (cas->type == GST_CASE_COMPOSITE_VIDEO_B)
+      tally = srv->composite->mode == COMPOSE_MODE_NONE ?
+          GST_MULTIVIEW_TALLY_PREVIEW : GST_MULTIVIEW_TALLY_PROGRAM;
+    else
+      continue;
+    for (i = 0; i < tiles->len; ++i) {
+      GstMultiviewTile *tile = &g_array_index (tiles, GstMultiviewTile, i);
+      if (tile->port == cas->sink_port)
+        tile->tally = tally;
+    }
+  }
+  GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+
+  g_array_sort (tiles, gst_switch_server_compare_tiles);
+  gst_multiview_update (srv->multiview, (GstMultiviewTile *) tiles->data,
+      tiles->len);
+  g_array_free (tiles, TRUE);
+
+end:
+  GST_SWITCH_SERVER_UNLOCK_MULTIVIEW (srv);
+}
+
+/**
+ * gst_switch_server_end_multiview:
+ *
+ * Invoked when a multiview output is ended.
+ */
+static void
+gst_switch_server_end_multiview (GstMultiview * mv, GstSwitchServer * srv)
+{
+  gint port = mv->sink_port;
+
+  GST_SWITCH_SERVER_LOCK_MULTIVIEW (srv);
+  if (srv->multiview == mv)
+    srv->multiview = NULL;
+  GST_SWITCH_SERVER_UNLOCK_MULTIVIEW (srv);
+
+  INFO ("Removed %s", GST_WORKER (mv)->name);
+  g_object_unref (mv);
+
+  gst_switch_server_revoke_port (srv, port);
+}
+
+/**
+ * gst_switch_server_set_multiview:
+ *  @param width the multiview width, 0 to remove the multiview
+ *  @param height the multiview height, 0 to keep the composite aspect ratio
+ *  @param columns the number of tile columns, 0 for a square grid
+ *  @param jpeg serve JPEG frames instead of raw video
+ *  @return the port the multiview is served on, 0 if removed or on failure
+ *
+ *  Set up the multiview monitor output, which tiles every video input with
+ *  a label and tally border. It is rendered and served once, for any number
+ *  of clients. Changing the settings restarts it on a new port.
+ */
+gint
+gst_switch_server_set_multiview (GstSwitchServer * srv, gint width,
+    gint height, gint columns, gboolean jpeg)
+{
+  GstMultiview *mv, *old = NULL;
+  gint port = 0;
+
+  g_return_val_if_fail (srv->composite, 0);
+
+  if (width < 0 || height < 0 || columns < 0)
+    goto error_bad_size;
+
+  if (width > 0 && height == 0)
+    height = width * srv->composite->height / srv->composite->width;
+
+  width = (width + 1) & ~1;
+  height = (height + 1) & ~1;
+
+  GST_SWITCH_SERVER_LOCK_MULTIVIEW (srv);
+  mv = srv->multiview;
+  if (mv && mv->width == width && mv->height == height &&
+      mv->columns == columns && mv->jpeg == jpeg) {
+    port = mv->sink_port;
+    GST_SWITCH_SERVER_UNLOCK_MULTIVIEW (srv);
+    return port;
+  }
+
+  old = mv;
+  srv->multiview = NULL;
+
+  if (width > 0) {
+    port = gst_switch_server_alloc_port (srv);
+    mv = GST_MULTIVIEW (g_object_new (GST_TYPE_MULTIVIEW, "name", "multiview",
+            "port", port, "width", width, "height", height,
+            "columns", columns, "jpeg", jpeg, NULL));
+
+    g_signal_connect (mv, "start-worker",
+        G_CALLBACK (gst_switch_server_worker_start), srv);
+    g_signal_connect (mv, "worker-null",
+        G_CALLBACK (gst_switch_server_worker_null), srv);
+    g_signal_connect (mv, "end-worker",
+        G_CALLBACK (gst_switch_server_end_multiview), srv);
+
+    srv->multiview = mv;
+  }
+  GST_SWITCH_SERVER_UNLOCK_MULTIVIEW (srv);
+
+  /* the old multiview is released by gst_switch_server_end_multiview */
+  if (old)
+    gst_worker_stop (GST_WORKER (old));
+
+  if (port == 0)
+    return 0;
+
+  gst_switch_server_update_multiview (srv);
+
+  if (!gst_worker_start (GST_WORKER (mv)))
+    goto error_start;
+
+  INFO ("multiview %dx%d%s on %d", width, height, jpeg ? ",jpeg" : "", port);
+  return port;
+
+error_bad_size:
+  {
+    ERROR ("invalid multiview %dx%d (%d columns)", width, height, columns);
+    return 0;
+  }
+error_start:
+  {
+    ERROR ("failed to start multiview on %d", port);
+    GST_SWITCH_SERVER_LOCK_MULTIVIEW (srv);
+    if (srv->multiview == mv)
+      srv->multiview = NULL;
+    GST_SWITCH_SERVER_UNLOCK_MULTIVIEW (srv);
+    g_object_unref (mv);
+    gst_switch_server_revoke_port (srv, port);
+    return 0;
+  }
+}
+
+/**
+ * gst_switch_server_get_multiview_port:
+ *  @return the port the multiview is served on, 0 if there is none
+ */
+gint
+gst_switch_server_get_multiview_port (GstSwitchServer * srv)
+{
+  gint port = 0;
+
+  GST_SWITCH_SERVER_LOCK_MULTIVIEW (srv);
+  if (srv->multiview)
+    port = srv->multiview->sink_port;
+  GST_SWITCH_SERVER_UNLOCK_MULTIVIEW (srv);
+  return port;
+}
+
+/**
+ * gst_switch_server_compare_ports:
+ *
+ * Order ports.
+ */
+static gint
+gst_switch_server_compare_ports (gconstpointer a, gconstpointer b)
+{
+  return *(const gint *) a - *(const gint *) b;
+}
+
+/**
+ * gst_switch_server_update_mixer:
+ *
+ * Push the current audio inputs to the mixer. This is called whenever audio
+ * inputs come and go.
+ */
+static void
+gst_switch_server_update_mixer (GstSwitchServer * srv)
+{
+  GArray *ports;
+  GList *item;
+
+  GST_SWITCH_SERVER_LOCK_MIXER (srv);
+  if (srv->mixer == NULL)
+    goto end;
+
+  ports = g_array_new (FALSE, TRUE, sizeof (gint));
+
+  GST_SWITCH_SERVER_LOCK_CASES (srv);
+  for (item = srv->cases; item; item = g_list_next (item)) {
+    GstCase *cas = GST_CASE (item->data);
+    if (cas->type == GST_CASE_INPUT_AUDIO)
+      g_array_append_val (ports, cas->sink_port);
+  }
+  GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+
+  g_array_sort (ports, gst_switch_server_compare_ports);
+  gst_mixer_update (srv->mixer, (gint *) ports->data, ports->len);
+  g_array_free (ports, TRUE);
+
+end:
+  GST_SWITCH_SERVER_UNLOCK_MIXER (srv);
+}
+
+/**
+ * gst_switch_server_create_mixer:
+ * @return TRUE if the audio mixer is started.
+ *
+ * Create the audio mixer, which owns the composite audio from now on.
+ */
+static gboolean
+gst_switch_server_create_mixer (GstSwitchServer * srv)
+{
+  GstMixer *mixer;
+
+  mixer = GST_MIXER (g_object_new (GST_TYPE_MIXER, "name", "mixer", NULL));
+
+  g_signal_connect (mixer, "prepare-worker",
+      G_CALLBACK (gst_switch_server_prepare_loudness), srv);
+  g_signal_connect (mixer, "start-worker",
+      G_CALLBACK (gst_switch_server_worker_start), srv);
+  g_signal_connect (mixer, "worker-null",
+      G_CALLBACK (gst_switch_server_worker_null), srv);
+
+  GST_SWITCH_SERVER_LOCK_MIXER (srv);
+  srv->mixer = mixer;
+  GST_SWITCH_SERVER_UNLOCK_MIXER (srv);
+
+  gst_switch_server_update_mixer (srv);
+
+  if (!gst_worker_start (GST_WORKER (mixer))) {
+    ERROR ("failed to start the audio mixer");
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/**
+ * gst_switch_server_set_audio_mix:
+ *  @param port the audio input port
+ *  @param gain the linear gain, 1.0 for unity
+ *  @param mute TRUE to leave the input out of the mix
+ *  @param pan -1.0 left to 1.0 right
+ *  @return TRUE if the input is mixed, FALSE if there is no such input or
+ *          the server is not mixing
+ *
+ *  Change the mix of an audio input. The change is ramped in on the running
+ *  mix, it never restarts a pipeline.
+ */
+gboolean
+gst_switch_server_set_audio_mix (GstSwitchServer * srv, gint port,
+    gdouble gain, gboolean mute, gdouble pan)
+{
+  gboolean result = FALSE;
+
+  GST_SWITCH_SERVER_LOCK_MIXER (srv);
+  if (srv->mixer)
+    result = gst_mixer_set_channel (srv->mixer, port, gain, mute, pan);
+  GST_SWITCH_SERVER_UNLOCK_MIXER (srv);
+
+  if (!result)
+    WARN ("no mixed audio input on %d", port);
+  return result;
+}
+
+/**
+ * gst_switch_server_get_audio_mix:
+ *  @return a floating GVariant of type a(idid), one entry per audio input:
+ *          the port, gain, mute and pan. The mute is 1 or 0, as printed
+ *          booleans are no Python literals.
+ */
+GVariant *
+gst_switch_server_get_audio_mix (GstSwitchServer * srv)
+{
+  GVariantBuilder *builder;
+  GVariant *value;
+  GArray *channels;
+  guint i;
+
+  builder = g_variant_builder_new (G_VARIANT_TYPE ("a(idid)"));
+  GST_SWITCH_SERVER_LOCK_MIXER (srv);
+  if (srv->mixer) {
+    channels = gst_mixer_get_channels (srv->mixer);
+    for (i = 0; i < channels->len; ++i) {
+      GstMixerChannel *channel =
+          &g_array_index (channels, GstMixerChannel, i);
+      g_variant_builder_add (builder, "(idid)", channel->port,
+          channel->gain, channel->mute ? 1 : 0, channel->pan);
+    }
+    g_array_free (channels, TRUE);
+  }
+  GST_SWITCH_SERVER_UNLOCK_MIXER (srv);
+  value = g_variant_builder_end (builder);
+  g_variant_builder_unref (builder);
+  return value;
+}
+
+/**
+ * gst_switch_server_get_audio_levels:
+ *  @return a floating GVariant of type a(iddd), one entry per metered audio
+ *          input: the port, RMS, peak and decaying peak of the loudest
+ *          channel in dB. Port 0 is the program audio.
+ *
+ *  Get the latest audio levels, inputs which have not been metered lately
+ *  are left out.
+ */
+GVariant *
+gst_switch_server_get_audio_levels (GstSwitchServer * srv)
+{
+  GVariantBuilder *builder;
+  GstMeterLevel level;
+  gboolean program = FALSE;
+  GVariant *value;
+  GList *item;
+
+  builder = g_variant_builder_new (G_VARIANT_TYPE ("a(iddd)"));
+
+  GST_SWITCH_SERVER_LOCK_MIXER (srv);
+  if (srv->mixer && gst_mixer_get_level (srv->mixer, &level)) {
+    g_variant_builder_add (builder, "(iddd)", 0, level.rms, level.peak,
+        level.decay);
+    program = TRUE;
+  }
+  GST_SWITCH_SERVER_UNLOCK_MIXER (srv);
+
+  GST_SWITCH_SERVER_LOCK_CASES (srv);
+  for (item = srv->cases; item; item = g_list_next (item)) {
+    GstCase *cas = GST_CASE (item->data);
+    if (cas->serve_type != GST_SERVE_AUDIO_STREAM)
+      continue;
+    if (cas->type != GST_CASE_COMPOSITE_AUDIO && cas->type != GST_CASE_PREVIEW)
+      continue;
+    if (!gst_case_get_level (cas, &level))
+      continue;
+    g_variant_builder_add (builder, "(iddd)", cas->sink_port, level.rms,
+        level.peak, level.decay);
+    /* without the mixer the program is the selected input */
+    if (!program && cas->type == GST_CASE_COMPOSITE_AUDIO && !opts.audio_mix)
+      g_variant_builder_add (builder, "(iddd)", 0, level.rms, level.peak,
+          level.decay);
+  }
+  GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+
+  value = g_variant_builder_end (builder);
+  g_variant_builder_unref (builder);
+  return value;
+}
+
+/**
+ * gst_switch_server_set_av_offset:
+ *  @param port the video or audio input port
+ *  @param offset the delay in usec, 0 to GST_CASE_MAX_OFFSET
+ *  @return TRUE if the delay is applied, FALSE if there is no such input
+ *          or the delay is out of range
+ *
+ *  Delay an input to bring it in sync with the others. The delay is
+ *  applied to the running cases reading the input and kept for the cases
+ *  the input is switched to. Audio is delayed by whole samples.
+ */
+gboolean
+gst_switch_server_set_av_offset (GstSwitchServer * srv, gint port,
+    gint64 offset)
+{
+  GstCase *input = NULL;
+  GList *item;
+
+  if (offset < 0 || offset * GST_USECOND > GST_CASE_MAX_OFFSET) {
+    WARN ("invalid A/V offset: %" G_GINT64_FORMAT " usec", offset);
+    return FALSE;
+  }
+
+  GST_SWITCH_SERVER_LOCK_CASES (srv);
+  for (item = srv->cases; item; item = g_list_next (item)) {
+    GstCase *cas = GST_CASE (item->data);
+    if ((cas->type == GST_CASE_INPUT_VIDEO
+            || cas->type == GST_CASE_INPUT_AUDIO) && cas->sink_port == port) {
+      input = cas;
+      break;
+    }
+  }
+  if (input) {
+    input->offset = offset * GST_USECOND;
+    for (item = srv->cases; item; item = g_list_next (item)) {
+      GstCase *cas = GST_CASE (item->data);
+      if (cas->input == input && !cas->switching)
+        gst_case_apply_offset (cas);
+    }
+  }
+  GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+
+  if (!input) {
+    WARN ("no input on %d", port);
+    return FALSE;
+  }
+
+  INFO ("A/V offset of %d: %" G_GINT64_FORMAT " usec", port, offset);
+  return TRUE;
+}
+
+/**
+ * gst_switch_server_get_av_offsets:
+ *  @return a floating GVariant of type a(ix), one entry per input: the port
+ *          and the delay in usec.
+ */
+GVariant *
+gst_switch_server_get_av_offsets (GstSwitchServer * srv)
+{
+  GVariantBuilder *builder;
+  GVariant *value;
+  GList *item;
+
+  builder = g_variant_builder_new (G_VARIANT_TYPE ("a(ix)"));
+  GST_SWITCH_SERVER_LOCK_CASES (srv);
+  for (item = srv->cases; item; item = g_list_next (item)) {
+    GstCase *cas = GST_CASE (item->data);
+    if (cas->type == GST_CASE_INPUT_VIDEO || cas->type == GST_CASE_INPUT_AUDIO)
+      g_variant_builder_add (builder, "(ix)", cas->sink_port,
+          (gint64) (cas->offset / GST_USECOND));
+  }
+  GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+  value = g_variant_builder_end (builder);
+  g_variant_builder_unref (builder);
+  return value;
+}
+
+/**
+ * gst_switch_server_follow_video:
+ *
+ * Crossfade the mix to the audio paired with the video on channel A, the
+ * mix is left as it is if that video has no audio paired.
+ */
+static void
+gst_switch_server_follow_video (GstSwitchServer * srv)
+{
+  gpointer audio_port;
+  gint port = 0;
+  GList *item;
+
+  if (!opts.audio_follow_video)
+    return;
+
+  GST_SWITCH_SERVER_LOCK_CASES (srv);
+  for (item = srv->cases; item; item = g_list_next (item)) {
+    GstCase *cas = GST_CASE (item->data);
+    if (cas->type == GST_CASE_COMPOSITE_VIDEO_A) {
+      port = cas->sink_port;
+      break;
+    }
+  }
+  GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+
+  GST_SWITCH_SERVER_LOCK_MIXER (srv);
+  if (srv->mixer && g_hash_table_lookup_extended (srv->audio_pairs,
+          GINT_TO_POINTER (port), NULL, &audio_port))
+    gst_mixer_follow (srv->mixer, GPOINTER_TO_INT (audio_port));
+  GST_SWITCH_SERVER_UNLOCK_MIXER (srv);
+}
+
+/**
+ * gst_switch_server_pair_audio:
+ *  @param video_port the video input port
+ *  @param audio_port the audio input port, 0 to mix all inputs while the
+ *         video is on channel A
+ *  @return TRUE if paired, FALSE if the audio is not following the video
+ *
+ *  Pair an audio input with a video input. With --audio-follow-video the
+ *  mix is crossfaded to the paired audio whenever its video is switched to
+ *  channel A, the audio cases are never restarted for it. The ports need
+ *  not be connected yet.
+ */
+gboolean
+gst_switch_server_pair_audio (GstSwitchServer * srv, gint video_port,
+    gint audio_port)
+{
+  if (!opts.audio_follow_video) {
+    WARN ("audio is not following video");
+    return FALSE;
+  }
+
+  GST_SWITCH_SERVER_LOCK_MIXER (srv);
+  g_hash_table_insert (srv->audio_pairs, GINT_TO_POINTER (video_port),
+      GINT_TO_POINTER (audio_port));
+  GST_SWITCH_SERVER_UNLOCK_MIXER (srv);
+
+  INFO ("paired audio %d with video %d", audio_port, video_port);
+  gst_switch_server_follow_video (srv);
+  return TRUE;
+}
+
+/**
+ * gst_switch_server_get_audio_latency:
+ *  @return a floating GVariant of type a(ixx), one entry per audio input:
+ *          the port, the latency to its monitor output and the latency to
+ *          the program audio in usec, -1 where unknown.
+ *
+ *  The latencies are the sums of the latencies the running pipelines on
+ *  the way report, each inter hop adds the latency of its source. The
+ *  program is reached through the mixer, or directly by the input on the
+ *  composite audio when not mixing.
+ */
+GVariant *
+gst_switch_server_get_audio_latency (GstSwitchServer * srv)
+{
+  GstClockTime mix = GST_CLOCK_TIME_NONE;
+  GVariantBuilder *builder;
+  gboolean mixing;
+  GVariant *value;
+  GList *item;
+
+  GST_SWITCH_SERVER_LOCK_MIXER (srv);
+  mixing = (srv->mixer != NULL);
+  if (mixing)
+    mix = gst_worker_get_latency (GST_WORKER (srv->mixer));
+  GST_SWITCH_SERVER_UNLOCK_MIXER (srv);
+
+  builder = g_variant_builder_new (G_VARIANT_TYPE ("a(ixx)"));
+  GST_SWITCH_SERVER_LOCK_CASES (srv);
+  for (item = srv->cases; item; item = g_list_next (item)) {
+    GstCase *cas = GST_CASE (item->data);
+    GstClockTime hop, branch = GST_CLOCK_TIME_NONE;
+    gint64 monitor = -1, program = -1;
+
+    if (cas->serve_type != GST_SERVE_AUDIO_STREAM || cas->switching)
+      continue;
+    if (cas->type != GST_CASE_COMPOSITE_AUDIO && cas->type != GST_CASE_PREVIEW)
+      continue;
+
+    hop = gst_worker_get_latency (GST_WORKER (cas));
+    if (cas->branch)
+      branch = gst_worker_get_latency (GST_WORKER (cas->branch));
+    if (GST_CLOCK_TIME_IS_VALID (hop)) {
+      if (GST_CLOCK_TIME_IS_VALID (branch))
+        monitor = (hop + branch) / GST_USECOND;
+      if (mixing && GST_CLOCK_TIME_IS_VALID (mix))
+        program = (hop + mix) / GST_USECOND;
+      else if (!mixing && cas->type == GST_CASE_COMPOSITE_AUDIO)
+        program = hop / GST_USECOND;
+    }
+
+    g_variant_builder_add (builder, "(ixx)", cas->sink_port, monitor,
+        program);
+  }
+  GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+  value = g_variant_builder_end (builder);
+  g_variant_builder_unref (builder);
+  return value;
+}
+
+/**
+ * gst_switch_server_get_loudness:
+ *  @return a floating GVariant of type (dddd): the momentary, short-term
+ *          and integrated loudness of the composite audio in LUFS and its
+ *          true-peak in dBTP, GST_LOUDNESS_FLOOR until measured.
+ *
+ *  The integrated loudness and the true-peak are those of the recording
+ *  being written, see gst_switch_server_new_record.
+ */
+GVariant *
+gst_switch_server_get_loudness (GstSwitchServer * srv)
+{
+  GstLoudnessLevel level;
+
+  gst_loudness_get (&srv->loudness, &level);
+  return g_variant_new ("(dddd)", level.momentary, level.short_term,
+      level.integrated, level.true_peak);
+}
+
+/**
+ * gst_switch_server_get_watchdog_stats:
+ *  @return a floating GVariant of type (uuux): the pipelines found without
+ *          buffers, the restarts of them, the stalled pipelines flowing
+ *          again and the mean time to recover in usec.
+ */
+GVariant *
+gst_switch_server_get_watchdog_stats (GstSwitchServer * srv)
+{
+  GstWorkerWatchdogStats stats;
+
+  gst_worker_get_watchdog_stats (&stats);
+  return g_variant_new ("(uuux)", stats.stalls, stats.restarts,
+      stats.recoveries, stats.recovery_time);
+}
+
+/**
+ * gst_switch_server_get_stats:
+ *  @return a floating GVariant of type a(sa(sttttux)): the name of every
+ *          worker with the name, buffers, bytes, dropped and repeated
+ *          frames, queued buffers and mean processing usec of each of its
+ *          elements, see GstWorkerElementStats.
+ */
+GVariant *
+gst_switch_server_get_stats (GstSwitchServer * srv)
+{
+  GVariantBuilder builder, elements;
+  GList *workers, *w;
+  GArray *stats;
+  guint i;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(sa(sttttux))"));
+  workers = gst_worker_list ();
+  for (w = workers; w; w = g_list_next (w)) {
+    GstWorker *worker = GST_WORKER (w->data);
+
+    stats = gst_worker_get_stats (worker);
+    g_variant_builder_init (&elements, G_VARIANT_TYPE ("a(sttttux)"));
+    for (i = 0; i < stats->len; ++i) {
+      GstWorkerElementStats *s =
+          &g_array_index (stats, GstWorkerElementStats, i);
+      g_variant_builder_add (&elements, "(sttttux)", s->name, s->buffers,
+          s->bytes, s->dropped, s->repeated, s->queued, s->processing_time);
+    }
+    g_array_unref (stats);
+    g_variant_builder_add (&builder, "(sa(sttttux))",
+        worker->name ? worker->name : "", &elements);
+  }
+  g_list_free_full (workers, g_object_unref);
+  return g_variant_builder_end (&builder);
+}
+
+/**
+ * gst_switch_server_publish_stats:
+ *
+ * Tell the clients the pipeline counters, invoked every --stats-interval.
+ */
+static gboolean
+gst_switch_server_publish_stats (GstSwitchServer * srv)
+{
+  GVariant *stats = gst_switch_server_get_stats (srv);
+
+  g_variant_ref_sink (stats);
+  GST_SWITCH_SERVER_LOCK_CONTROLLER (srv);
+  if (srv->controller)
+    gst_switch_controller_tell_stats (srv->controller, stats);
+  GST_SWITCH_SERVER_UNLOCK_CONTROLLER (srv);
+  g_variant_unref (stats);
+  return TRUE;
+}
+
+/**
+ * gst_switch_server_append_latency_detect:
+ *  @param desc the pipeline string
+ *  @param path the name of the measured path
+ *
+ * Append a latency detector named "latency" with --measure-latency.
+ */
+void
+gst_switch_server_append_latency_detect (GString * desc, const gchar * path)
+{
+  if (!opts.measure_latency)
+    return;
+
+  g_string_append_printf (desc, "! latencydetect name=latency path=%s ",
+      path);
+}
+
+/**
+ * gst_switch_server_get_latency:
+ *  @return a(suuxxx), the path, frames seen and detected, p50, p99 and p999
+ *          of the glass to glass latency in usec, -1 for no measurement
+ *
+ * Read the latency detectors of all pipelines, see --measure-latency.
+ */
+GVariant *
+gst_switch_server_get_latency (GstSwitchServer * srv)
+{
+  GVariantBuilder builder;
+  GList *workers, *w;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(suuxxx)"));
+  workers = gst_worker_list ();
+  for (w = workers; w; w = g_list_next (w)) {
+    GstElement *detect = gst_worker_get_element (GST_WORKER (w->data),
+        "latency");
+    GstStructure *stats;
+    guint frames = 0, detected = 0;
+    gint64 p50 = -1, p99 = -1, p999 = -1;
+
+    if (detect == NULL)
+      continue;
+    g_object_get (detect, "stats", &stats, NULL);
+    gst_structure_get_uint (stats, "frames", &frames);
+    gst_structure_get_uint (stats, "detected", &detected);
+    gst_structure_get_int64 (stats, "latency-p50", &p50);
+    gst_structure_get_int64 (stats, "latency-p99", &p99);
+    gst_structure_get_int64 (stats, "latency-p999", &p999);
+    g_variant_builder_add (&builder, "(suuxxx)",
+        gst_structure_get_string (stats, "path"), frames, detected, p50, p99,
+        p999);
+    gst_structure_free (stats);
+    gst_object_unref (detect);
+  }
+  g_list_free_full (workers, g_object_unref);
+  return g_variant_builder_end (&builder);
+}
+
+typedef struct _GstSwitchServerInputMetrics GstSwitchServerInputMetrics;
+struct _GstSwitchServerInputMetrics
+{
+  gint port;
+  const gchar *type;
+  guint64 buffers;
+  guint64 bytes;
+  guint64 dropped;
+};
+
+/**
+ * gst_switch_server_input_metrics:
+ *
+ * The metrics of an input port, added on the first look up.
+ */
+static GstSwitchServerInputMetrics *
+gst_switch_server_input_metrics (GArray * inputs, gint port)
+{
+  GstSwitchServerInputMetrics input = { port, NULL, 0, 0, 0 };
+  guint i;
+
+  for (i = 0; i < inputs->len; ++i)
+    if (g_array_index (inputs, GstSwitchServerInputMetrics, i).port == port)
+      return &g_array_index (inputs, GstSwitchServerInputMetrics, i);
+  g_array_append_val (inputs, input);
+  return &g_array_index (inputs, GstSwitchServerInputMetrics, i);
+}
+
+/**
+ * gst_switch_server_find_element_stats:
+ *
+ * The counters of the element @name in @stats, NULL if it has none.
+ */
+static GstWorkerElementStats *
+gst_switch_server_find_element_stats (GArray * stats, const gchar * name)
+{
+  guint i;
+
+  for (i = 0; i < stats->len; ++i)
+    if (g_strcmp0 (g_array_index (stats, GstWorkerElementStats, i).name,
+            name) == 0)
+      return &g_array_index (stats, GstWorkerElementStats, i);
+  return NULL;
+}
+
+/**
+ * gst_switch_server_release_workers:
+ *
+ * Drop the references of a scrape to the workers in the main loop, the
+ * last one may finalize a worker, which is not for the metrics thread.
+ */
+static gboolean
+gst_switch_server_release_workers (GList * workers)
+{
+  g_list_free_full (workers, g_object_unref);
+  return FALSE;
+}
+
+/**
+ * gst_switch_server_append_metrics:
+ *
+ * Append the metrics of a scrape of --metrics-port, in a thread of the
+ * metrics service. The pipelines are read from the counters they keep
+ * with atomics. The only lock of a streaming thread taken is the one of
+ * the disk sink of the recorder, for its fill and throughput, which is
+ * never held over a write to the disk. Rates like the frames/s and the
+ * bitrate of the inputs are left to the scraper, see rate() of Prometheus.
+ */
+static void
+gst_switch_server_append_metrics (GString * out, GstSwitchServer * srv)
+{
+  GArray *inputs = g_array_new (FALSE, FALSE,
+      sizeof (GstSwitchServerInputMetrics));
+  GstWorkerElementStats *mix = NULL, *e;
+  GstWorkerWatchdogStats watchdog;
+  GstRecorderStats record = { 0 };
+  gboolean recording = FALSE;
+  GList *workers, *w;
+  GArray *stats, *composite = NULL;
+  gchar *labels;
+  guint i;
+
+  workers = gst_worker_list ();
+  for (w = workers; w; w = g_list_next (w)) {
+    GstWorker *worker = GST_WORKER (w->data);
+    GstSwitchServerInputMetrics *input;
+    GstCase *cas;
+
+    if (GST_IS_COMPOSITE (worker) && composite == NULL) {
+      composite = gst_worker_get_stats (worker);
+      mix = gst_switch_server_find_element_stats (composite, "mix");
+      continue;
+    }
+    if (!GST_IS_CASE (worker))
+      continue;
+
+    /* the input of a port is counted as it comes off the network, and all
+       the cases carrying it count its drops */
+    cas = GST_CASE (worker);
+    stats = gst_worker_get_stats (worker);
+    input = gst_switch_server_input_metrics (inputs, cas->sink_port);
+    for (i = 0; i < stats->len; ++i)
+      input->dropped += g_array_index (stats, GstWorkerElementStats,
+          i).dropped;
+    if (cas->type == GST_CASE_INPUT_VIDEO ||
+        cas->type == GST_CASE_INPUT_AUDIO) {
+      input->type = cas->type == GST_CASE_INPUT_VIDEO ? "video" : "audio";
+      if ((e = gst_switch_server_find_element_stats (stats, "source")))
+        input->bytes = e->bytes;
+      if ((e = gst_switch_server_find_element_stats (stats, "sink")))
+        input->buffers = e->buffers;
+    }
+    g_array_unref (stats);
+  }
+  g_idle_add ((GSourceFunc) gst_switch_server_release_workers, workers);
+
+  gst_switch_metrics_append_help (out, "gstswitch_input_frames_total",
+      "counter", "Frames or audio buffers decoded from an input.");
+  for (i = 0; i < inputs->len; ++i) {
+    GstSwitchServerInputMetrics *input =
+        &g_array_index (inputs, GstSwitchServerInputMetrics, i);
+    if (input->type == NULL)
+      continue;
+    labels = g_strdup_printf ("port=\"%d\",type=\"%s\"", input->port,
+        input->type);
+    gst_switch_metrics_append_value (out, "gstswitch_input_frames_total",
+        labels, input->buffers);
+    g_free (labels);
+  }
+  gst_switch_metrics_append_help (out, "gstswitch_input_bytes_total",
+      "counter", "Bytes received from an input.");
+  for (i = 0; i < inputs->len; ++i) {
+    GstSwitchServerInputMetrics *input =
+        &g_array_index (inputs, GstSwitchServerInputMetrics, i);
+    if (input->type == NULL)
+      continue;
+    labels = g_strdup_printf ("port=\"%d\",type=\"%s\"", input->port,
+        input->type);
+    gst_switch_metrics_append_value (out, "gstswitch_input_bytes_total",
+        labels, input->bytes);
+    g_free (labels);
+  }
+  gst_switch_metrics_append_help (out, "gstswitch_input_dropped_total",
+      "counter", "Frames of an input dropped by the pipelines carrying it.");
+  for (i = 0; i < inputs->len; ++i) {
+    GstSwitchServerInputMetrics *input =
+        &g_array_index (inputs, GstSwitchServerInputMetrics, i);
+    if (input->type == NULL)
+      continue;
+    labels = g_strdup_printf ("port=\"%d\",type=\"%s\"", input->port,
+        input->type);
+    gst_switch_metrics_append_value (out, "gstswitch_input_dropped_total",
+        labels, input->dropped);
+    g_free (labels);
+  }
+  g_array_unref (inputs);
+
+  gst_switch_metrics_append_help (out, "gstswitch_composite_frames_total",
+      "counter", "Frames rendered by the composite.");
+  gst_switch_metrics_append_value (out, "gstswitch_composite_frames_total",
+      NULL, mix ? mix->buffers : 0);
+  gst_switch_metrics_append_help (out, "gstswitch_composite_render_seconds",
+      "gauge", "Mean time the composite takes to render a frame.");
+  gst_switch_metrics_append_value (out, "gstswitch_composite_render_seconds",
+      NULL, mix && mix->processing_time >= 0 ?
+      mix->processing_time / 1e6 : 0);
+  if (composite)
+    g_array_unref (composite);
+
+  gst_switch_metrics_append_help (out, "gstswitch_switch_latency_seconds",
+      "histogram", "Time from a switch until the new input flows.");
+  gst_switch_metrics_append_histogram (out,
+      "gstswitch_switch_latency_seconds", NULL, &srv->switch_latency);
+  gst_switch_metrics_append_help (out,
+      "gstswitch_mode_change_latency_seconds", "histogram",
+      "Time from a composite mode change until its transition ended.");
+  gst_switch_metrics_append_histogram (out,
+      "gstswitch_mode_change_latency_seconds", NULL, &srv->mode_latency);
+
+  GST_SWITCH_SERVER_LOCK_RECORDER (srv);
+  if (srv->recorder) {
+    gst_recorder_get_stats (srv->recorder, &record);
+    recording = TRUE;
+  }
+  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+  if (recording) {
+    gst_switch_metrics_append_help (out,
+        "gstswitch_recorder_disk_throughput_bytes_per_second", "gauge",
+        "Bytes/s the recorder writes to disk.");
+    gst_switch_metrics_append_value (out,
+        "gstswitch_recorder_disk_throughput_bytes_per_second", NULL,
+        record.disk_throughput);
+    gst_switch_metrics_append_help (out, "gstswitch_recorder_disk_fill_ratio",
+        "gauge", "Fill of the disk buffer of the recorder.");
+    gst_switch_metrics_append_value (out,
+        "gstswitch_recorder_disk_fill_ratio", NULL, record.disk_fill / 100.0);
+    gst_switch_metrics_append_help (out, "gstswitch_recorder_frames_total",
+        "counter", "Frames written to the recording files.");
+    gst_switch_metrics_append_value (out, "gstswitch_recorder_frames_total",
+        NULL, record.frames);
+    gst_switch_metrics_append_help (out,
+        "gstswitch_recorder_disk_dropped_total", "counter",
+        "Frames dropped while the disk buffer was full.");
+    gst_switch_metrics_append_value (out,
+        "gstswitch_recorder_disk_dropped_total", NULL, record.disk_dropped);
+    g_free (record.location);
+  }
+
+  gst_worker_get_watchdog_stats (&watchdog);
+  gst_switch_metrics_append_help (out, "gstswitch_watchdog_restarts_total",
+      "counter", "Restarts of pipelines which stopped producing buffers.");
+  gst_switch_metrics_append_value (out, "gstswitch_watchdog_restarts_total",
+      NULL, watchdog.restarts);
+
+  GST_SWITCH_SERVER_LOCK_CONTROLLER (srv);
+  if (srv->controller)
+    gst_switch_controller_append_metrics (srv->controller, out);
+  GST_SWITCH_SERVER_UNLOCK_CONTROLLER (srv);
+
+  gst_switch_metrics_append_process (out);
+}
+
+/**
+ * gst_switch_server_serve_metrics:
+ *  @return TRUE unless --metrics-port could not be served.
+ *
+ * Serve the metrics on --metrics-port.
+ */
+static gboolean
+gst_switch_server_serve_metrics (GstSwitchServer * srv)
+{
+  GError *error = NULL;
+  guint16 port = opts.metrics_port;
+
+  if (!opts.metrics_port)
+    return TRUE;
+
+  srv->metrics = gst_switch_metrics_serve (opts.metrics_address, &port,
+      (GstSwitchMetricsFunc) gst_switch_server_append_metrics, srv, &error);
+  if (srv->metrics == NULL) {
+    ERROR ("failed to serve metrics on %s:%d: %s", opts.metrics_address,
+        opts.metrics_port, error->message);
+    g_error_free (error);
+    return FALSE;
+  }
+  INFO ("serving metrics on http://%s:%d/metrics", opts.metrics_address,
+      port);
+  return TRUE;
+}
+
+/**
+ * gst_switch_server_publish_levels:
+ *
+ * Tell the clients the audio levels, invoked every --meter-interval.
+ * Nothing is sent while no audio is metered.
+ */
+static gboolean
+gst_switch_server_publish_levels (GstSwitchServer * srv)
+{
+  GVariant *levels = gst_switch_server_get_audio_levels (srv);
+
+  g_variant_ref_sink (levels);
+  if (g_variant_n_children (levels) > 0) {
+    GST_SWITCH_SERVER_LOCK_CONTROLLER (srv);
+    if (srv->controller)
+      gst_switch_controller_tell_audio_levels (srv->controller, levels);
+    GST_SWITCH_SERVER_UNLOCK_CONTROLLER (srv);
+  }
+  g_variant_unref (levels);
+  return TRUE;
+}
+
+/**
+ * gst_switch_server_end_encoder:
+ *
+ * Invoked when an encoded output is ended.
+ */
+static void
+gst_switch_server_end_encoder (GstEncoder * enc, GstSwitchServer * srv)
+{
+  gint port = enc->sink_port;
+
+  GST_SWITCH_SERVER_LOCK_ENCODERS (srv);
+  if (g_list_find (srv->encoders, enc)) {
+    srv->encoders = g_list_remove (srv->encoders, enc);
+    INFO ("Removed %s (%d encoders left)", GST_WORKER (enc)->name,
+        g_list_length (srv->encoders));
+    g_object_unref (enc);
+  }
+  GST_SWITCH_SERVER_UNLOCK_ENCODERS (srv);
+
+  gst_switch_server_revoke_port (srv, port);
+}
+
+/**
+ * gst_switch_server_add_encoded_output:
+ *  @param codec "h264" or "vp8"
+ *  @param preset the x264 speed preset, ignored for VP8
+ *  @param bitrate the target bitrate in kbit/s, 0 for the default
+ *  @return the port the encoded output is served on, 0 on failure
+ *
+ *  Add an encoded composite output. An output with the same settings is
+ *  shared rather than encoded twice.
+ */
+gint
+gst_switch_server_add_encoded_output (GstSwitchServer * srv,
+    const gchar * codec, const gchar * preset, guint bitrate)
+{
+  GstEncoderCodec c;
+  GstEncoder *enc = NULL;
+  GList *item;
+  gchar *name;
+  gint port = 0;
+
+  g_return_val_if_fail (srv->composite, 0);
+
+  if (!gst_encoder_parse_codec (codec, &c))
+    goto error_bad_codec;
+
+  if (!preset || !*preset)
+    preset = GST_ENCODER_DEFAULT_PRESET;
+  if (c == GST_ENCODER_CODEC_H264 && !gst_encoder_is_valid_preset (preset))
+    goto error_bad_preset;
+
+  if (bitrate == 0)
+    bitrate = GST_ENCODER_DEFAULT_BITRATE;
+
+  GST_SWITCH_SERVER_LOCK_ENCODERS (srv);
+  for (item = srv->encoders; item; item = g_list_next (item)) {
+    enc = GST_ENCODER (item->data);
+    if (enc->codec == c && enc->bitrate == bitrate &&
+        (c != GST_ENCODER_CODEC_H264 || g_strcmp0 (enc->preset, preset) == 0)) {
+      port = enc->sink_port;
+      break;
+    }
+  }
+
+  if (port == 0) {
+    port = gst_switch_server_alloc_port (srv);
+    name = g_strdup_printf ("encoder-%d", port);
+    enc = GST_ENCODER (g_object_new (GST_TYPE_ENCODER, "name", name,
+            "codec", c, "preset", preset, "bitrate", bitrate, "port", port,
+            "width", srv->composite->width,
+            "height", srv->composite->height, NULL));
+    g_free (name);
+
+    g_signal_connect (enc, "start-worker",
+        G_CALLBACK (gst_switch_server_worker_start), srv);
+    g_signal_connect (enc, "worker-null",
+        G_CALLBACK (gst_switch_server_worker_null), srv);
+    g_signal_connect (enc, "end-worker",
+        G_CALLBACK (gst_switch_server_end_encoder), srv);
+
+    if (gst_worker_start (GST_WORKER (enc))) {
+      srv->encoders = g_list_append (srv->encoders, enc);
+      INFO ("encoded output %s/%s/%d on %d", codec, preset, bitrate, port);
+    } else {
+      ERROR ("failed to start encoded output %s on %d", codec, port);
+      g_object_unref (enc);
+      gst_switch_server_revoke_port (srv, port);
+      port = 0;
+    }
+  }
+  GST_SWITCH_SERVER_UNLOCK_ENCODERS (srv);
+  return port;
+
+error_bad_codec:
+  {
+    ERROR ("unsupported codec: %s", codec);
+    return 0;
+  }
+error_bad_preset:
+  {
+    ERROR ("unsupported preset: %s", preset);
+    return 0;
+  }
+}
+
+/**
+ * gst_switch_server_remove_encoded_output:
+ *  @param port the port of the encoded output
+ *  @return TRUE if the output was found and stopped
  *
- * Create the composite output worker.
+ *  Remove an encoded composite output, dropping all of its clients.
  */
-static gboolean
-gst_switch_server_create_output (GstSwitchServer * srv)
+gboolean
+gst_switch_server_remove_encoded_output (GstSwitchServer * srv, gint port)
 {
-  if (srv->output) {
-    return TRUE;
-  }
+  GstWorker *worker = NULL;
+  GList *item;
 
-  srv->output = GST_WORKER (g_object_new (GST_TYPE_WORKER,
-          "name", "output", NULL));
-  srv->output->pipeline_func_data = srv;
-  srv->output->pipeline_func = (GstWorkerGetPipelineString)
-      gst_switch_server_get_output_string;
+  GST_SWITCH_SERVER_LOCK_ENCODERS (srv);
+  for (item = srv->encoders; item; item = g_list_next (item)) {
+    if (GST_ENCODER (item->data)->sink_port == port) {
+      worker = GST_WORKER (g_object_ref (item->data));
+      break;
+    }
+  }
+  GST_SWITCH_SERVER_UNLOCK_ENCODERS (srv);
 
-  g_signal_connect (srv->output, "prepare-worker",
-      G_CALLBACK (gst_switch_server_prepare_output), srv);
-  g_signal_connect (srv->output, "start-worker",
-      G_CALLBACK (gst_switch_server_start_output), srv);
+  if (!worker) {
+    WARN ("no encoded output on %d", port);
+    return FALSE;
+  }
 
-  gst_worker_start (srv->output);
+  gst_worker_stop (worker);
+  g_object_unref (worker);
   return TRUE;
 }
 
 /**
- * gst_switch_server_create_recorder:
- * @return TRUE if the recorder is created successfully.
+ * gst_switch_server_get_encoded_outputs:
+ *  @return a floating GVariant of type a(issuuxxu), one entry per output:
+ *          port, codec, preset, target bitrate (kbit/s), measured bitrate
+ *          (bit/s), encode latency and worst latency (usec), clients.
  *
- * Creating the recorder.
+ *  Get the encoded outputs together with their statistics.
  */
-static gboolean
-gst_switch_server_create_recorder (GstSwitchServer * srv)
+GVariant *
+gst_switch_server_get_encoded_outputs (GstSwitchServer * srv)
 {
-  if (srv->recorder) {
-    return TRUE;
+  GVariantBuilder *builder;
+  GVariant *value;
+  GList *item;
+
+  builder = g_variant_builder_new (G_VARIANT_TYPE ("a(issuuxxu)"));
+  GST_SWITCH_SERVER_LOCK_ENCODERS (srv);
+  for (item = srv->encoders; item; item = g_list_next (item)) {
+    GstEncoder *enc = GST_ENCODER (item->data);
+    GstEncoderStats stats;
+    gst_encoder_get_stats (enc, &stats);
+    g_variant_builder_add (builder, "(issuuxxu)", enc->sink_port,
+        gst_encoder_codec_to_string (enc->codec), enc->preset, enc->bitrate,
+        stats.bitrate, stats.latency, stats.max_latency, stats.clients);
   }
+  GST_SWITCH_SERVER_UNLOCK_ENCODERS (srv);
+  value = g_variant_builder_end (builder);
+  g_variant_builder_unref (builder);
+  return value;
+}
+
+/**
+ * gst_switch_server_get_record_base_time:
+ *  @return the base time of the composite recorder, GST_CLOCK_TIME_NONE if
+ *          there is none
+ */
+static GstClockTime
+gst_switch_server_get_record_base_time (GstSwitchServer * srv)
+{
+  GstClockTime base_time = GST_CLOCK_TIME_NONE;
 
   GST_SWITCH_SERVER_LOCK_RECORDER (srv);
-  srv->recorder = GST_RECORDER (g_object_new (GST_TYPE_RECORDER,
-          "name", "recorder", "port",
-          srv->composite->encode_sink_port, "mode",
-          srv->composite->mode, "width",
-          srv->composite->width, "height", srv->composite->height, NULL));
+  if (srv->recorder)
+    base_time = srv->recorder->base_time;
+  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+  return base_time;
+}
 
-  g_signal_connect (srv->recorder, "start-worker",
-      G_CALLBACK (gst_switch_server_start_recorder), srv);
+/**
+ * gst_switch_server_end_iso:
+ *
+ * Invoked when an input recording is ended.
+ */
+static void
+gst_switch_server_end_iso (GstIso * iso, GstSwitchServer * srv)
+{
+  GST_SWITCH_SERVER_LOCK_ISOS (srv);
+  if (g_list_find (srv->isos, iso)) {
+    srv->isos = g_list_remove (srv->isos, iso);
+    INFO ("Removed %s (%d input recordings left)", GST_WORKER (iso)->name,
+        g_list_length (srv->isos));
+    g_object_unref (iso);
+  }
+  GST_SWITCH_SERVER_UNLOCK_ISOS (srv);
+}
 
-  gst_worker_start (GST_WORKER (srv->recorder));
-  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+/**
+ * gst_switch_server_start_iso:
+ *  @param port the port of the input
+ *  @param serve_type video or audio input
+ *
+ *  Record an input into its own file, on the timeline of the composite
+ *  recording.
+ */
+static void
+gst_switch_server_start_iso (GstSwitchServer * srv, gint port,
+    GstSwitchServeStreamType serve_type)
+{
+  GstRecorderCodec codec = GST_RECORDER_CODEC_MJPEG;
+  GstIso *iso;
+  gchar *name;
+
+  if (!gst_switch_server_get_record_filename ())
+    return;
+
+  if (opts.iso_codec)
+    gst_recorder_parse_codec (opts.iso_codec, &codec);
+
+  name = g_strdup_printf ("iso-%d", port);
+  iso = GST_ISO (g_object_new (GST_TYPE_ISO, "name", name, "port", port,
+          "serve", serve_type, "codec", codec,
+          "base-time", gst_switch_server_get_record_base_time (srv), NULL));
+  g_free (name);
+
+  g_signal_connect (iso, "start-worker",
+      G_CALLBACK (gst_switch_server_worker_start), srv);
+  g_signal_connect (iso, "worker-null",
+      G_CALLBACK (gst_switch_server_worker_null), srv);
+  g_signal_connect (iso, "end-worker",
+      G_CALLBACK (gst_switch_server_end_iso), srv);
+
+  GST_SWITCH_SERVER_LOCK_ISOS (srv);
+  if (gst_worker_start (GST_WORKER (iso))) {
+    srv->isos = g_list_append (srv->isos, iso);
+    INFO ("recording input %d", port);
+  } else {
+    ERROR ("failed to record input %d", port);
+    g_object_unref (iso);
+  }
+  GST_SWITCH_SERVER_UNLOCK_ISOS (srv);
+}
+
+/**
+ * gst_switch_server_stop_iso:
+ *  @param port the port of the input
+ *
+ *  Stop recording an input, closing out its file.
+ */
+static void
+gst_switch_server_stop_iso (GstSwitchServer * srv, gint port)
+{
+  GstWorker *worker = NULL;
+  GList *item;
+
+  GST_SWITCH_SERVER_LOCK_ISOS (srv);
+  for (item = srv->isos; item; item = g_list_next (item)) {
+    if (GST_ISO (item->data)->sink_port == port) {
+      worker = GST_WORKER (g_object_ref (item->data));
+      break;
+    }
+  }
+  GST_SWITCH_SERVER_UNLOCK_ISOS (srv);
+
+  if (worker) {
+    gst_worker_stop (worker);
+    g_object_unref (worker);
+  }
+}
+
+/**
+ * gst_switch_server_new_iso_record:
+ *
+ *  Roll the input recordings over to new files. If the composite recorder
+ *  was restarted, they are restarted too, onto its new timeline.
+ */
+static void
+gst_switch_server_new_iso_record (GstSwitchServer * srv)
+{
+  GstClockTime base_time = gst_switch_server_get_record_base_time (srv);
+  GList *item, *restart = NULL;
+
+  GST_SWITCH_SERVER_LOCK_ISOS (srv);
+  for (item = srv->isos; item; item = g_list_next (item)) {
+    GstIso *iso = GST_ISO (item->data);
+    if (iso->base_time != base_time || !gst_iso_new_fragment (iso))
+      restart = g_list_append (restart, g_object_ref (iso));
+  }
+  GST_SWITCH_SERVER_UNLOCK_ISOS (srv);
+
+  for (item = restart; item; item = g_list_next (item)) {
+    GstIso *iso = GST_ISO (item->data);
+    gst_worker_stop (GST_WORKER (iso));
+    gst_switch_server_start_iso (srv, iso->sink_port, iso->serve_type);
+  }
+  g_list_free_full (restart, g_object_unref);
+}
+
+/**
+ * gst_switch_server_get_iso_stats:
+ *  @return a floating GVariant of type a(issttdtt), one entry per input
+ *          recording: input port, "video" or "audio", the file being
+ *          written, frames and bytes written, the encoder CPU time in
+ *          percent of one core, the bytes/s written, and the time waited
+ *          for an encode slot in usec.
+ *
+ *  Get the input recordings together with their costs.
+ */
+GVariant *
+gst_switch_server_get_iso_stats (GstSwitchServer * srv)
+{
+  GVariantBuilder *builder;
+  GVariant *value;
+  GList *item;
+
+  builder = g_variant_builder_new (G_VARIANT_TYPE ("a(issttdtt)"));
+  GST_SWITCH_SERVER_LOCK_ISOS (srv);
+  for (item = srv->isos; item; item = g_list_next (item)) {
+    GstIso *iso = GST_ISO (item->data);
+    GstIsoStats stats;
+    gst_iso_get_stats (iso, &stats);
+    g_variant_builder_add (builder, "(issttdtt)", iso->sink_port,
+        iso->serve_type == GST_SERVE_AUDIO_STREAM ? "audio" : "video",
+        stats.location, stats.frames, stats.bytes, stats.cpu,
+        stats.throughput, stats.wait);
+    g_free (stats.location);
+  }
+  GST_SWITCH_SERVER_UNLOCK_ISOS (srv);
+  value = g_variant_builder_end (builder);
+  g_variant_builder_unref (builder);
+  return value;
+}
+
+/**
+ * gst_switch_server_end_replay:
+ *
+ * Invoked when a replay ring is ended.
+ */
+static void
+gst_switch_server_end_replay (GstReplay * replay, GstSwitchServer * srv)
+{
+  GST_SWITCH_SERVER_LOCK_REPLAYS (srv);
+  if (g_list_find (srv->replays, replay)) {
+    srv->replays = g_list_remove (srv->replays, replay);
+    INFO ("Removed %s (%d replay rings left)", GST_WORKER (replay)->name,
+        g_list_length (srv->replays));
+    g_object_unref (replay);
+  }
+  GST_SWITCH_SERVER_UNLOCK_REPLAYS (srv);
+}
+
+/**
+ * gst_switch_server_start_replay:
+ *  @param port the port of the input, or the compose port
+ *  @param program TRUE to keep the program rather than an input
+ *
+ *  Keep the last seconds of an input or the program in memory.
+ */
+static void
+gst_switch_server_start_replay (GstSwitchServer * srv, gint port,
+    gboolean program)
+{
+  GstReplay *replay;
+  gchar *name;
+
+  name = g_strdup_printf ("replay-%d", port);
+  replay = GST_REPLAY (g_object_new (GST_TYPE_REPLAY, "name", name,
+          "port", port, "program", program,
+          "width", srv->composite->width, "height", srv->composite->height,
+          "seconds", opts.replay_seconds, "quality", opts.replay_quality,
+          NULL));
+  g_free (name);
+
+  g_signal_connect (replay, "start-worker",
+      G_CALLBACK (gst_switch_server_worker_start), srv);
+  g_signal_connect (replay, "worker-null",
+      G_CALLBACK (gst_switch_server_worker_null), srv);
+  g_signal_connect (replay, "end-worker",
+      G_CALLBACK (gst_switch_server_end_replay), srv);
+
+  GST_SWITCH_SERVER_LOCK_REPLAYS (srv);
+  if (gst_worker_start (GST_WORKER (replay))) {
+    srv->replays = g_list_append (srv->replays, replay);
+    INFO ("keeping %d seconds of %s %d", opts.replay_seconds,
+        program ? "program" : "input", port);
+  } else {
+    ERROR ("failed to keep replays of %d", port);
+    g_object_unref (replay);
+  }
+  GST_SWITCH_SERVER_UNLOCK_REPLAYS (srv);
+}
+
+/**
+ * gst_switch_server_get_replay:
+ *  @param port the port of the input, or the compose port
+ *  @return the replay ring of the port, unref after use, NULL if none
+ */
+static GstReplay *
+gst_switch_server_get_replay (GstSwitchServer * srv, gint port)
+{
+  GstReplay *replay = NULL;
+  GList *item;
+
+  GST_SWITCH_SERVER_LOCK_REPLAYS (srv);
+  for (item = srv->replays; item; item = g_list_next (item)) {
+    if (GST_REPLAY (item->data)->sink_port == port) {
+      replay = GST_REPLAY (g_object_ref (item->data));
+      break;
+    }
+  }
+  GST_SWITCH_SERVER_UNLOCK_REPLAYS (srv);
+  return replay;
+}
+
+/**
+ * gst_switch_server_stop_replay:
+ *  @param port the port of the input
+ *
+ *  Stop keeping replays of an input, freeing its ring.
+ */
+static void
+gst_switch_server_stop_replay (GstSwitchServer * srv, gint port)
+{
+  GstReplay *replay = gst_switch_server_get_replay (srv, port);
+
+  if (replay) {
+    gst_worker_stop (GST_WORKER (replay));
+    g_object_unref (replay);
+  }
+}
+
+/**
+ * gst_switch_server_replay_mark_in:
+ *  @param port the port of the input, or the compose port for the program
+ *  @return TRUE if marked, FALSE if the port has no replay ring
+ *
+ *  Mark the start of a replay clip, now.
+ */
+gboolean
+gst_switch_server_replay_mark_in (GstSwitchServer * srv, gint port)
+{
+  GstReplay *replay = gst_switch_server_get_replay (srv, port);
+
+  if (!replay) {
+    WARN ("no replay ring on %d", port);
+    return FALSE;
+  }
+
+  gst_replay_mark_in (replay);
+  g_object_unref (replay);
+  return TRUE;
+}
+
+/**
+ * gst_switch_server_replay_mark_out:
+ *  @param port the port of the input, or the compose port for the program
+ *  @return TRUE if marked, FALSE if there is no ring or no in point
+ *
+ *  Mark the end of a replay clip, now.
+ */
+gboolean
+gst_switch_server_replay_mark_out (GstSwitchServer * srv, gint port)
+{
+  GstReplay *replay = gst_switch_server_get_replay (srv, port);
+  gboolean marked;
+
+  if (!replay) {
+    WARN ("no replay ring on %d", port);
+    return FALSE;
+  }
+
+  marked = gst_replay_mark_out (replay);
+  if (!marked)
+    WARN ("no replay in point on %d", port);
+  g_object_unref (replay);
+  return marked;
+}
+
+/**
+ * gst_switch_server_replay_play:
+ *  @param port the port of the input, or the compose port for the program
+ *  @param speed the playback speed, below 1 for slow motion
+ *  @return the port of the new input playing the clip, 0 on failure
+ *
+ *  Play the marked clip back, over and over, as a new video input. It can
+ *  be switched to like any other input until it's stopped.
+ */
+gint
+gst_switch_server_replay_play (GstSwitchServer * srv, gint port,
+    gdouble speed)
+{
+  GstReplay *replay;
+  GstReplayClip *clip;
+  GstCase *input;
+  gchar *name;
+  gint play_port;
+
+  if (speed < GST_REPLAY_MIN_SPEED || GST_REPLAY_MAX_SPEED < speed) {
+    ERROR ("invalid replay speed %f", speed);
+    return 0;
+  }
+
+  replay = gst_switch_server_get_replay (srv, port);
+  if (!replay) {
+    WARN ("no replay ring on %d", port);
+    return 0;
+  }
+
+  clip = gst_replay_get_clip (replay);
+  g_object_unref (replay);
+  if (!clip) {
+    WARN ("no replay clip marked on %d", port);
+    return 0;
+  }
+
+  GST_SWITCH_SERVER_LOCK_SERVE (srv);
+  play_port = gst_switch_server_alloc_port (srv);
+
+  name = g_strdup_printf ("input_%d", play_port);
+  input = GST_CASE (g_object_new (GST_TYPE_REPLAY_PLAYER, "name", name,
+          "type", GST_CASE_INPUT_VIDEO, "port", play_port,
+          "serve", GST_SERVE_VIDEO_STREAM, "clip", clip, "speed", speed,
+          NULL));
+  g_free (name);
+
+  if (gst_switch_server_serve_input (srv, input)) {
+    INFO ("replaying %d clip frames of %d on %d at %.2fx",
+        clip->frames->len, port, play_port, speed);
+  } else {
+    ERROR ("failed to replay %d", port);
+    gst_switch_server_revoke_port (srv, play_port);
+    play_port = 0;
+  }
+  GST_SWITCH_SERVER_UNLOCK_SERVE (srv);
+  return play_port;
+}
+
+/**
+ * gst_switch_server_replay_stop:
+ *  @param port the port of the input playing a replay
+ *  @return TRUE if the replay was found and stopped
+ *
+ *  Stop playing a replay, ending its input.
+ */
+gboolean
+gst_switch_server_replay_stop (GstSwitchServer * srv, gint port)
+{
+  GstWorker *worker = NULL;
+  GList *item;
+
+  GST_SWITCH_SERVER_LOCK_CASES (srv);
+  for (item = srv->cases; item; item = g_list_next (item)) {
+    if (GST_IS_REPLAY_PLAYER (item->data)
+        && GST_CASE (item->data)->sink_port == port) {
+      worker = GST_WORKER (g_object_ref (item->data));
+      break;
+    }
+  }
+  GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+
+  if (!worker) {
+    WARN ("no replay playing on %d", port);
+    return FALSE;
+  }
+
+  gst_worker_stop (worker);
+  g_object_unref (worker);
   return TRUE;
 }
 
+/**
+ * gst_switch_server_get_replay_stats:
+ *  @return a floating GVariant of type a(isdtttxx), one entry per replay
+ *          ring: the input or compose port, "input" or "program", the
+ *          seconds, frames and bytes held, the bytes per second of ring,
+ *          and the usec since the in and out points, -1 if not marked.
+ *
+ *  Get the replay rings together with their memory use.
+ */
+GVariant *
+gst_switch_server_get_replay_stats (GstSwitchServer * srv)
+{
+  GVariantBuilder *builder;
+  GVariant *value;
+  GList *item;
+
+  builder = g_variant_builder_new (G_VARIANT_TYPE ("a(isdtttxx)"));
+  GST_SWITCH_SERVER_LOCK_REPLAYS (srv);
+  for (item = srv->replays; item; item = g_list_next (item)) {
+    GstReplay *replay = GST_REPLAY (item->data);
+    GstReplayStats stats;
+    gst_replay_get_stats (replay, &stats);
+    g_variant_builder_add (builder, "(isdtttxx)", replay->sink_port,
+        replay->program ? "program" : "input", stats.seconds, stats.frames,
+        stats.bytes, stats.bytes_per_second, stats.mark_in, stats.mark_out);
+  }
+  GST_SWITCH_SERVER_UNLOCK_REPLAYS (srv);
+  value = g_variant_builder_end (builder);
+  g_variant_builder_unref (builder);
+  return value;
+}
+
 /*
 gboolean timeout(gpointer user_data) {
   INFO ("Exiting!");
@@ -1769,6 +4165,23 @@ gst_switch_server_run (GstSwitchServer * srv)
   if (!gst_switch_server_create_recorder (srv))
     goto error_prepare_recorder;
 
+  if (opts.replay_seconds)
+    gst_switch_server_start_replay (srv, srv->composite->sink_port, TRUE);
+
+  if (opts.audio_mix && !gst_switch_server_create_mixer (srv))
+    goto error_prepare_mixer;
+
+  if (opts.meter_interval)
+    g_timeout_add (opts.meter_interval,
+        (GSourceFunc) gst_switch_server_publish_levels, srv);
+
+  if (opts.stats_interval)
+    g_timeout_add (opts.stats_interval,
+        (GSourceFunc) gst_switch_server_publish_stats, srv);
+
+  if (!gst_switch_server_serve_metrics (srv))
+    goto error_serve_metrics;
+
   srv->video_acceptor = g_thread_new ("switch-server-video-acceptor",
       (GThreadFunc)
       gst_switch_server_video_acceptor, srv);
@@ -1808,6 +4221,16 @@ error_prepare_recorder:
     ERROR ("error preparing server");
     return;
   }
+error_prepare_mixer:
+  {
+    ERROR ("error preparing server");
+    return;
+  }
+error_serve_metrics:
+  {
+    ERROR ("error preparing server");
+    return;
+  }
 }
 
 static unsigned long long i = 0;
@@ -24,7 +24,11 @@
 
 #include <gio/gio.h>
 #include "gstcomposite.h"
+#include "gstmultiview.h"
+#include "gstmixer.h"
+#include "gstloudness.h"
 #include "gstswitchcontroller.h"
+#include "gstswitchmetrics.h"
 #include "../logutils.h"
 
 #define GST_TYPE_SWITCH_SERVER (gst_switch_server_get_type())
@@ -35,6 +39,19 @@
 
 #define GST_SWITCH_MIN_SINK_PORT 1
 #define GST_SWITCH_MAX_SINK_PORT 65535
+#define GST_SWITCH_SERVER_DEFAULT_STATS_INTERVAL 1000   /* ms */
+#define GST_SWITCH_SERVER_DEFAULT_METRICS_ADDRESS "127.0.0.1"
+
+/* tcpserversink settings of the raw serving points: always keep the latest
+ * buffer queued and burst it to new clients, right after the GDP stream
+ * header, so they can show a frame at once. */
+#define GST_SWITCH_SERVE_LATEST_BUFFER \
+  "sync-method=burst burst-format=buffers burst-value=1 buffers-min=1"
+
+/* tcpserversink settings of the encoded serving points: keep the latest
+ * keyframe queued and start new clients on it. */
+#define GST_SWITCH_SERVE_LATEST_KEYFRAME \
+  "sync-method=latest-keyframe recover-policy=keyframe time-min=2000000000"
 
 typedef struct _GstRecorder GstRecorder;
 typedef struct _GstSwitchServerClass GstSwitchServerClass;
@@ -46,6 +63,36 @@ typedef struct _GstSwitchServerOpts GstSwitchServerOpts;
  *  @param controller_address the dbus address for the controller
  *  @param video_input_port the video input TCP port
  *  @param audio_input_port the audio input TCP port
+ *  @param client_policy what to do with clients falling behind
+ *  @param client_lag how far behind clients may fall, in msec
+ *  @param record_max_size start a new recording file after this many MB
+ *  @param record_max_time start a new recording file after this many seconds
+ *  @param record_codec the recording codec name
+ *  @param record_quality the MJPEG recording quality
+ *  @param record_threads the MJPEG or H.264 recording encoder threads
+ *  @param record_buffer the recording disk buffer size in MB
+ *  @param record_iso also record every input into its own file
+ *  @param iso_codec the video codec name of the input recordings
+ *  @param iso_threads the frames all input recordings may encode at once
+ *  @param replay_seconds the seconds of the replay rings, 0 for none
+ *  @param replay_quality the JPEG quality of the replay rings
+ *  @param audio_mix mix all audio inputs instead of switching one
+ *  @param meter_interval msec between audio level signals, 0 for none
+ *  @param audio_follow_video crossfade the mix to the audio paired with A
+ *  @param audio_period msec of audio per buffer in the audio engine, 0 for
+ *         the default buffering
+ *  @param audio_realtime run the audio threads with SCHED_FIFO
+ *  @param pool_size stopped pipelines kept for reuse per shape
+ *  @param state_timeout msec a pipeline state change or the EOS of a clean
+ *         stop may take, 0 for no limit
+ *  @param watchdog msec a live pipeline may go without buffers before it is
+ *         restarted, 0 for no watchdog
+ *  @param stats_interval msec between pipeline statistics signals, 0 for
+ *         none
+ *  @param measure_latency decode the latencystamp barcodes of the inputs on
+ *         the output and the preview branches
+ *  @param metrics_port the HTTP port serving the metrics, 0 for none
+ *  @param metrics_address the local address of %metrics_port
  */
 struct _GstSwitchServerOpts
 {
@@ -60,6 +107,31 @@ struct _GstSwitchServerOpts
   GstCaps *video_caps;
   gchar *video_caps_str;
   gchar *audio_caps_str;
+  GstWorkerClientPolicy client_policy;
+  gint client_lag;
+  gint record_max_size;
+  gint record_max_time;
+  gchar *record_codec;
+  gint record_quality;
+  gint record_threads;
+  gint record_buffer;
+  gboolean record_iso;
+  gchar *iso_codec;
+  gint iso_threads;
+  gint replay_seconds;
+  gint replay_quality;
+  gboolean audio_mix;
+  gint meter_interval;
+  gboolean audio_follow_video;
+  gint audio_period;
+  gboolean audio_realtime;
+  gint pool_size;
+  gint state_timeout;
+  gint watchdog;
+  gint stats_interval;
+  gboolean measure_latency;
+  gint metrics_port;
+  gchar *metrics_address;
 };
 
 /**
@@ -93,6 +165,18 @@ struct _GstSwitchServerOpts
  *  @param output the output instance
  *  @param recorder_lock the lock for the %recorder
  *  @param recorder the recorder instance
+ *  @param encoders_lock the lock for %encoders
+ *  @param encoders the encoded composite outputs
+ *  @param isos_lock the lock for %isos
+ *  @param isos the input recordings
+ *  @param replays_lock the lock for %replays
+ *  @param replays the replay rings of the inputs and the program
+ *  @param multiview_lock the lock for %multiview
+ *  @param multiview the multiview monitor output
+ *  @param mixer_lock the lock for %mixer
+ *  @param mixer the audio mixer, NULL unless mixing
+ *  @param audio_pairs the audio port paired with each video port
+ *  @param loudness the loudness of the composite audio
  *  @param pip_lock the lock for PIP
  *  @param pip_x the PIP X position
  *  @param pip_y the PIP Y position
@@ -100,6 +184,11 @@ struct _GstSwitchServerOpts
  *  @param pip_h the PIP height
  *  @param clock_lock the lock for %clock
  *  @param clock a system clock
+ *  @param switch_latency the time from a switch to the new composite input
+ *  @param mode_latency the time from a mode change to its transition end
+ *  @param mode_started when the pending mode change was asked, locked with
+ *         %pip_lock
+ *  @param metrics the HTTP service of the metrics, NULL unless serving
  */
 struct _GstSwitchServer
 {
@@ -140,11 +229,33 @@ struct _GstSwitchServer
   GMutex recorder_lock;
   GstRecorder *recorder;
 
+  GMutex encoders_lock;
+  GList *encoders;
+
+  GMutex isos_lock;
+  GList *isos;
+
+  GMutex replays_lock;
+  GList *replays;
+
+  GMutex multiview_lock;
+  GstMultiview *multiview;
+
+  GMutex mixer_lock;
+  GstMixer *mixer;
+  GHashTable *audio_pairs;
+  GstLoudness loudness;
+
   GMutex pip_lock;
   gint pip_x, pip_y, pip_w, pip_h;
 
   GMutex clock_lock;
   GstClock *clock;
+
+  GstSwitchMetricsHistogram switch_latency;
+  GstSwitchMetricsHistogram mode_latency;
+  gint64 mode_started;
+  GSocketService *metrics;
 };
 
 /**
@@ -174,6 +285,42 @@ void gst_switch_server_mark_face (GstSwitchServer * srv,
 guint gst_switch_server_adjust_pip (GstSwitchServer * srv, gint dx, gint dy,
     gint dw, gint dh);
 gboolean gst_switch_server_new_record (GstSwitchServer * srv);
+GVariant *gst_switch_server_get_record_stats (GstSwitchServer * srv);
+GVariant *gst_switch_server_get_iso_stats (GstSwitchServer * srv);
+gboolean gst_switch_server_replay_mark_in (GstSwitchServer * srv, gint port);
+gboolean gst_switch_server_replay_mark_out (GstSwitchServer * srv, gint port);
+gint gst_switch_server_replay_play (GstSwitchServer * srv, gint port,
+    gdouble speed);
+gboolean gst_switch_server_replay_stop (GstSwitchServer * srv, gint port);
+GVariant *gst_switch_server_get_replay_stats (GstSwitchServer * srv);
+gint gst_switch_server_add_encoded_output (GstSwitchServer * srv,
+    const gchar * codec, const gchar * preset, guint bitrate);
+gboolean gst_switch_server_remove_encoded_output (GstSwitchServer * srv,
+    gint port);
+GVariant *gst_switch_server_get_encoded_outputs (GstSwitchServer * srv);
+gint gst_switch_server_get_preview_thumbnail (GstSwitchServer * srv,
+    gint port, gint width, gint height, gint rate, gboolean jpeg);
+GVariant *gst_switch_server_get_branch_stats (GstSwitchServer * srv);
+GVariant *gst_switch_server_get_client_stats (GstSwitchServer * srv);
+gint gst_switch_server_set_multiview (GstSwitchServer * srv, gint width,
+    gint height, gint columns, gboolean jpeg);
+gint gst_switch_server_get_multiview_port (GstSwitchServer * srv);
+gboolean gst_switch_server_set_audio_mix (GstSwitchServer * srv, gint port,
+    gdouble gain, gboolean mute, gdouble pan);
+GVariant *gst_switch_server_get_audio_mix (GstSwitchServer * srv);
+GVariant *gst_switch_server_get_audio_levels (GstSwitchServer * srv);
+gboolean gst_switch_server_set_av_offset (GstSwitchServer * srv, gint port,
+    gint64 offset);
+GVariant *gst_switch_server_get_av_offsets (GstSwitchServer * srv);
+gboolean gst_switch_server_pair_audio (GstSwitchServer * srv,
+    gint video_port, gint audio_port);
+GVariant *gst_switch_server_get_audio_latency (GstSwitchServer * srv);
+GVariant *gst_switch_server_get_loudness (GstSwitchServer * srv);
+GVariant *gst_switch_server_get_watchdog_stats (GstSwitchServer * srv);
+GVariant *gst_switch_server_get_stats (GstSwitchServer * srv);
+GVariant *gst_switch_server_get_latency (GstSwitchServer * srv);
+void gst_switch_server_append_latency_detect (GString * desc,
+    const gchar * path);
 
 GstCaps *gst_switch_server_getcaps (void);
 const gchar *gst_switch_server_get_audio_caps_str (void);
@@ -24,6 +24,7 @@
 #endif
 
 #include <stdlib.h>
+#include <math.h>
 #include "gstswitchui.h"
 #include "gstswitchcontroller.h"
 #include "gstvideodisp.h"
@@ -31,6 +32,7 @@
 #include "gstcase.h"
 
 #define GST_SWITCH_UI_DEFAULT_ADDRESS "tcp:host=127.0.0.1,port=5000"
+#define GST_SWITCH_UI_DEFAULT_THUMBNAIL_WIDTH 160
 #define GST_SWITCH_UI_LOCK_AUDIO(ui) (g_mutex_lock (&(ui)->audio_lock))
 #define GST_SWITCH_UI_UNLOCK_AUDIO(ui) (g_mutex_unlock (&(ui)->audio_lock))
 #define GST_SWITCH_UI_LOCK_COMPOSE(ui) (g_mutex_lock (&(ui)->compose_lock))
@@ -46,6 +48,10 @@ G_DEFINE_TYPE (GstSwitchUI, gst_switch_ui, GST_TYPE_SWITCH_CLIENT);
 
 gboolean verbose;
 gchar *srv_address = GST_SWITCH_UI_DEFAULT_ADDRESS;
+gint thumbnail_width = GST_SWITCH_UI_DEFAULT_THUMBNAIL_WIDTH;
+gint thumbnail_rate = 0;
+gboolean thumbnail_jpeg = FALSE;
+gboolean measure_latency = FALSE;
 
 static GOptionEntry entries[] = {
   {"verbose", 'v', 0, G_OPTION_ARG_NONE, &verbose, "Be verbose", NULL},
@@ -54,6 +60,17 @@ static GOptionEntry entries[] = {
   {"address", 'a', 0, G_OPTION_ARG_STRING, &srv_address,
         "Server Control-Adress, defaults to " GST_SWITCH_UI_DEFAULT_ADDRESS,
       NULL},
+  {"thumbnail-width", 't', 0, G_OPTION_ARG_INT, &thumbnail_width,
+      "Width of the preview thumbnails, 0 for full size previews", "NUM"},
+  {"thumbnail-rate", 'r', 0, G_OPTION_ARG_INT, &thumbnail_rate,
+      "Frame rate of the preview thumbnails, 0 for the input rate", "NUM"},
+  {"thumbnail-jpeg", 'j', 0, G_OPTION_ARG_NONE, &thumbnail_jpeg,
+      "Request JPEG-compressed preview thumbnails (for remote servers)",
+      NULL},
+  {"measure-latency", 0, 0, G_OPTION_ARG_NONE, &measure_latency,
+        "Measure the latency of inputs stamped by latencystamp on every "
+        "display, printed when the display ends",
+      NULL},
   {NULL}
 };
 
@@ -407,15 +424,21 @@ gst_switch_ui_prepare_videos (GstSwitchUI * ui)
 static gboolean
 gst_switch_ui_tick (GstSwitchUI * ui)
 {
-  if (ui->audio) {
+  if (ui->audio || ui->meter_time) {
     gboolean stucked = FALSE;
     gboolean silent = FALSE;
     GstClockTime endtime, diff;
     gdouble value = 0;
     GST_SWITCH_UI_LOCK_AUDIO (ui);
-    endtime = gst_audio_visual_get_endtime (ui->audio);
+    if (ui->meter_time) {
+      /* metered by the server, stuck when the levels stop coming */
+      endtime = ui->meter_time * GST_USECOND;
+      value = ui->meter_value;
+    } else {
+      endtime = gst_audio_visual_get_endtime (ui->audio);
+      value = gst_audio_visual_get_value (ui->audio);
+    }
     diff = endtime - ui->audio_endtime;
-    value = gst_audio_visual_get_value (ui->audio);
     stucked = ((GST_MSECOND * 700) <= diff);
     if (ui->audio_value == value)
       ui->audio_stuck_count += 1;
@@ -485,13 +508,20 @@ gst_switch_ui_run (GstSwitchUI * ui)
  * @memberof GstSwitchUI
  */
 static GstVideoDisp *
-gst_switch_ui_new_video_disp (GstSwitchUI * ui, GtkWidget * view, gint port)
+gst_switch_ui_new_video_disp_full (GstSwitchUI * ui, GtkWidget * view,
+    gint port, gint source_port, gboolean jpeg)
 {
   gchar *name = g_strdup_printf ("video-%d", port);
   GdkWindow *xview = gtk_widget_get_window (view);
   GstVideoDisp *disp = GST_VIDEO_DISP (g_object_new (GST_TYPE_VIDEO_DISP,
           "name", name, "port",
           port,
+          "source-port",
+          source_port,
+          "jpeg",
+          jpeg,
+          "latency",
+          measure_latency,
           "handle",
           (gulong)
           GDK_WINDOW_XID (xview),
@@ -503,6 +533,43 @@ gst_switch_ui_new_video_disp (GstSwitchUI * ui, GtkWidget * view, gint port)
   return disp;
 }
 
+/**
+ * @brief
+ * @param ui The GstSwitchUI instance.
+ * @param view
+ * @param port
+ * @memberof GstSwitchUI
+ */
+static GstVideoDisp *
+gst_switch_ui_new_video_disp (GstSwitchUI * ui, GtkWidget * view, gint port)
+{
+  return gst_switch_ui_new_video_disp_full (ui, view, port, 0, FALSE);
+}
+
+/**
+ * @brief Display a preview port, through a server side thumbnail if
+ *        one is available.
+ * @param ui The GstSwitchUI instance.
+ * @param view
+ * @param port
+ * @memberof GstSwitchUI
+ */
+static GstVideoDisp *
+gst_switch_ui_new_preview_disp (GstSwitchUI * ui, GtkWidget * view, gint port)
+{
+  gint thumbnail = 0;
+
+  if (thumbnail_width > 0) {
+    thumbnail = gst_switch_client_get_preview_thumbnail (GST_SWITCH_CLIENT
+        (ui), port, thumbnail_width, 0, thumbnail_rate, thumbnail_jpeg);
+    if (thumbnail == 0)
+      WARN ("no thumbnail for %d, using full size preview", port);
+  }
+
+  return gst_switch_ui_new_video_disp_full (ui, view, port, thumbnail,
+      thumbnail ? thumbnail_jpeg : FALSE);
+}
+
 /**
  * @brief
  * @param ui The GstSwitchUI instance.
@@ -526,7 +593,8 @@ gst_switch_ui_new_audio_visual_unsafe (GstSwitchUI * ui, GtkWidget * view,
   visual =
       GST_AUDIO_VISUAL (g_object_new
       (GST_TYPE_AUDIO_VISUAL, "name", name, "port", port,
-          "handle", handle, "active", (ui->audio_port == port), NULL));
+          "handle", handle, "active", (ui->audio_port == port),
+          "meter", (ui->meter_time == 0), NULL));
   g_free (name);
   if (!gst_worker_start (GST_WORKER (visual)))
     ERROR ("failed to start audio visual");
@@ -884,7 +952,7 @@ gst_switch_ui_add_preview_port (GstSwitchUI * ui, gint port, gint serve,
 
   switch (serve) {
     case GST_SERVE_VIDEO_STREAM:
-      disp = gst_switch_ui_new_video_disp (ui, preview, port);
+      disp = gst_switch_ui_new_preview_disp (ui, preview, port);
       disp->type = type;
       g_object_set_data (G_OBJECT (frame), "video-display", disp);
       g_signal_connect (G_OBJECT (disp), "end-worker",
@@ -926,6 +994,34 @@ gst_switch_ui_show_face_marker (GstSwitchUI * ui, GVariant * faces)
   GST_SWITCH_UI_UNLOCK_FACES (ui);
 }
 
+/**
+ * @brief Take the level of the active audio from the server levels.
+ * @param ui The GstSwitchUI instance.
+ * @param levels the "audio_levels" signal parameters, (a(iddd))
+ * @memberof GstSwitchUI
+ *
+ * Once the server meters the audio, new audio previews leave out their
+ * own level element.
+ */
+static void
+gst_switch_ui_audio_levels (GstSwitchUI * ui, GVariant * levels)
+{
+  GVariantIter *iter;
+  gdouble rms, peak, decay;
+  gint port;
+
+  g_variant_get (levels, "(a(iddd))", &iter);
+  GST_SWITCH_UI_LOCK_AUDIO (ui);
+  while (g_variant_iter_loop (iter, "(iddd)", &port, &rms, &peak, &decay)) {
+    if (port == ui->audio_port) {
+      ui->meter_value = pow (10, rms / 20);
+      ui->meter_time = g_get_monotonic_time ();
+    }
+  }
+  GST_SWITCH_UI_UNLOCK_AUDIO (ui);
+  g_variant_iter_free (iter);
+}
+
 static void
 gst_switch_ui_show_track_marker (GstSwitchUI * ui, GVariant * tracking)
 {
@@ -1307,6 +1403,8 @@ gst_switch_ui_class_init (GstSwitchUIClass * klass)
       gst_switch_ui_show_face_marker;
   client_class->show_track_marker = (GstSwitchClientShowFaceMarkerFunc)
       gst_switch_ui_show_track_marker;
+  client_class->audio_levels = (GstSwitchClientAudioLevelsFunc)
+      gst_switch_ui_audio_levels;
 }
 
 /**
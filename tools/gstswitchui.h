@@ -67,6 +67,8 @@ struct _GstSwitchUI
   GstClockTime audio_endtime;
   gdouble audio_value;
   gint audio_stuck_count;
+  gdouble meter_value;
+  gint64 meter_time;
 
   GMutex compose_lock;
   GstVideoDisp *compose;
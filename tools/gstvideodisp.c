@@ -33,6 +33,9 @@ enum
 {
   PROP_0,
   PROP_PORT,
+  PROP_SOURCE_PORT,
+  PROP_JPEG,
+  PROP_LATENCY,
   PROP_HANDLE,
 };
 
@@ -91,6 +94,15 @@ gst_video_disp_set_property (GstVideoDisp * disp, guint property_id,
     case PROP_PORT:
       disp->port = g_value_get_uint (value);
       break;
+    case PROP_SOURCE_PORT:
+      disp->source_port = g_value_get_uint (value);
+      break;
+    case PROP_JPEG:
+      disp->jpeg = g_value_get_boolean (value);
+      break;
+    case PROP_LATENCY:
+      disp->latency = g_value_get_boolean (value);
+      break;
     case PROP_HANDLE:
       disp->handle = g_value_get_ulong (value);
       break;
@@ -116,6 +128,15 @@ gst_video_disp_get_property (GstVideoDisp * disp, guint property_id,
     case PROP_PORT:
       g_value_set_uint (value, disp->port);
       break;
+    case PROP_SOURCE_PORT:
+      g_value_set_uint (value, disp->source_port);
+      break;
+    case PROP_JPEG:
+      g_value_set_boolean (value, disp->jpeg);
+      break;
+    case PROP_LATENCY:
+      g_value_set_boolean (value, disp->latency);
+      break;
     case PROP_HANDLE:
       g_value_set_ulong (value, disp->handle);
       break;
@@ -140,8 +161,13 @@ gst_video_disp_get_pipeline_string (GstVideoDisp * disp)
   desc = g_string_new ("");
 
   g_string_append_printf (desc, "tcpclientsrc name=source "
-      "port=%d ", disp->port);
+      "port=%d ", disp->source_port ? disp->source_port : disp->port);
   g_string_append_printf (desc, "! gdpdepay ");
+  if (disp->jpeg)
+    g_string_append_printf (desc, "! jpegdec ");
+  /* still in the served format, before the overlay needs RGB */
+  if (disp->latency)
+    g_string_append_printf (desc, "! latencydetect path=ui_%d ", disp->port);
   g_string_append_printf (desc, "! videoconvert ");
   g_string_append_printf (desc, "! cairooverlay name=overlay ");
   g_string_append_printf (desc, "! videoconvert ");
@@ -197,6 +223,22 @@ gst_video_disp_class_init (GstVideoDispClass * klass)
           GST_SWITCH_MIN_SINK_PORT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (object_class, PROP_SOURCE_PORT,
+      g_param_spec_uint ("source-port", "Source Port",
+          "Port to read from if not the sink port, e.g. a thumbnail",
+          0, GST_SWITCH_MAX_SINK_PORT, 0,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_JPEG,
+      g_param_spec_boolean ("jpeg", "JPEG",
+          "The source is JPEG encoded", FALSE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_LATENCY,
+      g_param_spec_boolean ("latency", "Latency",
+          "Measure the latency of latencystamp codes", FALSE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   g_object_class_install_property (object_class, PROP_HANDLE,
       g_param_spec_ulong ("handle", "Handle",
           "Window Handle", 0,
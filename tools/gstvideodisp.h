@@ -42,6 +42,9 @@ struct _GstVideoDisp
 {
   GstWorker base;               /*!< The parent object. */
   gint port;                    /*!< The port number. */
+  gint source_port;             /*!< The port actually read from, e.g. a thumbnail, 0 for %port. */
+  gboolean jpeg;                /*!< TRUE if the source is JPEG encoded. */
+  gboolean latency;             /*!< TRUE to decode the latencystamp codes. */
   gint type;                    /*!< The video type. */
   gulong handle;                /*!< The X Window handle for displaying the video. */
 };
@@ -28,6 +28,10 @@
 #include "gstswitchserver.h"
 
 #include <string.h>
+#ifdef G_OS_UNIX
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #define GST_WORKER_LOCK_PIPELINE(srv) (g_mutex_lock (&(srv)->pipeline_lock))
 #define GST_WORKER_UNLOCK_PIPELINE(srv) (g_mutex_unlock (&(srv)->pipeline_lock))
@@ -52,6 +56,58 @@ static guint gst_worker_signals[SIGNAL__LAST] = { 0 };
 
 extern gboolean verbose;
 
+/*!< @internal the client queue policy of the serving points */
+static GstWorkerClientPolicy gst_worker_client_policy =
+    GST_WORKER_CLIENT_DROP_TO_NEWEST;
+static guint gst_worker_client_lag = GST_WORKER_DEFAULT_CLIENT_LAG;
+
+/*!< @internal the idle pipelines by shape, a GQueue of READY pipelines for
+  each pool key */
+static GMutex gst_worker_pool_lock;
+static GHashTable *gst_worker_pool = NULL;
+static guint gst_worker_pool_size = GST_WORKER_DEFAULT_POOL_SIZE;
+
+/*!< @internal the msec a state change may take, 0 for no deadline */
+static guint gst_worker_state_timeout = GST_WORKER_DEFAULT_STATE_TIMEOUT;
+
+/*!< @internal the watchdog thread and the PLAYING live workers it watches,
+  each with a reference, the msec they may go without buffers, 0 for none */
+static GMutex gst_worker_watchdog_lock;
+static GCond gst_worker_watchdog_cond;
+static GThread *gst_worker_watchdog_thread = NULL;
+static guint gst_worker_watchdog_timeout = 0;
+static GList *gst_worker_watched = NULL;
+static GstWorkerWatchdogStats gst_worker_watchdog_stats = { 0 };
+static gint64 gst_worker_watchdog_recovery_total = 0;
+
+/*!< @internal all workers alive, without references */
+static GMutex gst_worker_all_lock;
+static GList *gst_worker_all = NULL;
+
+/**
+ * @brief The counters of an element, see GstWorkerElementStats.
+ *
+ * Pointer sized for g_atomic_pointer_add.
+ */
+typedef struct _GstWorkerCounters
+{
+  gsize buffers;
+  gsize bytes;
+  gsize qos_dropped;            /* the latest QoS message of the element */
+  gsize time;                   /* usec the timed buffers took */
+  gsize timed;                  /* buffers timed */
+  gint64 entered;               /* when the buffer in process came in, the
+                                   latest input of an aggregator */
+  gsize entries;                /* buffers into a queue or a rate element */
+  gsize gaps;                   /* buffers out flagged GAP, the repeats of a
+                                   rate element */
+  gboolean queue;               /* hands its buffers to another thread */
+  gboolean rate;                /* may drop and repeat its buffers */
+  guint held;                   /* buffers a rate element keeps back */
+  guint limit;                  /* the most buffers a queue holds, 0 if
+                                   unlimited */
+} GstWorkerCounters;
+
 #if ENABLE_ASSESSMENT
 guint assess_number = 0;
 #endif //ENABLE_ASSESSMENT
@@ -62,6 +118,87 @@ guint assess_number = 0;
 /*!< @internal */
 G_DEFINE_TYPE (GstWorker, gst_worker, G_TYPE_OBJECT);
 
+/**
+ * @brief Release a pipeline, it is in NULL when the last ref is gone.
+ */
+static void
+gst_worker_pool_release (GstElement * pipeline)
+{
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+/**
+ * @brief Release a queue of pooled pipelines.
+ */
+static void
+gst_worker_pool_free_queue (GQueue * queue)
+{
+  g_queue_free_full (queue, (GDestroyNotify) gst_worker_pool_release);
+}
+
+/**
+ * @brief Take an idle pipeline of a shape from the pool.
+ * @param key the shape
+ * @return the pipeline in READY, NULL if there is none
+ */
+static GstElement *
+gst_worker_pool_take (const gchar * key)
+{
+  GstElement *pipeline = NULL;
+  GQueue *queue;
+
+  g_mutex_lock (&gst_worker_pool_lock);
+  if (gst_worker_pool && (queue = g_hash_table_lookup (gst_worker_pool, key)))
+    pipeline = g_queue_pop_head (queue);
+  g_mutex_unlock (&gst_worker_pool_lock);
+  return pipeline;
+}
+
+/**
+ * @brief Give a stopped pipeline to the pool, it is released if the pool
+ *        of the shape is full.
+ * @param key the shape
+ * @param pipeline the pipeline, the reference is taken over
+ *
+ * The bus is flushed and left without handlers, so the next worker starts
+ * from a clean bus.
+ */
+static void
+gst_worker_pool_put (const gchar * key, GstElement * pipeline)
+{
+  GstBus *bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  GQueue *queue;
+
+  gst_bus_set_sync_handler (bus, NULL, NULL, NULL);
+  gst_bus_set_flushing (bus, TRUE);
+  gst_object_unref (bus);
+
+  if (gst_element_set_state (pipeline, GST_STATE_READY) !=
+      GST_STATE_CHANGE_SUCCESS) {
+    gst_worker_pool_release (pipeline);
+    return;
+  }
+
+  g_mutex_lock (&gst_worker_pool_lock);
+  if (gst_worker_pool == NULL)
+    gst_worker_pool = g_hash_table_new_full (g_str_hash, g_str_equal,
+        g_free, (GDestroyNotify) gst_worker_pool_free_queue);
+  queue = g_hash_table_lookup (gst_worker_pool, key);
+  if (queue == NULL) {
+    queue = g_queue_new ();
+    g_hash_table_insert (gst_worker_pool, g_strdup (key), queue);
+  }
+  if (g_queue_get_length (queue) < gst_worker_pool_size) {
+    g_queue_push_tail (queue, pipeline);
+    pipeline = NULL;
+  }
+  g_mutex_unlock (&gst_worker_pool_lock);
+
+  if (pipeline)
+    gst_worker_pool_release (pipeline);
+}
+
 /**
  * @brief Initialize GstWorker instances.
  * @param worker The GstWorker instance.
@@ -70,6 +207,8 @@ G_DEFINE_TYPE (GstWorker, gst_worker, G_TYPE_OBJECT);
 static void
 gst_worker_init (GstWorker * worker)
 {
+  gint i;
+
   worker->name = NULL;
   //worker->server = NULL;
   worker->bus = NULL;
@@ -79,9 +218,35 @@ gst_worker_init (GstWorker * worker)
   worker->pipeline_string = NULL;
   worker->paused_for_buffering = FALSE;
   worker->watch = 0;
+  worker->priority = 0;
+  worker->pool_key = NULL;
+  worker->start_time = 0;
+  worker->phase = GST_WORKER_PHASE_STOPPED;
+  worker->deadline = 0;
+  worker->done = NULL;
+  worker->done_data = NULL;
+  worker->slowest = NULL;
+  for (i = 0; i < GST_WORKER_TRANSITIONS; ++i)
+    worker->transitions[i].time = -1;
+  worker->flow = 0;
+  worker->flow_pads = NULL;
+  worker->stalled_since = 0;
+  worker->resumed_time = 0;
+  worker->recovered_time = 0;
+  worker->next_restart = 0;
+  worker->backoff = 0;
+  worker->restarting = FALSE;
 
   g_mutex_init (&worker->pipeline_lock);
-  g_cond_init (&worker->shutdown_cond);
+  g_mutex_init (&worker->trace_lock);
+
+  g_mutex_init (&worker->clients_lock);
+  worker->clients = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+      g_object_unref, gst_object_unref);
+
+  g_mutex_lock (&gst_worker_all_lock);
+  gst_worker_all = g_list_prepend (gst_worker_all, worker);
+  g_mutex_unlock (&gst_worker_all_lock);
 
   //INFO ("gst_worker init %p", worker);
 }
@@ -95,6 +260,14 @@ static void
 gst_worker_dispose (GstWorker * worker)
 {
   //INFO ("gst_worker dispose %p", worker);
+  g_mutex_lock (&gst_worker_all_lock);
+  gst_worker_all = g_list_remove (gst_worker_all, worker);
+  g_mutex_unlock (&gst_worker_all_lock);
+
+  if (worker->deadline) {
+    g_source_remove (worker->deadline);
+    worker->deadline = 0;
+  }
   if (worker->pipeline) {
     gst_element_set_state (worker->pipeline, GST_STATE_NULL);
   }
@@ -113,13 +286,18 @@ gst_worker_dispose (GstWorker * worker)
 static void
 gst_worker_finalize (GstWorker * worker)
 {
+  gint i;
+
   if (worker->watch) {
     g_source_remove (worker->watch);
     worker->watch = 0;
   }
   if (worker->pipeline) {
     INFO ("pipeline ref %d", GST_OBJECT_REFCOUNT (worker->pipeline));
-    gst_object_unref (worker->pipeline);
+    if (worker->pool_key && GST_OBJECT_REFCOUNT (worker->pipeline) == 1)
+      gst_worker_pool_put (worker->pool_key, worker->pipeline);
+    else
+      gst_object_unref (worker->pipeline);
     worker->pipeline = NULL;
   }
   if (worker->bus) {
@@ -141,12 +319,25 @@ gst_worker_finalize (GstWorker * worker)
   }
 
 
+  g_hash_table_destroy (worker->clients);
+  worker->clients = NULL;
+
+  g_free (worker->slowest);
+  worker->slowest = NULL;
+  for (i = 0; i < GST_WORKER_TRANSITIONS; ++i) {
+    g_free (worker->transitions[i].slowest);
+    worker->transitions[i].slowest = NULL;
+  }
+
   INFO ("gst_worker finalize %p", worker);
   g_mutex_clear (&worker->pipeline_lock);
-  g_cond_clear (&worker->shutdown_cond);
+  g_mutex_clear (&worker->trace_lock);
+  g_mutex_clear (&worker->clients_lock);
 
   g_free (worker->name);
   worker->name = NULL;
+  g_free (worker->pool_key);
+  worker->pool_key = NULL;
 
   if (G_OBJECT_CLASS (parent_class)->finalize)
     (*G_OBJECT_CLASS (parent_class)->finalize) (G_OBJECT (worker));
@@ -235,9 +426,27 @@ gst_worker_create_pipeline (GstWorker * worker)
   GError *error = NULL;
   GstParseContext *context = NULL;
   gint parse_flags = GST_PARSE_FLAG_NONE;
+  gint64 time;
   parse_flags |= GST_PARSE_FLAG_FATAL_ERRORS;
 
+  g_free (worker->pool_key);
+  worker->pool_key = workerclass->get_pool_key ?
+      workerclass->get_pool_key (worker) : NULL;
+  if (worker->pool_key)
+    pipeline = gst_worker_pool_take (worker->pool_key);
+  if (pipeline) {
+    if (workerclass->reuse && workerclass->reuse (worker, pipeline)) {
+      worker->start_stats.build = 0;
+      worker->start_stats.parse = 0;
+      worker->start_stats.pooled = TRUE;
+      return pipeline;
+    }
+    gst_worker_pool_release (pipeline);
+    pipeline = NULL;
+  }
+
 create_pipeline:
+  time = g_get_monotonic_time ();
   desc = workerclass->get_pipeline_string (worker);
   context = gst_parse_context_new ();
 
@@ -245,8 +454,12 @@ create_pipeline:
     g_print ("%s: %s\n", worker->name, desc->str);
   }
 
+  worker->start_stats.build = g_get_monotonic_time () - time;
+  time = g_get_monotonic_time ();
   pipeline = (GstElement *) gst_parse_launch_full (desc->str, context,
       parse_flags, &error);
+  worker->start_stats.parse = g_get_monotonic_time () - time;
+  worker->start_stats.pooled = FALSE;
   g_string_free (desc, TRUE);
 
   if (error == NULL) {
@@ -283,15 +496,671 @@ create_pipeline:
     ERROR ("%s: pipeline parsing error: %s", worker->name, error->message);
   }
 
-  if (pipeline) {
-    g_assert (GST_OBJECT_REFCOUNT (pipeline) == 1);
-    gst_object_unref (pipeline);
-    pipeline = NULL;
+  if (pipeline) {
+    g_assert (GST_OBJECT_REFCOUNT (pipeline) == 1);
+    gst_object_unref (pipeline);
+    pipeline = NULL;
+  }
+
+end:
+  gst_parse_context_free (context);
+  return pipeline;
+}
+
+/**
+ * @brief The slot of a state change in %transitions, -1 if it has none.
+ */
+static gint
+gst_worker_transition_index (GstStateChange transition)
+{
+  switch (transition) {
+    case GST_STATE_CHANGE_NULL_TO_READY:
+      return 0;
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+      return 1;
+    case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
+      return 2;
+    case GST_STATE_CHANGE_PLAYING_TO_PAUSED:
+      return 3;
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      return 4;
+    case GST_STATE_CHANGE_READY_TO_NULL:
+      return 5;
+    default:
+      return -1;
+  }
+}
+
+/**
+ * @brief Hand the end of the current phase to another caller.
+ * @param worker The GstWorker instance.
+ * @param done the new completion function, may be NULL
+ * @param data User defined data for %done.
+ *
+ * The caller waiting for the current phase is told it failed.
+ */
+static void
+gst_worker_expect (GstWorker * worker, GstWorkerDoneFunc done, gpointer data)
+{
+  GstWorkerDoneFunc last = worker->done;
+  gpointer last_data = worker->done_data;
+
+  worker->done = done;
+  worker->done_data = data;
+  if (last)
+    last (worker, FALSE, last_data);
+}
+
+/**
+ * @brief End the current phase for the caller waiting for it.
+ * @param worker The GstWorker instance.
+ * @param ok TRUE if the phase got where it was going.
+ */
+static void
+gst_worker_finish (GstWorker * worker, gboolean ok)
+{
+  GstWorkerDoneFunc done = worker->done;
+  gpointer data = worker->done_data;
+
+  worker->done = NULL;
+  worker->done_data = NULL;
+  if (done)
+    done (worker, ok, data);
+}
+
+/**
+ * @brief Drop the deadline of the current phase.
+ */
+static void
+gst_worker_disarm (GstWorker * worker)
+{
+  if (worker->deadline) {
+    g_source_remove (worker->deadline);
+    worker->deadline = 0;
+  }
+}
+
+static gboolean gst_worker_deadline (GstWorker * worker);
+
+/**
+ * @brief Give the current phase a deadline from now on.
+ */
+static void
+gst_worker_arm (GstWorker * worker)
+{
+  gst_worker_disarm (worker);
+  if (gst_worker_state_timeout)
+    worker->deadline = g_timeout_add (gst_worker_state_timeout,
+        (GSourceFunc) gst_worker_deadline, worker);
+}
+
+/**
+ * @brief Change the state of the pipeline, timing the change.
+ * @param worker The GstWorker instance.
+ * @param state the state to go to
+ *
+ * Every step of a starting pipeline gets a deadline of its own.
+ */
+static GstStateChangeReturn
+gst_worker_set_state (GstWorker * worker, GstState state)
+{
+  g_mutex_lock (&worker->trace_lock);
+  worker->transition_time = g_get_monotonic_time ();
+  g_free (worker->slowest);
+  worker->slowest = NULL;
+  worker->slowest_time = 0;
+  g_mutex_unlock (&worker->trace_lock);
+
+  if (worker->phase == GST_WORKER_PHASE_STARTING)
+    gst_worker_arm (worker);
+  return gst_element_set_state (worker->pipeline, state);
+}
+
+/**
+ * @brief Names of the elements of the pipeline still changing state.
+ * @return a newly allocated comma separated list
+ */
+static gchar *
+gst_worker_get_pending_elements (GstWorker * worker)
+{
+  GstIterator *iter = gst_bin_iterate_recurse (GST_BIN (worker->pipeline));
+  GString *names = g_string_new (NULL);
+  GValue value = { 0 };
+  gboolean done = FALSE;
+
+  while (!done) {
+    switch (gst_iterator_next (iter, &value)) {
+      case GST_ITERATOR_OK:
+      {
+        GstElement *element = g_value_get_object (&value);
+        if (GST_STATE_PENDING (element) != GST_STATE_VOID_PENDING)
+          g_string_append_printf (names, "%s%s", names->len ? ", " : "",
+              GST_ELEMENT_NAME (element));
+        g_value_reset (&value);
+      }
+        break;
+      case GST_ITERATOR_RESYNC:
+        g_string_truncate (names, 0);
+        gst_iterator_resync (iter);
+        break;
+      default:
+        done = TRUE;
+        break;
+    }
+  }
+
+  if (G_IS_VALUE (&value))
+    g_value_unset (&value);
+  gst_iterator_free (iter);
+  return g_string_free (names, FALSE);
+}
+
+/**
+ * @brief Count a buffer out of a source, in the streaming thread.
+ *
+ * An inter source like intervideosrc sends its latest frame again, then
+ * black, for a channel nobody writes. Those buffers are counted too, the
+ * pipeline is idle and not stalled, restarting the reader would not bring
+ * a writer back. Only a source sending nothing at all is stalled.
+ */
+static GstPadProbeReturn
+gst_worker_flow_probe (GstPad * pad, GstPadProbeInfo * info,
+    GstWorker * worker)
+{
+  g_atomic_int_inc (&worker->flow);
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Tell a test source filling in for the others, like the black
+ *        background of the multiview or the silence of the mixer.
+ */
+static gboolean
+gst_worker_is_filler (GstElement * element)
+{
+  GstElementFactory *factory = gst_element_get_factory (element);
+  const gchar *name;
+
+  if (factory == NULL)
+    return FALSE;
+  name = gst_plugin_feature_get_name (GST_PLUGIN_FEATURE (factory));
+  return g_strcmp0 (name, "videotestsrc") == 0 ||
+      g_strcmp0 (name, "audiotestsrc") == 0;
+}
+
+/**
+ * @brief Count the buffers out of the sources of the pipeline in %flow.
+ *
+ * A queue or a sink stuck downstream blocks the sources sooner or later,
+ * while a gate dropping buffers for no client does not. A test source is
+ * only counted if there is no other source, it would keep a pipeline
+ * flowing with the inter sources of its inputs stuck.
+ */
+static void
+gst_worker_count_flow (GstWorker * worker)
+{
+  GstIterator *iter = gst_bin_iterate_recurse (GST_BIN (worker->pipeline));
+  GValue value = { 0 };
+  gboolean done = FALSE;
+  GSList *pads = NULL, *fillers = NULL, **list, *p;
+  GList *l;
+
+  while (!done) {
+    switch (gst_iterator_next (iter, &value)) {
+      case GST_ITERATOR_OK:
+      {
+        GstElement *element = g_value_get_object (&value);
+        if (!GST_IS_BIN (element) &&
+            GST_OBJECT_FLAG_IS_SET (element, GST_ELEMENT_FLAG_SOURCE)) {
+          list = gst_worker_is_filler (element) ? &fillers : &pads;
+          GST_OBJECT_LOCK (element);
+          for (l = element->srcpads; l; l = g_list_next (l))
+            *list = g_slist_prepend (*list, gst_object_ref (l->data));
+          GST_OBJECT_UNLOCK (element);
+        }
+        g_value_reset (&value);
+      }
+        break;
+      case GST_ITERATOR_RESYNC:
+        g_slist_free_full (pads, gst_object_unref);
+        g_slist_free_full (fillers, gst_object_unref);
+        pads = fillers = NULL;
+        gst_iterator_resync (iter);
+        break;
+      default:
+        done = TRUE;
+        break;
+    }
+  }
+
+  if (G_IS_VALUE (&value))
+    g_value_unset (&value);
+  gst_iterator_free (iter);
+
+  if (pads == NULL) {
+    pads = fillers;
+    fillers = NULL;
+  }
+  g_slist_free_full (fillers, gst_object_unref);
+
+  for (p = pads; p; p = g_slist_next (p)) {
+    gulong id = gst_pad_add_probe (GST_PAD (p->data),
+        GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+        (GstPadProbeCallback) gst_worker_flow_probe, worker, NULL);
+    g_object_set_data (G_OBJECT (p->data), "gst-worker-flow",
+        GUINT_TO_POINTER (id));
+  }
+  worker->flow_pads = pads;
+}
+
+/**
+ * @brief Stop counting the buffers, the pipeline may be pooled after.
+ */
+static void
+gst_worker_uncount_flow (GstWorker * worker)
+{
+  GSList *p;
+
+  for (p = worker->flow_pads; p; p = g_slist_next (p)) {
+    GObject *pad = G_OBJECT (p->data);
+    gst_pad_remove_probe (GST_PAD (pad),
+        GPOINTER_TO_UINT (g_object_get_data (pad, "gst-worker-flow")));
+    g_object_set_data (pad, "gst-worker-flow", NULL);
+  }
+  g_slist_free_full (worker->flow_pads, gst_object_unref);
+  worker->flow_pads = NULL;
+}
+
+/**
+ * @brief Count a buffer or a list out of an element, and time it through
+ *        the element if it was timed coming in.
+ */
+static GstPadProbeReturn
+gst_worker_count_probe (GstPad * pad, GstPadProbeInfo * info,
+    GstWorkerCounters * counters)
+{
+  gsize n = 1, bytes = 0, gaps = 0, i;
+  GstBuffer *buffer;
+
+  if (GST_PAD_PROBE_INFO_TYPE (info) & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+    GstBufferList *list = GST_PAD_PROBE_INFO_BUFFER_LIST (info);
+    n = gst_buffer_list_length (list);
+    for (i = 0; i < n; ++i) {
+      buffer = gst_buffer_list_get (list, i);
+      bytes += gst_buffer_get_size (buffer);
+      gaps += GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_GAP) ? 1 : 0;
+    }
+  } else {
+    buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+    bytes = gst_buffer_get_size (buffer);
+    gaps = GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_GAP) ? 1 : 0;
+  }
+  g_atomic_pointer_add (&counters->buffers, n);
+  g_atomic_pointer_add (&counters->bytes, bytes);
+  if (counters->rate && gaps)
+    g_atomic_pointer_add (&counters->gaps, gaps);
+
+  if (counters->entered) {
+    g_atomic_pointer_add (&counters->time,
+        g_get_monotonic_time () - counters->entered);
+    g_atomic_pointer_add (&counters->timed, 1);
+    counters->entered = 0;
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Note when a buffer comes into an element.
+ */
+static GstPadProbeReturn
+gst_worker_enter_probe (GstPad * pad, GstPadProbeInfo * info,
+    GstWorkerCounters * counters)
+{
+  counters->entered = g_get_monotonic_time ();
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Count a buffer or a list into a queue or a rate element.
+ */
+static GstPadProbeReturn
+gst_worker_entry_probe (GstPad * pad, GstPadProbeInfo * info,
+    GstWorkerCounters * counters)
+{
+  gsize n = 1;
+
+  if (GST_PAD_PROBE_INFO_TYPE (info) & GST_PAD_PROBE_TYPE_BUFFER_LIST)
+    n = gst_buffer_list_length (GST_PAD_PROBE_INFO_BUFFER_LIST (info));
+  g_atomic_pointer_add (&counters->entries, n);
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Tell the queues and the rate elements, and take what they hold
+ *        at most.
+ *
+ * Only called before the pipeline flows, the properties of a queue take
+ * the lock of its streaming threads.
+ */
+static void
+gst_worker_kind_counters (GstElement * element, GstWorkerCounters * counters)
+{
+  GObjectClass *klass = G_OBJECT_GET_CLASS (element);
+  GParamSpec *spec;
+
+  counters->queue =
+      g_object_class_find_property (klass, "current-level-buffers") != NULL;
+  if (counters->queue)
+    g_object_get (element, "max-size-buffers", &counters->limit, NULL);
+
+  /* videorate and audiorate, videorate keeps its latest buffer back to
+     repeat it */
+  spec = g_object_class_find_property (klass, "drop");
+  counters->rate = spec && spec->value_type == G_TYPE_UINT64;
+  spec = g_object_class_find_property (klass, "duplicate");
+  counters->held = counters->rate && spec ? 1 : 0;
+}
+
+/**
+ * @brief Give an element of the pipeline its counters.
+ *
+ * The counters go with the element, a pooled pipeline keeps them and they
+ * start over.
+ */
+static void
+gst_worker_add_counters (const GValue * value, gpointer data)
+{
+  GstElement *element = g_value_get_object (value);
+  GstPadProbeType type =
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST;
+  GstWorkerCounters *counters;
+  GList *pads = NULL, *sinkpads = NULL, *l;
+  gboolean timed, entries;
+
+  if (GST_IS_BIN (element))
+    return;
+
+  counters = g_object_get_data (G_OBJECT (element), "gst-worker-counters");
+  if (counters) {
+    memset (counters, 0, sizeof (*counters));
+    gst_worker_kind_counters (element, counters);
+    return;
+  }
+  counters = g_new0 (GstWorkerCounters, 1);
+  g_object_set_data_full (G_OBJECT (element), "gst-worker-counters",
+      counters, g_free);
+  gst_worker_kind_counters (element, counters);
+
+  /* a queue hands its buffers to another thread, an aggregator like the
+     composite mixer is timed from its latest input to its output */
+  timed = element->numsinkpads >= 1 && element->numsrcpads == 1 &&
+      !counters->queue;
+  entries = element->numsrcpads && (counters->queue || counters->rate);
+
+  GST_OBJECT_LOCK (element);
+  for (l = element->numsrcpads ? element->srcpads : element->sinkpads; l;
+      l = g_list_next (l))
+    pads = g_list_prepend (pads, gst_object_ref (l->data));
+  for (l = timed || entries ? element->sinkpads : NULL; l; l = g_list_next (l))
+    sinkpads = g_list_prepend (sinkpads, gst_object_ref (l->data));
+  GST_OBJECT_UNLOCK (element);
+
+  for (l = pads; l; l = g_list_next (l))
+    gst_pad_add_probe (GST_PAD (l->data), type,
+        (GstPadProbeCallback) gst_worker_count_probe, counters, NULL);
+  g_list_free_full (pads, gst_object_unref);
+
+  for (l = sinkpads; l; l = g_list_next (l)) {
+    if (timed)
+      gst_pad_add_probe (GST_PAD (l->data), type,
+          (GstPadProbeCallback) gst_worker_enter_probe, counters, NULL);
+    if (entries)
+      gst_pad_add_probe (GST_PAD (l->data), type,
+          (GstPadProbeCallback) gst_worker_entry_probe, counters, NULL);
+  }
+  g_list_free_full (sinkpads, gst_object_unref);
+}
+
+/**
+ * @brief Keep the latest QoS drops of an element, in the streaming thread.
+ */
+static void
+gst_worker_count_qos (GstMessage * message)
+{
+  GstWorkerCounters *counters =
+      g_object_get_data (G_OBJECT (GST_MESSAGE_SRC (message)),
+      "gst-worker-counters");
+  guint64 dropped = G_MAXUINT64;
+
+  if (counters == NULL)
+    return;
+  gst_message_parse_qos_stats (message, NULL, NULL, &dropped);
+  if (dropped != G_MAXUINT64)
+    g_atomic_pointer_set (&counters->qos_dropped, GSIZE_TO_POINTER (dropped));
+}
+
+/**
+ * @brief Read the counters of an element.
+ *
+ * No property is read, that would take the locks of the streaming threads.
+ * The buffers in a queue and the drops of a rate element are told from the
+ * buffers in and out of it instead. A leaky queue drops without telling,
+ * its level is bounded by its limit.
+ */
+static void
+gst_worker_read_counters (const GValue * value, GArray * result)
+{
+  GstElement *element = g_value_get_object (value);
+  GstWorkerCounters *counters =
+      g_object_get_data (G_OBJECT (element), "gst-worker-counters");
+  GstWorkerElementStats stats = { 0 };
+  guint64 entries, out;
+  gsize timed;
+
+  if (counters == NULL)
+    return;
+
+  stats.name = gst_element_get_name (element);
+  stats.repeated = GPOINTER_TO_SIZE (g_atomic_pointer_get (&counters->gaps));
+  stats.buffers = GPOINTER_TO_SIZE (g_atomic_pointer_get (&counters->buffers));
+  stats.bytes = GPOINTER_TO_SIZE (g_atomic_pointer_get (&counters->bytes));
+  stats.dropped =
+      GPOINTER_TO_SIZE (g_atomic_pointer_get (&counters->qos_dropped));
+
+  /* read after the buffers out, so never behind them */
+  entries = GPOINTER_TO_SIZE (g_atomic_pointer_get (&counters->entries));
+  if (counters->rate) {
+    out = stats.buffers - MIN (stats.repeated, stats.buffers);
+    if (entries > out + counters->held)
+      stats.dropped += entries - out - counters->held;
+  }
+  if (counters->queue) {
+    stats.queued = entries > stats.buffers ? entries - stats.buffers : 0;
+    if (counters->limit)
+      stats.queued = MIN (stats.queued, counters->limit);
+  }
+
+  timed = GPOINTER_TO_SIZE (g_atomic_pointer_get (&counters->timed));
+  stats.processing_time = timed ?
+      (gint64) (GPOINTER_TO_SIZE (g_atomic_pointer_get (&counters->time)) /
+      timed) : -1;
+
+  g_array_append_val (result, stats);
+}
+
+static void
+gst_worker_clear_element_stats (GstWorkerElementStats * stats)
+{
+  g_free (stats->name);
+}
+
+/**
+ * @brief Have the watchdog watch a worker which just got PLAYING.
+ *
+ * A pipeline which is not live, like an input fed by a client socket, only
+ * flows with its input and may be idle as long as the input is.
+ */
+static void
+gst_worker_watchdog_add (GstWorker * worker)
+{
+  if (!gst_worker_watchdog_timeout || worker->flow_pads)
+    return;
+  if (!GST_CLOCK_TIME_IS_VALID (gst_worker_get_latency (worker)))
+    return;
+
+  gst_worker_count_flow (worker);
+  if (!worker->flow_pads)
+    return;
+
+  g_mutex_lock (&gst_worker_watchdog_lock);
+  worker->flow_seen = g_atomic_int_get (&worker->flow);
+  worker->flow_time = g_get_monotonic_time ();
+  gst_worker_watched = g_list_prepend (gst_worker_watched,
+      g_object_ref (worker));
+  g_mutex_unlock (&gst_worker_watchdog_lock);
+}
+
+/**
+ * @brief Stop watching a worker leaving PLAYING.
+ *
+ * The stall the worker may be in is kept, the next start of the worker
+ * ends it or not.
+ */
+static void
+gst_worker_watchdog_remove (GstWorker * worker)
+{
+  GList *link;
+
+  if (!worker->flow_pads)
+    return;
+
+  gst_worker_uncount_flow (worker);
+
+  g_mutex_lock (&gst_worker_watchdog_lock);
+  link = g_list_find (gst_worker_watched, worker);
+  if (link)
+    gst_worker_watched = g_list_delete_link (gst_worker_watched, link);
+  g_mutex_unlock (&gst_worker_watchdog_lock);
+
+  if (link)
+    g_object_unref (worker);
+}
+
+/**
+ * @brief Restart a stalled worker with a new pipeline, from the main loop.
+ */
+static gboolean
+gst_worker_watchdog_restart (GstWorker * worker)
+{
+  GstWorkerClass *workerclass = GST_WORKER_CLASS (G_OBJECT_GET_CLASS (worker));
+  gint64 idle, backoff;
+
+  g_mutex_lock (&gst_worker_watchdog_lock);
+  worker->restarting = FALSE;
+  idle = g_get_monotonic_time () - worker->stalled_since;
+  backoff = worker->backoff;
+  g_mutex_unlock (&gst_worker_watchdog_lock);
+
+  /* stopped meanwhile, nothing to heal */
+  if (worker->phase != GST_WORKER_PHASE_PLAYING)
+    return FALSE;
+
+  WARN ("%s: no buffers for %" G_GINT64_FORMAT " ms, restarting, the next "
+      "restart in %" G_GINT64_FORMAT " ms at the earliest", worker->name,
+      idle / 1000, backoff / 1000);
+
+  if (!workerclass->reset (worker) || !gst_worker_start (worker)) {
+    ERROR ("%s: failed to restart", worker->name);
+    gst_worker_stop_force (worker, TRUE);
+  }
+  return FALSE;
+}
+
+/**
+ * @brief Look at the flow of one worker.
+ * @param now the time of the look
+ * @param timeout usec the worker may go without buffers
+ *
+ * Invoked from the watchdog thread with the watchdog locked.
+ */
+static void
+gst_worker_watchdog_check (GstWorker * worker, gint64 now, gint64 timeout)
+{
+  GstWorkerWatchdogStats *stats = &gst_worker_watchdog_stats;
+  gint flow = g_atomic_int_get (&worker->flow);
+
+  if (flow != worker->flow_seen) {
+    worker->flow_seen = flow;
+    worker->flow_time = now;
+    /* a few buffers before getting stuck again are no recovery, it has to
+       flow for a timeout */
+    if (worker->stalled_since && !worker->resumed_time) {
+      worker->resumed_time = now;
+    } else if (worker->stalled_since && now - worker->resumed_time >= timeout) {
+      stats->recoveries += 1;
+      gst_worker_watchdog_recovery_total +=
+          worker->resumed_time - worker->stalled_since;
+      stats->recovery_time =
+          gst_worker_watchdog_recovery_total / stats->recoveries;
+      INFO ("%s: recovered after %" G_GINT64_FORMAT " ms, mean time to "
+          "recover %" G_GINT64_FORMAT " ms", worker->name,
+          (worker->resumed_time - worker->stalled_since) / 1000,
+          stats->recovery_time / 1000);
+      worker->stalled_since = 0;
+      worker->recovered_time = now;
+    }
+    return;
+  }
+
+  if (worker->restarting || now - worker->flow_time < timeout ||
+      now < worker->next_restart)
+    return;
+
+  if (!worker->stalled_since) {
+    stats->stalls += 1;
+    worker->stalled_since = worker->flow_time;
+    /* a worker stalling once in a while starts from the shortest backoff */
+    if (now - worker->recovered_time >
+        GST_WORKER_WATCHDOG_MAX_BACKOFF * G_TIME_SPAN_MILLISECOND)
+      worker->backoff = timeout;
+  }
+
+  stats->restarts += 1;
+  worker->resumed_time = 0;
+  worker->restarting = TRUE;
+  worker->next_restart = now + worker->backoff;
+  worker->backoff = MIN (worker->backoff * 2,
+      GST_WORKER_WATCHDOG_MAX_BACKOFF * G_TIME_SPAN_MILLISECOND);
+  g_idle_add_full (G_PRIORITY_DEFAULT,
+      (GSourceFunc) gst_worker_watchdog_restart, g_object_ref (worker),
+      g_object_unref);
+}
+
+/**
+ * @brief The watchdog thread, it looks at the workers four times per
+ *        timeout until the timeout is set to 0.
+ */
+static gpointer
+gst_worker_watchdog_run (gpointer data)
+{
+  GList *l;
+
+  g_mutex_lock (&gst_worker_watchdog_lock);
+  while (gst_worker_watchdog_timeout) {
+    gint64 timeout = gst_worker_watchdog_timeout * G_TIME_SPAN_MILLISECOND;
+    gint64 now;
+
+    g_cond_wait_until (&gst_worker_watchdog_cond, &gst_worker_watchdog_lock,
+        g_get_monotonic_time () + timeout / 4);
+    if (!gst_worker_watchdog_timeout)
+      break;
+
+    now = g_get_monotonic_time ();
+    for (l = gst_worker_watched; l; l = g_list_next (l))
+      gst_worker_watchdog_check (GST_WORKER (l->data), now, timeout);
   }
-
-end:
-  gst_parse_context_free (context);
-  return pipeline;
+  g_mutex_unlock (&gst_worker_watchdog_lock);
+  return NULL;
 }
 
 /**
@@ -315,14 +1184,44 @@ static gboolean gst_worker_prepare (GstWorker *);
  */
 gboolean
 gst_worker_start (GstWorker * worker)
+{
+  return gst_worker_start_async (worker, NULL, NULL);
+}
+
+/**
+ * @brief Start the worker pipeline, the state changes go on from the bus.
+ * @param worker The GstWorker instance.
+ * @param done called when PLAYING, or on failure
+ * @param data User defined data for %done.
+ * @memberof GstWorker
+ */
+gboolean
+gst_worker_start_async (GstWorker * worker, GstWorkerDoneFunc done,
+    gpointer data)
 {
   GstStateChangeReturn ret = GST_STATE_CHANGE_FAILURE;
 
   g_return_val_if_fail (GST_IS_WORKER (worker), FALSE);
 
+  worker->start_time = g_get_monotonic_time ();
   if (gst_worker_prepare (worker)) {
+    gst_worker_expect (worker, done, data);
     GST_WORKER_LOCK_PIPELINE (worker);
-    ret = gst_element_set_state (worker->pipeline, GST_STATE_READY);
+    worker->phase = GST_WORKER_PHASE_STARTING;
+    if (GST_STATE (worker->pipeline) == GST_STATE_READY) {
+      /* a pooled pipeline, no NULL to READY change will carry it on */
+      if (gst_worker_set_state (worker, GST_STATE_PAUSED) !=
+          GST_STATE_CHANGE_FAILURE)
+        ret = GST_STATE_CHANGE_SUCCESS;
+    } else {
+      ret = gst_worker_set_state (worker, GST_STATE_READY);
+    }
+    if (ret != GST_STATE_CHANGE_SUCCESS) {
+      gst_worker_disarm (worker);
+      worker->phase = GST_WORKER_PHASE_STOPPED;
+      worker->done = NULL;
+      worker->done_data = NULL;
+    }
     GST_WORKER_UNLOCK_PIPELINE (worker);
   }
 
@@ -350,7 +1249,12 @@ gst_worker_replay (GstWorker * worker)
         GST_CLOCK_TIME_NONE);
 
     if (state != GST_STATE_PLAYING) {
-      ret = gst_element_set_state (worker->pipeline, GST_STATE_READY);
+      worker->phase = GST_WORKER_PHASE_STARTING;
+      ret = gst_worker_set_state (worker, GST_STATE_READY);
+      if (ret != GST_STATE_CHANGE_SUCCESS) {
+        gst_worker_disarm (worker);
+        worker->phase = GST_WORKER_PHASE_STOPPED;
+      }
     }
   }
 
@@ -367,6 +1271,63 @@ gst_worker_state_ready_to_null_proxy (GstWorker * worker)
   return FALSE;
 }
 
+/**
+ * @brief Set the pipeline to NULL, the null handlers run from the main loop.
+ * @param worker The GstWorker instance.
+ *
+ * The pipeline must be locked.
+ */
+static void
+gst_worker_halt (GstWorker * worker)
+{
+  gst_worker_disarm (worker);
+  worker->phase = GST_WORKER_PHASE_STOPPING;
+  gst_worker_set_state (worker, GST_STATE_NULL);
+  gst_bus_set_flushing (worker->bus, TRUE);
+
+  g_idle_add_full (G_PRIORITY_DEFAULT,
+      (GSourceFunc) gst_worker_state_ready_to_null_proxy,
+      g_object_ref (worker), g_object_unref);
+  gst_worker_watchdog_remove (worker);
+}
+
+/**
+ * @brief The deadline of the current phase has passed.
+ * @param worker The GstWorker instance.
+ *
+ * A start is given up, a clean stop not getting its EOS is forced.
+ */
+static gboolean
+gst_worker_deadline (GstWorker * worker)
+{
+  gchar *pending;
+
+  worker->deadline = 0;
+
+  switch (worker->phase) {
+    case GST_WORKER_PHASE_STARTING:
+      pending = gst_worker_get_pending_elements (worker);
+      ERROR ("%s: %s to %s not done in %u ms, waiting for %s", worker->name,
+          gst_element_state_get_name (GST_STATE (worker->pipeline)),
+          gst_element_state_get_name (GST_STATE_NEXT (worker->pipeline)),
+          gst_worker_state_timeout, *pending ? pending : "the pipeline");
+      g_free (pending);
+      gst_worker_expect (worker, NULL, NULL);
+      break;
+    case GST_WORKER_PHASE_DRAINING:
+      WARN ("%s: no EOS in %u ms, forcing stop", worker->name,
+          gst_worker_state_timeout);
+      break;
+    default:
+      return FALSE;
+  }
+
+  GST_WORKER_LOCK_PIPELINE (worker);
+  gst_worker_halt (worker);
+  GST_WORKER_UNLOCK_PIPELINE (worker);
+  return FALSE;
+}
+
 /**
  * @brief Stop the worker pipeline.
  * @param worker The GstWorker instance.
@@ -376,39 +1337,64 @@ gst_worker_state_ready_to_null_proxy (GstWorker * worker)
 gboolean
 gst_worker_stop_force (GstWorker * worker, gboolean force)
 {
-  GstStateChangeReturn ret = GST_STATE_CHANGE_FAILURE;
-  gboolean no_eos;
-
-  g_return_val_if_fail (GST_IS_WORKER (worker), FALSE);
-
-  GST_WORKER_LOCK_PIPELINE (worker);
+  return gst_worker_stop_async (worker, force, NULL, NULL);
+}
 
-  if (worker->pipeline) {
-    GstState state;
+/**
+ * @brief Stop the worker pipeline, the EOS of a clean stop is not waited.
+ * @param worker The GstWorker instance.
+ * @param force Force stop if TRUE.
+ * @param done called after "end-worker"
+ * @param data User defined data for %done.
+ * @memberof GstWorker
+ */
+gboolean
+gst_worker_stop_async (GstWorker * worker, gboolean force,
+    GstWorkerDoneFunc done, gpointer data)
+{
+  gboolean stopping;
 
-    ret = gst_element_get_state (worker->pipeline, &state, NULL,
-        GST_CLOCK_TIME_NONE);
-    no_eos = (state == GST_STATE_PLAYING) && !worker->send_eos_on_stop;
+  g_return_val_if_fail (GST_IS_WORKER (worker), FALSE);
 
-    if (force || no_eos) {
-      ret = gst_element_set_state (worker->pipeline, GST_STATE_NULL);
+  if (worker->pipeline == NULL ||
+      (worker->phase == GST_WORKER_PHASE_STOPPED && !force))
+    return FALSE;
 
-      gst_bus_set_flushing (worker->bus, TRUE);
+  /* a stop without a caller of its own joins one in progress */
+  stopping = worker->phase == GST_WORKER_PHASE_DRAINING ||
+      worker->phase == GST_WORKER_PHASE_STOPPING;
+  if (done || !stopping)
+    gst_worker_expect (worker, done, data);
 
-      g_timeout_add (5,
-          (GSourceFunc) gst_worker_state_ready_to_null_proxy, worker);
-    } else if (state == GST_STATE_PLAYING) {
-      /* Send an EOS to cleanly shutdown */
-      gst_element_send_event (worker->pipeline, gst_event_new_eos ());
+  GST_WORKER_LOCK_PIPELINE (worker);
 
-      /* Go to sleep until the EOS handler calls stop_force (worker, TRUE); */
-      g_cond_wait (&worker->shutdown_cond, &worker->pipeline_lock);
-    }
+  switch (worker->phase) {
+    case GST_WORKER_PHASE_PLAYING:
+      if (!force && worker->send_eos_on_stop) {
+        /* Send an EOS to cleanly shutdown, the EOS handler calls
+           stop_force (worker, TRUE) */
+        worker->phase = GST_WORKER_PHASE_DRAINING;
+        gst_worker_watchdog_remove (worker);
+        gst_worker_arm (worker);
+        gst_element_send_event (worker->pipeline, gst_event_new_eos ());
+        break;
+      }
+      /* fall through */
+    case GST_WORKER_PHASE_STOPPED:
+    case GST_WORKER_PHASE_STARTING:
+      gst_worker_halt (worker);
+      break;
+    case GST_WORKER_PHASE_DRAINING:
+      if (force)
+        gst_worker_halt (worker);
+      break;
+    case GST_WORKER_PHASE_STOPPING:
+      break;
   }
 
   GST_WORKER_UNLOCK_PIPELINE (worker);
 
-  return ret == GST_STATE_CHANGE_SUCCESS ? TRUE : FALSE;
+  return TRUE;
 }
 
 /**
@@ -419,6 +1405,10 @@ gst_worker_get_element_unlocked (GstWorker * worker, const gchar * name)
 {
   g_return_val_if_fail (GST_IS_WORKER (worker), NULL);
 
+  /* stopped */
+  if (worker->pipeline == NULL)
+    return NULL;
+
   return gst_bin_get_by_name (GST_BIN (worker->pipeline), name);
 }
 
@@ -435,6 +1425,359 @@ gst_worker_get_element (GstWorker * worker, const gchar * name)
   return element;
 }
 
+/**
+ * @memberof GstWorker
+ */
+GstClockTime
+gst_worker_get_latency (GstWorker * worker)
+{
+  GstClockTime latency = GST_CLOCK_TIME_NONE, min;
+  gboolean live = FALSE;
+  GstQuery *query;
+
+  g_return_val_if_fail (GST_IS_WORKER (worker), GST_CLOCK_TIME_NONE);
+
+  GST_WORKER_LOCK_PIPELINE (worker);
+  if (worker->pipeline) {
+    query = gst_query_new_latency ();
+    if (gst_element_query (worker->pipeline, query)) {
+      gst_query_parse_latency (query, &live, &min, NULL);
+      if (live)
+        latency = min;
+    }
+    gst_query_unref (query);
+  }
+  GST_WORKER_UNLOCK_PIPELINE (worker);
+  return latency;
+}
+
+/**
+ * @memberof GstWorker
+ */
+void
+gst_worker_set_client_policy (GstWorkerClientPolicy policy, guint lag)
+{
+  gst_worker_client_policy = policy;
+  gst_worker_client_lag = lag;
+}
+
+/**
+ * @memberof GstWorker
+ */
+void
+gst_worker_set_state_timeout (guint timeout)
+{
+  gst_worker_state_timeout = timeout;
+}
+
+/**
+ * @memberof GstWorker
+ */
+void
+gst_worker_set_watchdog (guint timeout)
+{
+  GThread *thread;
+
+  g_mutex_lock (&gst_worker_watchdog_lock);
+  gst_worker_watchdog_timeout = 0;
+  thread = gst_worker_watchdog_thread;
+  gst_worker_watchdog_thread = NULL;
+  g_cond_signal (&gst_worker_watchdog_cond);
+  g_mutex_unlock (&gst_worker_watchdog_lock);
+
+  if (thread)
+    g_thread_join (thread);
+
+  gst_worker_watchdog_timeout = timeout;
+  if (timeout)
+    gst_worker_watchdog_thread = g_thread_new ("gst-worker-watchdog",
+        gst_worker_watchdog_run, NULL);
+}
+
+/**
+ * @memberof GstWorker
+ */
+void
+gst_worker_get_watchdog_stats (GstWorkerWatchdogStats * stats)
+{
+  g_mutex_lock (&gst_worker_watchdog_lock);
+  *stats = gst_worker_watchdog_stats;
+  g_mutex_unlock (&gst_worker_watchdog_lock);
+}
+
+/**
+ * @memberof GstWorker
+ */
+gboolean
+gst_worker_get_transition_stats (GstWorker * worker,
+    GstStateChange transition, GstWorkerTransitionStats * stats)
+{
+  gint i = gst_worker_transition_index (transition);
+
+  g_return_val_if_fail (GST_IS_WORKER (worker), FALSE);
+  g_return_val_if_fail (i >= 0, FALSE);
+
+  g_mutex_lock (&worker->trace_lock);
+  *stats = worker->transitions[i];
+  stats->slowest = g_strdup (stats->slowest);
+  g_mutex_unlock (&worker->trace_lock);
+  return stats->time >= 0;
+}
+
+/**
+ * @memberof GstWorker
+ */
+void
+gst_worker_set_pool_size (guint size)
+{
+  GHashTableIter iter;
+  GQueue *queue;
+
+  g_mutex_lock (&gst_worker_pool_lock);
+  gst_worker_pool_size = size;
+  if (gst_worker_pool) {
+    g_hash_table_iter_init (&iter, gst_worker_pool);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & queue))
+      while (g_queue_get_length (queue) > size)
+        gst_worker_pool_release (g_queue_pop_tail (queue));
+  }
+  g_mutex_unlock (&gst_worker_pool_lock);
+}
+
+/**
+ * @memberof GstWorker
+ */
+void
+gst_worker_pool_clear (void)
+{
+  GHashTable *pool;
+
+  g_mutex_lock (&gst_worker_pool_lock);
+  pool = gst_worker_pool;
+  gst_worker_pool = NULL;
+  g_mutex_unlock (&gst_worker_pool_lock);
+
+  if (pool)
+    g_hash_table_destroy (pool);
+}
+
+/**
+ * @memberof GstWorker
+ */
+GArray *
+gst_worker_get_stats (GstWorker * worker)
+{
+  GArray *result = g_array_new (FALSE, TRUE, sizeof (GstWorkerElementStats));
+  GstIterator *iter;
+
+  g_array_set_clear_func (result,
+      (GDestroyNotify) gst_worker_clear_element_stats);
+  g_return_val_if_fail (GST_IS_WORKER (worker), result);
+
+  GST_WORKER_LOCK_PIPELINE (worker);
+  if (worker->pipeline) {
+    iter = gst_bin_iterate_recurse (GST_BIN (worker->pipeline));
+    while (gst_iterator_foreach (iter,
+            (GstIteratorForeachFunction) gst_worker_read_counters,
+            result) == GST_ITERATOR_RESYNC) {
+      g_array_set_size (result, 0);
+      gst_iterator_resync (iter);
+    }
+    gst_iterator_free (iter);
+  }
+  GST_WORKER_UNLOCK_PIPELINE (worker);
+  return result;
+}
+
+/**
+ * @memberof GstWorker
+ */
+GList *
+gst_worker_list (void)
+{
+  GList *workers;
+
+  g_mutex_lock (&gst_worker_all_lock);
+  workers = g_list_copy (gst_worker_all);
+  g_list_foreach (workers, (GFunc) g_object_ref, NULL);
+  g_mutex_unlock (&gst_worker_all_lock);
+  return workers;
+}
+
+/**
+ * @memberof GstWorker
+ */
+gboolean
+gst_worker_parse_client_policy (const gchar * name,
+    GstWorkerClientPolicy * policy)
+{
+  if (g_strcmp0 (name, "newest") == 0) {
+    *policy = GST_WORKER_CLIENT_DROP_TO_NEWEST;
+  } else if (g_strcmp0 (name, "keyframe") == 0) {
+    *policy = GST_WORKER_CLIENT_DROP_TO_KEYFRAME;
+  } else if (g_strcmp0 (name, "disconnect") == 0) {
+    *policy = GST_WORKER_CLIENT_DISCONNECT;
+  } else {
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/**
+ * @brief Invoked when a client is added to a watched sink.
+ * @memberof GstWorker
+ */
+static void
+gst_worker_client_added (GstElement * sink, GObject * socket,
+    GstWorker * worker)
+{
+  g_return_if_fail (G_IS_SOCKET (socket));
+
+  g_mutex_lock (&worker->clients_lock);
+  g_hash_table_insert (worker->clients, g_object_ref (socket),
+      gst_object_ref (sink));
+  g_mutex_unlock (&worker->clients_lock);
+}
+
+/**
+ * @brief Invoked when a client is removed from a watched sink.
+ * @memberof GstWorker
+ */
+static void
+gst_worker_client_removed (GstElement * sink, GSocket * socket,
+    GstWorker * worker)
+{
+  g_return_if_fail (G_IS_SOCKET (socket));
+
+  g_mutex_lock (&worker->clients_lock);
+  g_hash_table_remove (worker->clients, socket);
+  g_mutex_unlock (&worker->clients_lock);
+}
+
+/**
+ * @memberof GstWorker
+ */
+void
+gst_worker_watch_clients (GstWorker * worker, GstElement * sink,
+    gboolean keyframes)
+{
+  GstWorkerClientPolicy policy = gst_worker_client_policy;
+  gint64 limit = gst_worker_client_lag * GST_MSECOND;
+
+  g_return_if_fail (GST_IS_WORKER (worker));
+  g_return_if_fail (GST_IS_ELEMENT (sink));
+
+  if (keyframes && policy == GST_WORKER_CLIENT_DROP_TO_NEWEST)
+    policy = GST_WORKER_CLIENT_DROP_TO_KEYFRAME;
+
+  /* The sink keeps one buffer queue and a read position per client, so
+   * a slow client never blocks the others, and the limits below bound how
+   * far behind it can fall. */
+  gst_util_set_object_arg (G_OBJECT (sink), "units-format", "time");
+  switch (policy) {
+    case GST_WORKER_CLIENT_DROP_TO_NEWEST:
+      gst_util_set_object_arg (G_OBJECT (sink), "recover-policy", "latest");
+      g_object_set (sink, "units-soft-max", limit, NULL);
+      break;
+    case GST_WORKER_CLIENT_DROP_TO_KEYFRAME:
+      gst_util_set_object_arg (G_OBJECT (sink), "recover-policy", "keyframe");
+      g_object_set (sink, "units-soft-max", limit, NULL);
+      break;
+    case GST_WORKER_CLIENT_DISCONNECT:
+      gst_util_set_object_arg (G_OBJECT (sink), "recover-policy", "none");
+      g_object_set (sink, "units-max", limit, NULL);
+      break;
+  }
+
+  g_signal_connect (sink, "client-added",
+      G_CALLBACK (gst_worker_client_added), worker);
+  g_signal_connect (sink, "client-socket-removed",
+      G_CALLBACK (gst_worker_client_removed), worker);
+}
+
+/**
+ * @brief Get the timestamp of the newest buffer queued by a sink.
+ * @memberof GstWorker
+ */
+static GstClockTime
+gst_worker_get_newest_timestamp (GstElement * sink)
+{
+  GstClockTime timestamp = GST_CLOCK_TIME_NONE;
+  GstSample *sample = NULL;
+
+  g_object_get (sink, "last-sample", &sample, NULL);
+  if (sample) {
+    GstBuffer *buffer = gst_sample_get_buffer (sample);
+    if (buffer)
+      timestamp = GST_BUFFER_DTS_OR_PTS (buffer);
+    gst_sample_unref (sample);
+  }
+  return timestamp;
+}
+
+/**
+ * @memberof GstWorker
+ */
+GArray *
+gst_worker_get_client_stats (GstWorker * worker)
+{
+  GArray *result = g_array_new (FALSE, TRUE, sizeof (GstWorkerClientStats));
+  GHashTable *clients;
+  GHashTableIter iter;
+  gpointer socket, sink;
+
+  g_return_val_if_fail (GST_IS_WORKER (worker), result);
+
+  /* Query the sinks on a copy, they emit client-socket-removed with their
+   * own lock held. */
+  clients = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+      g_object_unref, gst_object_unref);
+  g_mutex_lock (&worker->clients_lock);
+  g_hash_table_iter_init (&iter, worker->clients);
+  while (g_hash_table_iter_next (&iter, &socket, &sink)) {
+    g_hash_table_insert (clients, g_object_ref (socket),
+        gst_object_ref (sink));
+  }
+  g_mutex_unlock (&worker->clients_lock);
+
+  g_hash_table_iter_init (&iter, clients);
+  while (g_hash_table_iter_next (&iter, &socket, &sink)) {
+    GstWorkerClientStats stats = { 0 };
+    GstStructure *structure = NULL;
+    GstClockTime newest, last = GST_CLOCK_TIME_NONE;
+    guint64 duration = 0;
+
+    /* The stats are empty if the client has just been removed. */
+    g_signal_emit_by_name (sink, "get-stats", socket, &structure);
+    if (!structure)
+      continue;
+    if (!gst_structure_get_uint64 (structure, "bytes-sent", &stats.bytes)) {
+      gst_structure_free (structure);
+      continue;
+    }
+
+    stats.fd = g_socket_get_fd (G_SOCKET (socket));
+    gst_structure_get_uint64 (structure, "buffers-dropped", &stats.dropped);
+    gst_structure_get_uint64 (structure, "connect-duration", &duration);
+    gst_structure_get_uint64 (structure, "last-buffer-ts", &last);
+    gst_structure_free (structure);
+
+    if (duration)
+      stats.throughput = gst_util_uint64_scale (stats.bytes, 8 * GST_SECOND,
+          duration);
+
+    newest = gst_worker_get_newest_timestamp (GST_ELEMENT (sink));
+    if (GST_CLOCK_TIME_IS_VALID (newest) && GST_CLOCK_TIME_IS_VALID (last)
+        && newest > last)
+      stats.lag = GST_TIME_AS_USECONDS (newest - last);
+
+    g_array_append_val (result, stats);
+  }
+  g_hash_table_destroy (clients);
+
+  return result;
+}
+
 /*
 static void
 gst_worker_missing_plugin (GstWorker *worker, GstStructure *structure)
@@ -486,6 +1829,10 @@ gst_worker_handle_error (GstWorker * worker, GError * error, const char *debug)
   }
   ERROR ("DEBUG INFO:\n%s\n", debug);
 
+  /* a failed pipeline is never reused */
+  g_free (worker->pool_key);
+  worker->pool_key = NULL;
+
   gst_worker_stop (worker);
   GstWorkerClass *worker_class = GST_WORKER_CLASS (G_OBJECT_GET_CLASS (worker));
   worker_class->close (worker);
@@ -513,7 +1860,7 @@ gst_worker_state_null_to_ready (GstWorker * worker)
 {
   g_return_if_fail (GST_IS_WORKER (worker));
 
-  gst_element_set_state (worker->pipeline, GST_STATE_PAUSED);
+  gst_worker_set_state (worker, GST_STATE_PAUSED);
 }
 
 static void
@@ -522,7 +1869,10 @@ gst_worker_state_ready_to_paused (GstWorker * worker)
   g_return_if_fail (GST_IS_WORKER (worker));
 
   if (!worker->paused_for_buffering) {
-    gst_element_set_state (worker->pipeline, GST_STATE_PLAYING);
+    gst_worker_set_state (worker, GST_STATE_PLAYING);
+  } else {
+    /* waiting for the data, not for a state change */
+    gst_worker_disarm (worker);
   }
 }
 
@@ -533,12 +1883,33 @@ gst_worker_state_paused_to_playing (GstWorker * worker)
 
   g_return_if_fail (GST_IS_WORKER (worker));
 
+  if (worker->start_time) {
+    GstWorkerStartStats *stats = &worker->start_stats;
+    stats->start = g_get_monotonic_time () - worker->start_time;
+    worker->start_time = 0;
+    INFO ("%s: started in %" G_GINT64_FORMAT " usec, string %"
+        G_GINT64_FORMAT ", parse %" G_GINT64_FORMAT "%s", worker->name,
+        stats->start, stats->build, stats->parse,
+        stats->pooled ? ", pooled" : "");
+  }
+
+  if (worker->phase == GST_WORKER_PHASE_STARTING) {
+    gst_worker_disarm (worker);
+    worker->phase = GST_WORKER_PHASE_PLAYING;
+  }
+
   workerclass = GST_WORKER_CLASS (G_OBJECT_GET_CLASS (worker));
   if (workerclass->alive) {
     (*workerclass->alive) (worker);
   }
 
+  if (worker->phase == GST_WORKER_PHASE_PLAYING)
+    gst_worker_watchdog_add (worker);
+
   g_signal_emit (worker, gst_worker_signals[SIGNAL_START_WORKER], 0);
+
+  if (worker->phase == GST_WORKER_PHASE_PLAYING)
+    gst_worker_finish (worker, TRUE);
 }
 
 static void
@@ -556,11 +1927,21 @@ gst_worker_state_ready_to_null (GstWorker * worker)
 {
   GstWorkerClass *workerclass;
   GstWorkerNullReturn ret = GST_WORKER_NR_END;
+  GstWorkerDoneFunc done;
+  gpointer data;
 
   //INFO ("%s", __FUNCTION__);
 
   g_return_if_fail (GST_IS_WORKER (worker));
 
+  /* the stop is done, whatever the handlers start next */
+  done = worker->done;
+  data = worker->done_data;
+  worker->done = NULL;
+  worker->done_data = NULL;
+  if (worker->phase == GST_WORKER_PHASE_STOPPING)
+    worker->phase = GST_WORKER_PHASE_STOPPED;
+
   workerclass = GST_WORKER_CLASS (G_OBJECT_GET_CLASS (worker));
   if (workerclass->null) {
     switch ((ret = (*workerclass->null) (worker))) {
@@ -576,6 +1957,9 @@ gst_worker_state_ready_to_null (GstWorker * worker)
 
   if (ret == GST_WORKER_NR_END)
     g_signal_emit (worker, gst_worker_signals[SIGNAL_END_WORKER], 0);
+
+  if (done)
+    done (worker, TRUE, data);
 }
 
 static gboolean
@@ -609,13 +1993,109 @@ gst_worker_pipeline_state_changed (GstWorker * worker,
   return TRUE;
 }
 
+/**
+ * @memberof GstWorker
+ *
+ * Raise the streaming thread posting a stream status message to the
+ * SCHED_FIFO priority of the worker. The ENTER status is posted from the
+ * new thread itself, before it processes any data. Raising needs
+ * CAP_SYS_NICE or an rtprio limit, the thread stays as it is otherwise.
+ */
+static void
+gst_worker_raise_thread (GstWorker * worker, GstMessage * message)
+{
+#ifdef G_OS_UNIX
+  static gboolean warned = FALSE;
+  GstStreamStatusType type;
+  struct sched_param param;
+  GstElement *owner;
+  gint err;
+
+  gst_message_parse_stream_status (message, &type, &owner);
+  if (type != GST_STREAM_STATUS_TYPE_ENTER)
+    return;
+
+  memset (&param, 0, sizeof (param));
+  param.sched_priority = worker->priority;
+  err = pthread_setschedparam (pthread_self (), SCHED_FIFO, &param);
+  if (err != 0 && !warned) {
+    WARN ("%s: no realtime priority for %s: %s", worker->name,
+        GST_ELEMENT_NAME (owner), g_strerror (err));
+    warned = TRUE;
+  }
+#endif
+}
+
+/**
+ * @memberof GstWorker
+ *
+ * Time a state change as it is posted. Every element changing is a
+ * candidate for the slowest one, which the change of the pipeline itself
+ * records with its own time. A change of several steps times each step
+ * from the end of the one before.
+ */
+static void
+gst_worker_trace_state_changed (GstWorker * worker, GstMessage * message)
+{
+  GstWorkerTransitionStats *stats;
+  GstState oldstate, newstate;
+  gboolean slow = FALSE;
+  gchar *trace = NULL;
+  gint64 elapsed;
+  gint i;
+
+  gst_message_parse_state_changed (message, &oldstate, &newstate, NULL);
+  i = gst_worker_transition_index (GST_STATE_TRANSITION (oldstate, newstate));
+
+  g_mutex_lock (&worker->trace_lock);
+  elapsed = g_get_monotonic_time () - worker->transition_time;
+  if (GST_MESSAGE_SRC (message) != GST_OBJECT (worker->pipeline)) {
+    if (elapsed >= worker->slowest_time) {
+      g_free (worker->slowest);
+      worker->slowest = g_strdup (GST_MESSAGE_SRC_NAME (message));
+      worker->slowest_time = elapsed;
+    }
+  } else if (i >= 0) {
+    stats = &worker->transitions[i];
+    g_free (stats->slowest);
+    stats->time = elapsed;
+    stats->slowest = worker->slowest;
+    stats->slowest_time = worker->slowest_time;
+    worker->slowest = NULL;
+    worker->slowest_time = 0;
+    worker->transition_time += elapsed;
+
+    /* half the deadline is worth a warning */
+    slow = gst_worker_state_timeout && elapsed > gst_worker_state_timeout * 500;
+    if (slow || verbose)
+      trace = g_strdup_printf ("%s: %s to %s in %.1f ms, slowest %s at %.1f ms",
+          worker->name, gst_element_state_get_name (oldstate),
+          gst_element_state_get_name (newstate), elapsed / 1000.0,
+          stats->slowest ? stats->slowest : "none",
+          stats->slowest_time / 1000.0);
+  }
+  g_mutex_unlock (&worker->trace_lock);
+
+  if (slow)
+    WARN ("%s", trace);
+  else if (trace)
+    INFO ("%s", trace);
+  g_free (trace);
+}
+
 static GstBusSyncReply
 gst_worker_message_sync (GstBus * bus, GstMessage * message, GstWorker * worker)
 {
   switch (GST_MESSAGE_TYPE (message)) {
-    case GST_MESSAGE_EOS:
-      /* When we see EOS, wake up and gst_worker_stop that might be waiting */
-      g_cond_signal (&worker->shutdown_cond);
+    case GST_MESSAGE_STATE_CHANGED:
+      gst_worker_trace_state_changed (worker, message);
+      break;
+    case GST_MESSAGE_STREAM_STATUS:
+      if (worker->priority > 0)
+        gst_worker_raise_thread (worker, message);
+      break;
+    case GST_MESSAGE_QOS:
+      gst_worker_count_qos (message);
       break;
     default:
       break;
@@ -716,11 +2196,11 @@ gst_worker_message (GstBus * bus, GstMessage * message, GstWorker * worker)
       if (!worker->paused_for_buffering && percent < 100) {
         g_print ("pausing for buffing\n");
         worker->paused_for_buffering = TRUE;
-        gst_element_set_state (worker->pipeline, GST_STATE_PAUSED);
+        gst_worker_set_state (worker, GST_STATE_PAUSED);
       } else if (worker->paused_for_buffering && percent == 100) {
         g_print ("unpausing for buffing\n");
         worker->paused_for_buffering = FALSE;
-        gst_element_set_state (worker->pipeline, GST_STATE_PLAYING);
+        gst_worker_set_state (worker, GST_STATE_PLAYING);
       }
     }
       break;
@@ -756,6 +2236,7 @@ static gboolean
 gst_worker_prepare_unsafe (GstWorker * worker)
 {
   GstWorkerClass *workerclass;
+  GstIterator *iter;
 
   g_return_val_if_fail (worker, FALSE);
 
@@ -777,6 +2258,7 @@ gst_worker_prepare_unsafe (GstWorker * worker)
   if (!worker->bus)
     goto error_get_bus;
 
+  gst_bus_set_flushing (worker->bus, FALSE);
   worker->watch = gst_bus_add_watch (worker->bus,
       (GstBusFunc) gst_worker_message, worker);
 
@@ -786,6 +2268,12 @@ gst_worker_prepare_unsafe (GstWorker * worker)
   gst_bus_set_sync_handler (worker->bus,
       (GstBusSyncHandler) (gst_worker_message_sync), worker, NULL);
 
+  iter = gst_bin_iterate_recurse (GST_BIN (worker->pipeline));
+  while (gst_iterator_foreach (iter, gst_worker_add_counters, NULL) ==
+      GST_ITERATOR_RESYNC)
+    gst_iterator_resync (iter);
+  gst_iterator_free (iter);
+
   if (workerclass->prepare && !workerclass->prepare (worker))
     goto error_prepare;
 
@@ -854,7 +2342,13 @@ gst_worker_reset (GstWorker * worker)
 
 #if 1
   if (worker) {
+    /* a start or stop in progress is gone with the pipeline */
+    gst_worker_expect (worker, NULL, NULL);
+    gst_worker_disarm (worker);
+    worker->phase = GST_WORKER_PHASE_STOPPED;
+
     GST_WORKER_LOCK_PIPELINE (worker);
+    gst_worker_watchdog_remove (worker);
     if (worker->pipeline) {
       gst_element_set_state (worker->pipeline, GST_STATE_NULL);
     }
@@ -881,6 +2375,9 @@ gst_worker_reset (GstWorker * worker)
       gst_object_unref (worker->bus);
       worker->bus = NULL;
     }
+    g_mutex_lock (&worker->clients_lock);
+    g_hash_table_remove_all (worker->clients);
+    g_mutex_unlock (&worker->clients_lock);
     ok = gst_worker_prepare_unsafe (worker);
     GST_WORKER_UNLOCK_PIPELINE (worker);
   }
@@ -31,10 +31,120 @@
 #define GST_IS_WORKER(object) (G_TYPE_CHECK_INSTANCE_TYPE ((object), GST_TYPE_WORKER))
 #define GST_IS_WORKER_CLASS(class) (G_TYPE_CHECK_CLASS_TYPE ((class), GST_TYPE_WORKER))
 
+#define GST_WORKER_DEFAULT_CLIENT_LAG 1000  /* ms */
+#define GST_WORKER_DEFAULT_POOL_SIZE 2  /* idle pipelines kept per shape */
+#define GST_WORKER_DEFAULT_STATE_TIMEOUT 10000  /* ms per state change */
+#define GST_WORKER_DEFAULT_WATCHDOG 5000        /* ms without buffers */
+#define GST_WORKER_WATCHDOG_MAX_BACKOFF 60000   /* ms between restarts */
+
 typedef struct _GstWorker GstWorker;
 typedef struct _GstWorkerClass GstWorkerClass;
+typedef struct _GstWorkerClientStats GstWorkerClientStats;
+typedef struct _GstWorkerStartStats GstWorkerStartStats;
+typedef struct _GstWorkerTransitionStats GstWorkerTransitionStats;
+typedef struct _GstWorkerWatchdogStats GstWorkerWatchdogStats;
+typedef struct _GstWorkerElementStats GstWorkerElementStats;
 typedef struct _GstSwitchServer GstSwitchServer;
 
+/**
+ * @enum GstWorkerClientPolicy
+ *
+ * What a serving point does with a client falling behind by more than the
+ * client lag limit.
+ */
+typedef enum
+{
+  GST_WORKER_CLIENT_DROP_TO_NEWEST,     /*!< skip to the newest buffer */
+  GST_WORKER_CLIENT_DROP_TO_KEYFRAME,   /*!< skip to the latest keyframe */
+  GST_WORKER_CLIENT_DISCONNECT, /*!< disconnect the client */
+} GstWorkerClientPolicy;
+
+/**
+ * @enum GstWorkerPhase
+ *
+ * Where a worker is between gst_worker_start_async and
+ * gst_worker_stop_async. Every phase but the stopped and the playing one
+ * has a deadline, see gst_worker_set_state_timeout.
+ */
+typedef enum
+{
+  GST_WORKER_PHASE_STOPPED,     /*!< no pipeline or a NULL one */
+  GST_WORKER_PHASE_STARTING,    /*!< stepping the pipeline up to PLAYING */
+  GST_WORKER_PHASE_PLAYING,     /*!< the pipeline is PLAYING */
+  GST_WORKER_PHASE_DRAINING,    /*!< waiting for the EOS of a clean stop */
+  GST_WORKER_PHASE_STOPPING,    /*!< NULL, the null handlers are pending */
+} GstWorkerPhase;
+
+/**
+ *  @brief Snapshot of the statistics of one client of a serving point.
+ */
+struct _GstWorkerClientStats
+{
+  gint fd;                      /*!< the client socket */
+  gint64 lag;                   /*!< how far the client is behind, usec */
+  guint64 dropped;              /*!< buffers dropped for the client */
+  guint64 bytes;                /*!< bytes sent to the client */
+  guint64 throughput;           /*!< average send throughput, bit/s */
+};
+
+/**
+ *  @brief What the last start of a worker took, in usec.
+ */
+struct _GstWorkerStartStats
+{
+  gint64 build;                 /*!< building the pipeline string */
+  gint64 parse;                 /*!< parsing the pipeline string */
+  gint64 start;                 /*!< from gst_worker_start to PLAYING */
+  gboolean pooled;              /*!< TRUE if the pipeline was reused */
+};
+
+/**
+ *  @brief What the last pipeline state change of a kind took.
+ */
+struct _GstWorkerTransitionStats
+{
+  gint64 time;                  /*!< usec from the request to the pipeline */
+  gchar *slowest;               /*!< the element changing last, or NULL */
+  gint64 slowest_time;          /*!< usec until %slowest changed */
+};
+
+#define GST_WORKER_TRANSITIONS 6        /*!< NULL to READY .. READY to NULL */
+
+/**
+ *  @brief What the watchdog has done since the start of the process.
+ */
+struct _GstWorkerWatchdogStats
+{
+  guint stalls;                 /*!< PLAYING workers found without buffers */
+  guint restarts;               /*!< restarts of stalled workers */
+  guint recoveries;             /*!< stalled workers flowing again */
+  gint64 recovery_time;         /*!< mean usec from the last buffer before a
+                                   stall to the first one of a lasting flow
+                                   after it */
+};
+
+/**
+ *  @brief Snapshot of the counters of one element of a worker pipeline.
+ *
+ *  The counters are kept with the element from the preparation of the
+ *  worker on, and updated with atomics from the streaming threads. The
+ *  queued, dropped and repeated buffers are told from the buffers in and
+ *  out of the element, no property of it is read.
+ */
+struct _GstWorkerElementStats
+{
+  gchar *name;                  /*!< the element name */
+  guint64 buffers;              /*!< buffers out of it, into it for sinks */
+  guint64 bytes;                /*!< bytes of %buffers */
+  guint64 dropped;              /*!< frames dropped by QoS or videorate */
+  guint64 repeated;             /*!< frames repeated by videorate, flagged
+                                   GAP */
+  guint queued;                 /*!< buffers in a queue, 0 for others */
+  gint64 processing_time;       /*!< mean usec a buffer takes through it,
+                                   from the latest input of an aggregator,
+                                   -1 if not measured */
+};
+
 /**
  * @enum GstWorkerNullReturn
  * 
@@ -66,6 +176,20 @@ typedef GString *(*GstWorkerGetPipelineStringFunc) (GstWorker * worker);
  */
 typedef gboolean (*GstWorkerPrepareFunc) (GstWorker * worker);
 
+/**
+ *  @brief worker pool key callback function
+ *  @param worker The GstWorker instance.
+ */
+typedef gchar *(*GstWorkerGetPoolKeyFunc) (GstWorker * worker);
+
+/**
+ *  @brief worker pipeline reuse callback function
+ *  @param worker The GstWorker instance.
+ *  @param pipeline the pooled pipeline
+ */
+typedef gboolean (*GstWorkerReuseFunc) (GstWorker * worker,
+    GstElement * pipeline);
+
 /**
  *  @brief worker message callback function
  *  @param worker The GstWorker instance.
@@ -85,6 +209,16 @@ typedef GstWorkerNullReturn (*GstWorkerNullFunc) (GstWorker * worker);
  */
 typedef void (*GstWorkerAliveFunc) (GstWorker * worker);
 
+/**
+ *  @brief worker start or stop completion function
+ *  @param worker The GstWorker instance.
+ *  @param ok TRUE if the worker got there, FALSE if it failed, missed its
+ *         deadline or was asked for something else meanwhile
+ *  @param data User defined data pointer.
+ */
+typedef void (*GstWorkerDoneFunc) (GstWorker * worker, gboolean ok,
+    gpointer data);
+
 /**
  *  @brief worker virtual close function
  *  @param worker The GstWorker instance.
@@ -106,7 +240,6 @@ struct _GstWorker
   //GstSwitchServer *server; /*!<  */
 
   GMutex pipeline_lock;         /*!< Mutex for %pipeline */
-  GCond shutdown_cond;          /*!< Cond for shutting down pipelines cleanly */
   GstElement *pipeline;         /*!< The pipeline. */
   GstBus *bus;                  /*!< The pipeline bus. */
 
@@ -122,6 +255,44 @@ struct _GstWorker
    * via an EOS event to finish up before stopping
    */
   gboolean send_eos_on_stop;
+
+  GMutex clients_lock;          /*!< Mutex for %clients */
+  GHashTable *clients;          /*!< client GSocket to its serving sink */
+
+  /*!< SCHED_FIFO priority of the streaming threads, 0 leaves them alone
+   */
+  gint priority;
+
+  gchar *pool_key;              /*!< the shape of %pipeline, NULL if unpooled */
+  gint64 start_time;            /*!< when the worker was last started */
+  GstWorkerStartStats start_stats;      /*!< what the last start took */
+
+  GstWorkerPhase phase;         /*!< where the worker is */
+  guint deadline;               /*!< the timeout failing the current phase */
+  GstWorkerDoneFunc done;       /*!< called when the current phase ends */
+  gpointer done_data;           /*!< Caller defined data for %done. */
+
+  /*!< Mutex for the transition tracing, done in the streaming threads
+   */
+  GMutex trace_lock;
+  gint64 transition_time;       /*!< when the pending state change began */
+  gchar *slowest;               /*!< the element of it changing last */
+  gint64 slowest_time;          /*!< usec until %slowest changed */
+  GstWorkerTransitionStats transitions[GST_WORKER_TRANSITIONS]; /*!< last */
+
+  gint flow;                    /*!< buffers out of the sources, atomic */
+  GSList *flow_pads;            /*!< the source pads counted in %flow */
+
+  /*!< The state of the watchdog, under its lock
+   */
+  gint flow_seen;               /*!< %flow when the watchdog last looked */
+  gint64 flow_time;             /*!< when %flow last moved */
+  gint64 stalled_since;         /*!< the last buffer of a stall, 0 if none */
+  gint64 resumed_time;          /*!< the first buffer after a stall */
+  gint64 recovered_time;        /*!< when the last stall ended */
+  gint64 next_restart;          /*!< the earliest restart of a stall */
+  gint64 backoff;               /*!< usec from a restart to the next one */
+  gboolean restarting;          /*!< a restart is queued */
 };
 
 /**
@@ -185,6 +356,24 @@ struct _GstWorkerClass
    */
   GstElement *(*create_pipeline) (GstWorker * worker);
 
+  /**
+   *  @brief Virtual function naming the shape of the worker pipeline.
+   *  @param worker The GstWorker instance.
+   *  @return A newly allocated key, or NULL to never pool the pipeline.
+   *
+   *  Stopped pipelines of the same shape are kept in READY and handed to
+   *  the next worker asking for it, which only differ in properties.
+   */
+  gchar *(*get_pool_key) (GstWorker * worker);
+
+  /**
+   *  @brief Virtual function setting up a pooled pipeline for the worker.
+   *  @param worker The GstWorker instance.
+   *  @param pipeline A pipeline of the same shape, in READY.
+   *  @return TRUE if the pipeline is usable.
+   */
+    gboolean (*reuse) (GstWorker * worker, GstElement * pipeline);
+
   /**
    *  @brief Virtual function called when the worker is prepared.
    *  @param worker The GstWorker instance.
@@ -227,18 +416,53 @@ GType gst_worker_get_type (void);
  *  @param worker The GstWorker instance.
  *
  *  Start the worker. This will call the derived create_pipeline and the
- *  virtual "prepare" function.
+ *  virtual "prepare" function. Same as gst_worker_start_async (worker,
+ *  NULL, NULL).
  *
  *  @return TRUE if worker prepared and started.
  *  @memberof GstWorker
  */
 gboolean gst_worker_start (GstWorker * worker);
 
+/**
+ *  @param worker The GstWorker instance.
+ *  @param done Called once the worker is PLAYING, or has failed to get
+ *         there, may be NULL.
+ *  @param data User defined data for @done.
+ *
+ *  Start the worker without waiting for it. Each state change of the
+ *  pipeline on the way up has to be done within the state timeout, the
+ *  worker is stopped otherwise.
+ *
+ *  @return TRUE if the start is under way, @done is not called otherwise.
+ *  @memberof GstWorker
+ */
+gboolean gst_worker_start_async (GstWorker * worker, GstWorkerDoneFunc done,
+    gpointer data);
+
+/**
+ *  @param worker The GstWorker instance.
+ *  @param force Skip the EOS of a clean stop if TRUE.
+ *  @param done Called after "end-worker", or when the stop is overtaken,
+ *         may be NULL.
+ *  @param data User defined data for @done.
+ *
+ *  Stop the worker without waiting for it. A PLAYING worker shutting down
+ *  cleanly is sent an EOS first, it is forced to stop if the EOS is not
+ *  through within the state timeout. A worker already stopping is joined.
+ *
+ *  @return TRUE if the stop is under way, @done is not called otherwise.
+ *  @memberof GstWorker
+ */
+gboolean gst_worker_stop_async (GstWorker * worker, gboolean force,
+    GstWorkerDoneFunc done, gpointer data);
+
 /**
  *  @param worker The GstWorker instance.
  *  @param force Force stopping the pipeline if TRUE.
  *
  *  Stop the pipeline, Pass TRUE to the second argument to make it force stop.
+ *  Same as gst_worker_stop_async (worker, force, NULL, NULL).
  *
  *  @return TRUE if stop request sent.
  *  @memberof GstWorker
@@ -285,4 +509,145 @@ GstElement *gst_worker_get_element_unlocked (GstWorker * worker,
  */
 GstElement *gst_worker_get_element (GstWorker * worker, const gchar * name);
 
+/**
+ *  @param worker The GstWorker instance.
+ *
+ *  Query the latency of the running pipeline, the time from a buffer
+ *  entering the pipeline to its sinks rendering it.
+ *
+ *  @return the latency, GST_CLOCK_TIME_NONE if the pipeline is not live
+ *          or not running.
+ *  @memberof GstWorker
+ */
+GstClockTime gst_worker_get_latency (GstWorker * worker);
+
+/**
+ *  @param policy The policy for clients falling behind.
+ *  @param lag How far behind a client may fall, in milliseconds.
+ *
+ *  Set the client queue policy of serving points watched afterwards.
+ *
+ *  @see gst_worker_watch_clients
+ */
+void gst_worker_set_client_policy (GstWorkerClientPolicy policy, guint lag);
+
+/**
+ *  @param size The idle pipelines kept for each shape, 0 for none.
+ *
+ *  Set the size of the pipeline pool, pipelines already pooled beyond the
+ *  new size are released.
+ */
+void gst_worker_set_pool_size (guint size);
+
+/**
+ *  Release all pooled pipelines.
+ */
+void gst_worker_pool_clear (void);
+
+/**
+ *  @param timeout The msec a state change or the EOS of a clean stop may
+ *         take, 0 to wait forever.
+ *
+ *  Set the deadline of the state changes requested afterwards.
+ */
+void gst_worker_set_state_timeout (guint timeout);
+
+/**
+ *  @param timeout The msec a PLAYING live worker may go without a buffer
+ *         out of its sources, 0 for no watchdog.
+ *
+ *  Start or stop the watchdog thread. It restarts the workers stalled for
+ *  longer than @timeout, and a worker stalling again within
+ *  GST_WORKER_WATCHDOG_MAX_BACKOFF msec of its last restart waits twice as
+ *  long as before for the next one. Workers which are not live only flow
+ *  with their input and are left alone, so are the readers of an inter
+ *  channel nobody writes, which send the latest frame again or black.
+ */
+void gst_worker_set_watchdog (guint timeout);
+
+/**
+ *  @param stats Return location of the statistics.
+ *
+ *  Get the stalls and restarts of the watchdog so far.
+ *
+ *  MT safe.
+ */
+void gst_worker_get_watchdog_stats (GstWorkerWatchdogStats * stats);
+
+/**
+ *  @param worker The GstWorker instance.
+ *  @param transition The state change, e.g. GST_STATE_CHANGE_READY_TO_PAUSED.
+ *  @param stats Return location of the statistics.
+ *
+ *  Get what the last state change of a kind took, and the element which
+ *  took longest in it.
+ *
+ *  MT safe.
+ *
+ *  @return TRUE if the pipeline went through @transition, free
+ *          stats->slowest with g_free.
+ *  @memberof GstWorker
+ */
+gboolean gst_worker_get_transition_stats (GstWorker * worker,
+    GstStateChange transition, GstWorkerTransitionStats * stats);
+
+/**
+ *  @param worker The GstWorker instance.
+ *
+ *  Get the counters of the elements of the worker pipeline. The processing
+ *  time is measured for elements with one sink and one source pad which do
+ *  not hand buffers to another thread.
+ *
+ *  MT safe.
+ *
+ *  @return a GArray of GstWorkerElementStats, free with g_array_unref.
+ *  @memberof GstWorker
+ */
+GArray *gst_worker_get_stats (GstWorker * worker);
+
+/**
+ *  Get all workers alive.
+ *
+ *  MT safe.
+ *
+ *  @return a GList of the workers, free with g_list_free_full (list,
+ *          g_object_unref).
+ */
+GList *gst_worker_list (void);
+
+/**
+ *  @param name The policy name, "newest", "keyframe" or "disconnect".
+ *  @param policy Return location of the policy.
+ *
+ *  @return TRUE if the name is a valid policy.
+ */
+gboolean gst_worker_parse_client_policy (const gchar * name,
+    GstWorkerClientPolicy * policy);
+
+/**
+ *  @param worker The GstWorker instance.
+ *  @param sink A tcpserversink of the worker pipeline.
+ *  @param keyframes TRUE if the sink serves an encoded stream.
+ *
+ *  Bound the queue of every client of @sink according to the client
+ *  policy, and keep track of the clients for gst_worker_get_client_stats.
+ *  Clients of an encoded stream are never resynced to a delta frame.
+ *
+ *  @memberof GstWorker
+ */
+void gst_worker_watch_clients (GstWorker * worker, GstElement * sink,
+    gboolean keyframes);
+
+/**
+ *  @param worker The GstWorker instance.
+ *
+ *  Get the statistics of the clients of the watched sinks.
+ *
+ *  MT safe.
+ *
+ *  @return a GArray of GstWorkerClientStats, free with g_array_unref.
+ *  @memberof GstWorker
+ */
+GArray *gst_worker_get_client_stats (GstWorker * worker);
+
 #endif //__GST_WORKER_H__